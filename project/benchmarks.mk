@@ -0,0 +1,45 @@
+###############################################################################
+##  OBJECTS                                                                  ##
+###############################################################################
+
+BENCH_SOURCE = $(wildcard $(SOURCE_BENCH)/*.c)
+
+BENCH_OBJECT = $(patsubst %.c,%.o,$(subst $(SOURCE_BENCH)/,$(TARGET_BENCH)/,$(BENCH_SOURCE)))
+
+###############################################################################
+##  FLAGS                                                                    ##
+###############################################################################
+
+BENCH_CFLAGS = -I$(TARGET_INCL)
+
+# Benchmarks link against the same libraries as the tests.
+BENCH_LDFLAGS = $(TEST_LDFLAGS)
+
+BENCH_ARGS := -h $(AS_HOST) -p $(AS_PORT)
+
+###############################################################################
+##  TARGETS                                                                  ##
+###############################################################################
+
+.PHONY: benchmarks
+benchmarks: $(TARGET_BENCH)/benchmarks
+
+.PHONY: benchmarks-run
+benchmarks-run: $(TARGET_BENCH)/benchmarks
+	$(TARGET_BENCH)/benchmarks $(BENCH_ARGS)
+
+.PHONY: benchmarks-mock
+benchmarks-mock: $(TARGET_BENCH)/benchmarks
+	$(TARGET_BENCH)/benchmarks --mock -d 10
+
+.PHONY: benchmarks-clean
+benchmarks-clean:
+	@rm -rf $(TARGET_BENCH)
+
+$(TARGET_BENCH)/%.o: CFLAGS = $(BENCH_CFLAGS)
+$(TARGET_BENCH)/%.o: $(SOURCE_BENCH)/%.c $(SOURCE_BENCH)/benchmark.h
+	$(object)
+
+$(TARGET_BENCH)/benchmarks: CFLAGS += $(BENCH_CFLAGS)
+$(TARGET_BENCH)/benchmarks: $(BENCH_OBJECT) $(TARGET_LIB)/libaerospike.a | build prepare
+	$(executable) $(BENCH_LDFLAGS)
@@ -61,6 +61,14 @@ ifeq ($(EVENT_LIB),libevent)
   TEST_LDFLAGS += -levent_core -levent_pthreads
 endif
 
+ifeq ($(EVENT_LIB),io_uring)
+  TEST_LDFLAGS += -luring
+endif
+
+ifeq ($(USE_LIBDEFLATE),1)
+  TEST_LDFLAGS += -ldeflate
+endif
+
 AS_HOST := 127.0.0.1
 AS_PORT := 3000
 AS_ARGS := -h $(AS_HOST) -p $(AS_PORT)
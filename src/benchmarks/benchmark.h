@@ -0,0 +1,133 @@
+/*
+ * Copyright 2008-2021 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#pragma once
+
+#include <aerospike/aerospike.h>
+#include <aerospike/as_latency.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+typedef enum {
+	BENCH_MODE_SYNC,
+	BENCH_MODE_ASYNC,
+	BENCH_MODE_PIPELINE
+} bench_mode;
+
+typedef enum {
+	// Write each key in the key space once.
+	BENCH_WORKLOAD_INSERT,
+
+	// Random reads and updates over the key space.
+	BENCH_WORKLOAD_READ_UPDATE
+} bench_workload;
+
+typedef struct bench_args_s {
+	char* host;
+	int port;
+	char* ns;
+	char* set;
+	uint64_t start_key;
+	uint64_t keys;
+
+	// Bin value size in bytes. Zero writes an integer bin.
+	uint32_t bin_size;
+
+	bench_workload workload;
+	uint32_t read_pct;
+
+	// Keys per read. Values greater than one use batch reads.
+	uint32_t batch_size;
+
+	// Sync worker threads or async command generator threads.
+	uint32_t threads;
+
+	bench_mode mode;
+	uint32_t async_max_commands;
+	uint32_t event_loops;
+
+	// Maximum transactions per second across all threads. Zero is unlimited.
+	uint32_t throughput;
+
+	// Run time in seconds. Zero runs until insert completes or forever for read/update.
+	uint32_t duration;
+
+	// Seconds between reports.
+	uint32_t interval;
+
+	uint32_t timeout_ms;
+
+	// Run against an in-process mock server instead of a cluster.
+	bool mock;
+
+	// Delay added to each mock server response in microseconds.
+	uint32_t mock_delay_us;
+} bench_args;
+
+typedef struct bench_counter_s {
+	uint64_t count;
+	uint64_t timeouts;
+	uint64_t errors;
+	as_latency_buckets latency;
+} bench_counter;
+
+typedef struct bench_data_s {
+	bench_args* args;
+	aerospike* as;
+	uint8_t* value;
+	bench_counter write;
+	bench_counter read;
+	uint64_t inserted;
+	uint32_t errors_logged;
+	volatile bool valid;
+} bench_data;
+
+typedef struct bench_mock_s bench_mock;
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * Run workload until duration expires, insert completes or bench_stop() is called.
+ * Statistics are reported to stdout every args->interval seconds.
+ */
+int
+bench_run(bench_data* data);
+
+/**
+ * Signal workers to stop.
+ */
+void
+bench_stop(bench_data* data);
+
+/**
+ * Start mock server on a 127.0.0.1 ephemeral port. The mock server answers the info
+ * requests needed to form a single node cluster and returns canned responses for reads,
+ * writes and batch reads. Nothing is stored.
+ */
+bench_mock*
+bench_mock_start(bench_args* args, uint16_t* port);
+
+/**
+ * Stop mock server. Client connections should be closed first.
+ */
+void
+bench_mock_stop(bench_mock* mock);
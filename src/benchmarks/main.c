@@ -0,0 +1,369 @@
+/*
+ * Copyright 2008-2021 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include "benchmark.h"
+#include <aerospike/as_event.h>
+#include <citrusleaf/alloc.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ * STATIC VARIABLES
+ *****************************************************************************/
+
+static bench_data* g_data = NULL;
+
+static const char* short_options = "h:p:n:s:K:k:b:w:B:z:aPc:W:g:d:i:T:MD:u";
+
+static struct option long_options[] = {
+	{"hosts",              required_argument, 0, 'h'},
+	{"port",               required_argument, 0, 'p'},
+	{"namespace",          required_argument, 0, 'n'},
+	{"set",                required_argument, 0, 's'},
+	{"start-key",          required_argument, 0, 'K'},
+	{"keys",               required_argument, 0, 'k'},
+	{"bin-size",           required_argument, 0, 'b'},
+	{"workload",           required_argument, 0, 'w'},
+	{"batch-size",         required_argument, 0, 'B'},
+	{"threads",            required_argument, 0, 'z'},
+	{"async",              no_argument,       0, 'a'},
+	{"pipeline",           no_argument,       0, 'P'},
+	{"async-max-commands", required_argument, 0, 'c'},
+	{"event-loops",        required_argument, 0, 'W'},
+	{"throughput",         required_argument, 0, 'g'},
+	{"duration",           required_argument, 0, 'd'},
+	{"interval",           required_argument, 0, 'i'},
+	{"timeout",            required_argument, 0, 'T'},
+	{"mock",               no_argument,       0, 'M'},
+	{"mock-delay",         required_argument, 0, 'D'},
+	{"usage",              no_argument,       0, 'u'},
+	{0, 0, 0, 0}
+};
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+static void
+print_usage(const char* program)
+{
+	printf("Usage: %s <options>\n", program);
+	printf("-h --hosts <host>            Seed host. Default: 127.0.0.1\n");
+	printf("-p --port <port>             Seed port. Default: 3000\n");
+	printf("-n --namespace <ns>          Namespace. Default: test\n");
+	printf("-s --set <set>               Set name. Default: testset\n");
+	printf("-K --start-key <key>         First key. Default: 0\n");
+	printf("-k --keys <count>            Number of keys. Default: 100000\n");
+	printf("-b --bin-size <bytes>        Bytes bin size. 0 writes an integer bin. Default: 0\n");
+	printf("-w --workload I|RU,<pct>     Insert all keys or random read/update with read\n");
+	printf("                             percentage. Default: RU,50\n");
+	printf("-B --batch-size <size>       Keys per read. Greater than 1 uses batch reads.\n");
+	printf("                             Default: 1\n");
+	printf("-z --threads <count>         Sync worker or async generator threads. Default: 16\n");
+	printf("-a --async                   Use async commands.\n");
+	printf("-P --pipeline                Use async commands with pipelining.\n");
+	printf("-c --async-max-commands <n>  Maximum async commands in flight. Default: 200\n");
+	printf("-W --event-loops <count>     Async event loops. Default: 1\n");
+	printf("-g --throughput <tps>        Throttle to transactions per second. Default: 0\n");
+	printf("-d --duration <seconds>      Run time. 0 runs until insert completes or forever.\n");
+	printf("                             Default: 0\n");
+	printf("-i --interval <seconds>      Seconds between reports. Default: 1\n");
+	printf("-T --timeout <ms>            Total command timeout. Default: 1000\n");
+	printf("-M --mock                    Run against an in-process mock server.\n");
+	printf("-D --mock-delay <us>         Mock server delay per response. Default: 0\n");
+	printf("-u --usage                   Print usage.\n");
+}
+
+static bool
+parse_workload(bench_args* args, const char* s)
+{
+	if (strcmp(s, "I") == 0) {
+		args->workload = BENCH_WORKLOAD_INSERT;
+		return true;
+	}
+
+	if (strncmp(s, "RU", 2) == 0) {
+		args->workload = BENCH_WORKLOAD_READ_UPDATE;
+
+		if (s[2] == ',') {
+			args->read_pct = (uint32_t)atoi(s + 3);
+		}
+		return args->read_pct <= 100;
+	}
+	return false;
+}
+
+static bool
+parse_args(int argc, char** argv, bench_args* args)
+{
+	args->host = "127.0.0.1";
+	args->port = 3000;
+	args->ns = "test";
+	args->set = "testset";
+	args->start_key = 0;
+	args->keys = 100000;
+	args->bin_size = 0;
+	args->workload = BENCH_WORKLOAD_READ_UPDATE;
+	args->read_pct = 50;
+	args->batch_size = 1;
+	args->threads = 16;
+	args->mode = BENCH_MODE_SYNC;
+	args->async_max_commands = 200;
+	args->event_loops = 1;
+	args->throughput = 0;
+	args->duration = 0;
+	args->interval = 1;
+	args->timeout_ms = 1000;
+	args->mock = false;
+	args->mock_delay_us = 0;
+
+	int c;
+
+	while ((c = getopt_long(argc, argv, short_options, long_options, NULL)) != -1) {
+		switch (c) {
+			case 'h':
+				args->host = optarg;
+				break;
+			case 'p':
+				args->port = atoi(optarg);
+				break;
+			case 'n':
+				args->ns = optarg;
+				break;
+			case 's':
+				args->set = optarg;
+				break;
+			case 'K':
+				args->start_key = strtoull(optarg, NULL, 10);
+				break;
+			case 'k':
+				args->keys = strtoull(optarg, NULL, 10);
+				break;
+			case 'b':
+				args->bin_size = (uint32_t)atoi(optarg);
+				break;
+			case 'w':
+				if (! parse_workload(args, optarg)) {
+					fprintf(stderr, "Invalid workload: %s\n", optarg);
+					return false;
+				}
+				break;
+			case 'B':
+				args->batch_size = (uint32_t)atoi(optarg);
+				break;
+			case 'z':
+				args->threads = (uint32_t)atoi(optarg);
+				break;
+			case 'a':
+				args->mode = BENCH_MODE_ASYNC;
+				break;
+			case 'P':
+				args->mode = BENCH_MODE_PIPELINE;
+				break;
+			case 'c':
+				args->async_max_commands = (uint32_t)atoi(optarg);
+				break;
+			case 'W':
+				args->event_loops = (uint32_t)atoi(optarg);
+				break;
+			case 'g':
+				args->throughput = (uint32_t)atoi(optarg);
+				break;
+			case 'd':
+				args->duration = (uint32_t)atoi(optarg);
+				break;
+			case 'i':
+				args->interval = (uint32_t)atoi(optarg);
+				break;
+			case 'T':
+				args->timeout_ms = (uint32_t)atoi(optarg);
+				break;
+			case 'M':
+				args->mock = true;
+				break;
+			case 'D':
+				args->mock_delay_us = (uint32_t)atoi(optarg);
+				break;
+			case 'u':
+			default:
+				return false;
+		}
+	}
+
+	if (args->keys == 0 || args->threads == 0 || args->interval == 0 ||
+		args->batch_size == 0 || args->event_loops == 0 || args->async_max_commands == 0) {
+		fprintf(stderr, "keys, threads, interval, batch-size, event-loops and "
+				"async-max-commands must be greater than zero\n");
+		return false;
+	}
+	return true;
+}
+
+static void
+print_args(bench_args* args)
+{
+	static const char* modes[] = {"sync", "async", "pipeline"};
+
+	printf("hosts:              %s:%d%s\n", args->host, args->port, args->mock ? " (mock)" : "");
+	printf("namespace:          %s\n", args->ns);
+	printf("set:                %s\n", args->set);
+	printf("keys:               %" PRIu64 " starting at %" PRIu64 "\n", args->keys,
+		   args->start_key);
+	printf("bin:                %s(%u)\n", args->bin_size ? "bytes" : "integer", args->bin_size);
+
+	if (args->workload == BENCH_WORKLOAD_INSERT) {
+		printf("workload:           insert\n");
+	}
+	else {
+		printf("workload:           read %u%% update %u%%\n", args->read_pct,
+			   100 - args->read_pct);
+	}
+
+	printf("batch size:         %u\n", args->batch_size);
+	printf("mode:               %s\n", modes[args->mode]);
+	printf("threads:            %u\n", args->threads);
+
+	if (args->mode != BENCH_MODE_SYNC) {
+		printf("async max commands: %u\n", args->async_max_commands);
+		printf("event loops:        %u\n", args->event_loops);
+	}
+
+	printf("throughput:         %s%u\n", args->throughput ? "" : "unlimited ",
+		   args->throughput);
+	printf("timeout:            %u ms\n", args->timeout_ms);
+	fflush(stdout);
+}
+
+static void
+sig_handler(int sig)
+{
+	if (g_data) {
+		bench_stop(g_data);
+	}
+}
+
+/******************************************************************************
+ * MAIN
+ *****************************************************************************/
+
+int
+main(int argc, char** argv)
+{
+	bench_args args;
+
+	if (! parse_args(argc, argv, &args)) {
+		print_usage(argv[0]);
+		return -1;
+	}
+
+	signal(SIGPIPE, SIG_IGN);
+
+	bench_mock* mock = NULL;
+
+	if (args.mock) {
+		uint16_t port;
+		mock = bench_mock_start(&args, &port);
+
+		if (! mock) {
+			return -1;
+		}
+		args.host = "127.0.0.1";
+		args.port = port;
+	}
+
+	print_args(&args);
+
+	if (args.mode != BENCH_MODE_SYNC && ! as_event_create_loops(args.event_loops)) {
+		fprintf(stderr, "Failed to create event loops. Build with "
+				"EVENT_LIB=libev|libuv|libevent|io_uring for async modes.\n");
+
+		if (mock) {
+			bench_mock_stop(mock);
+		}
+		return -1;
+	}
+
+	as_config config;
+	as_config_init(&config);
+	as_config_add_host(&config, args.host, (uint16_t)args.port);
+	config.async_max_conns_per_node = args.async_max_commands;
+	config.pipe_max_conns_per_node = args.async_max_commands;
+
+	if (args.mode == BENCH_MODE_SYNC && config.max_conns_per_node < args.threads) {
+		config.max_conns_per_node = args.threads;
+	}
+
+	as_policies* p = &config.policies;
+	p->read.base.total_timeout = args.timeout_ms;
+	p->write.base.total_timeout = args.timeout_ms;
+	p->batch.base.total_timeout = args.timeout_ms;
+
+	aerospike as;
+	aerospike_init(&as, &config);
+
+	as_error err;
+
+	if (aerospike_connect(&as, &err) != AEROSPIKE_OK) {
+		fprintf(stderr, "Failed to connect: %d %s\n", err.code, err.message);
+		aerospike_destroy(&as);
+
+		if (args.mode != BENCH_MODE_SYNC) {
+			as_event_close_loops();
+		}
+
+		if (mock) {
+			bench_mock_stop(mock);
+		}
+		return -1;
+	}
+
+	bench_data data;
+	memset(&data, 0, sizeof(bench_data));
+	data.args = &args;
+	data.as = &as;
+
+	if (args.bin_size > 0) {
+		data.value = cf_malloc(args.bin_size);
+
+		for (uint32_t i = 0; i < args.bin_size; i++) {
+			data.value[i] = (uint8_t)i;
+		}
+	}
+
+	g_data = &data;
+	signal(SIGINT, sig_handler);
+	signal(SIGTERM, sig_handler);
+
+	int rv = bench_run(&data);
+
+	g_data = NULL;
+	aerospike_close(&as, &err);
+	aerospike_destroy(&as);
+
+	if (args.mode != BENCH_MODE_SYNC) {
+		as_event_close_loops();
+	}
+
+	if (mock) {
+		bench_mock_stop(mock);
+	}
+
+	cf_free(data.value);
+	return rv;
+}
@@ -0,0 +1,544 @@
+/*
+ * Copyright 2008-2021 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include "benchmark.h"
+#include <aerospike/as_atomic.h>
+#include <aerospike/as_bytes.h>
+#include <aerospike/as_command.h>
+#include <aerospike/as_proto.h>
+#include <citrusleaf/alloc.h>
+#include <citrusleaf/cf_b64.h>
+#include <citrusleaf/cf_byte_order.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/******************************************************************************
+ * MACROS
+ *****************************************************************************/
+
+#define MOCK_NODE_NAME "BB9000000000001"
+#define MOCK_PARTITIONS 4096
+#define MOCK_BIN_NAME "bin"
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+struct bench_mock_s {
+	pthread_t accept_thread;
+	char* replicas;
+	uint8_t* bin;
+	uint32_t bin_size;
+	uint32_t conns;
+	uint32_t delay_us;
+	uint8_t particle_type;
+	int listen_fd;
+	uint16_t port;
+	volatile bool running;
+};
+
+typedef struct {
+	bench_mock* mock;
+	int fd;
+} mock_conn;
+
+typedef struct {
+	uint8_t* data;
+	size_t size;
+	size_t capacity;
+} mock_buffer;
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+static uint8_t*
+mock_buffer_reserve(mock_buffer* mb, size_t size)
+{
+	if (mb->size + size > mb->capacity) {
+		size_t capacity = mb->capacity * 2;
+
+		if (capacity < mb->size + size) {
+			capacity = mb->size + size;
+		}
+		mb->data = cf_realloc(mb->data, capacity);
+		mb->capacity = capacity;
+	}
+
+	uint8_t* p = mb->data + mb->size;
+	mb->size += size;
+	return p;
+}
+
+static bool
+mock_read(int fd, uint8_t* buf, size_t len)
+{
+	while (len > 0) {
+		ssize_t n = read(fd, buf, len);
+
+		if (n <= 0) {
+			if (n < 0 && errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		buf += n;
+		len -= (size_t)n;
+	}
+	return true;
+}
+
+static bool
+mock_write(int fd, const uint8_t* buf, size_t len)
+{
+	while (len > 0) {
+		ssize_t n = write(fd, buf, len);
+
+		if (n <= 0) {
+			if (n < 0 && errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		buf += n;
+		len -= (size_t)n;
+	}
+	return true;
+}
+
+static void
+mock_write_proto(uint8_t* p, uint8_t type, size_t size)
+{
+	uint64_t proto = ((uint64_t)AS_PROTO_VERSION << 56) | ((uint64_t)type << 48) | size;
+	*(uint64_t*)p = cf_swap_to_be64(proto);
+}
+
+static uint8_t*
+mock_write_msg(
+	uint8_t* p, uint8_t info3, uint8_t result_code, uint32_t index, uint16_t n_ops
+	)
+{
+	memset(p, 0, 22);
+	p[0] = 22;
+	p[3] = info3;
+	p[5] = result_code;
+	*(uint32_t*)(p + 6) = cf_swap_to_be32(result_code == AEROSPIKE_OK ? 1 : 0);
+	*(uint32_t*)(p + 14) = cf_swap_to_be32(index);
+	*(uint16_t*)(p + 20) = cf_swap_to_be16(n_ops);
+	return p + 22;
+}
+
+static size_t
+mock_bin_size(bench_mock* mock)
+{
+	return 8 + sizeof(MOCK_BIN_NAME) - 1 + mock->bin_size;
+}
+
+static uint8_t*
+mock_write_bin(bench_mock* mock, uint8_t* p)
+{
+	uint32_t name_len = sizeof(MOCK_BIN_NAME) - 1;
+
+	*(uint32_t*)p = cf_swap_to_be32(4 + name_len + mock->bin_size);
+	p += 4;
+	*p++ = AS_OPERATOR_READ;
+	*p++ = mock->particle_type;
+	*p++ = 0;
+	*p++ = (uint8_t)name_len;
+	memcpy(p, MOCK_BIN_NAME, name_len);
+	p += name_len;
+	memcpy(p, mock->bin, mock->bin_size);
+	return p + mock->bin_size;
+}
+
+static const char*
+mock_info_value(bench_mock* mock, const char* name, char* tmp, size_t tmp_size)
+{
+	if (strcmp(name, "node") == 0) {
+		return MOCK_NODE_NAME;
+	}
+
+	if (strcmp(name, "partition-generation") == 0 ||
+		strcmp(name, "peers-generation") == 0 ||
+		strcmp(name, "rebalance-generation") == 0) {
+		return "1";
+	}
+
+	if (strcmp(name, "features") == 0) {
+		return "batch-index;blob-bits;float;geo;peers;pipelining;pscans;query-show;replicas";
+	}
+
+	if (strcmp(name, "partitions") == 0) {
+		snprintf(tmp, tmp_size, "%u", MOCK_PARTITIONS);
+		return tmp;
+	}
+
+	if (strcmp(name, "replicas") == 0) {
+		return mock->replicas;
+	}
+
+	if (strncmp(name, "peers-", 6) == 0) {
+		// Single node cluster has no peers.
+		snprintf(tmp, tmp_size, "1,%u,[]", mock->port);
+		return tmp;
+	}
+	return "";
+}
+
+static bool
+mock_handle_info(bench_mock* mock, int fd, char* names, size_t size, mock_buffer* out)
+{
+	char tmp[64];
+
+	mock_buffer_reserve(out, 8);
+
+	char* p = names;
+	char* end = names + size;
+
+	while (p < end) {
+		char* name = p;
+
+		while (p < end && *p != '\n') {
+			p++;
+		}
+		*p++ = 0;
+
+		if (*name == 0) {
+			continue;
+		}
+
+		const char* value = mock_info_value(mock, name, tmp, sizeof(tmp));
+		size_t name_len = strlen(name);
+		size_t value_len = strlen(value);
+		uint8_t* w = mock_buffer_reserve(out, name_len + value_len + 2);
+
+		memcpy(w, name, name_len);
+		w += name_len;
+		*w++ = '\t';
+		memcpy(w, value, value_len);
+		w += value_len;
+		*w = '\n';
+	}
+
+	mock_write_proto(out->data, AS_INFO_MESSAGE_TYPE, out->size - 8);
+	return mock_write(fd, out->data, out->size);
+}
+
+static uint8_t*
+mock_skip_fields(uint8_t* p, uint8_t* end, uint16_t n_fields, uint8_t** batch)
+{
+	for (uint16_t i = 0; i < n_fields && p + 5 <= end; i++) {
+		uint32_t len = cf_swap_from_be32(*(uint32_t*)p);
+
+		if (batch && (p[4] == AS_FIELD_BATCH_INDEX || p[4] == AS_FIELD_BATCH_INDEX_WITH_SET)) {
+			*batch = p + 5;
+		}
+		p += 4 + len;
+	}
+	return p;
+}
+
+static uint8_t*
+mock_skip_ops(uint8_t* p, uint8_t* end, uint16_t n_ops)
+{
+	for (uint16_t i = 0; i < n_ops && p + 4 <= end; i++) {
+		p += 4 + cf_swap_from_be32(*(uint32_t*)p);
+	}
+	return p;
+}
+
+static bool
+mock_handle_batch(bench_mock* mock, int fd, uint8_t* p, uint8_t* end, mock_buffer* out)
+{
+	uint32_t n_keys = cf_swap_from_be32(*(uint32_t*)p);
+	p += 5;
+
+	bool bins = true;
+
+	mock_buffer_reserve(out, 8);
+
+	for (uint32_t i = 0; i < n_keys && p + 25 <= end; i++) {
+		uint32_t index = cf_swap_from_be32(*(uint32_t*)p);
+		p += 4 + AS_DIGEST_VALUE_SIZE;
+
+		if (*p++ == 0) {
+			// Full entry follows: read_attr, n_fields, n_ops, fields, ops.
+			uint8_t read_attr = *p++;
+			uint16_t n_fields = cf_swap_from_be16(*(uint16_t*)p);
+			uint16_t n_ops = cf_swap_from_be16(*(uint16_t*)(p + 2));
+			p += 4;
+			p = mock_skip_fields(p, end, n_fields, NULL);
+			p = mock_skip_ops(p, end, n_ops);
+			bins = (read_attr & AS_MSG_INFO1_GET_NOBINDATA) == 0;
+		}
+
+		uint8_t* w = mock_buffer_reserve(out, 22 + (bins ? mock_bin_size(mock) : 0));
+		w = mock_write_msg(w, 0, AEROSPIKE_OK, index, bins ? 1 : 0);
+
+		if (bins) {
+			mock_write_bin(mock, w);
+		}
+	}
+
+	mock_write_msg(mock_buffer_reserve(out, 22), AS_MSG_INFO3_LAST, AEROSPIKE_OK, 0, 0);
+	mock_write_proto(out->data, AS_MESSAGE_TYPE, out->size - 8);
+	return mock_write(fd, out->data, out->size);
+}
+
+static bool
+mock_handle_msg(bench_mock* mock, int fd, uint8_t* buf, size_t size, mock_buffer* out)
+{
+	if (size < 22) {
+		return false;
+	}
+
+	uint8_t info1 = buf[1];
+	uint8_t info2 = buf[2];
+	uint16_t n_fields = cf_swap_from_be16(*(uint16_t*)(buf + 18));
+	uint8_t* end = buf + size;
+	uint8_t* batch = NULL;
+
+	mock_skip_fields(buf + 22, end, n_fields, &batch);
+
+	if (batch) {
+		return mock_handle_batch(mock, fd, batch, end, out);
+	}
+
+	bool bins = (info1 & AS_MSG_INFO1_READ) && !(info1 & AS_MSG_INFO1_GET_NOBINDATA) &&
+		!(info2 & AS_MSG_INFO2_WRITE);
+
+	uint8_t* w = mock_buffer_reserve(out, 8 + 22 + (bins ? mock_bin_size(mock) : 0));
+	w = mock_write_msg(w + 8, 0, AEROSPIKE_OK, 0, bins ? 1 : 0);
+
+	if (bins) {
+		mock_write_bin(mock, w);
+	}
+
+	mock_write_proto(out->data, AS_MESSAGE_TYPE, out->size - 8);
+	return mock_write(fd, out->data, out->size);
+}
+
+static void*
+mock_conn_run(void* udata)
+{
+	mock_conn* conn = udata;
+	bench_mock* mock = conn->mock;
+	int fd = conn->fd;
+	cf_free(conn);
+
+	mock_buffer in = {.data = cf_malloc(4096), .size = 0, .capacity = 4096};
+	mock_buffer out = {.data = cf_malloc(4096), .size = 0, .capacity = 4096};
+	uint8_t header[8];
+
+	while (mock->running && mock_read(fd, header, sizeof(header))) {
+		uint8_t type = header[1];
+		size_t size = (size_t)(cf_swap_from_be64(*(uint64_t*)header) & 0xFFFFFFFFFFFFULL);
+
+		if (header[0] != AS_PROTO_VERSION || size > PROTO_SIZE_MAX) {
+			break;
+		}
+
+		in.size = 0;
+		uint8_t* body = mock_buffer_reserve(&in, size + 1);
+
+		if (! mock_read(fd, body, size)) {
+			break;
+		}
+
+		if (mock->delay_us) {
+			usleep(mock->delay_us);
+		}
+
+		out.size = 0;
+		bool rv;
+
+		if (type == AS_INFO_MESSAGE_TYPE) {
+			rv = mock_handle_info(mock, fd, (char*)body, size, &out);
+		}
+		else if (type == AS_MESSAGE_TYPE) {
+			rv = mock_handle_msg(mock, fd, body, size, &out);
+		}
+		else {
+			// Security and compression are not supported.
+			rv = false;
+		}
+
+		if (! rv) {
+			break;
+		}
+	}
+
+	close(fd);
+	cf_free(in.data);
+	cf_free(out.data);
+	as_decr_uint32(&mock->conns);
+	return NULL;
+}
+
+static void*
+mock_accept_run(void* udata)
+{
+	bench_mock* mock = udata;
+
+	while (mock->running) {
+		int fd = accept(mock->listen_fd, NULL, NULL);
+
+		if (fd < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+
+		int flag = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+		mock_conn* conn = cf_malloc(sizeof(mock_conn));
+		conn->mock = mock;
+		conn->fd = fd;
+
+		as_incr_uint32(&mock->conns);
+
+		pthread_t thread;
+		pthread_attr_t attr;
+		pthread_attr_init(&attr);
+		pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+		if (pthread_create(&thread, &attr, mock_conn_run, conn) != 0) {
+			as_decr_uint32(&mock->conns);
+			close(fd);
+			cf_free(conn);
+		}
+		pthread_attr_destroy(&attr);
+	}
+	return NULL;
+}
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+bench_mock*
+bench_mock_start(bench_args* args, uint16_t* port)
+{
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+	if (fd < 0) {
+		fprintf(stderr, "Mock server socket failed: %s\n", strerror(errno));
+		return NULL;
+	}
+
+	int flag = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+
+	struct sockaddr_in addr;
+	socklen_t len = sizeof(addr);
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+
+	if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 1024) != 0 ||
+		getsockname(fd, (struct sockaddr*)&addr, &len) != 0) {
+		fprintf(stderr, "Mock server listen failed: %s\n", strerror(errno));
+		close(fd);
+		return NULL;
+	}
+
+	bench_mock* mock = cf_malloc(sizeof(bench_mock));
+	memset(mock, 0, sizeof(bench_mock));
+	mock->listen_fd = fd;
+	mock->port = ntohs(addr.sin_port);
+	mock->delay_us = args->mock_delay_us;
+	mock->running = true;
+
+	// Canned bin value returned by every read.
+	if (args->bin_size == 0) {
+		mock->particle_type = AS_BYTES_INTEGER;
+		mock->bin_size = 8;
+		mock->bin = cf_malloc(8);
+		*(uint64_t*)mock->bin = cf_swap_to_be64(1);
+	}
+	else {
+		mock->particle_type = AS_BYTES_BLOB;
+		mock->bin_size = args->bin_size;
+		mock->bin = cf_malloc(args->bin_size);
+		memset(mock->bin, 'a', args->bin_size);
+	}
+
+	// This node owns master and prole of every partition.
+	uint8_t bitmap[(MOCK_PARTITIONS + 7) / 8];
+	memset(bitmap, 0xFF, sizeof(bitmap));
+
+	uint32_t b64_len = cf_b64_encoded_len(sizeof(bitmap));
+	size_t ns_len = strlen(args->ns);
+	char* r = cf_malloc(ns_len + 8 + (b64_len + 1) * 2 + 1);
+	mock->replicas = r;
+
+	memcpy(r, args->ns, ns_len);
+	r += ns_len;
+	memcpy(r, ":0,2,", 5);
+	r += 5;
+	cf_b64_encode(bitmap, sizeof(bitmap), r);
+	r += b64_len;
+	*r++ = ',';
+	cf_b64_encode(bitmap, sizeof(bitmap), r);
+	r += b64_len;
+	*r++ = ';';
+	*r = 0;
+
+	if (pthread_create(&mock->accept_thread, NULL, mock_accept_run, mock) != 0) {
+		fprintf(stderr, "Mock server thread failed\n");
+		close(fd);
+		cf_free(mock->replicas);
+		cf_free(mock->bin);
+		cf_free(mock);
+		return NULL;
+	}
+
+	*port = mock->port;
+	return mock;
+}
+
+void
+bench_mock_stop(bench_mock* mock)
+{
+	mock->running = false;
+	shutdown(mock->listen_fd, SHUT_RDWR);
+	close(mock->listen_fd);
+	pthread_join(mock->accept_thread, NULL);
+
+	// Connection threads exit when the client closes its sockets.
+	for (uint32_t i = 0; i < 1000 && as_load_uint32(&mock->conns) > 0; i++) {
+		usleep(1000);
+	}
+
+	if (as_load_uint32(&mock->conns) > 0) {
+		// Leak mock rather than free memory still referenced by connection threads.
+		return;
+	}
+
+	cf_free(mock->replicas);
+	cf_free(mock->bin);
+	cf_free(mock);
+}
@@ -0,0 +1,588 @@
+/*
+ * Copyright 2008-2021 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include "benchmark.h"
+#include <aerospike/aerospike_batch.h>
+#include <aerospike/aerospike_key.h>
+#include <aerospike/as_atomic.h>
+#include <aerospike/as_event.h>
+#include <aerospike/as_random.h>
+#include <aerospike/as_record.h>
+#include <aerospike/as_sleep.h>
+#include <citrusleaf/alloc.h>
+#include <citrusleaf/cf_clock.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/******************************************************************************
+ * MACROS
+ *****************************************************************************/
+
+#define BENCH_BIN_NAME "bin"
+#define BENCH_MAX_ERRORS_LOGGED 10
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+typedef struct {
+	bench_data* data;
+	pthread_t thread;
+	uint64_t key_begin;
+	uint64_t key_end;
+	uint64_t throttle_begin;
+	uint64_t throttle_count;
+	double throttle_rate;
+
+	// Async commands in flight. Generator waits on cond when limit is reached.
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	uint32_t in_flight;
+	uint32_t max_in_flight;
+} bench_worker;
+
+typedef struct {
+	bench_worker* worker;
+	bench_counter* counter;
+	uint64_t begin;
+} bench_command;
+
+typedef struct {
+	uint64_t count;
+	uint64_t timeouts;
+	uint64_t errors;
+	as_latency_buckets latency;
+} bench_snapshot;
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+static void
+bench_record_result(bench_data* data, bench_counter* counter, as_error* err, uint64_t begin)
+{
+	switch (err->code) {
+		case AEROSPIKE_OK:
+		case AEROSPIKE_ERR_RECORD_NOT_FOUND:
+			as_latency_add(&counter->latency, cf_getns() - begin);
+			as_incr_uint64(&counter->count);
+			break;
+
+		case AEROSPIKE_ERR_TIMEOUT:
+			as_incr_uint64(&counter->timeouts);
+			break;
+
+		default:
+			as_incr_uint64(&counter->errors);
+
+			if (as_faa_uint32(&data->errors_logged, 1) < BENCH_MAX_ERRORS_LOGGED) {
+				fprintf(stderr, "Error %d: %s\n", err->code, err->message);
+			}
+			break;
+	}
+}
+
+static void
+bench_throttle(bench_worker* w)
+{
+	if (w->throttle_rate <= 0.0) {
+		return;
+	}
+
+	w->throttle_count++;
+
+	uint64_t expected = (uint64_t)((double)w->throttle_count * 1000000000.0 / w->throttle_rate);
+	uint64_t elapsed = cf_getns() - w->throttle_begin;
+
+	if (expected > elapsed + 1000) {
+		usleep((useconds_t)((expected - elapsed) / 1000));
+	}
+}
+
+static inline uint64_t
+bench_random_key(bench_data* data, as_random* ran)
+{
+	return data->args->start_key + as_random_next_uint64(ran) % data->args->keys;
+}
+
+static void
+bench_init_record(bench_data* data, as_record* rec)
+{
+	as_record_inita(rec, 1);
+
+	if (data->args->bin_size == 0) {
+		as_record_set_int64(rec, BENCH_BIN_NAME, (int64_t)cf_getms());
+	}
+	else {
+		as_record_set_raw(rec, BENCH_BIN_NAME, data->value, data->args->bin_size);
+	}
+}
+
+static void
+bench_init_batch(bench_data* data, as_random* ran, as_batch_read_records* records)
+{
+	bench_args* args = data->args;
+
+	for (uint32_t i = 0; i < args->batch_size; i++) {
+		as_batch_read_record* r = as_batch_read_reserve(records);
+		as_key_init_int64(&r->key, args->ns, args->set, (int64_t)bench_random_key(data, ran));
+		r->read_all_bins = true;
+	}
+}
+
+/******************************************************************************
+ * SYNC WORKLOAD
+ *****************************************************************************/
+
+static void
+bench_sync_write(bench_data* data, uint64_t k)
+{
+	as_key key;
+	as_key_init_int64(&key, data->args->ns, data->args->set, (int64_t)k);
+
+	as_record rec;
+	bench_init_record(data, &rec);
+
+	as_error err;
+	uint64_t begin = cf_getns();
+	aerospike_key_put(data->as, &err, NULL, &key, &rec);
+	bench_record_result(data, &data->write, &err, begin);
+	as_record_destroy(&rec);
+}
+
+static void
+bench_sync_read(bench_data* data, as_random* ran)
+{
+	as_error err;
+
+	if (data->args->batch_size > 1) {
+		as_batch_read_records records;
+		as_batch_read_inita(&records, data->args->batch_size);
+		bench_init_batch(data, ran, &records);
+
+		uint64_t begin = cf_getns();
+		aerospike_batch_read(data->as, &err, NULL, &records);
+		bench_record_result(data, &data->read, &err, begin);
+		as_batch_read_destroy(&records);
+		return;
+	}
+
+	as_key key;
+	as_key_init_int64(&key, data->args->ns, data->args->set,
+					  (int64_t)bench_random_key(data, ran));
+
+	as_record* rec = NULL;
+	uint64_t begin = cf_getns();
+	aerospike_key_get(data->as, &err, NULL, &key, &rec);
+	bench_record_result(data, &data->read, &err, begin);
+	as_record_destroy(rec);
+}
+
+static void*
+bench_sync_run(void* udata)
+{
+	bench_worker* w = udata;
+	bench_data* data = w->data;
+	bench_args* args = data->args;
+	as_random* ran = as_random_instance();
+
+	w->throttle_begin = cf_getns();
+
+	if (args->workload == BENCH_WORKLOAD_INSERT) {
+		for (uint64_t k = w->key_begin; k < w->key_end && data->valid; k++) {
+			bench_sync_write(data, k);
+			as_incr_uint64(&data->inserted);
+			bench_throttle(w);
+		}
+		return NULL;
+	}
+
+	while (data->valid) {
+		if (as_random_next_uint32(ran) % 100 < args->read_pct) {
+			bench_sync_read(data, ran);
+		}
+		else {
+			bench_sync_write(data, bench_random_key(data, ran));
+		}
+		bench_throttle(w);
+	}
+	return NULL;
+}
+
+/******************************************************************************
+ * ASYNC WORKLOAD
+ *****************************************************************************/
+
+static void
+bench_async_complete(bench_command* cmd, as_error* err)
+{
+	bench_worker* w = cmd->worker;
+
+	if (err) {
+		bench_record_result(w->data, cmd->counter, err, cmd->begin);
+	}
+	else {
+		as_error ok;
+		as_error_init(&ok);
+		bench_record_result(w->data, cmd->counter, &ok, cmd->begin);
+	}
+	cf_free(cmd);
+
+	pthread_mutex_lock(&w->lock);
+	w->in_flight--;
+	pthread_cond_signal(&w->cond);
+	pthread_mutex_unlock(&w->lock);
+}
+
+static void
+bench_async_write_listener(as_error* err, void* udata, as_event_loop* event_loop)
+{
+	bench_async_complete(udata, err);
+}
+
+static void
+bench_async_read_listener(as_error* err, as_record* rec, void* udata, as_event_loop* event_loop)
+{
+	bench_async_complete(udata, err);
+}
+
+static void
+bench_async_batch_listener(
+	as_error* err, as_batch_read_records* records, void* udata, as_event_loop* event_loop
+	)
+{
+	as_batch_read_destroy(records);
+	bench_async_complete(udata, err);
+}
+
+static void
+bench_pipe_listener(void* udata, as_event_loop* event_loop)
+{
+	// Next command may be pipelined on the same connection. Nothing to do.
+}
+
+static bool
+bench_async_reserve(bench_worker* w)
+{
+	pthread_mutex_lock(&w->lock);
+
+	while (w->in_flight >= w->max_in_flight && w->data->valid) {
+		pthread_cond_wait(&w->cond, &w->lock);
+	}
+
+	bool valid = w->data->valid;
+
+	if (valid) {
+		w->in_flight++;
+	}
+	pthread_mutex_unlock(&w->lock);
+	return valid;
+}
+
+static void
+bench_async_write(bench_worker* w, uint64_t k)
+{
+	bench_data* data = w->data;
+	as_key key;
+	as_key_init_int64(&key, data->args->ns, data->args->set, (int64_t)k);
+
+	as_record rec;
+	bench_init_record(data, &rec);
+
+	bench_command* cmd = cf_malloc(sizeof(bench_command));
+	cmd->worker = w;
+	cmd->counter = &data->write;
+	cmd->begin = cf_getns();
+
+	as_pipe_listener pipe = data->args->mode == BENCH_MODE_PIPELINE ? bench_pipe_listener : NULL;
+	as_error err;
+
+	if (aerospike_key_put_async(data->as, &err, NULL, &key, &rec, bench_async_write_listener,
+								cmd, NULL, pipe) != AEROSPIKE_OK) {
+		bench_async_complete(cmd, &err);
+	}
+	as_record_destroy(&rec);
+}
+
+static void
+bench_async_read(bench_worker* w, as_random* ran)
+{
+	bench_data* data = w->data;
+	bench_command* cmd = cf_malloc(sizeof(bench_command));
+	cmd->worker = w;
+	cmd->counter = &data->read;
+	as_error err;
+
+	if (data->args->batch_size > 1) {
+		as_batch_read_records* records = as_batch_read_create(data->args->batch_size);
+		bench_init_batch(data, ran, records);
+		cmd->begin = cf_getns();
+
+		if (aerospike_batch_read_async(data->as, &err, NULL, records,
+									   bench_async_batch_listener, cmd, NULL) != AEROSPIKE_OK) {
+			as_batch_read_destroy(records);
+			bench_async_complete(cmd, &err);
+		}
+		return;
+	}
+
+	as_key key;
+	as_key_init_int64(&key, data->args->ns, data->args->set,
+					  (int64_t)bench_random_key(data, ran));
+
+	as_pipe_listener pipe = data->args->mode == BENCH_MODE_PIPELINE ? bench_pipe_listener : NULL;
+	cmd->begin = cf_getns();
+
+	if (aerospike_key_get_async(data->as, &err, NULL, &key, bench_async_read_listener, cmd,
+								NULL, pipe) != AEROSPIKE_OK) {
+		bench_async_complete(cmd, &err);
+	}
+}
+
+static void*
+bench_async_run(void* udata)
+{
+	bench_worker* w = udata;
+	bench_data* data = w->data;
+	bench_args* args = data->args;
+	as_random* ran = as_random_instance();
+
+	w->throttle_begin = cf_getns();
+
+	if (args->workload == BENCH_WORKLOAD_INSERT) {
+		for (uint64_t k = w->key_begin; k < w->key_end && bench_async_reserve(w); k++) {
+			bench_async_write(w, k);
+			as_incr_uint64(&data->inserted);
+			bench_throttle(w);
+		}
+	}
+	else {
+		while (bench_async_reserve(w)) {
+			if (as_random_next_uint32(ran) % 100 < args->read_pct) {
+				bench_async_read(w, ran);
+			}
+			else {
+				bench_async_write(w, bench_random_key(data, ran));
+			}
+			bench_throttle(w);
+		}
+	}
+
+	// Wait for outstanding commands.
+	pthread_mutex_lock(&w->lock);
+
+	while (w->in_flight > 0) {
+		pthread_cond_wait(&w->cond, &w->lock);
+	}
+	pthread_mutex_unlock(&w->lock);
+	return NULL;
+}
+
+/******************************************************************************
+ * REPORTING
+ *****************************************************************************/
+
+static void
+bench_snapshot_take(bench_counter* counter, bench_snapshot* prev, bench_snapshot* delta)
+{
+	bench_snapshot cur;
+	cur.count = as_load_uint64(&counter->count);
+	cur.timeouts = as_load_uint64(&counter->timeouts);
+	cur.errors = as_load_uint64(&counter->errors);
+	as_latency_copy(&cur.latency, &counter->latency);
+
+	delta->count = cur.count - prev->count;
+	delta->timeouts = cur.timeouts - prev->timeouts;
+	delta->errors = cur.errors - prev->errors;
+
+	for (uint32_t i = 0; i < AS_LATENCY_BUCKETS; i++) {
+		delta->latency.buckets[i] = cur.latency.buckets[i] - prev->latency.buckets[i];
+	}
+	*prev = cur;
+}
+
+static void
+bench_print_latency(const char* name, bench_snapshot* s)
+{
+	uint64_t count = as_latency_count(&s->latency);
+
+	printf("%-6s", name);
+
+	// Percent of commands over 2^10 us (~1ms), 2^11 us (~2ms) ... 2^16 us (~64ms).
+	for (uint32_t limit = 10; limit <= 16; limit++) {
+		uint64_t over = 0;
+
+		for (uint32_t i = limit + 1; i < AS_LATENCY_BUCKETS; i++) {
+			over += s->latency.buckets[i];
+		}
+
+		double pct = count ? (double)over * 100.0 / (double)count : 0.0;
+		printf(" %6.2f%%", pct);
+	}
+
+	printf(" %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64 "\n",
+		   as_latency_percentile(&s->latency, 50.0), as_latency_percentile(&s->latency, 90.0),
+		   as_latency_percentile(&s->latency, 99.0), as_latency_percentile(&s->latency, 99.9));
+}
+
+static void
+bench_print_interval(
+	bench_data* data, bench_snapshot* write, bench_snapshot* read, double seconds
+	)
+{
+	char tm_str[32];
+	time_t now = time(NULL);
+	struct tm tm;
+	localtime_r(&now, &tm);
+	strftime(tm_str, sizeof(tm_str), "%Y-%m-%d %H:%M:%S", &tm);
+
+	uint64_t write_tps = (uint64_t)((double)write->count / seconds);
+	uint64_t read_tps = (uint64_t)((double)read->count / seconds);
+
+	printf("%s write(tps=%" PRIu64 " timeouts=%" PRIu64 " errors=%" PRIu64 ")"
+		   " read(tps=%" PRIu64 " timeouts=%" PRIu64 " errors=%" PRIu64 ")"
+		   " total(tps=%" PRIu64 " timeouts=%" PRIu64 " errors=%" PRIu64 ")\n",
+		   tm_str, write_tps, write->timeouts, write->errors,
+		   read_tps, read->timeouts, read->errors,
+		   write_tps + read_tps, write->timeouts + read->timeouts, write->errors + read->errors);
+
+	if (data->args->workload == BENCH_WORKLOAD_INSERT) {
+		printf("inserted %" PRIu64 " of %" PRIu64 "\n", as_load_uint64(&data->inserted),
+			   data->args->keys);
+	}
+
+	printf("      %8s %8s %8s %8s %8s %8s %8s %8s %8s %8s %8s\n", ">1ms", ">2ms", ">4ms", ">8ms",
+		   ">16ms", ">32ms", ">64ms", "p50(us)", "p90(us)", "p99(us)", "p999(us)");
+	bench_print_latency("write", write);
+	bench_print_latency("read", read);
+	fflush(stdout);
+}
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+int
+bench_run(bench_data* data)
+{
+	bench_args* args = data->args;
+	bool async = args->mode != BENCH_MODE_SYNC;
+	uint32_t n_threads = args->threads;
+
+	if (args->workload == BENCH_WORKLOAD_INSERT && n_threads > args->keys) {
+		n_threads = (uint32_t)args->keys;
+	}
+
+	bench_worker* workers = cf_malloc(sizeof(bench_worker) * n_threads);
+	memset(workers, 0, sizeof(bench_worker) * n_threads);
+
+	uint64_t keys_per_thread = args->keys / n_threads;
+	uint64_t keys_rem = args->keys % n_threads;
+	uint64_t key = args->start_key;
+	double rate = args->throughput ? (double)args->throughput / n_threads : 0.0;
+	uint32_t max_in_flight = args->async_max_commands / n_threads;
+
+	if (max_in_flight == 0) {
+		max_in_flight = 1;
+	}
+
+	data->valid = true;
+
+	for (uint32_t i = 0; i < n_threads; i++) {
+		bench_worker* w = &workers[i];
+		w->data = data;
+		w->key_begin = key;
+		key += keys_per_thread + (i < keys_rem ? 1 : 0);
+		w->key_end = key;
+		w->throttle_rate = rate;
+		w->max_in_flight = max_in_flight;
+		pthread_mutex_init(&w->lock, NULL);
+		pthread_cond_init(&w->cond, NULL);
+
+		if (pthread_create(&w->thread, NULL, async ? bench_async_run : bench_sync_run, w) != 0) {
+			fprintf(stderr, "Failed to create thread\n");
+			data->valid = false;
+			n_threads = i;
+			break;
+		}
+	}
+
+	bench_snapshot write_prev, read_prev, write_total, read_total;
+	memset(&write_prev, 0, sizeof(bench_snapshot));
+	memset(&read_prev, 0, sizeof(bench_snapshot));
+
+	uint64_t begin = cf_getms();
+	uint64_t prev = begin;
+	uint64_t end = args->duration ? begin + args->duration * 1000ULL : 0;
+
+	while (data->valid) {
+		as_sleep(args->interval * 1000);
+
+		uint64_t now = cf_getms();
+
+		if (end && now >= end) {
+			data->valid = false;
+		}
+
+		if (args->workload == BENCH_WORKLOAD_INSERT &&
+			as_load_uint64(&data->inserted) >= args->keys) {
+			data->valid = false;
+		}
+
+		bench_snapshot write, read;
+		bench_snapshot_take(&data->write, &write_prev, &write);
+		bench_snapshot_take(&data->read, &read_prev, &read);
+		bench_print_interval(data, &write, &read, (double)(now - prev) / 1000.0);
+		prev = now;
+	}
+
+	// Wake async generators blocked on in flight limit.
+	for (uint32_t i = 0; i < n_threads; i++) {
+		bench_worker* w = &workers[i];
+		pthread_mutex_lock(&w->lock);
+		pthread_cond_broadcast(&w->cond);
+		pthread_mutex_unlock(&w->lock);
+	}
+
+	for (uint32_t i = 0; i < n_threads; i++) {
+		pthread_join(workers[i].thread, NULL);
+	}
+
+	for (uint32_t i = 0; i < n_threads; i++) {
+		pthread_mutex_destroy(&workers[i].lock);
+		pthread_cond_destroy(&workers[i].cond);
+	}
+	cf_free(workers);
+
+	// Report totals for the whole run.
+	memset(&write_prev, 0, sizeof(bench_snapshot));
+	memset(&read_prev, 0, sizeof(bench_snapshot));
+	bench_snapshot_take(&data->write, &write_prev, &write_total);
+	bench_snapshot_take(&data->read, &read_prev, &read_total);
+
+	printf("Total:\n");
+	bench_print_interval(data, &write_total, &read_total, (double)(cf_getms() - begin) / 1000.0);
+	return 0;
+}
+
+void
+bench_stop(bench_data* data)
+{
+	data->valid = false;
+}
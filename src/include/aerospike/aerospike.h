@@ -325,6 +325,35 @@ aerospike_close(aerospike* as, as_error* err);
 AS_EXTERN bool
 aerospike_cluster_is_connected(aerospike* as);
 
+/**
+ * Resolve namespace to a handle that can be stored in as_key.ns_handle. Commands on keys that
+ * carry a handle find the namespace partition table by index instead of comparing namespace
+ * names. The handle remains valid for the life of the aerospike instance. If the handle does
+ * not refer to the key's namespace (handle from another instance or namespace), the command
+ * falls back to the namespace name lookup.
+ *
+ * ~~~~~~~~~~{.c}
+ * uint32_t handle;
+ *
+ * if (aerospike_namespace_handle(&as, &err, "test", &handle) == AEROSPIKE_OK) {
+ *     as_key key;
+ *     as_key_init_int64(&key, "test", "demo", 1);
+ *     key.ns_handle = handle;
+ * }
+ * ~~~~~~~~~~
+ *
+ * @param as 		Aerospike instance.
+ * @param err		If an error occurs, this will be populated.
+ * @param ns		Namespace name.
+ * @param handle	Namespace handle on success.
+ *
+ * @returns AEROSPIKE_OK on success. Otherwise an error occurred.
+ *
+ * @relates aerospike
+ */
+AS_EXTERN as_status
+aerospike_namespace_handle(aerospike* as, as_error* err, const char* ns, uint32_t* handle);
+
 /**
  * Should stop socket operation if interrupted by a signal.  Default is false which means
  * the socket operation will be retried until timeout.
@@ -119,8 +119,11 @@ typedef struct as_batch_read_records_s {
  * or aerospike_batch_exists() functions.
  *
  * 	The `results` argument will be an array of `n` as_batch_read entries. The
- * 	`results` argument is on the stack and is only available within the context
- * 	of the callback. To use the data outside of the callback, copy the data.
+ * 	`results` argument is only available within the context of the callback.
+ * 	To use the data outside of the callback, copy the data.
+ *
+ * 	If as_policy_batch.max_chunk_keys is set and the batch is larger, the callback is
+ * 	called once per chunk of consecutive keys. Returning false stops the remaining chunks.
  *
  * ~~~~~~~~~~{.c}
  * bool my_callback(const as_batch_read * results, uint32_t n, void* udata) {
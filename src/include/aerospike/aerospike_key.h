@@ -43,6 +43,205 @@
 extern "C" {
 #endif
 
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+/**
+ * Single record command type used by aerospike_key_pipeline().
+ *
+ * @ingroup key_operations
+ */
+typedef enum as_pipeline_op_type_e {
+	AS_PIPELINE_GET,
+	AS_PIPELINE_EXISTS,
+	AS_PIPELINE_PUT,
+	AS_PIPELINE_REMOVE,
+	AS_PIPELINE_OPERATE
+} as_pipeline_op_type;
+
+/**
+ * Single record command issued by aerospike_key_pipeline().
+ *
+ * @ingroup key_operations
+ */
+typedef struct as_pipeline_op_s {
+	/**
+	 * Command type.
+	 */
+	as_pipeline_op_type type;
+
+	/**
+	 * The key of the record.
+	 */
+	const as_key* key;
+
+	/**
+	 * Command policy. Use the member that matches the command type: read for AS_PIPELINE_GET
+	 * and AS_PIPELINE_EXISTS, write for AS_PIPELINE_PUT, remove for AS_PIPELINE_REMOVE and
+	 * operate for AS_PIPELINE_OPERATE. If NULL, the default policy for that type is used.
+	 */
+	union {
+		const as_policy_read* read;
+		const as_policy_write* write;
+		const as_policy_remove* remove;
+		const as_policy_operate* operate;
+	} policy;
+
+	/**
+	 * Operations for AS_PIPELINE_OPERATE.
+	 */
+	const as_operations* ops;
+
+	/**
+	 * Record to write for AS_PIPELINE_PUT. For AS_PIPELINE_GET, AS_PIPELINE_EXISTS and
+	 * AS_PIPELINE_OPERATE, the record populated with the result. If NULL, the record will be
+	 * created and must be destroyed by the caller. Otherwise, the record is reused.
+	 */
+	as_record* record;
+
+	/**
+	 * Command result set by aerospike_key_pipeline().
+	 */
+	as_status result;
+
+	/**
+	 * Command error details set by aerospike_key_pipeline(). Only populated when result is
+	 * not AEROSPIKE_OK.
+	 */
+	as_error error;
+
+} as_pipeline_op;
+
+/**
+ * Single record command template created by aerospike_key_prepare_put(),
+ * aerospike_key_prepare_select() or aerospike_key_prepare_operate(). Namespace, set, bin names,
+ * operation types, policy flags and filter expression are serialized once. Each
+ * aerospike_key_execute_prepared() call then only writes the key digest, values, ttl and
+ * generation.
+ *
+ * A prepared command is read-only after creation and can be executed from multiple threads
+ * at the same time. Call as_prepared_destroy() when it is no longer needed.
+ *
+ * @ingroup key_operations
+ */
+typedef struct as_prepared_s {
+	/**
+	 * @private
+	 * Serialized command template.
+	 */
+	uint8_t* buf;
+
+	/**
+	 * @private
+	 * Command policy. The filter expression is already serialized in buf.
+	 */
+	as_policy_base base;
+
+	/**
+	 * @private
+	 * Namespace of the prepared command.
+	 */
+	char ns[AS_NAMESPACE_MAX_SIZE];
+
+	/**
+	 * @private
+	 * Set of the prepared command.
+	 */
+	char set[AS_SET_MAX_SIZE];
+
+	/**
+	 * @private
+	 * Size of proto header, message header, namespace and set fields in buf.
+	 */
+	uint32_t header_size;
+
+	/**
+	 * @private
+	 * Size of filter field in buf.
+	 */
+	uint32_t filter_size;
+
+	/**
+	 * @private
+	 * Size of buf.
+	 */
+	uint32_t size;
+
+	/**
+	 * @private
+	 * Compress commands larger than this size. Zero disables compression.
+	 */
+	uint32_t compression_threshold;
+
+	/**
+	 * @private
+	 * Hedged read delay in milliseconds.
+	 */
+	uint32_t hedge_delay;
+
+	/**
+	 * @private
+	 * Hedged read latency percentile.
+	 */
+	float hedge_percentile;
+
+	/**
+	 * @private
+	 * Replica algorithm.
+	 */
+	as_policy_replica replica;
+
+	/**
+	 * @private
+	 * Read mode for strong consistency namespaces.
+	 */
+	as_policy_read_mode_sc read_mode_sc;
+
+	/**
+	 * @private
+	 * Send user key when AS_POLICY_KEY_SEND.
+	 */
+	as_policy_key key;
+
+	/**
+	 * @private
+	 * Generation policy.
+	 */
+	as_policy_gen gen;
+
+	/**
+	 * @private
+	 * Field count excluding user key.
+	 */
+	uint16_t n_fields;
+
+	/**
+	 * @private
+	 * Operation count.
+	 */
+	uint16_t n_ops;
+
+	/**
+	 * @private
+	 * Command writes the record.
+	 */
+	bool write;
+
+	/**
+	 * @private
+	 * Deserialize list and map values.
+	 */
+	bool deserialize;
+
+	/**
+	 * @private
+	 * Parse result record into one allocation.
+	 */
+	bool record_arena;
+
+} as_prepared;
+
 /******************************************************************************
  * FUNCTIONS
  *****************************************************************************/
@@ -636,6 +835,174 @@ aerospike_key_apply_async(
 	as_pipe_listener pipe_listener
 	);
 
+/**
+ * Execute many single record commands with pipelining. Commands are grouped by target node and
+ * each group is written back-to-back on one pooled connection to that node before any response
+ * is read. Responses are then read in order. Groups for different nodes are sent before the
+ * first response is read, so nodes process their commands in parallel.
+ *
+ * Each command's result is stored in its as_pipeline_op.result and error details are stored in
+ * as_pipeline_op.error. All commands sent to a node share the largest socket_timeout and
+ * total_timeout of that node's command policies. Put and operate commands are compressed
+ * according to their policy's compress and compression_threshold settings.
+ *
+ * Pipelined commands bypass the normal single record command path. They are not retried, so
+ * max_retries and sleep_between_retries are ignored, and they are not counted by the adaptive
+ * per node concurrency limiter (as_config.max_concurrency_per_node).
+ *
+ * ~~~~~~~~~~{.c}
+ * as_pipeline_op ops[2];
+ * memset(ops, 0, sizeof(ops));
+ *
+ * ops[0].type = AS_PIPELINE_PUT;
+ * ops[0].key = &key1;
+ * ops[0].record = &rec1;
+ *
+ * ops[1].type = AS_PIPELINE_GET;
+ * ops[1].key = &key2;
+ *
+ * if (aerospike_key_pipeline(&as, &err, ops, 2) != AEROSPIKE_OK) {
+ *     printf("error(%d) %s at [%s:%d]", err.code, err.message, err.file, err.line);
+ * }
+ *
+ * if (ops[1].result == AEROSPIKE_OK) {
+ *     as_record_destroy(ops[1].record);
+ * }
+ * ~~~~~~~~~~
+ *
+ * @param as			The aerospike instance to use for this operation.
+ * @param err			The as_error to be populated if a connection error occurs.
+ * @param ops			The commands to execute.
+ * @param n_ops			The number of commands.
+ *
+ * @return AEROSPIKE_OK if every command received a response. The individual command results
+ * may still contain errors. Otherwise, the first connection error. In that case, commands that
+ * did not receive a response have their result set to that error.
+ *
+ * @ingroup key_operations
+ */
+AS_EXTERN as_status
+aerospike_key_pipeline(aerospike* as, as_error* err, as_pipeline_op* ops, uint32_t n_ops);
+
+/**
+ * Prepare a put command that writes the given bins. The bins array is terminated by a NULL
+ * entry. Values are provided in the same order to aerospike_key_execute_prepared().
+ *
+ * ~~~~~~~~~~{.c}
+ * const char* bins[] = {"a", "b", NULL};
+ * as_prepared prep;
+ *
+ * if (aerospike_key_prepare_put(&as, &err, NULL, "test", "demo", bins, &prep) != AEROSPIKE_OK) {
+ *     printf("error(%d) %s at [%s:%d]", err.code, err.message, err.file, err.line);
+ * }
+ *
+ * as_integer a;
+ * as_string b;
+ * as_val* values[] = {(as_val*)as_integer_init(&a, 1), (as_val*)as_string_init(&b, "x", false)};
+ *
+ * as_key key;
+ * as_key_init_int64(&key, "test", "demo", 1);
+ * aerospike_key_execute_prepared(&as, &err, &prep, &key, values, AS_RECORD_DEFAULT_TTL, 0, NULL);
+ * as_prepared_destroy(&prep);
+ * ~~~~~~~~~~
+ *
+ * @param as			The aerospike instance to use for this operation.
+ * @param err			The as_error to be populated if an error occurs.
+ * @param policy		The policy to use for this operation. If NULL, then the default policy will be used.
+ * @param ns			The namespace of all keys passed to aerospike_key_execute_prepared().
+ * @param set			The set of all keys passed to aerospike_key_execute_prepared().
+ * @param bins			The bin names, terminated by a NULL entry.
+ * @param prep			The prepared command to initialize.
+ *
+ * @return AEROSPIKE_OK if successful. Otherwise an error.
+ *
+ * @ingroup key_operations
+ */
+AS_EXTERN as_status
+aerospike_key_prepare_put(
+	aerospike* as, as_error* err, const as_policy_write* policy, const char* ns, const char* set,
+	const char* bins[], as_prepared* prep
+	);
+
+/**
+ * Prepare a read command that returns the given bins. The bins array is terminated by a NULL
+ * entry. If bins is NULL, all bins are returned.
+ *
+ * @param as			The aerospike instance to use for this operation.
+ * @param err			The as_error to be populated if an error occurs.
+ * @param policy		The policy to use for this operation. If NULL, then the default policy will be used.
+ * @param ns			The namespace of all keys passed to aerospike_key_execute_prepared().
+ * @param set			The set of all keys passed to aerospike_key_execute_prepared().
+ * @param bins			The bin names, terminated by a NULL entry, or NULL for all bins.
+ * @param prep			The prepared command to initialize.
+ *
+ * @return AEROSPIKE_OK if successful. Otherwise an error.
+ *
+ * @ingroup key_operations
+ */
+AS_EXTERN as_status
+aerospike_key_prepare_select(
+	aerospike* as, as_error* err, const as_policy_read* policy, const char* ns, const char* set,
+	const char* bins[], as_prepared* prep
+	);
+
+/**
+ * Prepare an operate command with the operation types and bin names of ops. Operation values,
+ * ttl and gen in ops are ignored. Values are provided per command, in operation order, to
+ * aerospike_key_execute_prepared().
+ *
+ * @param as			The aerospike instance to use for this operation.
+ * @param err			The as_error to be populated if an error occurs.
+ * @param policy		The policy to use for this operation. If NULL, then the default policy will be used.
+ * @param ns			The namespace of all keys passed to aerospike_key_execute_prepared().
+ * @param set			The set of all keys passed to aerospike_key_execute_prepared().
+ * @param ops			The operations template.
+ * @param prep			The prepared command to initialize.
+ *
+ * @return AEROSPIKE_OK if successful. Otherwise an error.
+ *
+ * @ingroup key_operations
+ */
+AS_EXTERN as_status
+aerospike_key_prepare_operate(
+	aerospike* as, as_error* err, const as_policy_operate* policy, const char* ns,
+	const char* set, const as_operations* ops, as_prepared* prep
+	);
+
+/**
+ * Execute a prepared command for the given key.
+ *
+ * @param as			The aerospike instance to use for this operation.
+ * @param err			The as_error to be populated if an error occurs.
+ * @param prep			The prepared command.
+ * @param key			The key of the record. Namespace and set must match the prepared command.
+ * @param values		One value per prepared bin or operation. A NULL entry sends no value,
+ *						which is required for read, touch and delete operations. May be NULL
+ *						for prepared reads.
+ * @param ttl			Record ttl for write commands. Ignored for reads.
+ * @param gen			Expected generation when the prepare policy gen is not AS_POLICY_GEN_IGNORE.
+ * @param rec			The record to be populated with the result. May be NULL when no result
+ *						is needed. If the record pointer is preset to NULL, the record will be
+ *						created and initialized. Otherwise, the record is reused.
+ *
+ * @return AEROSPIKE_OK if successful. Otherwise an error.
+ *
+ * @ingroup key_operations
+ */
+AS_EXTERN as_status
+aerospike_key_execute_prepared(
+	aerospike* as, as_error* err, const as_prepared* prep, const as_key* key, as_val** values,
+	uint32_t ttl, uint16_t gen, as_record** rec
+	);
+
+/**
+ * Release prepared command resources.
+ *
+ * @ingroup key_operations
+ */
+AS_EXTERN void
+as_prepared_destroy(as_prepared* prep);
+
 /**
  * @cond SKIP_DOXYGEN
  * doxygen skips this section till endcond
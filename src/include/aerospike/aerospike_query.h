@@ -145,6 +145,64 @@ typedef bool (*aerospike_query_foreach_callback)(const as_val* val, void* udata)
  */
 typedef bool (*as_async_query_record_listener)(as_error* err, as_record* record, void* udata, as_event_loop* event_loop);
 
+/**
+ * Native client side aggregation used by aerospike_query_aggregate(). Records are folded into
+ * a partial state owned by each query worker thread, so map() does not need to be thread safe.
+ * When the query completes, the partial states are combined with reduce().
+ *
+ * ~~~~~~~~~~{.c}
+ * void* sum_create(void* udata)
+ * {
+ *     return cf_calloc(1, sizeof(int64_t));
+ * }
+ *
+ * bool sum_map(void* state, const as_record* rec, void* udata)
+ * {
+ *     *(int64_t*)state += as_record_get_int64(rec, "bin1", 0);
+ *     return true;
+ * }
+ *
+ * void sum_reduce(void* state, void* other, void* udata)
+ * {
+ *     *(int64_t*)state += *(int64_t*)other;
+ * }
+ *
+ * void sum_destroy(void* state, void* udata)
+ * {
+ *     cf_free(state);
+ * }
+ * ~~~~~~~~~~
+ *
+ * @ingroup query_operations
+ */
+typedef struct as_query_aggregator_s {
+	/**
+	 * Create empty partial state. Called once per worker thread that receives records, or
+	 * once if no records are returned.
+	 */
+	void* (*create)(void* udata);
+
+	/**
+	 * Fold record into partial state. Return `false` to end the query.
+	 */
+	bool (*map)(void* state, const as_record* rec, void* udata);
+
+	/**
+	 * Combine other partial state into state. other is destroyed after this call.
+	 */
+	void (*reduce)(void* state, void* other, void* udata);
+
+	/**
+	 * Destroy partial or final state.
+	 */
+	void (*destroy)(void* state, void* udata);
+
+	/**
+	 * User data passed to all callbacks.
+	 */
+	void* udata;
+} as_query_aggregator;
+
 /******************************************************************************
  * FUNCTIONS
  *****************************************************************************/
@@ -184,6 +242,40 @@ aerospike_query_foreach(
 	aerospike_query_foreach_callback callback, void* udata
 	);
 
+/**
+ * Execute a query and aggregate the returned records with native callbacks instead of a
+ * Lua stream UDF. map() runs on the query worker threads directly on parsed records and
+ * the per-thread partial states are combined with reduce() when the query completes.
+ * The query must not have an as_query_apply() UDF. Queries without a where clause are
+ * run as scans like aerospike_query_foreach().
+ *
+ * ~~~~~~~~~~{.c}
+ * as_query_aggregator aggr = {sum_create, sum_map, sum_reduce, sum_destroy, NULL};
+ * void* result;
+ *
+ * if (aerospike_query_aggregate(&as, &err, NULL, &query, &aggr, &result) == AEROSPIKE_OK) {
+ *     printf("sum: %" PRId64 "\n", *(int64_t*)result);
+ *     aggr.destroy(result, aggr.udata);
+ * }
+ * ~~~~~~~~~~
+ *
+ * @param as			The aerospike instance to use for this operation.
+ * @param err			The as_error to be populated if an error occurs.
+ * @param policy		The policy to use for this operation. If NULL, then the default policy will be used.
+ * @param query			The query to execute against the cluster.
+ * @param aggr			Native aggregation callbacks.
+ * @param result		Final state on success. Caller must destroy it with aggr->destroy().
+ *
+ * @return AEROSPIKE_OK on success, otherwise an error.
+ *
+ * @ingroup query_operations
+ */
+AS_EXTERN as_status
+aerospike_query_aggregate(
+	aerospike* as, as_error* err, const as_policy_query* policy, const as_query* query,
+	const as_query_aggregator* aggr, void** result
+	);
+
 /**
  * Asynchronously execute a query and call the listener function for each result item.
  * Standard secondary index queries are supported, but aggregation queries are not supported
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <aerospike/aerospike.h>
+#include <aerospike/as_compress.h>
 #include <aerospike/as_node.h>
 
 /**
@@ -92,6 +93,27 @@ typedef struct as_node_stats_s {
 	 */
 	uint32_t error_count;
 
+	/**
+	 * Current adaptive concurrency limit. Zero if max_concurrency_per_node is not configured.
+	 */
+	uint32_t concurrency_limit;
+
+	/**
+	 * Single record commands currently in progress under the adaptive concurrency limit.
+	 */
+	uint32_t concurrency;
+
+	/**
+	 * Total commands rejected by the adaptive concurrency limit.
+	 */
+	uint32_t concurrency_rejected;
+
+	/**
+	 * Command latency histograms on this node indexed by as_latency_type.
+	 * Use as_latency_percentile() to retrieve percentiles.
+	 */
+	as_latency_buckets latency[AS_LATENCY_TYPE_MAX];
+
 } as_node_stats;
 
 /**
@@ -111,6 +133,17 @@ typedef struct as_event_loop_stats_s {
 	 */
 	uint32_t queue_size;
 
+	/**
+	 * Approximate number of commands submitted to this event loop from
+	 * other threads that have not been executed yet.
+	 */
+	uint32_t submit_size;
+
+	/**
+	 * Total wakeup signals sent to this event loop.
+	 */
+	uint64_t wakeups;
+
 } as_event_loop_stats;
 
 /**
@@ -144,6 +177,12 @@ typedef struct as_cluster_stats_s {
 	 */
 	uint32_t thread_pool_queued_tasks;
 
+	/**
+	 * Wire compression statistics.  Compressor state is shared by all clusters in the process,
+	 * so these counters are process wide.
+	 */
+	as_compress_stats compression;
+
 } as_cluster_stats;
 
 struct as_cluster_s;
@@ -231,6 +270,8 @@ aerospike_event_loop_stats(as_event_loop* event_loop, as_event_loop_stats* stats
 	// Warning: cross-thread references without a lock.
 	stats->process_size = as_event_loop_get_process_size(event_loop);
 	stats->queue_size = as_event_loop_get_queue_size(event_loop);
+	stats->submit_size = as_event_loop_get_submit_size(event_loop);
+	stats->wakeups = as_event_loop_get_wakeups(event_loop);
 }
 
 /**
@@ -85,14 +85,15 @@ as_async_write_command_create(
 	// Allocate enough memory to cover: struct size + write buffer size + auth max buffer size
 	// Then, round up memory size in 1KB increments.
 	size_t s = (sizeof(as_async_write_command) + size + AS_AUTHENTICATION_MAX_SIZE + 1023) & ~1023;
-	as_event_command* cmd = (as_event_command*)cf_malloc(s);
+	event_loop = as_event_assign(event_loop);
+	as_event_command* cmd = (as_event_command*)as_event_slab_alloc(event_loop, &s);
 	as_async_write_command* wcmd = (as_async_write_command*)cmd;
 	cmd->total_deadline = policy->total_timeout;
 	cmd->socket_timeout = policy->socket_timeout;
 	cmd->max_retries = policy->max_retries;
 	cmd->iteration = 0;
 	cmd->replica = replica;
-	cmd->event_loop = as_event_assign(event_loop);
+	cmd->event_loop = event_loop;
 	cmd->cluster = cluster;
 	cmd->node = NULL;
 	cmd->ns = ns;
@@ -102,11 +103,13 @@ as_async_write_command_create(
 	cmd->pipe_listener = pipe_listener;
 	cmd->buf = wcmd->space;
 	cmd->read_capacity = (uint32_t)(s - size - sizeof(as_async_write_command));
+	cmd->alloc_size = (uint32_t)s;
 	cmd->type = AS_ASYNC_TYPE_WRITE;
 	cmd->proto_type = AS_MESSAGE_TYPE;
 	cmd->state = AS_ASYNC_STATE_UNREGISTERED;
 	cmd->flags = flags;
 	cmd->flags2 = 0;
+	cmd->replica_index = 0;
 	wcmd->listener = listener;
 	return cmd;
 }
@@ -114,7 +117,7 @@ as_async_write_command_create(
 static inline as_event_command*
 as_async_record_command_create(
 	as_cluster* cluster, const as_policy_base* policy, as_policy_replica replica, const char* ns,
-	void* partition, bool deserialize, bool heap_rec, uint8_t flags,
+	void* partition, bool deserialize, bool heap_rec, bool arena, uint8_t flags,
 	as_async_record_listener listener, void* udata, as_event_loop* event_loop,
 	as_pipe_listener pipe_listener, size_t size, as_event_parse_results_fn parse_results
 	)
@@ -123,14 +126,15 @@ as_async_record_command_create(
 	// Then, round up memory size in 4KB increments to reduce fragmentation and to allow socket
 	// read to reuse buffer for small socket write sizes.
 	size_t s = (sizeof(as_async_record_command) + size + AS_AUTHENTICATION_MAX_SIZE + 4095) & ~4095;
-	as_event_command* cmd = (as_event_command*)cf_malloc(s);
+	event_loop = as_event_assign(event_loop);
+	as_event_command* cmd = (as_event_command*)as_event_slab_alloc(event_loop, &s);
 	as_async_record_command* rcmd = (as_async_record_command*)cmd;
 	cmd->total_deadline = policy->total_timeout;
 	cmd->socket_timeout = policy->socket_timeout;
 	cmd->max_retries = policy->max_retries;
 	cmd->iteration = 0;
 	cmd->replica = replica;
-	cmd->event_loop = as_event_assign(event_loop);
+	cmd->event_loop = event_loop;
 	cmd->cluster = cluster;
 	cmd->node = NULL;
 	cmd->ns = ns;
@@ -140,17 +144,22 @@ as_async_record_command_create(
 	cmd->pipe_listener = pipe_listener;
 	cmd->buf = rcmd->space;
 	cmd->read_capacity = (uint32_t)(s - size - sizeof(as_async_record_command));
+	cmd->alloc_size = (uint32_t)s;
 	cmd->type = AS_ASYNC_TYPE_RECORD;
 	cmd->proto_type = AS_MESSAGE_TYPE;
 	cmd->state = AS_ASYNC_STATE_UNREGISTERED;
 	cmd->flags = flags;
 	cmd->flags2 = 0;
+	cmd->replica_index = 0;
 	if (deserialize) {
 		cmd->flags2 |= AS_ASYNC_FLAGS2_DESERIALIZE;
 	}
 	if (heap_rec) {
 		cmd->flags2 |= AS_ASYNC_FLAGS2_HEAP_REC;
 	}
+	if (arena) {
+		cmd->flags2 |= AS_ASYNC_FLAGS2_RECORD_ARENA;
+	}
 	rcmd->listener = listener;
 	return cmd;
 }
@@ -167,14 +176,15 @@ as_async_value_command_create(
 	// Then, round up memory size in 4KB increments to reduce fragmentation and to allow socket
 	// read to reuse buffer for small socket write sizes.
 	size_t s = (sizeof(as_async_value_command) + size + AS_AUTHENTICATION_MAX_SIZE + 4095) & ~4095;
-	as_event_command* cmd = (as_event_command*)cf_malloc(s);
+	event_loop = as_event_assign(event_loop);
+	as_event_command* cmd = (as_event_command*)as_event_slab_alloc(event_loop, &s);
 	as_async_value_command* vcmd = (as_async_value_command*)cmd;
 	cmd->total_deadline = policy->total_timeout;
 	cmd->socket_timeout = policy->socket_timeout;
 	cmd->max_retries = policy->max_retries;
 	cmd->iteration = 0;
 	cmd->replica = replica;
-	cmd->event_loop = as_event_assign(event_loop);
+	cmd->event_loop = event_loop;
 	cmd->cluster = cluster;
 	cmd->node = NULL;
 	cmd->ns = ns;
@@ -184,11 +194,13 @@ as_async_value_command_create(
 	cmd->pipe_listener = pipe_listener;
 	cmd->buf = vcmd->space;
 	cmd->read_capacity = (uint32_t)(s - size - sizeof(as_async_value_command));
+	cmd->alloc_size = (uint32_t)s;
 	cmd->type = AS_ASYNC_TYPE_VALUE;
 	cmd->proto_type = AS_MESSAGE_TYPE;
 	cmd->state = AS_ASYNC_STATE_UNREGISTERED;
 	cmd->flags = flags;
 	cmd->flags2 = 0;
+	cmd->replica_index = 0;
 	vcmd->listener = listener;
 	return cmd;
 }
@@ -202,14 +214,15 @@ as_async_info_command_create(
 	// Allocate enough memory to cover: struct size + write buffer size + auth max buffer size
 	// Then, round up memory size in 1KB increments.
 	size_t s = (sizeof(as_async_info_command) + size + AS_AUTHENTICATION_MAX_SIZE + 1023) & ~1023;
-	as_event_command* cmd = (as_event_command*)cf_malloc(s);
+	event_loop = as_event_assign(event_loop);
+	as_event_command* cmd = (as_event_command*)as_event_slab_alloc(event_loop, &s);
 	as_async_info_command* icmd = (as_async_info_command*)cmd;
 	cmd->total_deadline = policy->timeout;
 	cmd->socket_timeout = policy->timeout;
 	cmd->max_retries = 1;
 	cmd->iteration = 0;
 	cmd->replica = AS_POLICY_REPLICA_MASTER;
-	cmd->event_loop = as_event_assign(event_loop);
+	cmd->event_loop = event_loop;
 	cmd->cluster = node->cluster;
 	cmd->node = node;
 	cmd->ns = NULL;
@@ -219,11 +232,13 @@ as_async_info_command_create(
 	cmd->pipe_listener = NULL;
 	cmd->buf = icmd->space;
 	cmd->read_capacity = (uint32_t)(s - size - sizeof(as_async_info_command));
+	cmd->alloc_size = (uint32_t)s;
 	cmd->type = AS_ASYNC_TYPE_INFO;
 	cmd->proto_type = AS_INFO_MESSAGE_TYPE;
 	cmd->state = AS_ASYNC_STATE_UNREGISTERED;
-	cmd->flags = AS_ASYNC_FLAGS_MASTER;
+	cmd->flags = 0;
 	cmd->flags2 = 0;
+	cmd->replica_index = 0;
 	icmd->listener = listener;
 	return cmd;
 }
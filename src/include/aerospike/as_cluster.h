@@ -130,6 +130,24 @@ typedef struct as_cluster_s {
 	 * Expected cluster name for all nodes.  May be null.
 	 */
 	char* cluster_name;
+
+	/**
+	 * @private
+	 * Cluster snapshot file path.  May be null.
+	 */
+	char* snapshot_path;
+
+	/**
+	 * @private
+	 * Time of last cluster snapshot write in milliseconds.
+	 */
+	uint64_t snapshot_ms;
+
+	/**
+	 * @private
+	 * Minimum milliseconds between cluster snapshot writes.
+	 */
+	uint32_t snapshot_interval;
 	
 	/**
 	 * Cluster event function that will be called when nodes are added/removed from the cluster.
@@ -174,6 +192,12 @@ typedef struct as_cluster_s {
 	 * Pool of threads used to query server nodes in parallel for batch, scan and query.
 	 */
 	as_thread_pool thread_pool;
+
+	/**
+	 * @private
+	 * Pool of threads used to send cluster tend info requests to server nodes in parallel.
+	 */
+	as_thread_pool tend_pool;
 		
 	/**
 	 * @private
@@ -238,6 +262,24 @@ typedef struct as_cluster_s {
 	 */
 	uint32_t error_rate_window;
 
+	/**
+	 * @private
+	 * Max adaptive concurrency limit per node. Zero disables limiter.
+	 */
+	uint32_t max_concurrency;
+
+	/**
+	 * @private
+	 * Min adaptive concurrency limit per node.
+	 */
+	uint32_t min_concurrency;
+
+	/**
+	 * @private
+	 * Command latency in nanoseconds above which the node concurrency limit is decreased.
+	 */
+	uint64_t concurrency_latency_ns;
+
 	/**
 	 * @private
 	 * Milliseconds between cluster tends.
@@ -334,6 +376,12 @@ typedef struct as_cluster_s {
 	 */
 	bool use_services_alternate;
 	
+	/**
+	 * @private
+	 * Use lock-free sync connection pools.
+	 */
+	bool conn_pools_lock_free;
+
 	/**
 	 * @private
 	 * Request server rack ids.
@@ -466,7 +514,7 @@ as_node_get_by_name(as_cluster* cluster, const char* name);
 as_node*
 as_partition_reg_get_node(
 	as_cluster* cluster, const char* ns, as_partition* p, as_node* prev_node,
-	as_policy_replica replica, bool use_master
+	as_policy_replica replica, uint8_t replica_index
 	);
 
 struct as_partition_shm_s;
@@ -479,27 +527,28 @@ struct as_partition_shm_s;
 as_node*
 as_partition_shm_get_node(
 	as_cluster* cluster, const char* ns, struct as_partition_shm_s* partition,
-	as_node* prev_node, as_policy_replica replica, bool use_master
+	as_node* prev_node, as_policy_replica replica, uint8_t replica_index
 	);
 
 /**
  * @private
  * Get mapped node given partition and replica.  This function does not reserve the node.
- * The caller must reserve the node for future use.
+ * The caller must reserve the node for future use.  replica_index selects the replica that
+ * is tried first.  Commands advance it on retry to cycle through all replicas.
  */
 static inline as_node*
 as_partition_get_node(
 	as_cluster* cluster, const char* ns, void* partition, as_node* prev_node,
-	as_policy_replica replica, bool master
+	as_policy_replica replica, uint8_t replica_index
 	)
 {
 	if (cluster->shm_info) {
 		return as_partition_shm_get_node(cluster, ns, (struct as_partition_shm_s*)partition,
-										 prev_node, replica, master);
+										 prev_node, replica, replica_index);
 	}
 	else {
 		return as_partition_reg_get_node(cluster, ns, (as_partition*)partition,
-										 prev_node, replica, master);
+										 prev_node, replica, replica_index);
 	}
 }
 
@@ -546,6 +595,62 @@ as_node_valid_error_count(as_node* node)
 	return max == 0 || max >= as_load_uint32(&node->error_count);
 }
 
+/**
+ * @private
+ * Adjust node's adaptive concurrency limit from a completed command.
+ */
+void
+as_node_concurrency_update(as_node* node, uint64_t begin_ns, bool overload);
+
+/**
+ * @private
+ * Reserve a command slot under node's adaptive concurrency limit.
+ * Return false if the limit has been reached.
+ */
+static inline bool
+as_node_concurrency_acquire(as_node* node)
+{
+	if (node->cluster->max_concurrency == 0) {
+		return true;
+	}
+
+	uint32_t limit = as_load_uint32(&node->concurrency_limit);
+
+	if (as_aaf_uint32(&node->concurrency, 1) > limit) {
+		as_decr_uint32(&node->concurrency);
+		as_incr_uint32(&node->concurrency_rejected);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @private
+ * Release command slot acquired by as_node_concurrency_acquire(). The command's latency
+ * since begin_ns and the overload indicator (timeout, connection error or device overload)
+ * adjust the node's concurrency limit.
+ */
+static inline void
+as_node_concurrency_release(as_node* node, uint64_t begin_ns, bool overload)
+{
+	if (node->cluster->max_concurrency > 0) {
+		as_node_concurrency_update(node, begin_ns, overload);
+	}
+}
+
+/**
+ * @private
+ * Release command slot without adjusting node's concurrency limit. Used when the command
+ * outcome does not reflect node latency.
+ */
+static inline void
+as_node_concurrency_cancel(as_node* node)
+{
+	if (node->cluster->max_concurrency > 0) {
+		as_decr_uint32(&node->concurrency);
+	}
+}
+
 /**
  * @private
  * Close connection and increment node's error count.
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2008-2021 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#pragma once
+
+#include <aerospike/as_std.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct as_cluster_s;
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * @private
+ * Create nodes, racks and partition tables from the cluster snapshot file so commands can be
+ * routed before the first tend.  Nodes are not validated here.  The tend thread validates them
+ * with the normal node name, generation and regime checks.  Return true if nodes were loaded.
+ */
+bool
+as_cluster_snapshot_load(struct as_cluster_s* cluster);
+
+/**
+ * @private
+ * Write current nodes, racks and partition tables to the cluster snapshot file.
+ * Must be called from the tend thread.
+ */
+void
+as_cluster_snapshot_write(struct as_cluster_s* cluster);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
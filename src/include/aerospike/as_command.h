@@ -38,6 +38,8 @@ extern "C" {
 #define AS_COMMAND_FLAGS_READ 1
 #define AS_COMMAND_FLAGS_BATCH 2
 #define AS_COMMAND_FLAGS_LINEARIZE 4
+#define AS_COMMAND_FLAGS_IOV 8
+#define AS_COMMAND_FLAGS_HEDGE 16
 
 // Field IDs
 #define AS_FIELD_NAMESPACE 0
@@ -114,6 +116,10 @@ extern "C" {
 #define AS_STACK_BUF_SIZE (1024 * 16)
 #define AS_COMPRESS_THRESHOLD 128
 
+// String/blob bin values at least this size are sent in place via scatter/gather
+// instead of being copied into the command buffer.
+#define AS_COMMAND_IOV_THRESHOLD (1024 * 16)
+
 /**
  * @private
  * Macros use these stand-ins for cf_malloc() / cf_free(), so that
@@ -153,6 +159,34 @@ local_free(void* memory)
  */
 typedef size_t (*as_write_fn) (void* udata, uint8_t* buf);
 
+/**
+ * @private
+ * Scatter/gather command segments. Command buffer runs are interleaved with
+ * bin values that are referenced in place.
+ */
+typedef struct as_command_iov_s {
+	/**
+	 * Segments (as_socket_iov).
+	 */
+	as_vector segments;
+
+	/**
+	 * Start of command buffer run that has not been added to segments yet.
+	 */
+	uint8_t* run;
+
+	/**
+	 * Total size of bin values referenced in place.
+	 */
+	size_t ref_size;
+} as_command_iov;
+
+/**
+ * @private
+ * Write scatter/gather buffer callback used in as_command_send_iov().
+ */
+typedef size_t (*as_write_iov_fn) (void* udata, uint8_t* buf, as_command_iov* iov);
+
 /**
  * @private
  * Parse results callback used in as_command_execute().
@@ -175,6 +209,8 @@ typedef struct as_command_s {
 	void* udata;
 	uint8_t* buf;
 	size_t buf_size;
+	as_socket_iov* iov; // Used only when AS_COMMAND_FLAGS_IOV is set.
+	uint32_t iov_size;
 	uint32_t partition_id;
 	as_policy_replica replica;
 	uint64_t deadline_ms;
@@ -182,9 +218,12 @@ typedef struct as_command_s {
 	uint32_t total_timeout;
 	uint32_t max_retries;
 	uint32_t iteration;
+	uint32_t hedge_delay; // Used only when AS_COMMAND_FLAGS_HEDGE is set.
+	float hedge_percentile; // Used only when AS_COMMAND_FLAGS_HEDGE is set.
 	uint8_t flags;
-	bool master;
-	bool master_sc; // Used in batch only.
+	uint8_t latency_type;
+	uint8_t replica_index;
+	uint8_t replica_index_sc; // Used in batch only.
 } as_command;
 
 /**
@@ -194,6 +233,7 @@ typedef struct as_command_s {
 typedef struct as_command_parse_result_data_s {
 	as_record** record;
 	bool deserialize;
+	bool arena;
 } as_command_parse_result_data;
 
 /******************************************************************************
@@ -222,6 +262,13 @@ as_buffers_destroy(as_queue* buffers)
 size_t
 as_command_key_size(as_policy_key policy, const as_key* key, uint16_t* n_fields);
 
+/**
+ * @private
+ * Calculate size of user key field.
+ */
+size_t
+as_command_user_key_size(const as_key* key);
+
 /**
  * @private
  * Calculate size of string field.
@@ -462,6 +509,13 @@ as_command_write_field_digest(uint8_t* p, const as_digest* val)
 uint8_t*
 as_command_write_key(uint8_t* p, as_policy_key policy, const as_key* key);
 
+/**
+ * @private
+ * Write user key field.
+ */
+uint8_t*
+as_command_write_user_key(uint8_t* begin, const as_key* key);
+
 /**
  * @private
  * Write bin header and bin name.
@@ -469,6 +523,13 @@ as_command_write_key(uint8_t* p, as_policy_key policy, const as_key* key);
 uint8_t*
 as_command_write_bin_name(uint8_t* cmd, const char* name);
 
+/**
+ * @private
+ * Write operation header and bin name without a value.
+ */
+uint8_t*
+as_command_write_op_name(uint8_t* cmd, as_operator op_type, const char* name);
+
 /**
  * @private
  * Write bin.
@@ -478,6 +539,58 @@ as_command_write_bin(
 	uint8_t* begin, as_operator operation_type, const as_bin* bin, as_queue* buffers
 	);
 
+/**
+ * @private
+ * Write value after an operation header and bin name written by as_command_write_op_name().
+ * Set the operation size and value type.
+ */
+uint8_t*
+as_command_write_op_value(uint8_t* begin, as_val* val, as_queue* buffers);
+
+/**
+ * @private
+ * Return bin value size if the value is large enough to be sent in place via
+ * scatter/gather. Otherwise, return zero.
+ */
+static inline size_t
+as_command_value_ref_size(const as_val* val)
+{
+	size_t size;
+
+	switch (val->type) {
+		case AS_STRING:
+			// len should have been already set by as_command_value_size().
+			size = ((as_string*)val)->len;
+			break;
+
+		case AS_BYTES:
+			size = ((as_bytes*)val)->size;
+			break;
+
+		default:
+			return 0;
+	}
+	return (size >= AS_COMMAND_IOV_THRESHOLD)? size : 0;
+}
+
+/**
+ * @private
+ * Write bin. Large string/blob values are added to iov segments instead of
+ * being copied to the command buffer.
+ */
+uint8_t*
+as_command_write_bin_iov(
+	uint8_t* begin, as_operator operation_type, const as_bin* bin, as_queue* buffers,
+	as_command_iov* iov
+	);
+
+/**
+ * @private
+ * Finish writing scatter/gather command. Return total command size.
+ */
+size_t
+as_command_write_end_iov(uint8_t* begin, uint8_t* end, as_command_iov* iov);
+
 /**
  * @private
  * Finish writing command.
@@ -541,7 +654,7 @@ as_command_start_timer(as_command* cmd)
 
 	cmd->max_retries = policy->max_retries;
 	cmd->iteration = 0;
-	cmd->master = true;
+	cmd->replica_index = 0;
 
 	if (policy->total_timeout > 0) {
 		cmd->socket_timeout = (policy->socket_timeout == 0 ||
@@ -567,6 +680,17 @@ as_command_send(
 	as_command* cmd, as_error* err, uint32_t comp_threshold, as_write_fn write_fn, void* udata
 	);
 
+/**
+ * @private
+ * Write command buffer runs and send command to the server using scatter/gather.
+ * cmd->buf_size must be set to the command size minus the referenced bin values
+ * and ref_count must be the number of referenced bin values.
+ */
+as_status
+as_command_send_iov(
+	as_command* cmd, as_error* err, as_write_iov_fn write_fn, void* udata, uint32_t ref_count
+	);
+
 /**
  * @private
  * Send command to the server.
@@ -574,6 +698,14 @@ as_command_send(
 as_status
 as_command_execute(as_command* cmd, as_error* err);
 
+/**
+ * @private
+ * Read one single record response from socket and pass it to cmd->parse_results_fn.
+ * Only cmd socket_timeout, deadline_ms, parse_results_fn and udata are referenced.
+ */
+as_status
+as_command_read_message(as_error* err, as_command* cmd, as_socket* sock, as_node* node);
+
 /**
  * @private
  * Parse header of server response.
@@ -605,9 +737,15 @@ as_command_parse_success_failure_bins(uint8_t** pp, as_error* err, as_msg* msg,
 /**
  * @private
  * Parse bins received from the server.
+ *
+ * If arena is true, the bin array and all variable length bin values (strings, geojson, blobs
+ * and undeserialized lists/maps) are stored in a single allocation owned by rec->bins.entries.
+ * Bin values reference slices of that allocation and are not freed individually.
  */
 as_status
-as_command_parse_bins(uint8_t** pp, as_error* err, as_record* rec, uint32_t n_bins, bool deserialize);
+as_command_parse_bins(
+	uint8_t** pp, as_error* err, as_record* rec, uint32_t n_bins, bool deserialize, bool arena
+	);
 
 /**
  * @private
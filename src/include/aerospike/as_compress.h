@@ -0,0 +1,102 @@
+/*
+ * Copyright 2008-2021 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#pragma once
+
+#include <aerospike/as_error.h>
+#include <aerospike/as_std.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+/**
+ * Wire compression statistics.  Counters are process wide and accumulate from the first
+ * compressed command or response.
+ */
+typedef struct as_compress_stats_s {
+	/**
+	 * Command bytes before compression.
+	 */
+	uint64_t compress_in;
+
+	/**
+	 * Command bytes after compression.
+	 */
+	uint64_t compress_out;
+
+	/**
+	 * Nanoseconds spent compressing commands.
+	 */
+	uint64_t compress_ns;
+
+	/**
+	 * Response bytes before decompression.
+	 */
+	uint64_t decompress_in;
+
+	/**
+	 * Response bytes after decompression.
+	 */
+	uint64_t decompress_out;
+
+	/**
+	 * Nanoseconds spent decompressing responses.
+	 */
+	uint64_t decompress_ns;
+
+} as_compress_stats;
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * @private
+ * Return max zlib compressed size of src_sz bytes.
+ */
+size_t
+as_compress_bound(size_t src_sz);
+
+/**
+ * @private
+ * Compress src into zlib format using the calling thread's reusable compressor.
+ * On input, trg_sz is the trg capacity.  On output, trg_sz is the compressed size.
+ */
+as_status
+as_compress(as_error* err, uint8_t* trg, size_t* trg_sz, uint8_t* src, size_t src_sz);
+
+/**
+ * @private
+ * Decompress zlib formatted src using the calling thread's reusable decompressor.
+ * On input, trg_sz is the trg capacity.  On output, trg_sz is the decompressed size.
+ */
+as_status
+as_decompress(as_error* err, uint8_t* trg, size_t* trg_sz, uint8_t* src, size_t src_sz);
+
+/**
+ * Copy wire compression statistics.
+ */
+AS_EXTERN void
+as_compress_stats_get(as_compress_stats* stats);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
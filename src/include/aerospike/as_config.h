@@ -319,6 +319,24 @@ typedef struct as_config_tls_s {
 	 */
 	bool for_login_only;
 
+	/**
+	 * Do not resume TLS sessions.  By default, the client caches the last session ticket or
+	 * session ID received from each node and resumes that session on new connections to the
+	 * node, which avoids a full handshake when many connections are opened at once.  Cached
+	 * sessions are discarded when as_tls_config_reload() is called.
+	 * Default: false (resume sessions)
+	 */
+	bool disable_session_resumption;
+
+	/**
+	 * Enable kernel TLS offload on Linux.  When supported by OpenSSL (3.0+) and the kernel,
+	 * record encryption and decryption for the negotiated cipher are performed by the kernel
+	 * after the handshake, so reads and writes do not copy data through user space encryption.
+	 * Connections fall back to user space TLS when offload is not available.
+	 * Default: false
+	 */
+	bool enable_ktls;
+
 } as_config_tls;
 
 /**
@@ -593,6 +611,33 @@ typedef struct as_config_s {
 	 */
 	uint32_t error_rate_window;
 
+	/**
+	 * Maximum number of concurrent single record commands per node allowed by the adaptive
+	 * concurrency limiter. The limiter applies to sync and async single record commands.
+	 * Each node's limit starts at this value, is cut by a quarter when a command exceeds
+	 * concurrency_latency_threshold, times out or hits a connection error and grows by one
+	 * after each full limit of fast commands (AIMD). Commands that would exceed the current
+	 * limit are rejected with AEROSPIKE_ERR_CONCURRENCY_LIMIT, so load is shed before node
+	 * latency turns into cascading timeouts.
+	 *
+	 * If max_concurrency_per_node is zero, the limiter is disabled.
+	 * Default: 0
+	 */
+	uint32_t max_concurrency_per_node;
+
+	/**
+	 * Minimum value of the adaptive per node concurrency limit.
+	 * Default: 16
+	 */
+	uint32_t min_concurrency_per_node;
+
+	/**
+	 * Command latency in milliseconds above which the adaptive per node concurrency limit is
+	 * decreased.
+	 * Default: 50
+	 */
+	uint32_t concurrency_latency_threshold;
+
 	/**
 	 * Polling interval in milliseconds for cluster tender
 	 * Default: 1000
@@ -612,6 +657,17 @@ typedef struct as_config_s {
 	 */
 	uint32_t thread_pool_size;
 
+	/**
+	 * Number of threads used by the cluster tender to send info requests to server nodes in
+	 * parallel.  Each tend iteration then takes about one round trip per tend phase regardless
+	 * of cluster size, so partition map updates after migrations are not delayed on large
+	 * clusters.  Responses are still processed sequentially by the tend thread.
+	 *
+	 * Values 0 and 1 send requests sequentially from the tend thread.
+	 * Default: 1
+	 */
+	uint32_t tend_threads;
+
 	/**
 	 * Assign tend thread to this specific CPU ID.
 	 * Default: -1 (Any CPU).
@@ -674,6 +730,20 @@ typedef struct as_config_s {
 	 */
 	bool use_services_alternate;
 
+	/**
+	 * Use lock-free ring buffers for synchronous connection pools instead of mutex guarded
+	 * stacks.  Lock-free pools reduce contention when many threads issue synchronous commands
+	 * to a small number of nodes.  Connection limits (min_conns_per_node, max_conns_per_node
+	 * and conn_pools_per_node) are enforced the same way for both pool types.
+	 *
+	 * Lock-free pools are FIFO, so pooled connections are used in round-robin order instead
+	 * of most recently used order.  Idle connections are still trimmed by the cluster tend
+	 * thread, but only after all connections in the pool have become idle.
+	 *
+	 * Default: false
+	 */
+	bool conn_pools_lock_free;
+
 	/**
 	 * Track server rack data.  This field is useful when directing read commands to 
 	 * the server node that contains the key and exists on the same rack as the client.
@@ -751,6 +821,25 @@ typedef struct as_config_s {
 	 * Default: 30
 	 */
 	uint32_t shm_takeover_threshold_sec;
+
+	/**
+	 * Path of the cluster snapshot file.  If not null, the tend thread periodically writes
+	 * current nodes, racks and partition maps to this file.  A new client that finds the file
+	 * loads it on startup and routes commands immediately instead of waiting for the initial
+	 * cluster tend.  Snapshot entries are then validated by the tend thread with the normal
+	 * node name, generation and regime checks.
+	 *
+	 * The snapshot is not used when authentication is enabled or use_shm is true.
+	 * Use as_config_set_snapshot_path() to set this field.
+	 * Default: NULL
+	 */
+	char* snapshot_path;
+
+	/**
+	 * Minimum interval in milliseconds between cluster snapshot writes.
+	 * Default: 10000
+	 */
+	uint32_t snapshot_interval;
 } as_config;
 
 /******************************************************************************
@@ -854,6 +943,17 @@ as_config_set_cluster_name(as_config* config, const char* cluster_name)
 	as_config_set_string(&config->cluster_name, cluster_name);
 }
 
+/**
+ * Set cluster snapshot file path.
+ *
+ * @relates as_config
+ */
+static inline void
+as_config_set_snapshot_path(as_config* config, const char* snapshot_path)
+{
+	as_config_set_string(&config->snapshot_path, snapshot_path);
+}
+
 /**
  * Set cluster event callback and user data.
  *
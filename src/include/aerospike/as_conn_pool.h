@@ -16,8 +16,10 @@
  */
 #pragma once
 
+#include <aerospike/as_atomic.h>
 #include <aerospike/as_queue.h>
 #include <aerospike/as_socket.h>
+#include <citrusleaf/alloc.h>
 #include <pthread.h>
 
 #ifdef __cplusplus
@@ -28,9 +30,30 @@ extern "C" {
  * TYPES
  *****************************************************************************/
 
+/**
+ * @private
+ * Lock-free connection ring slot.
+ */
+typedef struct as_conn_slot_s {
+	/**
+	 * Slot sequence number used to determine if slot is ready for push or pop.
+	 */
+	uint64_t seq;
+
+	/**
+	 * Pooled socket.
+	 */
+	as_socket sock;
+} as_conn_slot;
+
 /**
  * @private
  * Sync connection pool.
+ *
+ * The default pool is a mutex guarded LIFO stack. If lock_free is set, the pool is
+ * a bounded multi-producer/multi-consumer FIFO ring where push/pop only require a single
+ * compare-and-swap on the ring position. Both pools share the same total/capacity
+ * connection accounting.
  */
 typedef struct as_conn_pool_s {
 	/**
@@ -43,10 +66,50 @@ typedef struct as_conn_pool_s {
 	 */
 	as_queue queue;
 
+	/**
+	 * Lock-free ring. Only used when lock_free is true.
+	 */
+	as_conn_slot* ring;
+
+	/**
+	 * Lock-free ring capacity - 1. Ring capacity is a power of 2.
+	 */
+	uint64_t ring_mask;
+
+	/**
+	 * Lock-free ring position where next connection will be pushed.
+	 */
+	uint64_t ring_tail;
+
+	/**
+	 * Keep ring_tail and ring_head on separate cache lines.
+	 */
+	uint8_t pad[56];
+
+	/**
+	 * Lock-free ring position where next connection will be popped.
+	 */
+	uint64_t ring_head;
+
+	/**
+	 * Total connections in use and in pool.
+	 */
+	uint32_t total;
+
+	/**
+	 * Maximum number of connections.
+	 */
+	uint32_t capacity;
+
 	/**
 	 * Minimum number of connections.
 	 */
 	uint32_t min_size;
+
+	/**
+	 * Use lock-free ring instead of mutex guarded queue.
+	 */
+	bool lock_free;
 } as_conn_pool;
 
 /******************************************************************************
@@ -58,20 +121,135 @@ typedef struct as_conn_pool_s {
  * Initialize a connection pool.
  */
 static inline void
-as_conn_pool_init(as_conn_pool* pool, uint32_t item_size, uint32_t min_size, uint32_t max_size)
+as_conn_pool_init(
+	as_conn_pool* pool, uint32_t item_size, uint32_t min_size, uint32_t max_size, bool lock_free
+	)
 {
-	pthread_mutex_init(&pool->lock, NULL);
-	as_queue_init(&pool->queue, item_size, max_size);
+	pool->total = 0;
+	pool->capacity = max_size;
 	pool->min_size = min_size;
+	pool->lock_free = lock_free;
+
+	if (lock_free) {
+		// Round ring capacity up to power of 2 so positions can be masked. Reserve at least
+		// twice the maximum connections, so a consumer that is preempted between claiming
+		// and releasing a slot does not cause spurious full ring failures.
+		uint64_t size = 1;
+
+		while (size < (uint64_t)max_size * 2) {
+			size <<= 1;
+		}
+
+		pool->ring = (as_conn_slot*)cf_malloc(sizeof(as_conn_slot) * size);
+		pool->ring_mask = size - 1;
+		pool->ring_head = 0;
+		pool->ring_tail = 0;
+
+		for (uint64_t i = 0; i < size; i++) {
+			pool->ring[i].seq = i;
+		}
+	}
+	else {
+		pthread_mutex_init(&pool->lock, NULL);
+		as_queue_init(&pool->queue, item_size, max_size);
+		pool->ring = NULL;
+	}
+}
+
+/**
+ * @private
+ * Push connection to lock-free ring. Return false if ring is full.
+ */
+static inline bool
+as_conn_pool_ring_push(as_conn_pool* pool, as_socket* sock)
+{
+	uint64_t pos = as_load_uint64(&pool->ring_tail);
+	as_conn_slot* slot;
+
+	while (true) {
+		slot = &pool->ring[pos & pool->ring_mask];
+
+		uint64_t seq = as_load_uint64(&slot->seq);
+		as_fence_acq();
+
+		int64_t dif = (int64_t)seq - (int64_t)pos;
+
+		if (dif == 0) {
+			// Slot is free. Claim it.
+			if (as_cas_uint64(&pool->ring_tail, pos, pos + 1)) {
+				break;
+			}
+			pos = as_load_uint64(&pool->ring_tail);
+		}
+		else if (dif < 0) {
+			// Ring is full.
+			return false;
+		}
+		else {
+			// Another thread claimed slot. Reload position.
+			pos = as_load_uint64(&pool->ring_tail);
+		}
+	}
+
+	slot->sock = *sock;
+	as_fence_rls();
+	as_store_uint64(&slot->seq, pos + 1);
+	return true;
+}
+
+/**
+ * @private
+ * Pop connection from lock-free ring. Return false if ring is empty.
+ */
+static inline bool
+as_conn_pool_ring_pop(as_conn_pool* pool, as_socket* sock)
+{
+	uint64_t pos = as_load_uint64(&pool->ring_head);
+	as_conn_slot* slot;
+
+	while (true) {
+		slot = &pool->ring[pos & pool->ring_mask];
+
+		uint64_t seq = as_load_uint64(&slot->seq);
+		as_fence_acq();
+
+		int64_t dif = (int64_t)seq - (int64_t)(pos + 1);
+
+		if (dif == 0) {
+			// Slot is filled. Claim it.
+			if (as_cas_uint64(&pool->ring_head, pos, pos + 1)) {
+				break;
+			}
+			pos = as_load_uint64(&pool->ring_head);
+		}
+		else if (dif < 0) {
+			// Ring is empty.
+			return false;
+		}
+		else {
+			// Another thread claimed slot. Reload position.
+			pos = as_load_uint64(&pool->ring_head);
+		}
+	}
+
+	*sock = slot->sock;
+	as_fence_rls();
+	as_store_uint64(&slot->seq, pos + pool->ring_mask + 1);
+	return true;
 }
 
 /**
  * @private
  * Pop connection from head of pool.
+ * Lock-free pools are FIFO, so the least recently used connection is returned.
  */
 static inline bool
 as_conn_pool_pop_head(as_conn_pool* pool, as_socket* sock)
 {
+	if (pool->lock_free) {
+		return as_conn_pool_ring_pop(pool, sock);
+	}
+
 	pthread_mutex_lock(&pool->lock);
 	bool status = as_queue_pop(&pool->queue, sock);
 	pthread_mutex_unlock(&pool->lock);
@@ -81,10 +259,15 @@ as_conn_pool_pop_head(as_conn_pool* pool, as_socket* sock)
 /**
  * @private
  * Pop connection from tail of pool.
+ * Lock-free pools are FIFO, so the least recently used connection is returned.
  */
 static inline bool
 as_conn_pool_pop_tail(as_conn_pool* pool, as_socket* sock)
 {
+	if (pool->lock_free) {
+		return as_conn_pool_ring_pop(pool, sock);
+	}
+
 	pthread_mutex_lock(&pool->lock);
 	bool status = as_queue_pop_tail(&pool->queue, sock);
 	pthread_mutex_unlock(&pool->lock);
@@ -98,6 +281,10 @@ as_conn_pool_pop_tail(as_conn_pool* pool, as_socket* sock)
 static inline bool
 as_conn_pool_push_head(as_conn_pool* pool, as_socket* sock)
 {
+	if (pool->lock_free) {
+		return as_conn_pool_ring_push(pool, sock);
+	}
+
 	pthread_mutex_lock(&pool->lock);
 	bool status = as_queue_push_head_limit(&pool->queue, sock);
 	pthread_mutex_unlock(&pool->lock);
@@ -111,6 +298,10 @@ as_conn_pool_push_head(as_conn_pool* pool, as_socket* sock)
 static inline bool
 as_conn_pool_push_tail(as_conn_pool* pool, as_socket* sock)
 {
+	if (pool->lock_free) {
+		return as_conn_pool_ring_push(pool, sock);
+	}
+
 	pthread_mutex_lock(&pool->lock);
 	bool status = as_queue_push_limit(&pool->queue, sock);
 	pthread_mutex_unlock(&pool->lock);
@@ -125,7 +316,7 @@ as_conn_pool_push_tail(as_conn_pool* pool, as_socket* sock)
 static inline bool
 as_conn_pool_incr(as_conn_pool* pool)
 {
-	return as_faa_uint32(&pool->queue.total, 1) < pool->queue.capacity;
+	return as_faa_uint32(&pool->total, 1) < pool->capacity;
 }
 
 /**
@@ -135,7 +326,7 @@ as_conn_pool_incr(as_conn_pool* pool)
 static inline void
 as_conn_pool_decr(as_conn_pool* pool)
 {
-	as_decr_uint32(&pool->queue.total);
+	as_decr_uint32(&pool->total);
 }
 
 /**
@@ -145,7 +336,28 @@ as_conn_pool_decr(as_conn_pool* pool)
 static inline int
 as_conn_pool_excess(as_conn_pool* pool)
 {
-	return as_load_uint32(&pool->queue.total) - pool->min_size;
+	return as_load_uint32(&pool->total) - pool->min_size;
+}
+
+/**
+ * @private
+ * Return approximate number of connections in pool and total connections.
+ */
+static inline void
+as_conn_pool_usage(as_conn_pool* pool, uint32_t* in_pool, uint32_t* total)
+{
+	if (pool->lock_free) {
+		uint64_t head = as_load_uint64(&pool->ring_head);
+		uint64_t tail = as_load_uint64(&pool->ring_tail);
+		*in_pool = (tail > head)? (uint32_t)(tail - head) : 0;
+		*total = as_load_uint32(&pool->total);
+		return;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	*in_pool = as_queue_size(&pool->queue);
+	*total = pool->total;
+	pthread_mutex_unlock(&pool->lock);
 }
 
 /**
@@ -157,6 +369,14 @@ as_conn_pool_destroy(as_conn_pool* pool)
 {
 	as_socket sock;
 
+	if (pool->lock_free) {
+		while (as_conn_pool_ring_pop(pool, &sock)) {
+			as_socket_close(&sock);
+		}
+		cf_free(pool->ring);
+		return;
+	}
+
 	pthread_mutex_lock(&pool->lock);
 
 	while (as_queue_pop(&pool->queue, &sock)) {
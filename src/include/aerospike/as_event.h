@@ -16,6 +16,7 @@
  */
 #pragma once
 
+#include <aerospike/as_atomic.h>
 #include <aerospike/as_error.h>
 #include <aerospike/as_queue.h>
 #include <pthread.h>
@@ -26,7 +27,8 @@
  * Generic asynchronous events abstraction.  Designed to support multiple event libraries.
  * Only one library is supported per build.
  */
-#if defined(AS_USE_LIBEV) || defined(AS_USE_LIBUV) || defined(AS_USE_LIBEVENT)
+#if defined(AS_USE_LIBEV) || defined(AS_USE_LIBUV) || defined(AS_USE_LIBEVENT) || \
+	defined(AS_USE_IO_URING)
 #define AS_EVENT_LIB_DEFINED 1
 #endif
 
@@ -37,6 +39,8 @@
 #elif defined(AS_USE_LIBEVENT)
 #include <event2/event_struct.h>
 #include <aerospike/as_vector.h>
+#elif defined(AS_USE_IO_URING)
+struct as_uring_s;
 #else
 #endif
 
@@ -116,13 +120,28 @@ typedef struct as_event_loop {
 	struct event wakeup;
 	struct event trim;
 	as_vector clusters;
+#elif defined(AS_USE_IO_URING)
+	struct as_uring_s* loop;
 #else
 	void* loop;
 #endif
 		
 	struct as_event_loop* next;
+	// Lock-free multi-producer, single-consumer ring for commands submitted from other threads.
+	struct as_event_submit_slot_s* submit_ring;
+	uint32_t submit_mask;
+	uint32_t submit_tail;
+	uint32_t submit_head;
+	// Commands submitted and not yet executed. Wakeup is only sent on transition from zero.
+	uint32_t submit_size;
+	// Overflow queue used when submit_ring is full. Protected by lock.
+	uint32_t overflow_size;
 	pthread_mutex_t lock;
 	as_queue queue;
+	uint64_t wakeups;
+	// Size-classed freelists for command, connection and response buffer memory.
+	// Only accessed from the event loop thread.
+	struct as_event_slab_s* slab;
 	as_queue delay_queue;
 	as_queue pipe_cb_queue;
 	pthread_t thread;
@@ -414,6 +433,31 @@ as_event_loop_get_queue_size(as_event_loop* event_loop)
 	return as_queue_size(&event_loop->delay_queue);
 }
 
+/**
+ * Return the approximate number of commands submitted to this event loop from other
+ * threads that have not been executed yet.
+ *
+ * @ingroup async_events
+ */
+static inline uint32_t
+as_event_loop_get_submit_size(as_event_loop* event_loop)
+{
+	return as_load_uint32(&event_loop->submit_size);
+}
+
+/**
+ * Return the number of wakeup signals sent to this event loop. Wakeups are only sent when
+ * the submission queue transitions from empty to non-empty, so this value is normally much
+ * lower than the number of commands submitted from other threads.
+ *
+ * @ingroup async_events
+ */
+static inline uint64_t
+as_event_loop_get_wakeups(as_event_loop* event_loop)
+{
+	return as_load_uint64(&event_loop->wakeups);
+}
+
 /**
  * Close internal event loops and release watchers for internal and external event loops.
  * The global event loop array will also be destroyed for internal event loops.
@@ -32,6 +32,8 @@
 struct as_uv_tls;
 #elif defined(AS_USE_LIBEVENT)
 #include <event2/event.h>
+#elif defined(AS_USE_IO_URING)
+struct as_uring_s;
 #else
 #endif
 
@@ -57,17 +59,19 @@ extern "C" {
 #define AS_ASYNC_STATE_QUEUE_ERROR 11
 #define AS_ASYNC_STATE_RETRY 12
 
-#define AS_ASYNC_FLAGS_MASTER 1
 #define AS_ASYNC_FLAGS_READ 2
 #define AS_ASYNC_FLAGS_HAS_TIMER 4
 #define AS_ASYNC_FLAGS_USING_SOCKET_TIMER 8
 #define AS_ASYNC_FLAGS_EVENT_RECEIVED 16
 #define AS_ASYNC_FLAGS_FREE_BUF 32
 #define AS_ASYNC_FLAGS_LINEARIZE 64
-#define AS_ASYNC_FLAGS_MASTER_SC 128
 
 #define AS_ASYNC_FLAGS2_DESERIALIZE 1
 #define AS_ASYNC_FLAGS2_HEAP_REC 2
+#define AS_ASYNC_FLAGS2_RECORD_ARENA 4
+#define AS_ASYNC_FLAGS2_HEDGE 8
+#define AS_ASYNC_FLAGS2_HEDGE_TIMER 16
+#define AS_ASYNC_FLAGS2_CONCURRENCY 32
 
 #define AS_ASYNC_AUTH_RETURN_CODE 1
 
@@ -76,14 +80,47 @@ extern "C" {
 #define AS_EVENT_CONNECTION_ERROR 2
 
 #define AS_EVENT_QUEUE_INITIAL_CAPACITY 256
+#define AS_EVENT_SUBMIT_CAPACITY 4096 // Must be power of 2.
+
+// Slab size classes are 1KB to 16KB in 1KB steps, followed by 32KB to 256KB in powers of 2.
+#define AS_EVENT_SLAB_CLASSES 20
+#define AS_EVENT_SLAB_MAX_SIZE (256 * 1024)
+#define AS_EVENT_SLAB_CLASS_BYTES (512 * 1024) // Maximum cached bytes per size class.
+#define AS_EVENT_SLAB_MAX_CONNS 1024
+
+// Read-ahead buffer size for non-pipelined libev/libevent connections.
+#define AS_EVENT_READ_AHEAD_SIZE (16 * 1024)
 	
 struct as_event_command;
 struct as_event_executor;
 
+/**
+ * Connection receive buffer. A single read can pull in a response header, its body and
+ * following blocks of multi-block responses. Bytes in [pos, len) have not been consumed.
+ * Data is allocated on first use.
+ */
+typedef struct {
+	uint8_t* data;
+	uint32_t pos;
+	uint32_t len;
+} as_event_read_buffer;
+
+#if defined(AS_USE_IO_URING)
+typedef struct {
+	// Absolute expiration in nanoseconds.
+	uint64_t deadline;
+	// Repeat interval in milliseconds. Zero for one-shot timers.
+	uint32_t repeat;
+	// One-based position in event loop timer heap. Zero if not active.
+	uint32_t index;
+} as_uring_timer;
+#endif
+
 typedef struct {
 #if defined(AS_USE_LIBEV)
 	struct ev_io watcher;
 	as_socket socket;
+	as_event_read_buffer rbuf;
 #elif defined(AS_USE_LIBUV)
 	uv_tcp_t socket;
 	struct as_uv_tls* tls;
@@ -96,6 +133,21 @@ typedef struct {
 #elif defined(AS_USE_LIBEVENT)
 	struct event watcher;
 	as_socket socket;
+	as_event_read_buffer rbuf;
+#elif defined(AS_USE_IO_URING)
+	as_socket socket;
+	as_event_loop* event_loop;
+	// Receive staging buffer. Bytes in [rbuf_pos, rbuf_len) have not been consumed.
+	uint8_t* rbuf;
+	uint32_t rbuf_pos;
+	uint32_t rbuf_len;
+	// Registered file slot or -1 if socket fd is used directly.
+	int32_t file_index;
+	// Registered buffer slot or -1 if rbuf is heap allocated.
+	int32_t buf_index;
+	// Operations in flight (AS_URING_OP_* bits).
+	uint8_t ops;
+	bool closed;
 #else
 #endif
 	int watching;
@@ -105,6 +157,7 @@ typedef struct {
 typedef struct {
 	as_event_connection base;
 	struct as_event_command* cmd;
+	as_event_loop* event_loop;
 } as_async_connection;
 
 typedef struct {
@@ -123,12 +176,17 @@ typedef struct as_event_command {
 	uv_timer_t timer;
 #elif defined(AS_USE_LIBEVENT)
 	struct event timer;
+#elif defined(AS_USE_IO_URING)
+	as_uring_timer timer;
 #else
 #endif
 	uint64_t total_deadline;
+	uint64_t begin;
 	uint32_t socket_timeout;
 	uint32_t max_retries;
 	uint32_t iteration;
+	uint32_t hedge_delay; // Used only when AS_ASYNC_FLAGS2_HEDGE is set.
+	float hedge_percentile; // Used only when AS_ASYNC_FLAGS2_HEDGE is set.
 	as_policy_replica replica;
 	as_event_loop* event_loop;
 	as_event_connection* conn;
@@ -148,6 +206,7 @@ typedef struct as_event_command {
 	uint32_t read_capacity;
 	uint32_t len;
 	uint32_t pos;
+	uint32_t alloc_size; // Command allocation size. Used to return memory to event loop slab.
 
 	uint8_t type;
 	uint8_t proto_type;
@@ -155,6 +214,8 @@ typedef struct as_event_command {
 	uint8_t state;
 	uint8_t flags;
 	uint8_t flags2;
+	uint8_t replica_index;
+	uint8_t replica_index_sc; // Used in batch only.
 } as_event_command;
 
 typedef struct {
@@ -162,6 +223,20 @@ typedef struct {
 	void* udata;
 } as_event_commander;
 
+typedef struct as_event_slab_s {
+	// Free blocks are linked through their first word.
+	void* blocks[AS_EVENT_SLAB_CLASSES];
+	uint32_t size[AS_EVENT_SLAB_CLASSES];
+	void* conns;
+	uint32_t conns_size;
+} as_event_slab;
+
+typedef struct as_event_submit_slot_s {
+	// Sequence number used to hand off slot ownership between producers and consumer.
+	uint32_t seq;
+	as_event_commander cmd;
+} as_event_submit_slot;
+
 typedef struct as_event_executor {
 	pthread_mutex_t lock;
 	struct as_event_command** commands;
@@ -267,6 +342,30 @@ as_event_create_connections(as_node* node, as_async_conn_pool* pools);
 void
 as_event_close_cluster(as_cluster* cluster);
 
+void*
+as_event_slab_alloc(as_event_loop* event_loop, size_t* size);
+
+void
+as_event_slab_free(as_event_loop* event_loop, void* ptr, size_t size);
+
+void
+as_event_slab_destroy(as_event_slab* slab);
+
+as_async_connection*
+as_event_connection_alloc(as_event_loop* event_loop);
+
+void
+as_event_connection_free(as_event_connection* conn);
+
+bool
+as_event_submit(as_event_loop* event_loop, as_event_commander* qcmd, bool* wakeup);
+
+bool
+as_event_submit_pop(as_event_loop* event_loop, as_event_commander* qcmd);
+
+bool
+as_event_submit_complete(as_event_loop* event_loop, uint32_t count);
+
 /******************************************************************************
  * IMPLEMENTATION SPECIFIC FUNCTIONS
  *****************************************************************************/
@@ -317,6 +416,10 @@ as_event_conn_current_tran(as_event_connection* conn, uint64_t max_socket_idle_n
 static inline int
 as_event_conn_validate(as_event_connection* conn)
 {
+	if (conn->rbuf.pos < conn->rbuf.len) {
+		// Unconsumed bytes from a previous response.
+		return -1;
+	}
 	return as_socket_validate_fd(conn->socket.fd);
 }
 
@@ -324,7 +427,8 @@ static inline void
 as_event_close_connection(as_event_connection* conn)
 {
 	as_socket_close(&conn->socket);
-	cf_free(conn);
+	cf_free(conn->rbuf.data);
+	as_event_connection_free(conn);
 }
 
 static inline void
@@ -515,6 +619,10 @@ as_event_conn_current_tran(as_event_connection* conn, uint64_t max_socket_idle_n
 static inline int
 as_event_conn_validate(as_event_connection* conn)
 {
+	if (conn->rbuf.pos < conn->rbuf.len) {
+		// Unconsumed bytes from a previous response.
+		return -1;
+	}
 	return as_socket_validate_fd(conn->socket.fd);
 }
 
@@ -522,7 +630,8 @@ static inline void
 as_event_close_connection(as_event_connection* conn)
 {
 	as_socket_close(&conn->socket);
-	cf_free(conn);
+	cf_free(conn->rbuf.data);
+	as_event_connection_free(conn);
 }
 
 static inline void
@@ -586,6 +695,104 @@ as_event_command_release(as_event_command* cmd)
 	as_event_command_free(cmd);
 }
 
+/******************************************************************************
+ * IO_URING INLINE FUNCTIONS
+ *****************************************************************************/
+
+#elif defined(AS_USE_IO_URING)
+
+// Connection operation bits. AS_URING_OP_DISPATCH is set while a completion is being
+// processed, so connections closed by callbacks are not freed until processing returns.
+#define AS_URING_OP_READ 1
+#define AS_URING_OP_WRITE 2
+#define AS_URING_OP_CONNECT 4
+#define AS_URING_OP_DISPATCH 8
+#define AS_URING_OP_IO (AS_URING_OP_READ | AS_URING_OP_WRITE | AS_URING_OP_CONNECT)
+
+void as_uring_timer_start(as_event_command* cmd, uint64_t ms);
+void as_uring_timer_stop(as_event_command* cmd);
+void as_uring_cancel(as_event_connection* conn);
+void as_event_close_connection(as_event_connection* conn);
+
+static inline bool
+as_event_conn_current_trim(as_event_connection* conn, uint64_t max_socket_idle_ns)
+{
+	return as_socket_current_trim(conn->socket.last_used, max_socket_idle_ns);
+}
+
+static inline bool
+as_event_conn_current_tran(as_event_connection* conn, uint64_t max_socket_idle_ns)
+{
+	return as_socket_current_tran(conn->socket.last_used, max_socket_idle_ns);
+}
+
+static inline int
+as_event_conn_validate(as_event_connection* conn)
+{
+	// Pipeline connections keep a read in flight while readers are outstanding.
+	// Other pooled connections must be idle with no unconsumed bytes.
+	if (! conn->pipeline &&
+		((conn->ops & AS_URING_OP_IO) || conn->rbuf_pos < conn->rbuf_len)) {
+		return -1;
+	}
+	return as_socket_validate_fd(conn->socket.fd);
+}
+
+static inline void
+as_event_set_conn_last_used(as_event_connection* conn)
+{
+	conn->socket.last_used = cf_getns();
+}
+
+static inline void
+as_event_timer_once(as_event_command* cmd, uint64_t timeout)
+{
+	cmd->timer.repeat = 0;
+	as_uring_timer_start(cmd, timeout);
+	cmd->flags |= AS_ASYNC_FLAGS_HAS_TIMER;
+}
+
+static inline void
+as_event_timer_repeat(as_event_command* cmd, uint64_t repeat)
+{
+	cmd->timer.repeat = (uint32_t)repeat;
+	as_uring_timer_start(cmd, repeat);
+	cmd->flags |= AS_ASYNC_FLAGS_HAS_TIMER | AS_ASYNC_FLAGS_USING_SOCKET_TIMER;
+}
+
+static inline void
+as_event_timer_again(as_event_command* cmd)
+{
+	as_uring_timer_start(cmd, cmd->timer.repeat);
+}
+
+static inline void
+as_event_timer_stop(as_event_command* cmd)
+{
+	if (cmd->flags & AS_ASYNC_FLAGS_HAS_TIMER) {
+		as_uring_timer_stop(cmd);
+	}
+}
+
+static inline void
+as_event_stop_watcher(as_event_command* cmd, as_event_connection* conn)
+{
+	as_uring_cancel(conn);
+	conn->watching = 0;
+}
+
+static inline void
+as_event_stop_read(as_event_connection* conn)
+{
+	// This method only needed for libuv pipelined connections.
+}
+
+static inline void
+as_event_command_release(as_event_command* cmd)
+{
+	as_event_command_free(cmd);
+}
+
 /******************************************************************************
  * EVENT_LIB NOT DEFINED INLINE FUNCTIONS
  *****************************************************************************/
@@ -668,6 +875,18 @@ as_event_assign(as_event_loop* event_loop)
 	return event_loop ? event_loop : as_event_loop_get();
 }
 
+static inline void
+as_event_command_buf_grow(as_event_command* cmd, size_t size)
+{
+	// Replace read buffer with a larger buffer. Capacity is rounded up to the slab size class.
+	if (cmd->flags & AS_ASYNC_FLAGS_FREE_BUF) {
+		as_event_slab_free(cmd->event_loop, cmd->buf, cmd->read_capacity);
+	}
+	cmd->buf = as_event_slab_alloc(cmd->event_loop, &size);
+	cmd->read_capacity = (uint32_t)size;
+	cmd->flags |= AS_ASYNC_FLAGS_FREE_BUF;
+}
+
 static inline void
 as_event_set_auth_write(as_event_command* cmd, as_session* session)
 {
@@ -816,6 +1035,9 @@ as_event_command_destroy(as_event_command* cmd)
 static inline void
 as_event_loop_destroy(as_event_loop* event_loop)
 {
+	cf_free(event_loop->submit_ring);
+	as_event_slab_destroy(event_loop->slab);
+	event_loop->slab = NULL;
 	as_queue_destroy(&event_loop->queue);
 	as_queue_destroy(&event_loop->delay_queue);
 	as_queue_destroy(&event_loop->pipe_cb_queue);
@@ -228,6 +228,14 @@ typedef struct as_key_s {
 	 */
 	as_digest digest;
 
+	/**
+	 * Optional namespace handle returned by aerospike_namespace_handle(). When set, the
+	 * partition table is found by index instead of comparing namespace names. Handles are
+	 * only valid for the aerospike instance that resolved them. A handle that does not refer
+	 * to this key's namespace falls back to the name lookup. Zero means not resolved.
+	 */
+	uint32_t ns_handle;
+
 } as_key;
 
 /******************************************************************************
@@ -689,6 +697,31 @@ as_key_digest(as_key* key);
 AS_EXTERN as_status
 as_key_set_digest(as_error* err, as_key* key);
 
+/**
+ * Set the digest value in an array of keys.  Digests are computed several keys at a time
+ * using SIMD instructions when available, which is significantly faster than calling
+ * as_key_set_digest() for each key.  Keys with a digest already set are skipped.
+ *
+ * @param err 		Error message that is populated on error.
+ * @param keys 		The keys to set digests for.
+ * @param n_keys	The number of keys.
+ *
+ * @return Status code.
+ *
+ * @relates as_key
+ * @ingroup as_key_object
+ */
+AS_EXTERN as_status
+as_key_set_digests(as_error* err, as_key* keys, uint32_t n_keys);
+
+/**
+ * @private
+ * Set the digest value in keys that are embedded in larger structures.  The first key
+ * starts at keys and each following key starts stride bytes after the previous key.
+ */
+AS_EXTERN as_status
+as_key_set_digests_stride(as_error* err, void* keys, uint32_t n_keys, size_t stride);
+
 #ifdef __cplusplus
 } // end extern "C"
 #endif
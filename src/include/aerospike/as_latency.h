@@ -0,0 +1,139 @@
+/*
+ * Copyright 2008-2021 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#pragma once
+
+#include <aerospike/as_atomic.h>
+#include <aerospike/as_std.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * MACROS
+ *****************************************************************************/
+
+/**
+ * Number of latency histogram buckets. Bucket 0 counts commands that completed in
+ * less than 1 microsecond. Bucket N (N > 0) counts commands that completed in
+ * [2^(N-1), 2^N) microseconds. The last bucket also counts all longer commands.
+ *
+ * @ingroup cluster_stats
+ */
+#define AS_LATENCY_BUCKETS 26
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+/**
+ * Command class used to categorize latency histograms.
+ *
+ * @ingroup cluster_stats
+ */
+typedef enum as_latency_type_e {
+	AS_LATENCY_TYPE_READ,
+	AS_LATENCY_TYPE_WRITE,
+	AS_LATENCY_TYPE_BATCH,
+	AS_LATENCY_TYPE_SCAN,
+	AS_LATENCY_TYPE_QUERY,
+	AS_LATENCY_TYPE_UDF,
+	AS_LATENCY_TYPE_INFO,
+
+	/**
+	 * Number of latency types. Also used to denote commands that are not tracked.
+	 */
+	AS_LATENCY_TYPE_MAX
+} as_latency_type;
+
+/**
+ * Fixed bucket latency histogram. Buckets are exponential powers of 2 in microseconds.
+ * Counters are only incremented with atomic operations, so histograms can be updated
+ * concurrently without locks.
+ *
+ * @ingroup cluster_stats
+ */
+typedef struct as_latency_buckets_s {
+	/**
+	 * Command counts per bucket.
+	 */
+	uint64_t buckets[AS_LATENCY_BUCKETS];
+
+} as_latency_buckets;
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * @private
+ * Add elapsed time in nanoseconds to latency histogram.
+ */
+static inline void
+as_latency_add(as_latency_buckets* latency, uint64_t elapsed_ns)
+{
+	uint64_t us = elapsed_ns / 1000;
+	uint32_t index = 0;
+
+	while (us > 0 && index < AS_LATENCY_BUCKETS - 1) {
+		us >>= 1;
+		index++;
+	}
+	as_incr_uint64(&latency->buckets[index]);
+}
+
+/**
+ * @private
+ * Copy latency histogram counters without locking.
+ */
+static inline void
+as_latency_copy(as_latency_buckets* trg, as_latency_buckets* src)
+{
+	for (uint32_t i = 0; i < AS_LATENCY_BUCKETS; i++) {
+		trg->buckets[i] = as_load_uint64(&src->buckets[i]);
+	}
+}
+
+/**
+ * Return total number of commands counted in latency histogram.
+ *
+ * @ingroup cluster_stats
+ */
+AS_EXTERN uint64_t
+as_latency_count(const as_latency_buckets* latency);
+
+/**
+ * Return latency upper bound in microseconds for the given percentile (0.0 - 100.0).
+ * For example, as_latency_percentile(latency, 99.9) returns the p999 latency.
+ * Return zero if no commands have been counted.
+ *
+ * @ingroup cluster_stats
+ */
+AS_EXTERN uint64_t
+as_latency_percentile(const as_latency_buckets* latency, double percentile);
+
+/**
+ * Return latency type name.
+ *
+ * @ingroup cluster_stats
+ */
+AS_EXTERN const char*
+as_latency_type_string(as_latency_type type);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
@@ -21,6 +21,7 @@
 #include <aerospike/as_conn_pool.h>
 #include <aerospike/as_error.h>
 #include <aerospike/as_event.h>
+#include <aerospike/as_latency.h>
 #include <aerospike/as_socket.h>
 #include <aerospike/as_partition.h>
 #include <aerospike/as_queue.h>
@@ -233,6 +234,12 @@ typedef struct as_node_s {
 	 * TLS certificate name (needed for TLS only, NULL otherwise).
 	 */
 	char* tls_name;
+
+	/**
+	 * @private
+	 * TLS session resumed by new connections to this node.
+	 */
+	as_tls_session tls_session;
 	
 	/**
 	 * The name of the node.
@@ -290,6 +297,11 @@ typedef struct as_node_s {
 	 */
 	as_session* session;
 
+	/**
+	 * Command latency histograms indexed by as_latency_type.
+	 */
+	as_latency_buckets latency[AS_LATENCY_TYPE_MAX];
+
 	/**
 	 * Racks data.
 	 */
@@ -320,6 +332,32 @@ typedef struct as_node_s {
 	 */
 	uint32_t error_count;
 
+	/**
+	 * Single record commands currently in progress on this node when the adaptive
+	 * concurrency limiter is enabled.
+	 */
+	uint32_t concurrency;
+
+	/**
+	 * Current adaptive concurrency limit.
+	 */
+	uint32_t concurrency_limit;
+
+	/**
+	 * Fast commands completed since the concurrency limit last changed.
+	 */
+	uint32_t concurrency_successes;
+
+	/**
+	 * Total commands rejected by the adaptive concurrency limit.
+	 */
+	uint32_t concurrency_rejected;
+
+	/**
+	 * Time in nanoseconds when the concurrency limit was last decreased.
+	 */
+	uint64_t concurrency_decreased;
+
 	/**
 	 * Server's generation count for peers.
 	 */
@@ -409,6 +447,50 @@ typedef struct as_node_info_s {
 
 } as_node_info;
 
+/**
+ * @private
+ * Info request type sent by cluster tend.
+ */
+typedef enum as_node_tend_type_e {
+	AS_NODE_TEND_REFRESH,
+	AS_NODE_TEND_PEERS,
+	AS_NODE_TEND_PARTITIONS,
+	AS_NODE_TEND_RACKS
+} as_node_tend_type;
+
+/**
+ * @private
+ * Info request sent by cluster tend.  The response is read on a tend pool thread and
+ * processed later on the tend thread, so only network round trips run in parallel.
+ */
+typedef struct as_node_tend_request_s {
+	/**
+	 * Target node.
+	 */
+	as_node* node;
+
+	/**
+	 * Heap allocated response.  Freed by processing.
+	 */
+	char* response;
+
+	/**
+	 * Fetch error.
+	 */
+	as_error err;
+
+	/**
+	 * Fetch status.
+	 */
+	as_status status;
+
+	/**
+	 * Request type.
+	 */
+	as_node_tend_type type;
+
+} as_node_tend_request;
+
 /******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
@@ -564,6 +646,26 @@ as_node_put_connection(as_node* node, as_socket* sock)
 	}
 }
 
+/**
+ * @private
+ * Add elapsed time since begin_ns to node's latency histogram for the given command type.
+ */
+static inline void
+as_node_add_latency(as_node* node, uint8_t type, uint64_t begin_ns)
+{
+	if (type < AS_LATENCY_TYPE_MAX) {
+		as_latency_add(&node->latency[type], cf_getns() - begin_ns);
+	}
+}
+
+/**
+ * @private
+ * Return milliseconds to wait for a read response from this node before hedging the read to
+ * another replica. Return zero if the read should not be hedged.
+ */
+uint32_t
+as_node_hedge_delay(as_node* node, uint32_t hedge_delay, double hedge_percentile);
+
 /**
  * @private
  * Balance sync connections.
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2008-2021 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#pragma once
+
+#include <aerospike/as_error.h>
+#include <aerospike/as_std.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+/**
+ * @private
+ * Parse one response block on a parse thread. Message headers have already been
+ * swapped to host byte order by the socket reader.
+ */
+typedef as_status (*as_parse_pool_fn)(as_error* err, uint8_t* buf, size_t size, void* udata);
+
+struct as_parse_pool_s;
+struct as_parse_stream_s;
+
+/**
+ * @private
+ * Response block copied from the socket reader's buffer.
+ */
+typedef struct as_parse_block_s {
+	struct as_parse_stream_s* stream;
+	uint8_t* buf;
+	size_t size;
+} as_parse_block;
+
+/**
+ * @private
+ * Bounded block queue owned by a single parse thread.
+ */
+typedef struct as_parse_queue_s {
+	struct as_parse_pool_s* pool;
+	as_parse_block* blocks;
+	pthread_cond_t not_empty;
+	pthread_t thread;
+	uint32_t head;
+	uint32_t size;
+} as_parse_queue;
+
+/**
+ * @private
+ * Pool of threads that parse response blocks handed off by sync scan/query socket
+ * readers. Readers block when the target queue is full, so a slow callback applies
+ * backpressure to the socket instead of growing memory without bound.
+ */
+typedef struct as_parse_pool_s {
+	pthread_mutex_t lock;
+	pthread_cond_t not_full;
+	pthread_cond_t drained;
+	as_parse_queue* queues;
+	as_parse_pool_fn fn;
+	uint32_t n_threads;
+	uint32_t capacity;
+	uint32_t next;
+	bool ordered;
+	bool closing;
+} as_parse_pool;
+
+/**
+ * @private
+ * Response stream of one node command. All blocks of a stream are parsed by the same
+ * thread when the pool is ordered, so records of a partition are delivered in the order
+ * they were received.
+ */
+typedef struct as_parse_stream_s {
+	as_parse_pool* pool;
+	void* udata;
+	as_error err;
+	as_status status;
+	uint32_t queue;
+	uint32_t pending;
+	bool ordered;
+} as_parse_stream;
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * @private
+ * Start parse threads. Each thread's queue holds up to capacity blocks.
+ */
+as_status
+as_parse_pool_init(
+	as_parse_pool* pool, as_error* err, uint32_t n_threads, uint32_t capacity, bool ordered,
+	as_parse_pool_fn fn
+	);
+
+/**
+ * @private
+ * Stop and join parse threads. All streams must be drained first.
+ */
+void
+as_parse_pool_destroy(as_parse_pool* pool);
+
+/**
+ * @private
+ * Initialize stream for a node command.
+ */
+void
+as_parse_stream_init(as_parse_pool* pool, as_parse_stream* stream, void* udata);
+
+/**
+ * @private
+ * Copy block and queue it for parsing. Block until there is room in the queue.
+ * Return the stream's error if a previous block failed to parse.
+ */
+as_status
+as_parse_stream_push(as_parse_stream* stream, as_error* err, uint8_t* buf, size_t size);
+
+/**
+ * @private
+ * Wait for all queued blocks of the stream to be parsed and return the first parse error.
+ */
+as_status
+as_parse_stream_drain(as_parse_stream* stream, as_error* err);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
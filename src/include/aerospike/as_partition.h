@@ -39,6 +39,12 @@ extern "C" {
  */
 #define AS_MAX_NAMESPACE_SIZE 32
 
+/**
+ * Maximum number of replicas (master plus proles) tracked per partition.
+ * Replicas beyond this limit are ignored.
+ */
+#define AS_MAX_REPLICAS 4
+
 /******************************************************************************
  * TYPES
  *****************************************************************************/
@@ -49,13 +55,11 @@ struct as_key_s;
 
 /**
  * @private
- * Map of namespace data partitions to nodes.
- *
- * TODO - not ideal for replication factor > 2.
+ * Map of namespace data partitions to nodes. nodes[0] is the master and the remaining
+ * entries are proles in server replica order.
  */
 typedef struct as_partition_s {
-	struct as_node_s* master;
-	struct as_node_s* prole;
+	struct as_node_s* nodes[AS_MAX_REPLICAS];
 	uint32_t regime;
 } as_partition;
 
@@ -67,7 +71,8 @@ typedef struct as_partition_table_s {
 	char ns[AS_MAX_NAMESPACE_SIZE];
 	uint32_t size;
 	bool sc_mode;
-	char pad[3];
+	uint8_t replica_size;
+	char pad[2];
 	as_partition partitions[];
 } as_partition_table;
 
@@ -130,6 +135,15 @@ as_partition_info_init(
 	const struct as_key_s* key
 	);
 
+/**
+ * @private
+ * Resolve namespace to handle (partition table index + 1).
+ */
+as_status
+as_partition_namespace_handle(
+	struct as_cluster_s* cluster, struct as_error_s* err, const char* ns, uint32_t* handle
+	);
+
 /**
  * @private
  * Log all partition maps in the cluster.
@@ -45,6 +45,7 @@ typedef struct as_node_partitions_s {
 	as_vector parts_partial;
 	uint64_t record_count;
 	uint64_t record_max;
+	uint32_t records_per_second;
 	uint32_t parts_requested;
 	uint32_t parts_received;
 } as_node_partitions;
@@ -61,6 +62,8 @@ typedef struct as_partition_tracker_s {
 	as_vector* errors;
 	uint64_t max_records;
 	uint32_t parts_capacity;
+	uint32_t node_parallelism;
+	uint32_t records_per_second;
 	uint32_t sleep_between_retries;
 	uint32_t socket_timeout;
 	uint32_t total_timeout;
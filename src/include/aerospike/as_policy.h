@@ -280,7 +280,7 @@ typedef enum as_policy_replica_e {
 
 	/**
 	 * Distribute reads across nodes containing key's master and replicated partition
-	 * in round-robin fashion.  Currently restricted to master and one prole.
+	 * in round-robin fashion.  Up to AS_MAX_REPLICAS replicas are used.
 	 */
 	AS_POLICY_REPLICA_ANY,
 
@@ -288,8 +288,8 @@ typedef enum as_policy_replica_e {
 	 * Try node containing master partition first.
 	 * If connection fails, all commands try nodes containing replicated partitions.
 	 * If socketTimeout is reached, reads also try nodes containing replicated partitions,
-	 * but writes remain on master node.
-	 * Currently restricted to master and one prole.
+	 * but writes remain on master node.  Each retry moves to the next replica, cycling
+	 * through up to AS_MAX_REPLICAS replicas.
 	 */
 	AS_POLICY_REPLICA_SEQUENCE,
 
@@ -566,6 +566,15 @@ typedef struct as_policy_read_s {
 	 */
 	bool deserialize;
 
+	/**
+	 * Allocate the bin array and all variable length bin values (strings, geojson, blobs and
+	 * undeserialized lists/maps) of the returned record in a single block owned by the record.
+	 * This replaces one heap allocation per bin value with one allocation per record.
+	 * Bin values point into that block, so they are only valid until the record is destroyed.
+	 * Default: false
+	 */
+	bool record_arena;
+
 	/**
 	 * Should as_record instance be allocated on the heap before user listener is called in
 	 * async commands. If true, the user is responsible for calling as_record_destroy() when done
@@ -575,6 +584,27 @@ typedef struct as_policy_read_s {
 	 */
 	bool async_heap_rec;
 
+	/**
+	 * Milliseconds to wait for the first response before sending the same read to the next
+	 * replica (hedged read). The first response to arrive is used and the other connection
+	 * is closed. Hedging is performed at most once per command and only when replica is not
+	 * AS_POLICY_REPLICA_MASTER. Async commands have only one connection, so an async hedge
+	 * abandons the slow attempt and sends the read to the next replica.
+	 *
+	 * If zero and hedge_percentile is also zero, reads are not hedged.
+	 * Default: 0
+	 */
+	uint32_t hedge_delay;
+
+	/**
+	 * Use the target node's read latency percentile (0.0 - 100.0) as the hedge delay once the
+	 * node has enough latency samples. If hedge_delay is also set, it caps the percentile
+	 * delay. For example, 99.0 hedges reads that are slower than the node's p99 latency.
+	 *
+	 * Default: 0.0 (use hedge_delay only)
+	 */
+	double hedge_percentile;
+
 } as_policy_read;
 	
 /**
@@ -743,6 +773,15 @@ typedef struct as_policy_operate_s {
 	 */
 	bool deserialize;
 
+	/**
+	 * Allocate the bin array and all variable length bin values (strings, geojson, blobs and
+	 * undeserialized lists/maps) of the returned record in a single block owned by the record.
+	 * This replaces one heap allocation per bin value with one allocation per record.
+	 * Bin values point into that block, so they are only valid until the record is destroyed.
+	 * Default: false
+	 */
+	bool record_arena;
+
 	/**
 	 * If the transaction results in a record deletion, leave a tombstone for the record.
 	 * This prevents deleted records from reappearing after node failures.
@@ -841,6 +880,20 @@ typedef struct as_policy_batch_s {
 	 */
 	as_policy_read_mode_sc read_mode_sc;
 
+	/**
+	 * Maximum number of keys processed at once by aerospike_batch_get(),
+	 * aerospike_batch_get_bins(), aerospike_batch_get_ops() and aerospike_batch_exists().
+	 * If greater than zero and the batch contains more keys, the keys are split into
+	 * consecutive chunks of at most this size. Each chunk is sent to the server nodes as
+	 * separate sub-batches and the callback is called once per chunk with only that
+	 * chunk's results. Record memory is released after each callback returns, so client
+	 * memory is bounded by the chunk size instead of the batch size. If the callback returns
+	 * false, the remaining chunks are skipped and AEROSPIKE_ERR_CLIENT_ABORT is returned.
+	 *
+	 * Default: 0 (process all keys at once)
+	 */
+	uint32_t max_chunk_keys;
+
 	/**
 	 * Determine if batch commands to each server are run in parallel threads.
 	 *
@@ -891,6 +944,14 @@ typedef struct as_policy_batch_s {
 	 */
 	bool deserialize;
 
+	/**
+	 * Allocate the bin array and all variable length bin values (strings, geojson, blobs and
+	 * undeserialized lists/maps) of each returned record in a single block owned by that record.
+	 * Bin values point into that block, so they are only valid until the record is destroyed.
+	 * Default: false
+	 */
+	bool record_arena;
+
 } as_policy_batch;
 	
 /**
@@ -914,6 +975,48 @@ typedef struct as_policy_query_s {
 	 */
 	uint32_t info_timeout;
 
+	/**
+	 * Number of threads that parse records and run the callback for foreground sync queries.
+	 * When greater than zero, socket reader threads only frame each response block and hand it
+	 * to these threads through a bounded queue, so a slow callback or expensive list/map
+	 * deserialization does not stall the socket and cause server side timeouts. The callback
+	 * may be called concurrently from multiple parse threads.
+	 *
+	 * Default: 0 (parse records on the socket reader thread)
+	 */
+	uint32_t parse_threads;
+
+	/**
+	 * Maximum response blocks queued per parse thread. Socket readers block when the queue
+	 * is full. Only used when parse_threads is greater than zero.
+	 *
+	 * Default: 16
+	 */
+	uint32_t parse_queue_size;
+
+	/**
+	 * Number of client side Lua states that reduce values returned by the servers in
+	 * aerospike_query_foreach() when as_query.apply is set. Each state reduces its share of
+	 * values with the as_query_apply_merge() function. Partial results are then merged in a
+	 * tree of merge states (at most 4 inputs each), and a final state runs the client side
+	 * stage of the apply function once. Stages after reduce() therefore run exactly once.
+	 *
+	 * Values greater than 1 require as_query_apply_merge(). Otherwise, the query fails with
+	 * AEROSPIKE_ERR_PARAM.
+	 *
+	 * Default: 1
+	 */
+	uint32_t aggregate_threads;
+
+	/**
+	 * Maximum values buffered in each client side aggregation input stream. Query socket
+	 * readers block when the stream is full, so memory stays bounded when the Lua
+	 * aggregation falls behind.
+	 *
+	 * Default: 4096
+	 */
+	uint32_t aggregate_queue_size;
+
 	/**
 	 * Terminate query if cluster is in migration state. If query where clause not 
 	 * defined (scan), this field is ignored.
@@ -930,6 +1033,24 @@ typedef struct as_policy_query_s {
 	 */
 	bool deserialize;
 
+	/**
+	 * Parse all response blocks of a node command on the same parse thread, so
+	 * records from the same node are delivered in the order they were received. If false,
+	 * blocks are handed to the least busy parse thread. Only used when parse_threads is
+	 * greater than zero.
+	 *
+	 * Default: true
+	 */
+	bool parse_ordered;
+
+	/**
+	 * Allocate the bin array and all variable length bin values (strings, geojson, blobs and
+	 * undeserialized lists/maps) of each returned record in a single block owned by that record.
+	 * Bin values point into that block, so they are only valid until the record is destroyed.
+	 * Default: false
+	 */
+	bool record_arena;
+
 } as_policy_query;
 
 /**
@@ -962,6 +1083,39 @@ typedef struct as_policy_scan_s {
 	 */
 	uint32_t records_per_second;
 
+	/**
+	 * Maximum number of concurrent sub-scans per node for partition scans. Each node's
+	 * partitions are divided evenly across the sub-scans, which run on separate connections
+	 * and threads (or async commands). This spreads record parsing and callbacks over more
+	 * client cores. Only used when as_scan.concurrent is true.
+	 *
+	 * The server applies records_per_second to each scan command, so when a node is split
+	 * into sub-scans, records_per_second is divided across that node's sub-scans (rounded up).
+	 * The combined rate per node stays at the configured limit.
+	 *
+	 * Default: 1 (one scan command per node)
+	 */
+	uint32_t node_parallelism;
+
+	/**
+	 * Number of threads that parse records and run the callback for foreground sync scans.
+	 * When greater than zero, socket reader threads only frame each response block and hand it
+	 * to these threads through a bounded queue, so a slow callback or expensive list/map
+	 * deserialization does not stall the socket and cause server side timeouts. The callback
+	 * may be called concurrently from multiple parse threads.
+	 *
+	 * Default: 0 (parse records on the socket reader thread)
+	 */
+	uint32_t parse_threads;
+
+	/**
+	 * Maximum response blocks queued per parse thread. Socket readers block when the queue
+	 * is full. Only used when parse_threads is greater than zero.
+	 *
+	 * Default: 16
+	 */
+	uint32_t parse_queue_size;
+
 	/**
 	 * If the transaction results in a record deletion, leave a tombstone for the record.
 	 * This prevents deleted records from reappearing after node failures.
@@ -971,6 +1125,27 @@ typedef struct as_policy_scan_s {
 	 */
 	bool durable_delete;
 
+	/**
+	 * Parse all response blocks of a node command on the same parse thread, so
+	 * records of a partition are delivered in the order they were received. If false,
+	 * blocks are handed to the least busy parse thread. Only used when parse_threads is
+	 * greater than zero.
+	 *
+	 * Partition scans always parse each node command's blocks in order, because partition
+	 * status is updated as records are delivered and must not run ahead of delivery.
+	 *
+	 * Default: true
+	 */
+	bool parse_ordered;
+
+	/**
+	 * Allocate the bin array and all variable length bin values (strings, geojson, blobs and
+	 * undeserialized lists/maps) of each returned record in a single block owned by that record.
+	 * Bin values point into that block, so they are only valid until the record is destroyed.
+	 * Default: false
+	 */
+	bool record_arena;
+
 } as_policy_scan;
 
 /**
@@ -1151,7 +1326,10 @@ as_policy_read_init(as_policy_read* p)
 	p->read_mode_ap = AS_POLICY_READ_MODE_AP_DEFAULT;
 	p->read_mode_sc = AS_POLICY_READ_MODE_SC_DEFAULT;
 	p->deserialize = true;
+	p->record_arena = false;
 	p->async_heap_rec = false;
+	p->hedge_delay = 0;
+	p->hedge_percentile = 0.0;
 	return p;
 }
 
@@ -1225,6 +1403,7 @@ as_policy_operate_init(as_policy_operate* p)
 	p->gen = AS_POLICY_GEN_DEFAULT;
 	p->exists = AS_POLICY_EXISTS_DEFAULT;
 	p->deserialize = true;
+	p->record_arena = false;
 	p->durable_delete = false;
 	p->async_heap_rec = false;
 	return p;
@@ -1328,10 +1507,12 @@ as_policy_batch_init(as_policy_batch* p)
 	p->replica = AS_POLICY_REPLICA_SEQUENCE;
 	p->read_mode_ap = AS_POLICY_READ_MODE_AP_DEFAULT;
 	p->read_mode_sc = AS_POLICY_READ_MODE_SC_DEFAULT;
+	p->max_chunk_keys = 0;
 	p->concurrent = false;
 	p->allow_inline = true;
 	p->send_set_name = false;
 	p->deserialize = true;
+	p->record_arena = false;
 	return p;
 }
 
@@ -1363,7 +1544,12 @@ as_policy_scan_init(as_policy_scan* p)
 	as_policy_base_query_init(&p->base);
 	p->max_records = 0;
 	p->records_per_second = 0;
+	p->node_parallelism = 1;
+	p->parse_threads = 0;
+	p->parse_queue_size = 16;
 	p->durable_delete = false;
+	p->parse_ordered = true;
+	p->record_arena = false;
 	return p;
 }
 
@@ -1394,8 +1580,14 @@ as_policy_query_init(as_policy_query* p)
 {
 	as_policy_base_query_init(&p->base);
 	p->info_timeout = 10000;
+	p->parse_threads = 0;
+	p->parse_queue_size = 16;
+	p->aggregate_threads = 1;
+	p->aggregate_queue_size = 4096;
 	p->fail_on_cluster_change = false;
 	p->deserialize = true;
+	p->parse_ordered = true;
+	p->record_arena = false;
 	return p;
 }
 
@@ -512,6 +512,14 @@ typedef struct as_query_s {
 	 */
 	as_udf_call apply;
 
+	/**
+	 * Stream function in the apply module that merges partial aggregation results when
+	 * as_policy_query.aggregate_threads is greater than 1.
+	 *
+	 * Should be set via `as_query_apply_merge()`.
+	 */
+	as_udf_function_name apply_merge;
+
 	/**
 	 * Perform write operations on a background query.
 	 * If ops is set, ops will be destroyed when as_query_destroy() is called.
@@ -852,6 +860,35 @@ as_query_predexp_add(as_query* query, as_predexp_base * predexp);
 AS_EXTERN bool
 as_query_apply(as_query* query, const char* module, const char* function, const as_list* arglist);
 
+/**
+ * Set the stream function used to merge partial results of parallel client side aggregation
+ * (as_policy_query.aggregate_threads > 1). The function must be in the same module as the
+ * apply function and must only reduce its input stream with the same reduce function as the
+ * apply function. The apply function arglist is also passed to the merge function.
+ *
+ * ~~~~~~~~~~{.c}
+ * // Lua module "my_module":
+ * //   function sum(s) return s : map(get_e) : reduce(add) : map(format) end
+ * //   function sum_merge(s) return s : reduce(add) end
+ *
+ * as_query_apply(&query, "my_module", "sum", NULL);
+ * as_query_apply_merge(&query, "sum_merge");
+ * ~~~~~~~~~~
+ *
+ * Each aggregation state merges its share of server results with the merge function.
+ * Partial results are then merged in a tree, and only the final state runs the client side
+ * stage of the apply function, so stages after reduce() run exactly once.
+ *
+ * @param query			The query.
+ * @param function		The merge function in the apply module.
+ *
+ * @return On success, true. Otherwise an error occurred.
+ *
+ * @relates as_query
+ */
+AS_EXTERN bool
+as_query_apply_merge(as_query* query, const char* function);
+
 #ifdef __cplusplus
 } // end extern "C"
 #endif
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2008-2021 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#pragma once
+
+#include <aerospike/as_std.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * MACROS
+ *****************************************************************************/
+
+/**
+ * @private
+ * Number of messages hashed in parallel by one multi-buffer pass.
+ */
+#if defined(__AVX2__)
+#define AS_RIPEMD160_LANES 8
+#else
+#define AS_RIPEMD160_LANES 4
+#endif
+
+/**
+ * @private
+ * Maximum message size in bytes hashed by the multi-buffer path. Longer messages fall back to
+ * the scalar implementation. Must leave room for padding in AS_RIPEMD160_MAX_BLOCKS blocks.
+ */
+#define AS_RIPEMD160_MAX_BLOCKS 4
+#define AS_RIPEMD160_MAX_SIZE (AS_RIPEMD160_MAX_BLOCKS * 64 - 9)
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+/**
+ * @private
+ * RIPEMD-160 input message composed of two consecutive segments (data1 followed by data2),
+ * identical to the input of cf_digest_compute2().
+ */
+typedef struct as_ripemd160_input_s {
+	const uint8_t* data1;
+	size_t len1;
+	const uint8_t* data2;
+	size_t len2;
+	uint8_t* digest;
+} as_ripemd160_input;
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * @private
+ * Compute RIPEMD-160 digests for many messages. Messages are hashed AS_RIPEMD160_LANES at a
+ * time using SIMD vector instructions when the compiler supports them. Each 20 byte digest is
+ * written to its input's digest pointer.
+ */
+void
+as_ripemd160_compute_many(const as_ripemd160_input* inputs, uint32_t n_inputs);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
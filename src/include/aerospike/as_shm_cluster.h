@@ -92,20 +92,15 @@ typedef struct as_node_shm_s {
 
 /**
  * @private
- * Shared memory representation of map of namespace data partitions to nodes. 16 bytes.
+ * Shared memory representation of map of namespace data partitions to nodes. 24 bytes.
  */
 typedef struct as_partition_shm_s {
 	/**
 	 * @private
-	 * Master node index offset.
+	 * Node index offsets. nodes[0] is the master and the remaining entries are proles
+	 * in server replica order.
 	 */
-	uint32_t master;
-
-	/**
-	 * @private
-	 * Prole node index offset.
-	 */
-	uint32_t prole;
+	uint32_t nodes[AS_MAX_REPLICAS];
 
 	/**
 	 * @private
@@ -137,11 +132,17 @@ typedef struct as_partition_table_shm_s {
 	 */
 	uint8_t sc_mode;
 
+	/**
+	 * @private
+	 * Number of replicas tracked in each partition.
+	 */
+	uint8_t replica_size;
+
 	/**
 	 * @private
 	 * Pad to 8 byte boundary.
 	 */
-	char pad[7];
+	char pad[6];
 
 	/**
 	 * @private
@@ -353,7 +354,7 @@ as_shm_find_partition_table(as_cluster_shm* cluster_shm, const char* ns);
 void
 as_shm_update_partitions(
 	as_shm_info* shm_info, const char* ns, char* bitmap_b64, int64_t len, as_node* node,
-	bool master, uint32_t regime
+	uint32_t replica_index, uint32_t replica_size, uint32_t regime
 	);
 
 /**
@@ -55,6 +55,7 @@ extern "C" {
 #endif
 
 struct ssl_ctx_st;
+struct ssl_session_st;
 struct evp_pkey_st;
 
 /**
@@ -66,13 +67,35 @@ typedef struct as_tls_context_s {
 	struct ssl_ctx_st* ssl_ctx;
 	struct evp_pkey_st* pkey;
 	void* cert_blacklist;
+	uint32_t session_gen;
 	bool log_session_info;
 	bool for_login_only;
+	bool session_resumption;
 } as_tls_context;
 
+/**
+ * @private
+ * Last resumable TLS session received from a server node.  New connections to the node
+ * resume this session instead of performing a full handshake.
+ */
+typedef struct as_tls_session_s {
+	pthread_mutex_t lock;
+	struct ssl_session_st* session;
+	uint32_t gen;
+} as_tls_session;
+
 struct as_conn_pool_s;
 struct as_node_s;
 
+/**
+ * @private
+ * Scatter/gather write segment.
+ */
+typedef struct as_socket_iov_s {
+	uint8_t* data;
+	size_t len;
+} as_socket_iov;
+
 /**
  * Socket fields for both regular and TLS sockets.
  */
@@ -242,6 +265,19 @@ as_socket_write_deadline(
 	uint32_t socket_timeout, uint64_t deadline
 	);
 
+/**
+ * @private
+ * Write multiple data segments with future deadline in milliseconds.
+ * Non-TLS sockets write all segments with as few writev()/sendmsg() calls as possible.
+ * TLS sockets coalesce small segments into full TLS records and write large segments directly.
+ * If deadline is zero, do not set deadline.
+ */
+as_status
+as_socket_writev_deadline(
+	as_error* err, as_socket* sock, struct as_node_s* node, as_socket_iov* iov, uint32_t iov_size,
+	uint32_t socket_timeout, uint64_t deadline
+	);
+
 /**
  * @private
  * Read socket data with future deadline in milliseconds.
@@ -32,6 +32,11 @@ typedef enum as_status_e {
 	/***************************************************************************
 	 * Client Errors
 	 **************************************************************************/
+	/**
+	 * Node adaptive concurrency limit reached.
+	 */
+	AEROSPIKE_ERR_CONCURRENCY_LIMIT = -15,
+
 	/**
 	 * Max errors limit reached.
 	 */
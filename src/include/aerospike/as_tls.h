@@ -45,6 +45,12 @@ void as_tls_set_name(as_socket* sock, const char* tls_name);
 struct ssl_st;
 void as_tls_set_context_name(struct ssl_st* ssl, as_tls_context* ctx, const char* tls_name);
 
+void as_tls_session_init(as_tls_session* session);
+
+void as_tls_session_destroy(as_tls_session* session);
+
+void as_tls_set_session(struct ssl_st* ssl, as_tls_context* ctx, as_tls_session* session);
+
 int as_tls_connect_once(as_socket* sock);
 
 int as_tls_connect(as_socket* sock, uint64_t deadline);
@@ -259,6 +259,13 @@ aerospike_cluster_is_connected(aerospike* as)
 	return as_cluster_is_connected(as->cluster);
 }
 
+as_status
+aerospike_namespace_handle(aerospike* as, as_error* err, const char* ns, uint32_t* handle)
+{
+	as_error_reset(err);
+	return as_partition_namespace_handle(as->cluster, err, ns, handle);
+}
+
 extern bool as_socket_stop_on_interrupt;
 
 void
@@ -43,6 +43,21 @@ typedef struct as_batch_node_s {
 	as_vector offsets;
 } as_batch_node;
 
+// Maximum partitions supported by batch partition map. Larger partition counts
+// fall back to resolving each key's node individually.
+#define AS_BATCH_MAP_PARTITIONS 4096
+
+// Minimum number of keys in a batch to use the batch partition map.
+#define AS_BATCH_MAP_MIN_KEYS 32
+
+typedef struct as_batch_partition_map_s {
+	const char* ns;
+	uint32_t n_partitions;
+	uint32_t partition_id;  // Partition of last key mapped. UINT32_MAX if not cached.
+	bool enabled;
+	uint16_t nodes[AS_BATCH_MAP_PARTITIONS];  // Batch node index + 1. Zero if not resolved.
+} as_batch_partition_map;
+
 typedef struct as_batch_task_s {
 	as_node* node;
 	as_vector offsets;
@@ -65,7 +80,6 @@ typedef struct as_batch_task_keys_s {
 	as_batch_task base;
 	const char* ns;
 	as_key* keys;
-	const as_batch* batch;
 	as_batch_read* results;
 	aerospike_batch_read_callback callback;
 	as_batch_callback_xdr callback_xdr;
@@ -137,12 +151,15 @@ as_batch_parse_fields(uint8_t* p, uint32_t n_fields)
 }
 
 static inline as_status
-as_batch_parse_record(uint8_t** pp, as_error* err, as_msg* msg, as_record* rec, bool deserialize)
+as_batch_parse_record(
+	uint8_t** pp, as_error* err, as_msg* msg, as_record* rec, bool deserialize, bool arena
+	)
 {
-	as_record_init(rec, msg->n_ops);
+	// Arena mode allocates bin array together with bin values.
+	as_record_init(rec, arena ? 0 : msg->n_ops);
 	rec->gen = msg->generation;
 	rec->ttl = cf_server_void_time_to_ttl(msg->record_ttl);
-	return as_command_parse_bins(pp, err, rec, msg->n_ops, deserialize);
+	return as_command_parse_bins(pp, err, rec, msg->n_ops, deserialize, arena);
 }
 
 static void
@@ -232,7 +249,8 @@ as_batch_async_parse_records(as_event_command* cmd)
 		
 		if (msg->result_code == AEROSPIKE_OK) {
 			as_status status = as_batch_parse_record(&p, &err, msg, &record->record,
-													 cmd->flags2 & AS_ASYNC_FLAGS2_DESERIALIZE);
+													 cmd->flags2 & AS_ASYNC_FLAGS2_DESERIALIZE,
+													 cmd->flags2 & AS_ASYNC_FLAGS2_RECORD_ARENA);
 
 			if (status != AEROSPIKE_OK) {
 				as_event_response_error(cmd, &err);
@@ -248,6 +266,7 @@ as_batch_parse_records(as_error* err, as_node* node, uint8_t* buf, size_t size,
 {
 	as_batch_task* task = udata;
 	bool deserialize = task->policy->deserialize;
+	bool arena = task->policy->record_arena;
 
 	uint8_t* p = buf;
 	uint8_t* end = buf + size;
@@ -281,7 +300,7 @@ as_batch_parse_records(as_error* err, as_node* node, uint8_t* buf, size_t size,
 			
 			if (msg->result_code == AEROSPIKE_OK) {
 				as_status status = as_batch_parse_record(&p, err, msg, &record->record,
-														 deserialize);
+														 deserialize, arena);
 
 				if (status != AEROSPIKE_OK) {
 					return status;
@@ -295,7 +314,7 @@ as_batch_parse_records(as_error* err, as_node* node, uint8_t* buf, size_t size,
 			if (btk->callback_xdr) {
 				if (msg->result_code == AEROSPIKE_OK) {
 					as_record rec;
-					as_status status = as_batch_parse_record(&p, err, msg, &rec, deserialize);
+					as_status status = as_batch_parse_record(&p, err, msg, &rec, deserialize, arena);
 
 					if (status != AEROSPIKE_OK) {
 						as_record_destroy(&rec);
@@ -316,7 +335,7 @@ as_batch_parse_records(as_error* err, as_node* node, uint8_t* buf, size_t size,
 				
 				if (msg->result_code == AEROSPIKE_OK) {
 					as_status status = as_batch_parse_record(&p, err, msg, &result->record,
-															 deserialize);
+															 deserialize, arena);
 
 					if (status != AEROSPIKE_OK) {
 						return status;
@@ -591,7 +610,8 @@ as_batch_get_replica_sc(const as_policy_batch* policy)
 static as_status
 as_batch_get_node(
 	as_cluster* cluster, as_error* err, const as_key* key, as_policy_replica replica,
-	as_policy_replica replica_sc, bool master, bool master_sc, as_node* prev_node, as_node** node_pp
+	as_policy_replica replica_sc, uint8_t replica_index, uint8_t replica_index_sc,
+	as_node* prev_node, as_node** node_pp
 	)
 {
 	as_partition_info pi;
@@ -603,10 +623,11 @@ as_batch_get_node(
 
 	if (pi.sc_mode) {
 		replica = replica_sc;
-		master = master_sc;
+		replica_index = replica_index_sc;
 	}
 
-	as_node* node = as_partition_get_node(cluster, pi.ns, pi.partition, prev_node, replica, master);
+	as_node* node = as_partition_get_node(cluster, pi.ns, pi.partition, prev_node, replica,
+										  replica_index);
 
 	if (! node) {
 		*node_pp = NULL;
@@ -637,20 +658,21 @@ as_batch_command_init(
 	cmd->replica = policy->replica;
 
 	// Note: Do not set flags to AS_COMMAND_FLAGS_LINEARIZE because AP and SC replicas
-	// are tracked separately for batch (cmd->master and cmd->master_sc).
+	// are tracked separately for batch (cmd->replica_index and cmd->replica_index_sc).
 	// SC master/replica switch is done in as_batch_retry().
 	cmd->flags = AS_COMMAND_FLAGS_READ | AS_COMMAND_FLAGS_BATCH;
+	cmd->latency_type = AS_LATENCY_TYPE_BATCH;
 
 	if (! parent) {
 		// Normal batch.
-		cmd->master_sc = true;
+		cmd->replica_index_sc = 0;
 		as_command_start_timer(cmd);
 	}
 	else {
 		// Split retry mode.  Do not reset timer.
-		cmd->master_sc = parent->master_sc;
+		cmd->replica_index_sc = parent->replica_index_sc;
 		cmd->iteration = parent->iteration;
-		cmd->master = parent->master;
+		cmd->replica_index = parent->replica_index;
 		cmd->socket_timeout = parent->socket_timeout;
 		cmd->total_timeout = parent->total_timeout;
 		cmd->max_retries = parent->max_retries;
@@ -922,6 +944,75 @@ as_batch_node_find(as_vector* batch_nodes, as_node* node)
 	return NULL;
 }
 
+static inline void
+as_batch_partition_map_init(
+	as_batch_partition_map* pm, as_cluster* cluster, const as_policy_batch* policy,
+	const char* ns, uint32_t n_keys
+	)
+{
+	// Random replica nodes are not cached because keys are supposed to be distributed
+	// across replicas even when they belong to the same partition.
+	pm->enabled = n_keys >= AS_BATCH_MAP_MIN_KEYS && policy->replica != AS_POLICY_REPLICA_ANY &&
+				  cluster->n_partitions <= AS_BATCH_MAP_PARTITIONS;
+
+	if (pm->enabled) {
+		pm->ns = ns;
+		pm->n_partitions = cluster->n_partitions;
+		memset(pm->nodes, 0, sizeof(uint16_t) * pm->n_partitions);
+	}
+}
+
+static as_status
+as_batch_partition_map_get(
+	as_batch_partition_map* pm, as_cluster* cluster, as_error* err, const as_policy_batch* policy,
+	as_policy_replica replica_sc, const as_key* key, as_vector* batch_nodes,
+	as_batch_node** batch_node_pp, as_node** node_pp
+	)
+{
+	// Resolve node once per partition for keys in the batch's first namespace.
+	// Subsequent keys in the same partition use the cached batch node index.
+	pm->partition_id = UINT32_MAX;
+
+	if (pm->enabled && strcmp(key->ns, pm->ns) == 0) {
+		uint32_t partition_id = as_partition_getid(key->digest.value, pm->n_partitions);
+		uint32_t index = pm->nodes[partition_id];
+
+		if (index) {
+			*batch_node_pp = as_vector_get(batch_nodes, index - 1);
+			return AEROSPIKE_OK;
+		}
+		pm->partition_id = partition_id;
+	}
+
+	as_node* node;
+	as_status status = as_batch_get_node(cluster, err, key, policy->replica, replica_sc, 0, 0,
+										 NULL, &node);
+
+	if (status != AEROSPIKE_OK) {
+		return status;
+	}
+
+	as_batch_node* batch_node = as_batch_node_find(batch_nodes, node);
+
+	if (batch_node && pm->partition_id != UINT32_MAX) {
+		uint32_t index = (uint32_t)(batch_node - (as_batch_node*)batch_nodes->list);
+		pm->nodes[pm->partition_id] = (uint16_t)(index + 1);
+	}
+
+	*batch_node_pp = batch_node;
+	*node_pp = node;
+	return AEROSPIKE_OK;
+}
+
+static inline void
+as_batch_partition_map_add(as_batch_partition_map* pm, uint32_t n_batch_nodes)
+{
+	// Cache the batch node that was just added for the last key's partition.
+	if (pm->partition_id != UINT32_MAX) {
+		pm->nodes[pm->partition_id] = (uint16_t)n_batch_nodes;
+	}
+}
+
 static void
 as_batch_release_nodes(as_vector* batch_nodes)
 {
@@ -964,26 +1055,12 @@ as_batch_release_nodes_after_async(as_vector* batch_nodes)
 }
 
 static as_status
-as_batch_keys_execute(
-	aerospike* as, as_error* err, const as_policy_batch* policy, const as_batch* batch,
-	int read_attr, const char** bins, uint32_t n_bins, as_operations* ops,
-	aerospike_batch_read_callback callback, as_batch_callback_xdr callback_xdr, void* udata
+as_batch_keys_execute_chunk(
+	as_batch_task_keys* btk, as_error* err, as_key* keys, uint32_t n_keys, bool* more
 	)
 {
-	as_error_reset(err);
-	
-	if (! policy) {
-		policy = &as->config.policies.batch;
-	}
-	
-	uint32_t n_keys = batch->keys.size;
-	
-	if (n_keys == 0) {
-		callback(0, 0, udata);
-		return AEROSPIKE_OK;
-	}
-	
-	as_cluster* cluster = as->cluster;
+	as_cluster* cluster = btk->base.cluster;
+	const as_policy_batch* policy = btk->base.policy;
 	as_nodes* nodes = as_nodes_reserve(cluster);
 	uint32_t n_nodes = nodes->size;
 	
@@ -992,13 +1069,11 @@ as_batch_keys_execute(
 		return as_error_set_message(err, AEROSPIKE_ERR_SERVER, cluster_empty_error);
 	}
 	
-	// Allocate results array on stack.  May be an issue for huge batch.
-	as_batch_read* results = (callback)? (as_batch_read*)alloca(sizeof(as_batch_read) * n_keys) : 0;
+	as_batch_read* results = btk->results;
 
 	as_vector batch_nodes;
 	as_vector_inita(&batch_nodes, sizeof(as_batch_node), n_nodes);
 
-	char* ns = batch->keys.entries[0].ns;
 	as_status status = AEROSPIKE_OK;
 	
 	// Create initial key capacity for each node as average + 25%.
@@ -1010,30 +1085,33 @@ as_batch_keys_execute(
 		offsets_capacity = 10;
 	}
 
-	as_policy_replica replica_sc = as_batch_get_replica_sc(policy);
-
-	// Map keys to server nodes.
-	for (uint32_t i = 0; i < n_keys; i++) {
-		as_key* key = &batch->keys.entries[i];
-		
-		if (callback) {
+	if (results) {
+		for (uint32_t i = 0; i < n_keys; i++) {
 			as_batch_read* result = &results[i];
-			result->key = key;
+			result->key = &keys[i];
 			result->result = AEROSPIKE_ERR_RECORD_NOT_FOUND;
 			as_record_init(&result->record, 0);
 		}
-		
-		status = as_key_set_digest(err, key);
-		
-		if (status != AEROSPIKE_OK) {
-			as_batch_release_nodes(&batch_nodes);
-			as_nodes_release(nodes);
-			return status;
-		}
+	}
+
+	// Compute all digests before mapping keys to nodes.
+	status = as_key_set_digests(err, keys, n_keys);
+
+	if (status != AEROSPIKE_OK) {
+		as_vector_destroy(&batch_nodes);
+		as_nodes_release(nodes);
+		return status;
+	}
+
+	as_batch_partition_map pm;
+	as_batch_partition_map_init(&pm, cluster, policy, keys[0].ns, n_keys);
 
+	// Map keys to server nodes.
+	for (uint32_t i = 0; i < n_keys; i++) {
+		as_batch_node* batch_node;
 		as_node* node;
-		status = as_batch_get_node(cluster, err, key, policy->replica, replica_sc, true, true,
-								   NULL, &node);
+		status = as_batch_partition_map_get(&pm, cluster, err, policy, btk->base.replica_sc,
+											&keys[i], &batch_nodes, &batch_node, &node);
 
 		if (status != AEROSPIKE_OK) {
 			as_batch_release_nodes(&batch_nodes);
@@ -1041,8 +1119,6 @@ as_batch_keys_execute(
 			return status;
 		}
 
-		as_batch_node* batch_node = as_batch_node_find(&batch_nodes, node);
-		
 		if (! batch_node) {
 			// Add batch node.
 			as_node_reserve(node);
@@ -1057,6 +1133,7 @@ as_batch_keys_execute(
 				// Allocate vector on heap to avoid stack overflow.
 				as_vector_init(&batch_node->offsets, sizeof(uint32_t), offsets_capacity);
 			}
+			as_batch_partition_map_add(&pm, batch_nodes.size);
 		}
 		as_vector_append(&batch_node->offsets, &i);
 	}
@@ -1064,40 +1141,25 @@ as_batch_keys_execute(
 	
 	uint32_t error_mutex = 0;
 	
-	// Initialize task.
-	as_batch_task_keys btk;
-	memset(&btk, 0, sizeof(as_batch_task_keys));
-	btk.base.cluster = cluster;
-	btk.base.policy = policy;
-	btk.base.err = err;
-	btk.base.error_mutex = &error_mutex;
-	btk.base.n_keys = n_keys;
-	btk.base.replica_sc = replica_sc;
-	btk.base.use_batch_records = false;
-	btk.ns = ns;
-	btk.keys = batch->keys.entries;
-	btk.batch = batch;
-	btk.results = results;
-	btk.callback = callback;
-	btk.callback_xdr = callback_xdr;
-	btk.udata = udata;
-	btk.ops = ops;
-	btk.bins = bins;
-	btk.n_bins = n_bins;
-	btk.read_attr = read_attr;
+	// Initialize task for this chunk. Offsets are relative to the chunk's first key.
+	btk->base.err = err;
+	btk->base.error_mutex = &error_mutex;
+	btk->base.n_keys = n_keys;
+	btk->keys = keys;
 
 	if (policy->concurrent && batch_nodes.size > 1) {
 		// Run batch requests in parallel in separate threads.
-		btk.base.complete_q = cf_queue_create(sizeof(as_batch_complete_task), true);
+		btk->base.complete_q = cf_queue_create(sizeof(as_batch_complete_task), true);
 		
 		uint32_t n_wait_nodes = batch_nodes.size;
+
+		// Allocate tasks on heap. The tasks only need to be valid within this function.
+		as_batch_task_keys* tasks = cf_malloc(sizeof(as_batch_task_keys) * batch_nodes.size);
 		
 		// Run task for each node.
 		for (uint32_t i = 0; i < batch_nodes.size; i++) {
-			// Stack allocate task for each node.  It should be fine since the task
-			// only needs to be valid within this function.
-			as_batch_task_keys* btk_node = alloca(sizeof(as_batch_task_keys));
-			memcpy(btk_node, &btk, sizeof(as_batch_task_keys));
+			as_batch_task_keys* btk_node = &tasks[i];
+			memcpy(btk_node, btk, sizeof(as_batch_task_keys));
 			
 			as_batch_node* batch_node = as_vector_get(&batch_nodes, i);
 			btk_node->base.node = batch_node->node;
@@ -1107,8 +1169,8 @@ as_batch_keys_execute(
 			
 			if (rc) {
 				// Thread could not be added. Abort entire batch.
-				if (as_fas_uint32(btk.base.error_mutex, 1) == 0) {
-					status = as_error_update(btk.base.err, AEROSPIKE_ERR_CLIENT,
+				if (as_fas_uint32(btk->base.error_mutex, 1) == 0) {
+					status = as_error_update(btk->base.err, AEROSPIKE_ERR_CLIENT,
 											 "Failed to add batch thread: %d", rc);
 				}
 				
@@ -1121,24 +1183,25 @@ as_batch_keys_execute(
 		// Wait for tasks to complete.
 		for (uint32_t i = 0; i < n_wait_nodes; i++) {
 			as_batch_complete_task complete;
-			cf_queue_pop(btk.base.complete_q, &complete, CF_QUEUE_FOREVER);
+			cf_queue_pop(btk->base.complete_q, &complete, CF_QUEUE_FOREVER);
 			
 			if (complete.result != AEROSPIKE_OK && status == AEROSPIKE_OK) {
 				status = complete.result;
 			}
 		}
 		
-		// Release temporary queue.
-		cf_queue_destroy(btk.base.complete_q);
+		// Release temporary queue and tasks.
+		cf_queue_destroy(btk->base.complete_q);
+		cf_free(tasks);
 	}
 	else {
 		// Run batch requests sequentially in same thread.
 		for (uint32_t i = 0; status == AEROSPIKE_OK && i < batch_nodes.size; i++) {
 			as_batch_node* batch_node = as_vector_get(&batch_nodes, i);
 			
-			btk.base.node = batch_node->node;
-			memcpy(&btk.base.offsets, &batch_node->offsets, sizeof(as_vector));
-			status = as_batch_execute_keys(&btk, err, NULL);
+			btk->base.node = batch_node->node;
+			memcpy(&btk->base.offsets, &batch_node->offsets, sizeof(as_vector));
+			status = as_batch_execute_keys(btk, err, NULL);
 		}
 	}
 			
@@ -1146,12 +1209,12 @@ as_batch_keys_execute(
 	as_batch_release_nodes(&batch_nodes);
 
 	// Call user defined function with results.
-	if (callback) {
-		callback(btk.results, n_keys, udata);
+	if (btk->callback) {
+		*more = btk->callback(results, n_keys, btk->udata);
 		
 		// Destroy records. User is responsible for destroying keys with as_batch_destroy().
 		for (uint32_t i = 0; i < n_keys; i++) {
-			as_batch_read* br = &btk.results[i];
+			as_batch_read* br = &results[i];
 			if (br->result == AEROSPIKE_OK) {
 				as_record_destroy(&br->record);
 			}
@@ -1160,6 +1223,92 @@ as_batch_keys_execute(
 	return status;
 }
 
+static as_status
+as_batch_keys_execute(
+	aerospike* as, as_error* err, const as_policy_batch* policy, const as_batch* batch,
+	int read_attr, const char** bins, uint32_t n_bins, as_operations* ops,
+	aerospike_batch_read_callback callback, as_batch_callback_xdr callback_xdr, void* udata
+	)
+{
+	as_error_reset(err);
+	
+	if (! policy) {
+		policy = &as->config.policies.batch;
+	}
+	
+	uint32_t n_keys = batch->keys.size;
+	
+	if (n_keys == 0) {
+		callback(0, 0, udata);
+		return AEROSPIKE_OK;
+	}
+
+	// Large batches are split into chunks of consecutive keys when max_chunk_keys is set.
+	uint32_t chunk_max = (policy->max_chunk_keys > 0 && n_keys > policy->max_chunk_keys) ?
+						 policy->max_chunk_keys : n_keys;
+
+	// Initialize task.
+	as_batch_task_keys btk;
+	memset(&btk, 0, sizeof(as_batch_task_keys));
+	btk.base.cluster = as->cluster;
+	btk.base.policy = policy;
+	btk.base.replica_sc = as_batch_get_replica_sc(policy);
+	btk.base.use_batch_records = false;
+	btk.ns = batch->keys.entries[0].ns;
+	btk.callback = callback;
+	btk.callback_xdr = callback_xdr;
+	btk.udata = udata;
+	btk.ops = ops;
+	btk.bins = bins;
+	btk.n_bins = n_bins;
+	btk.read_attr = read_attr;
+
+	// Allocate results array on stack when small. Otherwise, allocate on heap to
+	// avoid stack overflow. The results array is reused for each chunk.
+	size_t results_size = sizeof(as_batch_read) * chunk_max;
+	bool results_heap = false;
+
+	if (callback) {
+		if (results_size <= AS_STACK_BUF_SIZE) {
+			btk.results = (as_batch_read*)alloca(results_size);
+		}
+		else {
+			btk.results = (as_batch_read*)cf_malloc(results_size);
+			results_heap = true;
+		}
+	}
+
+	as_status status = AEROSPIKE_OK;
+	bool more = true;
+
+	for (uint32_t offset = 0; offset < n_keys; offset += chunk_max) {
+		uint32_t n = n_keys - offset;
+
+		if (n > chunk_max) {
+			n = chunk_max;
+		}
+
+		status = as_batch_keys_execute_chunk(&btk, err, &batch->keys.entries[offset], n, &more);
+
+		if (status != AEROSPIKE_OK) {
+			break;
+		}
+
+		if (! more && chunk_max < n_keys) {
+			// User aborted remaining chunks. The callback return value is ignored
+			// when the batch is not chunked to preserve original behavior.
+			status = as_error_set_message(err, AEROSPIKE_ERR_CLIENT_ABORT,
+										  "Batch aborted by callback");
+			break;
+		}
+	}
+
+	if (results_heap) {
+		cf_free(btk.results);
+	}
+	return status;
+}
+
 static as_status
 as_batch_read_execute_sync(
 	as_cluster* cluster, as_error* err, const as_policy_batch* policy, as_policy_replica replica_sc,
@@ -1268,11 +1417,18 @@ as_batch_read_command_create(
 	cmd->pipe_listener = NULL;
 	cmd->buf = ((as_async_batch_command*)cmd)->space;
 	cmd->read_capacity = (uint32_t)(s - size - sizeof(as_async_batch_command));
+	cmd->alloc_size = (uint32_t)s;
 	cmd->type = AS_ASYNC_TYPE_BATCH;
 	cmd->proto_type = AS_MESSAGE_TYPE;
 	cmd->state = AS_ASYNC_STATE_UNREGISTERED;
 	cmd->flags = flags;
 	cmd->flags2 = policy->deserialize ? AS_ASYNC_FLAGS2_DESERIALIZE : 0;
+	cmd->replica_index = 0;
+	cmd->replica_index_sc = 0;
+
+	if (policy->record_arena) {
+		cmd->flags2 |= AS_ASYNC_FLAGS2_RECORD_ARENA;
+	}
 	return cmd;
 }
 
@@ -1288,9 +1444,9 @@ as_batch_read_execute_async(
 	executor->replica_sc = replica_sc;
 
 	// Note: Do not set flags to AS_ASYNC_FLAGS_LINEARIZE because AP and SC replicas
-	// are tracked separately for batch (AS_ASYNC_FLAGS_MASTER and AS_ASYNC_FLAGS_MASTER_SC).
+	// are tracked separately for batch (cmd->replica_index and cmd->replica_index_sc).
 	// SC master/replica switch is done in as_batch_retry_async().
-	uint8_t flags = AS_ASYNC_FLAGS_READ | AS_ASYNC_FLAGS_MASTER | AS_ASYNC_FLAGS_MASTER_SC;
+	uint8_t flags = AS_ASYNC_FLAGS_READ;
 
 	as_queue buffers;
 	as_queue_inita(&buffers, sizeof(as_buffer), 8);
@@ -1423,32 +1579,37 @@ as_batch_records_execute(
 	
 	as_policy_replica replica_sc = as_batch_get_replica_sc(policy);
 
-	// Map keys to server nodes.
 	for (uint32_t i = 0; i < n_keys; i++) {
 		as_batch_read_record* record = as_vector_get(list, i);
-		as_key* key = &record->key;
-		
 		record->result = AEROSPIKE_ERR_RECORD_NOT_FOUND;
 		as_record_init(&record->record, 0);
-		
-		status = as_key_set_digest(err, key);
-		
-		if (status != AEROSPIKE_OK) {
-			as_batch_read_cleanup(async_executor, nodes, &batch_nodes);
-			return status;
-		}
-		
+	}
+
+	// Compute all digests before mapping keys to nodes.
+	as_batch_read_record* first = as_vector_get(list, 0);
+	status = as_key_set_digests_stride(err, &first->key, n_keys, list->item_size);
+
+	if (status != AEROSPIKE_OK) {
+		as_batch_read_cleanup(async_executor, nodes, &batch_nodes);
+		return status;
+	}
+
+	as_batch_partition_map pm;
+	as_batch_partition_map_init(&pm, cluster, policy, first->key.ns, n_keys);
+
+	// Map keys to server nodes.
+	for (uint32_t i = 0; i < n_keys; i++) {
+		as_batch_read_record* record = as_vector_get(list, i);
+		as_batch_node* batch_node;
 		as_node* node;
-		status = as_batch_get_node(cluster, err, key, policy->replica, replica_sc, true, true,
-								   NULL, &node);
+		status = as_batch_partition_map_get(&pm, cluster, err, policy, replica_sc, &record->key,
+											&batch_nodes, &batch_node, &node);
 
 		if (status != AEROSPIKE_OK) {
 			as_batch_read_cleanup(async_executor, nodes, &batch_nodes);
 			return status;
 		}
 
-		as_batch_node* batch_node = as_batch_node_find(&batch_nodes, node);
-		
 		if (! batch_node) {
 			// Add batch node.
 			as_node_reserve(node);
@@ -1463,6 +1624,7 @@ as_batch_records_execute(
 				// Allocate vector on heap to avoid stack overflow.
 				as_vector_init(&batch_node->offsets, sizeof(uint32_t), offsets_capacity);
 			}
+			as_batch_partition_map_add(&pm, batch_nodes.size);
 		}
 		as_vector_append(&batch_node->offsets, &i);
 	}
@@ -1518,7 +1680,8 @@ as_batch_retry_records(as_batch_task_records* btr, as_command* parent, as_error*
 
 		as_node* node;
 		status = as_batch_get_node(cluster, err, key, task->policy->replica, task->replica_sc,
-								   parent->master, parent->master_sc, parent->node, &node);
+								   parent->replica_index, parent->replica_index_sc, parent->node,
+								   &node);
 
 		if (status != AEROSPIKE_OK) {
 			as_batch_release_nodes(&batch_nodes);
@@ -1586,11 +1749,12 @@ as_batch_retry_keys(as_batch_task_keys* btk, as_command* parent, as_error* err)
 	// Map keys to server nodes.
 	for (uint32_t i = 0; i < offsets_size; i++) {
 		uint32_t offset = *(uint32_t*)as_vector_get(&task->offsets, i);
-		as_key* key = &btk->batch->keys.entries[offset];
+		as_key* key = &btk->keys[offset];
 
 		as_node* node;
 		status = as_batch_get_node(cluster, err, key, task->policy->replica, task->replica_sc,
-								   parent->master, parent->master_sc, parent->node, &node);
+								   parent->replica_index, parent->replica_index_sc, parent->node,
+								   &node);
 
 		if (status != AEROSPIKE_OK) {
 			as_batch_release_nodes(&batch_nodes);
@@ -1659,7 +1823,7 @@ as_batch_retry(as_command* parent, as_error* err)
 
 	if (err->code != AEROSPIKE_ERR_TIMEOUT ||
 		policy->read_mode_sc != AS_POLICY_READ_MODE_SC_LINEARIZE) {
-		parent->master_sc = ! parent->master_sc;
+		parent->replica_index_sc++;
 	}
 
 	if (task->use_batch_records) {
@@ -1695,11 +1859,14 @@ as_batch_retry_command_create(
 	cmd->buf = ((as_async_batch_command*)cmd)->space;
 	cmd->write_len = (uint32_t)size;
 	cmd->read_capacity = (uint32_t)(s - size - sizeof(as_async_batch_command));
+	cmd->alloc_size = (uint32_t)s;
 	cmd->type = AS_ASYNC_TYPE_BATCH;
 	cmd->proto_type = AS_MESSAGE_TYPE;
 	cmd->state = AS_ASYNC_STATE_UNREGISTERED;
 	cmd->flags = flags;
 	cmd->flags2 = parent->flags2;
+	cmd->replica_index = parent->replica_index;
+	cmd->replica_index_sc = parent->replica_index_sc;
 	return cmd;
 }
 
@@ -1828,7 +1995,7 @@ as_batch_retry_async(as_event_command* parent, bool timeout)
 	}
 
 	if (! timeout || policy.read_mode_sc != AS_POLICY_READ_MODE_SC_LINEARIZE) {
-		parent->flags ^= AS_ASYNC_FLAGS_MASTER_SC;  // Alternate between SC master and prole.
+		parent->replica_index_sc++;  // Advance to next SC replica.
 	}
 
 	as_vector batch_nodes;
@@ -1844,8 +2011,7 @@ as_batch_retry_async(as_event_command* parent, bool timeout)
 
 		as_node* node;
 		status = as_batch_get_node(cluster, &err, key, policy.replica, executor->replica_sc,
-								   parent->flags & AS_ASYNC_FLAGS_MASTER,
-								   parent->flags & AS_ASYNC_FLAGS_MASTER_SC,
+								   parent->replica_index, parent->replica_index_sc,
 								   parent->node, &node);
 
 		if (status != AEROSPIKE_OK) {
@@ -1938,8 +2104,7 @@ as_batch_retry_async(as_event_command* parent, bool timeout)
 	e->queued = e->max;
 	pthread_mutex_unlock(&e->lock);
 
-	uint8_t flags = AS_ASYNC_FLAGS_READ | (parent->flags & AS_ASYNC_FLAGS_MASTER) |
-					(parent->flags & AS_ASYNC_FLAGS_MASTER_SC);
+	uint8_t flags = AS_ASYNC_FLAGS_READ;
 
 	as_queue buffers;
 	as_queue_inita(&buffers, sizeof(as_buffer), 8);
@@ -36,6 +36,7 @@
 #include <aerospike/as_serializer.h>
 #include <aerospike/as_shm_cluster.h>
 #include <aerospike/as_status.h>
+#include <citrusleaf/alloc.h>
 #include <citrusleaf/cf_clock.h>
 
 /******************************************************************************
@@ -47,6 +48,18 @@ typedef struct as_read_info_s {
 	uint8_t flags;
 } as_read_info;
 
+typedef struct as_pipeline_node_s {
+	as_node* node;
+	as_vector indexes;  // Command indexes in send order.
+	uint8_t* buf;
+	size_t size;
+	size_t capacity;
+	uint64_t deadline_ms;
+	uint32_t socket_timeout;
+	as_socket socket;
+	bool sent;
+} as_pipeline_node;
+
 /******************************************************************************
  * FUNCTIONS
  *****************************************************************************/
@@ -80,6 +93,7 @@ as_command_init_read(
 	cmd->udata = udata;
 	cmd->buf_size = size;
 	cmd->partition_id = pi->partition_id;
+	cmd->latency_type = AS_LATENCY_TYPE_READ;
 
 	if (pi->sc_mode) {
 		switch (read_mode_sc) {
@@ -106,16 +120,28 @@ as_command_init_read(
 	}
 }
 
+static inline void
+as_command_init_hedge(as_command* cmd, uint32_t hedge_delay, float hedge_percentile)
+{
+	// Linearized reads retry on the same replica sequence, so they are not hedged.
+	if ((hedge_delay > 0 || hedge_percentile > 0.0) &&
+		cmd->replica != AS_POLICY_REPLICA_MASTER && !(cmd->flags & AS_COMMAND_FLAGS_LINEARIZE)) {
+		cmd->flags |= AS_COMMAND_FLAGS_HEDGE;
+		cmd->hedge_delay = hedge_delay;
+		cmd->hedge_percentile = hedge_percentile;
+	}
+}
+
 static inline as_status
 as_command_execute_read(
-	as_cluster* cluster, as_error* err, const as_policy_base* policy, as_policy_replica replica,
-	as_policy_read_mode_sc read_mode_sc, uint8_t* buf, size_t size, as_partition_info* pi,
-	const as_parse_results_fn fn, void* udata
+	as_cluster* cluster, as_error* err, const as_policy_read* policy, uint8_t* buf, size_t size,
+	as_partition_info* pi, const as_parse_results_fn fn, void* udata
 	)
 {
 	as_command cmd;
-	as_command_init_read(&cmd, cluster, policy, replica, read_mode_sc, size, pi,
-						 fn, udata);
+	as_command_init_read(&cmd, cluster, &policy->base, policy->replica, policy->read_mode_sc,
+						 size, pi, fn, udata);
+	as_command_init_hedge(&cmd, policy->hedge_delay, (float)policy->hedge_percentile);
 
 	cmd.buf = buf;
 	as_command_start_timer(&cmd);
@@ -138,6 +164,7 @@ as_command_init_write(
 	cmd->buf_size = size;
 	cmd->partition_id = pi->partition_id;
 	cmd->flags = 0;
+	cmd->latency_type = AS_LATENCY_TYPE_WRITE;
 
 	switch (replica) {
 		case AS_POLICY_REPLICA_PREFER_RACK:
@@ -165,24 +192,37 @@ as_event_command_init_read(
 		switch (read_mode_sc) {
 			case AS_POLICY_READ_MODE_SC_SESSION:
 				ri->replica = AS_POLICY_REPLICA_MASTER;
-				ri->flags = AS_ASYNC_FLAGS_MASTER | AS_ASYNC_FLAGS_READ;
+				ri->flags = AS_ASYNC_FLAGS_READ;
 				break;
 
 			case AS_POLICY_READ_MODE_SC_LINEARIZE:
 				ri->replica = (replica != AS_POLICY_REPLICA_PREFER_RACK) ?
 							   replica : AS_POLICY_REPLICA_SEQUENCE;
-				ri->flags = AS_ASYNC_FLAGS_MASTER | AS_ASYNC_FLAGS_READ | AS_ASYNC_FLAGS_LINEARIZE;
+				ri->flags = AS_ASYNC_FLAGS_READ | AS_ASYNC_FLAGS_LINEARIZE;
 				break;
 
 			default:
 				ri->replica = replica;
-				ri->flags = AS_ASYNC_FLAGS_MASTER | AS_ASYNC_FLAGS_READ;
+				ri->flags = AS_ASYNC_FLAGS_READ;
 				break;
 		}
 	}
 	else {
 		ri->replica = replica;
-		ri->flags = AS_ASYNC_FLAGS_MASTER | AS_ASYNC_FLAGS_READ;
+		ri->flags = AS_ASYNC_FLAGS_READ;
+	}
+}
+
+static inline void
+as_event_command_init_hedge(as_event_command* cmd, const as_policy_read* policy, as_read_info* ri)
+{
+	// Pipelined connections must receive responses in order, so they are not hedged.
+	if ((policy->hedge_delay > 0 || policy->hedge_percentile > 0.0) &&
+		ri->replica != AS_POLICY_REPLICA_MASTER && !(ri->flags & AS_ASYNC_FLAGS_LINEARIZE) &&
+		! cmd->pipe_listener) {
+		cmd->flags2 |= AS_ASYNC_FLAGS2_HEDGE;
+		cmd->hedge_delay = policy->hedge_delay;
+		cmd->hedge_percentile = (float)policy->hedge_percentile;
 	}
 }
 
@@ -216,6 +256,50 @@ as_command_write_filter(const as_policy_base* policy, uint32_t filter_size, uint
 	return p;
 }
 
+static inline size_t
+as_get_write(
+	uint8_t* buf, const as_policy_read* policy, const as_key* key, uint16_t n_fields,
+	uint32_t filter_size
+	)
+{
+	uint32_t timeout = as_command_server_timeout(&policy->base);
+	uint8_t* p = as_command_write_header_read(buf, &policy->base, policy->read_mode_ap,
+		policy->read_mode_sc, timeout, n_fields, 0, AS_MSG_INFO1_READ | AS_MSG_INFO1_GET_ALL);
+
+	p = as_command_write_key(p, policy->key, key);
+	p = as_command_write_filter(&policy->base, filter_size, p);
+	return as_command_write_end(buf, p);
+}
+
+static inline size_t
+as_exists_write(
+	uint8_t* buf, const as_policy_read* policy, const as_key* key, uint16_t n_fields,
+	uint32_t filter_size
+	)
+{
+	uint8_t* p = as_command_write_header_read_header(buf, &policy->base, policy->read_mode_ap,
+		policy->read_mode_sc, n_fields, 0, AS_MSG_INFO1_READ | AS_MSG_INFO1_GET_NOBINDATA);
+
+	p = as_command_write_key(p, policy->key, key);
+	p = as_command_write_filter(&policy->base, filter_size, p);
+	return as_command_write_end(buf, p);
+}
+
+static inline size_t
+as_remove_write(
+	uint8_t* buf, const as_policy_remove* policy, const as_key* key, uint16_t n_fields,
+	uint32_t filter_size
+	)
+{
+	uint8_t* p = as_command_write_header_write(buf, &policy->base, policy->commit_level,
+					AS_POLICY_EXISTS_IGNORE, policy->gen, policy->generation, 0, n_fields, 0,
+					policy->durable_delete, 0, AS_MSG_INFO2_WRITE | AS_MSG_INFO2_DELETE, 0);
+
+	p = as_command_write_key(p, policy->key, key);
+	p = as_command_write_filter(&policy->base, filter_size, p);
+	return as_command_write_end(buf, p);
+}
+
 /******************************************************************************
  * GET
  *****************************************************************************/
@@ -243,20 +327,15 @@ aerospike_key_get(
 	size += filter_size;
 
 	uint8_t* buf = as_command_buffer_init(size);
-	uint32_t timeout = as_command_server_timeout(&policy->base);
-	uint8_t* p = as_command_write_header_read(buf, &policy->base, policy->read_mode_ap,
-		policy->read_mode_sc, timeout, n_fields, 0, AS_MSG_INFO1_READ | AS_MSG_INFO1_GET_ALL);
-
-	p = as_command_write_key(p, policy->key, key);
-	p = as_command_write_filter(&policy->base, filter_size, p);
-	size = as_command_write_end(buf, p);
+	size = as_get_write(buf, policy, key, n_fields, filter_size);
 
 	as_command_parse_result_data data;
 	data.record = rec;
 	data.deserialize = policy->deserialize;
+	data.arena = policy->record_arena;
 
-	status = as_command_execute_read(cluster, err, &policy->base, policy->replica,
-				policy->read_mode_sc, buf, size, &pi, as_command_parse_result, &data);
+	status = as_command_execute_read(cluster, err, policy, buf, size, &pi, as_command_parse_result,
+				&data);
 
 	as_command_buffer_free(buf, size);
 	return status;
@@ -291,8 +370,10 @@ aerospike_key_get_async(
 
 	as_event_command* cmd = as_async_record_command_create(
 		cluster, &policy->base, ri.replica, pi.ns, pi.partition, policy->deserialize,
-		policy->async_heap_rec, ri.flags, listener, udata, event_loop, pipe_listener,
-		size, as_event_command_parse_result);
+		policy->async_heap_rec, policy->record_arena, ri.flags, listener, udata, event_loop,
+		pipe_listener, size, as_event_command_parse_result);
+
+	as_event_command_init_hedge(cmd, policy, &ri);
 
 	uint32_t timeout = as_command_server_timeout(&policy->base);
 	uint8_t* p = as_command_write_header_read(cmd->buf, &policy->base, policy->read_mode_ap,
@@ -357,9 +438,10 @@ aerospike_key_select(
 	as_command_parse_result_data data;
 	data.record = rec;
 	data.deserialize = policy->deserialize;
+	data.arena = policy->record_arena;
 
-	status = as_command_execute_read(cluster, err, &policy->base, policy->replica,
-				policy->read_mode_sc, buf, size, &pi, as_command_parse_result, &data);
+	status = as_command_execute_read(cluster, err, policy, buf, size, &pi, as_command_parse_result,
+				&data);
 
 	as_command_buffer_free(buf, size);
 	return status;
@@ -403,8 +485,10 @@ aerospike_key_select_async(
 
 	as_event_command* cmd = as_async_record_command_create(
 		cluster, &policy->base, ri.replica, pi.ns, pi.partition, policy->deserialize,
-		policy->async_heap_rec, ri.flags, listener, udata, event_loop, pipe_listener,
-		size, as_event_command_parse_result);
+		policy->async_heap_rec, policy->record_arena, ri.flags, listener, udata, event_loop,
+		pipe_listener, size, as_event_command_parse_result);
+
+	as_event_command_init_hedge(cmd, policy, &ri);
 
 	uint32_t timeout = as_command_server_timeout(&policy->base);
 	uint8_t* p = as_command_write_header_read(cmd->buf, &policy->base, policy->read_mode_ap,
@@ -447,15 +531,10 @@ aerospike_key_exists(
 	size += filter_size;
 
 	uint8_t* buf = as_command_buffer_init(size);
-	uint8_t* p = as_command_write_header_read_header(buf, &policy->base, policy->read_mode_ap,
-		policy->read_mode_sc, n_fields, 0, AS_MSG_INFO1_READ | AS_MSG_INFO1_GET_NOBINDATA);
+	size = as_exists_write(buf, policy, key, n_fields, filter_size);
 
-	p = as_command_write_key(p, policy->key, key);
-	p = as_command_write_filter(&policy->base, filter_size, p);
-	size = as_command_write_end(buf, p);
-
-	status = as_command_execute_read(cluster, err, &policy->base, policy->replica,
-				policy->read_mode_sc, buf, size, &pi, as_command_parse_header, rec);
+	status = as_command_execute_read(cluster, err, policy, buf, size, &pi, as_command_parse_header,
+				rec);
 
 	as_command_buffer_free(buf, size);
 
@@ -494,9 +573,11 @@ aerospike_key_exists_async(
 
 	as_event_command* cmd = as_async_record_command_create(
 		cluster, &policy->base, ri.replica, pi.ns, pi.partition, false, policy->async_heap_rec,
-		ri.flags, listener, udata, event_loop, pipe_listener,
+		false, ri.flags, listener, udata, event_loop, pipe_listener,
 		size, as_event_command_parse_result);
 
+	as_event_command_init_hedge(cmd, policy, &ri);
+
 	uint8_t* p = as_command_write_header_read_header(cmd->buf, &policy->base, policy->read_mode_ap,
 		policy->read_mode_sc, n_fields, 0, AS_MSG_INFO1_READ | AS_MSG_INFO1_GET_NOBINDATA);
 
@@ -515,6 +596,8 @@ typedef struct as_put_s {
 	const as_key* key;
 	as_record* rec;
 	as_queue* buffers;
+	size_t ref_size;
+	uint32_t ref_count;
 	uint32_t filter_size;
 	uint16_t n_fields;
 	uint16_t n_bins;
@@ -539,17 +622,26 @@ as_put_init(
 	size += put->filter_size;
 
 	as_bin* bins = rec->bins.entries;
+	put->ref_size = 0;
+	put->ref_count = 0;
 
 	for (uint16_t i = 0; i < n_bins; i++) {
 		size += as_command_bin_size(&bins[i], buffers);
+
+		// Track large values that can be sent in place by sync scatter/gather writes.
+		size_t ref_size = as_command_value_ref_size((as_val*)bins[i].valuep);
+
+		if (ref_size > 0) {
+			put->ref_size += ref_size;
+			put->ref_count++;
+		}
 	}
 	return size;
 }
 
 static size_t
-as_put_write(void* udata, uint8_t* buf)
+as_put_write_bins(as_put* put, uint8_t* buf, as_command_iov* iov)
 {
-	as_put* put = udata;
 	const as_policy_write* policy = put->policy;
 	as_record* rec = put->rec;
 
@@ -564,6 +656,14 @@ as_put_write(void* udata, uint8_t* buf)
 	uint16_t n_bins = put->n_bins;
 	as_queue* buffers = put->buffers;
 
+	if (iov) {
+		for (uint16_t i = 0; i < n_bins; i++) {
+			p = as_command_write_bin_iov(p, AS_OPERATOR_WRITE, &bins[i], buffers, iov);
+		}
+		as_buffers_destroy(buffers);
+		return as_command_write_end_iov(buf, p, iov);
+	}
+
 	for (uint16_t i = 0; i < n_bins; i++) {
 		p = as_command_write_bin(p, AS_OPERATOR_WRITE, &bins[i], buffers);
 	}
@@ -571,6 +671,18 @@ as_put_write(void* udata, uint8_t* buf)
 	return as_command_write_end(buf, p);
 }
 
+static size_t
+as_put_write(void* udata, uint8_t* buf)
+{
+	return as_put_write_bins(udata, buf, NULL);
+}
+
+static size_t
+as_put_write_iov(void* udata, uint8_t* buf, as_command_iov* iov)
+{
+	return as_put_write_bins(udata, buf, iov);
+}
+
 as_status
 aerospike_key_put(
 	aerospike* as, as_error* err, const as_policy_write* policy, const as_key* key, as_record* rec
@@ -602,6 +714,15 @@ aerospike_key_put(
 	}
 
 	as_command cmd;
+
+	if (put.ref_count > 0 && (compression_threshold == 0 || size <= compression_threshold)) {
+		// Send large values in place instead of copying them into the command buffer.
+		as_command_init_write(&cmd, cluster, &policy->base, policy->replica, size - put.ref_size,
+							  &pi, as_command_parse_header, NULL);
+
+		return as_command_send_iov(&cmd, err, as_put_write_iov, &put, put.ref_count);
+	}
+
 	as_command_init_write(&cmd, cluster, &policy->base, policy->replica, size, &pi,
 						  as_command_parse_header, NULL);
 
@@ -644,7 +765,7 @@ aerospike_key_put_async_ex(
 	if (compression_threshold == 0 || (size <= compression_threshold)) {
 		// Send uncompressed command.
 		as_event_command* cmd = as_async_write_command_create(
-				cluster, &policy->base, policy->replica, pi.ns, pi.partition, AS_ASYNC_FLAGS_MASTER,
+				cluster, &policy->base, policy->replica, pi.ns, pi.partition, 0,
 				listener, udata, event_loop, pipe_listener, size, as_event_command_parse_header);
 
 		cmd->write_len = (uint32_t)as_put_write(&put, cmd->buf);
@@ -669,7 +790,7 @@ aerospike_key_put_async_ex(
 		// Allocate command with compressed upper bound.
 		size_t comp_size = as_command_compress_max_size(size);
 		as_event_command* cmd = as_async_write_command_create(
-				cluster, &policy->base, policy->replica, pi.ns, pi.partition, AS_ASYNC_FLAGS_MASTER,
+				cluster, &policy->base, policy->replica, pi.ns, pi.partition, 0,
 				listener, udata, event_loop, pipe_listener, comp_size, as_event_command_parse_header);
 
 		// Compress buffer and execute.
@@ -732,13 +853,7 @@ aerospike_key_remove(
 	size += filter_size;
 
 	uint8_t* buf = as_command_buffer_init(size);
-	uint8_t* p = as_command_write_header_write(buf, &policy->base, policy->commit_level,
-					AS_POLICY_EXISTS_IGNORE, policy->gen, policy->generation, 0, n_fields, 0,
-					policy->durable_delete, 0, AS_MSG_INFO2_WRITE | AS_MSG_INFO2_DELETE, 0);
-
-	p = as_command_write_key(p, policy->key, key);
-	p = as_command_write_filter(&policy->base, filter_size, p);
-	size = as_command_write_end(buf, p);
+	size = as_remove_write(buf, policy, key, n_fields, filter_size);
 
 	as_command cmd;
 	as_command_init_write(&cmd, cluster, &policy->base, policy->replica, size, &pi,
@@ -777,7 +892,7 @@ aerospike_key_remove_async_ex(
 	size += filter_size;
 
 	as_event_command* cmd = as_async_write_command_create(
-		cluster, &policy->base, policy->replica, pi.ns, pi.partition, AS_ASYNC_FLAGS_MASTER,
+		cluster, &policy->base, policy->replica, pi.ns, pi.partition, 0,
 		listener, udata, event_loop, pipe_listener, size, as_event_command_parse_header);
 
 	uint8_t* p = as_command_write_header_write(cmd->buf, &policy->base, policy->commit_level,
@@ -858,7 +973,11 @@ as_operate_set_attr(const as_operations* ops, as_queue* buffers, uint8_t* rattr,
 				write_attr |= AS_MSG_INFO2_WRITE;
 				break;
 		}
-		size += as_command_bin_size(&op->bin, buffers);
+
+		// Buffers are null when only attributes are needed.
+		if (buffers) {
+			size += as_command_bin_size(&op->bin, buffers);
+		}
 	}
 	
 	if (respond_all_ops) {
@@ -965,6 +1084,7 @@ aerospike_key_operate(
 	as_command_parse_result_data data;
 	data.record = rec;
 	data.deserialize = policy->deserialize;
+	data.arena = policy->record_arena;
 
 	as_command cmd;
 
@@ -1020,8 +1140,8 @@ aerospike_key_operate_async(
 		if (oper.write_attr & AS_MSG_INFO2_WRITE) {
 			cmd = as_async_record_command_create(
 				cluster, &policy->base, policy->replica, pi.ns, pi.partition, policy->deserialize,
-				policy->async_heap_rec, AS_ASYNC_FLAGS_MASTER, listener, udata, event_loop,
-				pipe_listener, size, as_event_command_parse_result);
+				policy->async_heap_rec, policy->record_arena, 0, listener,
+				udata, event_loop, pipe_listener, size, as_event_command_parse_result);
 		}
 		else {
 			as_read_info ri;
@@ -1029,8 +1149,8 @@ aerospike_key_operate_async(
 
 			cmd = as_async_record_command_create(
 				cluster, &policy->base, ri.replica, pi.ns, pi.partition, policy->deserialize,
-				policy->async_heap_rec, ri.flags, listener, udata, event_loop, pipe_listener, size,
-				as_event_command_parse_result);
+				policy->async_heap_rec, policy->record_arena, ri.flags, listener, udata, event_loop,
+				pipe_listener, size, as_event_command_parse_result);
 		}
 
 		cmd->write_len = (uint32_t)as_operate_write(&oper, cmd->buf);
@@ -1048,8 +1168,8 @@ aerospike_key_operate_async(
 		if (oper.write_attr & AS_MSG_INFO2_WRITE) {
 			cmd = as_async_record_command_create(
 				cluster, &policy->base, policy->replica, pi.ns, pi.partition, policy->deserialize,
-				policy->async_heap_rec, AS_ASYNC_FLAGS_MASTER, listener, udata, event_loop,
-				pipe_listener, comp_size, as_event_command_parse_result);
+				policy->async_heap_rec, policy->record_arena, 0, listener,
+				udata, event_loop, pipe_listener, comp_size, as_event_command_parse_result);
 		}
 		else {
 			as_read_info ri;
@@ -1057,8 +1177,8 @@ aerospike_key_operate_async(
 
 			cmd = as_async_record_command_create(
 				cluster, &policy->base, ri.replica, pi.ns, pi.partition, policy->deserialize,
-				policy->async_heap_rec, ri.flags, listener, udata, event_loop, pipe_listener,
-				comp_size, as_event_command_parse_result);
+				policy->async_heap_rec, policy->record_arena, ri.flags, listener, udata, event_loop,
+				pipe_listener, comp_size, as_event_command_parse_result);
 		}
 
 		// Compress buffer and execute.
@@ -1163,6 +1283,7 @@ aerospike_key_apply(
 	as_command cmd;
 	as_command_init_write(&cmd, cluster, &policy->base, policy->replica, size, &pi,
 						  as_command_parse_success_failure, result);
+	cmd.latency_type = AS_LATENCY_TYPE_UDF;
 
 	uint32_t compression_threshold = policy->base.compress ? AS_COMPRESS_THRESHOLD : 0;
 
@@ -1199,7 +1320,7 @@ aerospike_key_apply_async(
 	if (! (policy->base.compress && size > AS_COMPRESS_THRESHOLD)) {
 		// Send uncompressed command.
 		as_event_command* cmd = as_async_value_command_create(cluster, &policy->base,
-			policy->replica, pi.ns, pi.partition, AS_ASYNC_FLAGS_MASTER, listener, udata,
+			policy->replica, pi.ns, pi.partition, 0, listener, udata,
 			event_loop, pipe_listener, size, as_event_command_parse_success_failure);
 
 		cmd->write_len = (uint32_t)as_apply_write(&ap, cmd->buf);
@@ -1222,7 +1343,7 @@ aerospike_key_apply_async(
 		size_t comp_size = as_command_compress_max_size(size);
 
 		as_event_command* cmd = as_async_value_command_create(cluster, &policy->base,
-			policy->replica, pi.ns, pi.partition, AS_ASYNC_FLAGS_MASTER, listener, udata,
+			policy->replica, pi.ns, pi.partition, 0, listener, udata,
 			event_loop, pipe_listener, comp_size, as_event_command_parse_success_failure);
 
 		// Compress buffer and execute.
@@ -1238,3 +1359,773 @@ aerospike_key_apply_async(
 		return as_event_command_execute(cmd, err);
 	}
 }
+
+/******************************************************************************
+ * PREPARED
+ *****************************************************************************/
+
+typedef struct as_prepared_cmd_s {
+	const as_prepared* prep;
+	const as_key* key;
+	as_val** values;
+	as_queue* buffers;
+	uint32_t ttl;
+	uint16_t gen;
+	bool send_key;
+} as_prepared_cmd;
+
+static as_status
+as_prepared_init(
+	as_prepared* prep, as_error* err, const as_policy_base* policy, as_policy_key key_policy,
+	const char* ns, const char* set, uint16_t n_ops
+	)
+{
+	as_error_reset(err);
+
+	size_t ns_len = strlen(ns);
+	size_t set_len = strlen(set);
+
+	if (ns_len >= AS_NAMESPACE_MAX_SIZE || set_len >= AS_SET_MAX_SIZE) {
+		return as_error_update(err, AEROSPIKE_ERR_PARAM, "Invalid namespace or set: %s %s",
+							   ns, set);
+	}
+
+	memset(prep, 0, sizeof(as_prepared));
+	memcpy(prep->ns, ns, ns_len + 1);
+	memcpy(prep->set, set, set_len + 1);
+	prep->key = key_policy;
+	prep->n_ops = n_ops;
+
+	// Namespace, set and digest fields.
+	prep->n_fields = 3;
+	prep->filter_size = as_command_filter_size(policy, &prep->n_fields);
+
+	// The template holds everything except the digest, user key and values.
+	prep->size = AS_HEADER_SIZE + AS_FIELD_HEADER_SIZE * 2 + (uint32_t)(ns_len + set_len) +
+				 prep->filter_size;
+
+	// The filter is serialized into the template, so the policy copy does not reference it.
+	prep->base = *policy;
+	prep->base.filter_exp = NULL;
+	prep->base.predexp = NULL;
+	return AEROSPIKE_OK;
+}
+
+static as_status
+as_prepared_add_size(as_prepared* prep, as_error* err, const char* name)
+{
+	size_t size = 0;
+	as_status status = as_command_bin_name_size(err, name, &size);
+
+	if (status != AEROSPIKE_OK) {
+		return status;
+	}
+	prep->size += (uint32_t)size;
+	return AEROSPIKE_OK;
+}
+
+static uint8_t*
+as_prepared_write_fields(as_prepared* prep, const as_policy_base* policy, uint8_t* p)
+{
+	p = as_command_write_field_string(p, AS_FIELD_NAMESPACE, prep->ns);
+	p = as_command_write_field_string(p, AS_FIELD_SETNAME, prep->set);
+	prep->header_size = (uint32_t)(p - prep->buf);
+	return as_command_write_filter(policy, prep->filter_size, p);
+}
+
+static size_t
+as_prepared_write(void* udata, uint8_t* buf)
+{
+	as_prepared_cmd* pc = udata;
+	const as_prepared* prep = pc->prep;
+
+	// Copy header, namespace and set. Then patch the fields that vary per command.
+	memcpy(buf, prep->buf, prep->header_size);
+
+	uint16_t n_fields = pc->send_key ? prep->n_fields + 1 : prep->n_fields;
+	*(uint16_t*)&buf[26] = cf_swap_to_be16(n_fields);
+
+	if (prep->write) {
+		if (prep->gen != AS_POLICY_GEN_IGNORE) {
+			*(uint32_t*)&buf[14] = cf_swap_to_be32(pc->gen);
+		}
+		*(uint32_t*)&buf[18] = cf_swap_to_be32(pc->ttl);
+	}
+
+	uint8_t* p = buf + prep->header_size;
+	p = as_command_write_field_digest(p, &pc->key->digest);
+
+	if (pc->send_key) {
+		p = as_command_write_user_key(p, pc->key);
+	}
+
+	const uint8_t* t = prep->buf + prep->header_size;
+	memcpy(p, t, prep->filter_size);
+	p += prep->filter_size;
+	t += prep->filter_size;
+
+	as_val** values = pc->values;
+
+	for (uint16_t i = 0; i < prep->n_ops; i++) {
+		// Copy operation header and bin name. Then append value.
+		uint32_t op_size = AS_OPERATION_HEADER_SIZE + t[7];
+		memcpy(p, t, op_size);
+		t += op_size;
+
+		if (values && values[i]) {
+			p = as_command_write_op_value(p, values[i], pc->buffers);
+		}
+		else {
+			p += op_size;
+		}
+	}
+	as_buffers_destroy(pc->buffers);
+	return as_command_write_end(buf, p);
+}
+
+as_status
+aerospike_key_prepare_put(
+	aerospike* as, as_error* err, const as_policy_write* policy, const char* ns, const char* set,
+	const char* bins[], as_prepared* prep
+	)
+{
+	if (! policy) {
+		policy = &as->config.policies.write;
+	}
+
+	uint16_t n_bins = 0;
+
+	while (bins[n_bins] != NULL && bins[n_bins][0] != '\0') {
+		n_bins++;
+	}
+
+	as_status status = as_prepared_init(prep, err, &policy->base, policy->key, ns, set, n_bins);
+
+	if (status != AEROSPIKE_OK) {
+		return status;
+	}
+
+	for (uint16_t i = 0; i < n_bins; i++) {
+		status = as_prepared_add_size(prep, err, bins[i]);
+
+		if (status != AEROSPIKE_OK) {
+			return status;
+		}
+	}
+
+	prep->write = true;
+	prep->replica = policy->replica;
+	prep->gen = policy->gen;
+
+	// Support new compress while still being compatible with old XDR compression_threshold.
+	prep->compression_threshold = policy->compression_threshold;
+
+	if (policy->base.compress && prep->compression_threshold == 0) {
+		prep->compression_threshold = AS_COMPRESS_THRESHOLD;
+	}
+
+	prep->buf = cf_malloc(prep->size);
+
+	uint8_t* p = as_command_write_header_write(prep->buf, &policy->base, policy->commit_level,
+		policy->exists, policy->gen, 0, 0, prep->n_fields, n_bins, policy->durable_delete, 0,
+		AS_MSG_INFO2_WRITE, 0);
+
+	p = as_prepared_write_fields(prep, &policy->base, p);
+
+	for (uint16_t i = 0; i < n_bins; i++) {
+		p = as_command_write_op_name(p, AS_OPERATOR_WRITE, bins[i]);
+	}
+	return AEROSPIKE_OK;
+}
+
+as_status
+aerospike_key_prepare_select(
+	aerospike* as, as_error* err, const as_policy_read* policy, const char* ns, const char* set,
+	const char* bins[], as_prepared* prep
+	)
+{
+	if (! policy) {
+		policy = &as->config.policies.read;
+	}
+
+	uint16_t n_bins = 0;
+
+	if (bins) {
+		while (bins[n_bins] != NULL && bins[n_bins][0] != '\0') {
+			n_bins++;
+		}
+	}
+
+	as_status status = as_prepared_init(prep, err, &policy->base, policy->key, ns, set, n_bins);
+
+	if (status != AEROSPIKE_OK) {
+		return status;
+	}
+
+	for (uint16_t i = 0; i < n_bins; i++) {
+		status = as_prepared_add_size(prep, err, bins[i]);
+
+		if (status != AEROSPIKE_OK) {
+			return status;
+		}
+	}
+
+	prep->replica = policy->replica;
+	prep->read_mode_sc = policy->read_mode_sc;
+	prep->hedge_delay = policy->hedge_delay;
+	prep->hedge_percentile = (float)policy->hedge_percentile;
+	prep->deserialize = policy->deserialize;
+	prep->record_arena = policy->record_arena;
+
+	prep->buf = cf_malloc(prep->size);
+
+	uint8_t read_attr = (n_bins == 0)? AS_MSG_INFO1_READ | AS_MSG_INFO1_GET_ALL : AS_MSG_INFO1_READ;
+	uint32_t timeout = as_command_server_timeout(&policy->base);
+	uint8_t* p = as_command_write_header_read(prep->buf, &policy->base, policy->read_mode_ap,
+		policy->read_mode_sc, timeout, prep->n_fields, n_bins, read_attr);
+
+	p = as_prepared_write_fields(prep, &policy->base, p);
+
+	for (uint16_t i = 0; i < n_bins; i++) {
+		p = as_command_write_bin_name(p, bins[i]);
+	}
+	return AEROSPIKE_OK;
+}
+
+as_status
+aerospike_key_prepare_operate(
+	aerospike* as, as_error* err, const as_policy_operate* policy, const char* ns,
+	const char* set, const as_operations* ops, as_prepared* prep
+	)
+{
+	uint16_t n_operations = ops->binops.size;
+
+	if (n_operations == 0) {
+		as_error_reset(err);
+		return as_error_set_message(err, AEROSPIKE_ERR_PARAM, "No operations defined");
+	}
+
+	uint8_t read_attr;
+	uint8_t write_attr;
+	uint8_t info_attr = 0;
+	as_operate_set_attr(ops, NULL, &read_attr, &write_attr);
+
+	as_policy_operate policy_local;
+
+	if (! policy) {
+		if (write_attr & AS_MSG_INFO2_WRITE) {
+			// Write operations should not retry by default.
+			policy = &as->config.policies.operate;
+		}
+		else {
+			// Read operations should retry by default.
+			as_policy_operate_copy(&as->config.policies.operate, &policy_local);
+			policy_local.base.max_retries = 2;
+			policy = &policy_local;
+		}
+	}
+
+	as_status status = as_prepared_init(prep, err, &policy->base, policy->key, ns, set,
+										n_operations);
+
+	if (status != AEROSPIKE_OK) {
+		return status;
+	}
+
+	for (uint16_t i = 0; i < n_operations; i++) {
+		status = as_prepared_add_size(prep, err, ops->binops.entries[i].bin.name);
+
+		if (status != AEROSPIKE_OK) {
+			return status;
+		}
+	}
+
+	prep->write = (write_attr & AS_MSG_INFO2_WRITE) != 0;
+	prep->replica = policy->replica;
+	prep->read_mode_sc = policy->read_mode_sc;
+	prep->gen = policy->gen;
+	prep->compression_threshold = policy->base.compress ? AS_COMPRESS_THRESHOLD : 0;
+	prep->deserialize = policy->deserialize;
+	prep->record_arena = policy->record_arena;
+
+	as_command_set_attr_read(policy->read_mode_ap, policy->read_mode_sc, policy->base.compress,
+							 &read_attr, &info_attr);
+
+	prep->buf = cf_malloc(prep->size);
+
+	uint8_t* p = as_command_write_header_write(prep->buf, &policy->base, policy->commit_level,
+		policy->exists, policy->gen, 0, 0, prep->n_fields, n_operations, policy->durable_delete,
+		read_attr, write_attr, info_attr);
+
+	p = as_prepared_write_fields(prep, &policy->base, p);
+
+	for (uint16_t i = 0; i < n_operations; i++) {
+		as_binop* op = &ops->binops.entries[i];
+		p = as_command_write_op_name(p, op->op, op->bin.name);
+	}
+	return AEROSPIKE_OK;
+}
+
+as_status
+aerospike_key_execute_prepared(
+	aerospike* as, as_error* err, const as_prepared* prep, const as_key* key, as_val** values,
+	uint32_t ttl, uint16_t gen, as_record** rec
+	)
+{
+	if (strcmp(key->ns, prep->ns) != 0 || strcmp(key->set, prep->set) != 0) {
+		as_error_reset(err);
+		return as_error_update(err, AEROSPIKE_ERR_PARAM,
+							   "Key namespace/set %s/%s does not match prepared command %s/%s",
+							   key->ns, key->set, prep->ns, prep->set);
+	}
+
+	as_cluster* cluster = as->cluster;
+	as_partition_info pi;
+	as_status status = as_key_partition_init(cluster, err, key, &pi);
+
+	if (status != AEROSPIKE_OK) {
+		return status;
+	}
+
+	as_queue buffers;
+	as_queue_inita(&buffers, sizeof(as_buffer), prep->n_ops);
+
+	as_prepared_cmd pc;
+	pc.prep = prep;
+	pc.key = key;
+	pc.values = values;
+	pc.buffers = &buffers;
+	pc.ttl = ttl;
+	pc.gen = gen;
+	pc.send_key = prep->key == AS_POLICY_KEY_SEND && key->valuep;
+
+	size_t size = prep->size + AS_FIELD_HEADER_SIZE + AS_DIGEST_VALUE_SIZE;
+
+	if (pc.send_key) {
+		size += as_command_user_key_size(key);
+	}
+
+	if (values) {
+		for (uint16_t i = 0; i < prep->n_ops; i++) {
+			if (values[i]) {
+				size += as_command_value_size(values[i], &buffers);
+			}
+		}
+	}
+
+	as_command_parse_result_data data;
+	data.record = rec;
+	data.deserialize = prep->deserialize;
+	data.arena = prep->record_arena;
+
+	as_parse_results_fn parse_fn = rec ? as_command_parse_result : as_command_parse_header;
+	void* udata = rec ? &data : NULL;
+	as_command cmd;
+
+	if (prep->write) {
+		as_command_init_write(&cmd, cluster, &prep->base, prep->replica, size, &pi, parse_fn,
+							  udata);
+	}
+	else {
+		as_command_init_read(&cmd, cluster, &prep->base, prep->replica, prep->read_mode_sc, size,
+							 &pi, parse_fn, udata);
+		as_command_init_hedge(&cmd, prep->hedge_delay, prep->hedge_percentile);
+	}
+	return as_command_send(&cmd, err, prep->compression_threshold, as_prepared_write, &pc);
+}
+
+void
+as_prepared_destroy(as_prepared* prep)
+{
+	cf_free(prep->buf);
+	prep->buf = NULL;
+}
+
+/******************************************************************************
+ * PIPELINE
+ *****************************************************************************/
+
+static as_pipeline_node*
+as_pipeline_node_get(as_vector* pnodes, as_node* node, const as_command* cmd)
+{
+	as_pipeline_node* pn = pnodes->list;
+
+	for (uint32_t i = 0; i < pnodes->size; i++, pn++) {
+		if (pn->node == node) {
+			// Use the largest timeouts of all commands sent to this node. Zero is unlimited.
+			if (pn->socket_timeout != 0 &&
+				(cmd->socket_timeout == 0 || cmd->socket_timeout > pn->socket_timeout)) {
+				pn->socket_timeout = cmd->socket_timeout;
+			}
+
+			if (pn->deadline_ms != 0 &&
+				(cmd->deadline_ms == 0 || cmd->deadline_ms > pn->deadline_ms)) {
+				pn->deadline_ms = cmd->deadline_ms;
+			}
+			return pn;
+		}
+	}
+
+	as_node_reserve(node);
+	pn = as_vector_reserve(pnodes);
+	pn->node = node;
+	as_vector_init(&pn->indexes, sizeof(uint32_t), 16);
+	pn->buf = NULL;
+	pn->size = 0;
+	pn->capacity = 0;
+	pn->deadline_ms = cmd->deadline_ms;
+	pn->socket_timeout = cmd->socket_timeout;
+	pn->sent = false;
+	return pn;
+}
+
+static inline uint8_t*
+as_pipeline_node_reserve(as_pipeline_node* pn, size_t size)
+{
+	size_t needed = pn->size + size;
+
+	if (needed > pn->capacity) {
+		size_t capacity = pn->capacity * 2;
+
+		if (capacity < needed) {
+			capacity = needed;
+		}
+		pn->buf = cf_realloc(pn->buf, capacity);
+		pn->capacity = capacity;
+	}
+	return pn->buf + pn->size;
+}
+
+static as_status
+as_pipeline_prepare(
+	aerospike* as, as_error* err, as_pipeline_op* op, uint32_t index, as_vector* pnodes
+	)
+{
+	as_cluster* cluster = as->cluster;
+	as_partition_info pi;
+	as_status status = as_key_partition_init(cluster, err, op->key, &pi);
+
+	if (status != AEROSPIKE_OK) {
+		return status;
+	}
+
+	const as_policy_read* read_policy = NULL;
+	const as_policy_write* write_policy = NULL;
+	const as_policy_remove* remove_policy = NULL;
+	as_policy_operate policy_local;
+	as_queue buffers;
+	as_put put;
+	as_operate oper;
+	as_command cmd;
+	uint16_t n_fields = 0;
+	uint32_t filter_size = 0;
+	uint32_t compression_threshold = 0;
+	size_t size;
+
+	// Estimate command size and determine target replica.
+	switch (op->type) {
+		case AS_PIPELINE_GET:
+		case AS_PIPELINE_EXISTS:
+			read_policy = op->policy.read ? op->policy.read : &as->config.policies.read;
+			size = as_command_key_size(read_policy->key, op->key, &n_fields);
+			filter_size = as_command_filter_size(&read_policy->base, &n_fields);
+			size += filter_size;
+			as_command_init_read(&cmd, cluster, &read_policy->base, read_policy->replica,
+								 read_policy->read_mode_sc, size, &pi, NULL, NULL);
+			break;
+
+		case AS_PIPELINE_PUT:
+			if (! op->record) {
+				return as_error_set_message(err, AEROSPIKE_ERR_PARAM, "Record not defined");
+			}
+			write_policy = op->policy.write ? op->policy.write : &as->config.policies.write;
+			as_queue_inita(&buffers, sizeof(as_buffer), op->record->bins.size);
+			size = as_put_init(&put, write_policy, op->key, op->record, &buffers);
+			as_command_init_write(&cmd, cluster, &write_policy->base, write_policy->replica, size,
+								  &pi, NULL, NULL);
+
+			// Support new compress while still being compatible with old XDR
+			// compression_threshold.
+			compression_threshold = write_policy->compression_threshold;
+
+			if (write_policy->base.compress && compression_threshold == 0) {
+				compression_threshold = AS_COMPRESS_THRESHOLD;
+			}
+			break;
+
+		case AS_PIPELINE_REMOVE:
+			remove_policy = op->policy.remove ? op->policy.remove : &as->config.policies.remove;
+			size = as_command_key_size(remove_policy->key, op->key, &n_fields);
+			filter_size = as_command_filter_size(&remove_policy->base, &n_fields);
+			size += filter_size;
+			as_command_init_write(&cmd, cluster, &remove_policy->base, remove_policy->replica,
+								  size, &pi, NULL, NULL);
+			break;
+
+		case AS_PIPELINE_OPERATE: {
+			if (! op->ops || op->ops->binops.size == 0) {
+				return as_error_set_message(err, AEROSPIKE_ERR_PARAM, "No operations defined");
+			}
+			as_queue_inita(&buffers, sizeof(as_buffer), op->ops->binops.size);
+			size = as_operate_init(&oper, as, op->policy.operate, &policy_local, op->key, op->ops,
+								   &buffers);
+
+			const as_policy_operate* policy = oper.policy;
+			compression_threshold = policy->base.compress ? AS_COMPRESS_THRESHOLD : 0;
+
+			if (oper.write_attr & AS_MSG_INFO2_WRITE) {
+				as_command_init_write(&cmd, cluster, &policy->base, policy->replica, size, &pi,
+									  NULL, NULL);
+			}
+			else {
+				as_command_init_read(&cmd, cluster, &policy->base, policy->replica,
+									 policy->read_mode_sc, size, &pi, NULL, NULL);
+			}
+			break;
+		}
+
+		default:
+			return as_error_update(err, AEROSPIKE_ERR_PARAM, "Invalid pipeline command type: %d",
+								   op->type);
+	}
+
+	as_command_start_timer(&cmd);
+
+	as_node* node = as_partition_get_node(cluster, cmd.ns, cmd.partition, NULL, cmd.replica,
+										  cmd.replica_index);
+
+	if (! node) {
+		if (op->type == AS_PIPELINE_PUT || op->type == AS_PIPELINE_OPERATE) {
+			as_buffers_destroy(&buffers);
+		}
+		return as_error_update(err, AEROSPIKE_ERR_INVALID_NODE,
+							   "Node not found for partition %s:%u", cmd.ns, cmd.partition_id);
+	}
+
+	// Write command after previous commands for the same node.
+	as_pipeline_node* pn = as_pipeline_node_get(pnodes, node, &cmd);
+	uint8_t* buf = as_pipeline_node_reserve(pn, size);
+
+	switch (op->type) {
+		case AS_PIPELINE_GET:
+			size = as_get_write(buf, read_policy, op->key, n_fields, filter_size);
+			break;
+
+		case AS_PIPELINE_EXISTS:
+			size = as_exists_write(buf, read_policy, op->key, n_fields, filter_size);
+			break;
+
+		case AS_PIPELINE_PUT:
+			size = as_put_write(&put, buf);
+			break;
+
+		case AS_PIPELINE_REMOVE:
+			size = as_remove_write(buf, remove_policy, op->key, n_fields, filter_size);
+			break;
+
+		case AS_PIPELINE_OPERATE:
+			size = as_operate_write(&oper, buf);
+			break;
+	}
+
+	if (compression_threshold > 0 && size > compression_threshold) {
+		// Replace command with its compressed form.
+		size_t comp_capacity = as_command_compress_max_size(size);
+		size_t comp_size = comp_capacity;
+		uint8_t* comp_buf = as_command_buffer_init(comp_capacity);
+		status = as_command_compress(err, buf, size, comp_buf, &comp_size);
+
+		if (status != AEROSPIKE_OK) {
+			as_command_buffer_free(comp_buf, comp_capacity);
+			return status;
+		}
+		buf = as_pipeline_node_reserve(pn, comp_size);
+		memcpy(buf, comp_buf, comp_size);
+		as_command_buffer_free(comp_buf, comp_capacity);
+		size = comp_size;
+	}
+
+	pn->size += size;
+	as_vector_append(&pn->indexes, &index);
+	return AEROSPIKE_OK;
+}
+
+static inline void
+as_pipeline_fail(as_pipeline_op* ops, as_vector* indexes, uint32_t offset, const as_error* err)
+{
+	for (uint32_t i = offset; i < indexes->size; i++) {
+		as_pipeline_op* op = &ops[*(uint32_t*)as_vector_get(indexes, i)];
+		op->result = err->code;
+		as_error_copy(&op->error, err);
+	}
+}
+
+static as_status
+as_pipeline_send(as_error* err, as_pipeline_node* pn)
+{
+	as_node* node = pn->node;
+
+	if (! as_node_valid_error_count(node)) {
+		return as_error_set_message(err, AEROSPIKE_MAX_ERROR_RATE, "Max error rate exceeded");
+	}
+
+	as_status status = as_node_get_connection(err, node, pn->socket_timeout, pn->deadline_ms,
+											  &pn->socket);
+
+	if (status != AEROSPIKE_OK) {
+		return status;
+	}
+
+	status = as_socket_write_deadline(err, &pn->socket, node, pn->buf, pn->size,
+									  pn->socket_timeout, pn->deadline_ms);
+
+	if (status != AEROSPIKE_OK) {
+		as_node_close_conn_error(node, &pn->socket, pn->socket.pool);
+	}
+	return status;
+}
+
+static inline bool
+as_pipeline_conn_error(as_error* err, as_status status)
+{
+	// Client errors and client timeouts can leave unread data in socket.
+	// Server timeouts have a message.  Client timeouts do not have a message.
+	return status < 0 || status == AEROSPIKE_NOT_AUTHENTICATED ||
+		(status == AEROSPIKE_ERR_TIMEOUT && ! err->message[0]);
+}
+
+static as_status
+as_pipeline_read(aerospike* as, as_error* err, as_pipeline_node* pn, as_pipeline_op* ops)
+{
+	as_command cmd;
+	cmd.socket_timeout = pn->socket_timeout;
+	cmd.deadline_ms = pn->deadline_ms;
+
+	as_vector* indexes = &pn->indexes;
+
+	for (uint32_t i = 0; i < indexes->size; i++) {
+		as_pipeline_op* op = &ops[*(uint32_t*)as_vector_get(indexes, i)];
+		as_command_parse_result_data data;
+		data.record = &op->record;
+
+		switch (op->type) {
+			case AS_PIPELINE_GET: {
+				const as_policy_read* policy = op->policy.read ? op->policy.read :
+															   &as->config.policies.read;
+				data.deserialize = policy->deserialize;
+				data.arena = policy->record_arena;
+				cmd.parse_results_fn = as_command_parse_result;
+				cmd.udata = &data;
+				break;
+			}
+
+			case AS_PIPELINE_OPERATE: {
+				const as_policy_operate* policy = op->policy.operate ? op->policy.operate :
+																	 &as->config.policies.operate;
+				data.deserialize = policy->deserialize;
+				data.arena = policy->record_arena;
+				cmd.parse_results_fn = as_command_parse_result;
+				cmd.udata = &data;
+				break;
+			}
+
+			case AS_PIPELINE_EXISTS:
+				cmd.parse_results_fn = as_command_parse_header;
+				cmd.udata = &op->record;
+				break;
+
+			default:
+				cmd.parse_results_fn = as_command_parse_header;
+				cmd.udata = NULL;
+				break;
+		}
+
+		as_status status = as_command_read_message(&op->error, &cmd, &pn->socket, pn->node);
+		op->result = status;
+
+		if (status != AEROSPIKE_OK && as_pipeline_conn_error(&op->error, status)) {
+			// Remaining responses can not be read.
+			as_error_copy(err, &op->error);
+			as_pipeline_fail(ops, indexes, i + 1, err);
+			return status;
+		}
+	}
+	return AEROSPIKE_OK;
+}
+
+as_status
+aerospike_key_pipeline(aerospike* as, as_error* err, as_pipeline_op* ops, uint32_t n_ops)
+{
+	as_error_reset(err);
+
+	as_nodes* nodes = as_nodes_reserve(as->cluster);
+	uint32_t n_nodes = nodes->size;
+	as_nodes_release(nodes);
+
+	if (n_nodes == 0) {
+		as_error_set_message(err, AEROSPIKE_ERR_SERVER,
+							 "Pipeline failed because cluster is empty.");
+
+		for (uint32_t i = 0; i < n_ops; i++) {
+			ops[i].result = err->code;
+			as_error_copy(&ops[i].error, err);
+		}
+		return err->code;
+	}
+
+	as_vector pnodes;
+	as_vector_inita(&pnodes, sizeof(as_pipeline_node), n_nodes);
+
+	// Group commands by node. Commands that can not be prepared keep their error result.
+	for (uint32_t i = 0; i < n_ops; i++) {
+		as_error_init(&ops[i].error);
+		ops[i].result = as_pipeline_prepare(as, &ops[i].error, &ops[i], i, &pnodes);
+	}
+
+	as_status status = AEROSPIKE_OK;
+	as_error node_err;
+
+	// Send all commands to every node before reading any response.
+	for (uint32_t i = 0; i < pnodes.size; i++) {
+		as_pipeline_node* pn = as_vector_get(&pnodes, i);
+		as_status s = as_pipeline_send(&node_err, pn);
+
+		if (s == AEROSPIKE_OK) {
+			pn->sent = true;
+		}
+		else {
+			as_pipeline_fail(ops, &pn->indexes, 0, &node_err);
+
+			if (status == AEROSPIKE_OK) {
+				status = s;
+				as_error_copy(err, &node_err);
+			}
+		}
+	}
+
+	// Read responses in order for each node.
+	for (uint32_t i = 0; i < pnodes.size; i++) {
+		as_pipeline_node* pn = as_vector_get(&pnodes, i);
+
+		if (pn->sent) {
+			as_status s = as_pipeline_read(as, &node_err, pn, ops);
+
+			if (s == AEROSPIKE_OK) {
+				as_node_put_connection(pn->node, &pn->socket);
+			}
+			else {
+				as_node_close_conn_error(pn->node, &pn->socket, pn->socket.pool);
+
+				if (status == AEROSPIKE_OK) {
+					status = s;
+					as_error_copy(err, &node_err);
+				}
+			}
+		}
+		as_node_release(pn->node);
+		as_vector_destroy(&pn->indexes);
+		cf_free(pn->buf);
+	}
+	as_vector_destroy(&pnodes);
+	return status;
+}
@@ -26,6 +26,7 @@
 #include <aerospike/as_module.h>
 #include <aerospike/as_msgpack.h>
 #include <aerospike/as_operations.h>
+#include <aerospike/as_parse_pool.h>
 #include <aerospike/as_policy.h>
 #include <aerospike/as_query.h>
 #include <aerospike/as_query_validate.h>
@@ -36,6 +37,7 @@
 #include <aerospike/as_stream.h>
 #include <aerospike/as_thread_pool.h>
 #include <aerospike/as_udf_context.h>
+#include <aerospike/as_vector.h>
 #include <aerospike/mod_lua.h>
 
 /******************************************************************************
@@ -45,11 +47,43 @@
 #define QUERY_FOREGROUND 1
 #define QUERY_BACKGROUND 2
 
+// Maximum partial results merged by each parallel aggregation merge state.
+#define QUERY_AGGR_FAN_IN 4
+
 typedef struct as_query_user_callback_s {
 	aerospike_query_foreach_callback callback;
 	void* udata;
+	uint32_t* error_mutex;
 } as_query_user_callback;
 
+typedef struct as_query_aggr_queue_s {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	as_val** vals;
+	uint32_t capacity;
+	uint32_t head;
+	uint32_t size;
+	bool abort;
+} as_query_aggr_queue;
+
+typedef struct as_query_aggr_input_s {
+	as_stream* streams;
+	uint32_t n_streams;
+	uint32_t next;
+} as_query_aggr_input;
+
+typedef struct as_query_aggr_merge_s {
+	as_stream* stream;
+	uint32_t remaining;
+} as_query_aggr_merge;
+
+typedef struct as_query_native_s {
+	const as_query_aggregator* aggr;
+	pthread_key_t key;
+	pthread_mutex_t lock;
+	as_vector states;
+} as_query_native;
+
 typedef struct as_query_task_s {
 	as_node* node;
 	
@@ -61,20 +95,26 @@ typedef struct as_query_task_s {
 	void* udata;
 	uint32_t* error_mutex;
 	as_error* err;
-	cf_queue* input_queue;
 	cf_queue* complete_q;
+	as_parse_pool* parse_pool;
+	as_parse_stream* stream;
 	uint64_t task_id;
 	uint64_t cluster_key;
 
 	uint8_t* cmd;
 	size_t cmd_size;
+	bool aggregate;
 	bool first;
 } as_query_task;
 
 typedef struct as_query_task_aggr_s {
 	const as_query* query;
+	const char* function;
 	as_stream* input_stream;
+	as_stream* output_stream;
 	as_query_user_callback* callback_data;
+	as_query_aggr_queue* queues;
+	uint32_t n_queues;
 	uint32_t* error_mutex;
 	as_error* err;
 	cf_queue* complete_q;
@@ -130,6 +170,45 @@ static const as_aerospike_hooks query_aerospike_hooks = {
 	.log = as_query_aerospike_log,
 };
 
+static void
+as_query_aggr_queue_init(as_query_aggr_queue* q, uint32_t capacity)
+{
+	if (capacity == 0) {
+		capacity = 1;
+	}
+
+	pthread_mutex_init(&q->lock, NULL);
+	pthread_cond_init(&q->cond, NULL);
+	q->vals = cf_malloc(sizeof(as_val*) * capacity);
+	q->capacity = capacity;
+	q->head = 0;
+	q->size = 0;
+	q->abort = false;
+}
+
+static void
+as_query_aggr_queue_destroy(as_query_aggr_queue* q)
+{
+	// Destroy values that were not consumed.
+	while (q->size > 0) {
+		as_val_destroy(q->vals[q->head]);
+		q->head = (q->head + 1) % q->capacity;
+		q->size--;
+	}
+	cf_free(q->vals);
+	pthread_cond_destroy(&q->cond);
+	pthread_mutex_destroy(&q->lock);
+}
+
+static void
+as_query_aggr_queue_abort(as_query_aggr_queue* q)
+{
+	pthread_mutex_lock(&q->lock);
+	q->abort = true;
+	pthread_cond_broadcast(&q->cond);
+	pthread_mutex_unlock(&q->lock);
+}
+
 // This is a no-op. the queue and its contents are destroyed at end of aerospike_query_foreach().
 static int
 as_input_stream_destroy(as_stream *s)
@@ -140,20 +219,49 @@ as_input_stream_destroy(as_stream *s)
 static as_val*
 as_input_stream_read(const as_stream* s)
 {
+	as_query_aggr_queue* q = as_stream_source(s);
 	as_val* val = NULL;
-	cf_queue_pop(as_stream_source(s), &val, CF_QUEUE_FOREVER);
+
+	pthread_mutex_lock(&q->lock);
+
+	while (q->size == 0 && ! q->abort) {
+		pthread_cond_wait(&q->cond, &q->lock);
+	}
+
+	// Return end of stream on abort.
+	if (q->size > 0) {
+		val = q->vals[q->head];
+		q->head = (q->head + 1) % q->capacity;
+		q->size--;
+		pthread_cond_broadcast(&q->cond);
+	}
+	pthread_mutex_unlock(&q->lock);
 	return val;
 }
 
 static as_stream_status
 as_input_stream_write(const as_stream* s, as_val* val)
 {
-    if (cf_queue_push(as_stream_source(s), &val) != CF_QUEUE_OK) {
-        as_log_error("Write to client side stream failed.");
-        as_val_destroy(val);
-        return AS_STREAM_ERR;
-    }
-    return AS_STREAM_OK;
+	as_query_aggr_queue* q = as_stream_source(s);
+
+	pthread_mutex_lock(&q->lock);
+
+	// Block until the aggregation catches up.
+	while (q->size == q->capacity && ! q->abort) {
+		pthread_cond_wait(&q->cond, &q->lock);
+	}
+
+	if (q->abort) {
+		pthread_mutex_unlock(&q->lock);
+		as_val_destroy(val);
+		return AS_STREAM_ERR;
+	}
+
+	q->vals[(q->head + q->size) % q->capacity] = val;
+	q->size++;
+	pthread_cond_broadcast(&q->cond);
+	pthread_mutex_unlock(&q->lock);
+	return AS_STREAM_OK;
 }
 
 static const as_stream_hooks input_stream_hooks = {
@@ -171,6 +279,55 @@ as_query_aggregate_callback(const as_val* v, void* udata)
     return status? false : true;
 }
 
+// Distribute values across parallel aggregation input streams.
+static bool
+as_query_aggregate_parallel_callback(const as_val* v, void* udata)
+{
+	as_query_aggr_input* input = udata;
+
+	if (! v) {
+		// End of stream must be sent to all aggregation states.
+		bool rv = true;
+
+		for (uint32_t i = 0; i < input->n_streams; i++) {
+			if (as_stream_write(&input->streams[i], NULL) != AS_STREAM_OK) {
+				rv = false;
+			}
+		}
+		return rv;
+	}
+
+	uint32_t i = as_faa_uint32(&input->next, 1) % input->n_streams;
+	as_stream_status status = as_stream_write(&input->streams[i], (as_val*)v);
+	return status? false : true;
+}
+
+static int
+as_merge_stream_destroy(as_stream* s)
+{
+	return 0;
+}
+
+static as_stream_status
+as_merge_stream_write(const as_stream* s, as_val* val)
+{
+	as_query_aggr_merge* merge = as_stream_source(s);
+
+	if (! val) {
+		// Only the last child aggregation to finish ends the merge stream.
+		if (as_aaf_uint32(&merge->remaining, -1) != 0) {
+			return AS_STREAM_OK;
+		}
+	}
+	return as_stream_write(merge->stream, val);
+}
+
+static const as_stream_hooks merge_stream_hooks = {
+    .destroy  = as_merge_stream_destroy,
+    .read     = NULL,
+    .write    = as_merge_stream_write
+};
+
 static int
 as_output_stream_destroy(as_stream* s)
 {
@@ -181,6 +338,14 @@ static as_stream_status
 as_output_stream_write(const as_stream* s, as_val* val)
 {
 	as_query_user_callback* source = (as_query_user_callback*)as_stream_source(s);
+
+	// Aborted input streams read as end of stream, so the final aggregation may still emit a
+	// partial result after the query failed. Do not pass it to the user.
+	if (as_load_uint32(source->error_mutex)) {
+		as_val_destroy(val);
+		return AS_STREAM_ERR;
+	}
+
 	bool rv = source->callback(val, source->udata);
 	as_val_destroy(val);
 	return rv? AS_STREAM_OK : AS_STREAM_ERR;
@@ -209,7 +374,8 @@ as_query_parse_record_async(as_event_command* cmd, uint8_t** pp, as_msg* msg, as
 	*pp = as_command_parse_key(*pp, msg->n_fields, &rec.key);
 
 	as_status status = as_command_parse_bins(pp, err, &rec, msg->n_ops,
-											 cmd->flags2 & AS_ASYNC_FLAGS2_DESERIALIZE);
+											 cmd->flags2 & AS_ASYNC_FLAGS2_DESERIALIZE,
+											 cmd->flags2 & AS_ASYNC_FLAGS2_RECORD_ARENA);
 
 	if (status != AEROSPIKE_OK) {
 		as_record_destroy(&rec);
@@ -276,7 +442,7 @@ as_query_parse_record(uint8_t** pp, as_msg* msg, as_query_task* task, as_error*
 {
 	bool rv = true;
 	
-	if (task->input_queue) {
+	if (task->aggregate) {
 		// Parse aggregate return values.
 		as_val* val = 0;
 		as_status status = as_command_parse_success_failure_bins(pp, err, msg, &val);
@@ -309,7 +475,9 @@ as_query_parse_record(uint8_t** pp, as_msg* msg, as_query_task* task, as_error*
 		rec.ttl = cf_server_void_time_to_ttl(msg->record_ttl);
 		*pp = as_command_parse_key(*pp, msg->n_fields, &rec.key);
 
-		as_status status = as_command_parse_bins(pp, err, &rec, msg->n_ops, task->query_policy->deserialize);
+		as_status status = as_command_parse_bins(pp, err, &rec, msg->n_ops,
+												 task->query_policy->deserialize,
+												 task->query_policy->record_arena);
 
 		if (status != AEROSPIKE_OK) {
 			as_record_destroy(&rec);
@@ -368,6 +536,83 @@ as_query_parse_records(as_error* err, as_node* node, uint8_t* buf, size_t size,
 	return AEROSPIKE_OK;
 }
 
+static as_status
+as_query_parse_block(as_error* err, uint8_t* buf, size_t size, void* udata)
+{
+	// Runs on a parse thread. Message headers were swapped by the socket reader in
+	// as_query_stage_records().
+	as_query_task* task = udata;
+	uint8_t* p = buf;
+	uint8_t* end = buf + size;
+	as_status status;
+
+	while (p < end) {
+		as_msg* msg = (as_msg*)p;
+		p += sizeof(as_msg);
+
+		status = as_query_parse_record(&p, msg, task, err);
+
+		if (status != AEROSPIKE_OK) {
+			return status;
+		}
+
+		if (as_load_uint32(task->error_mutex)) {
+			err->code = AEROSPIKE_ERR_QUERY_ABORTED;
+			return err->code;
+		}
+	}
+	return AEROSPIKE_OK;
+}
+
+static as_status
+as_query_stage_records(as_error* err, as_node* node, uint8_t* buf, size_t size, void* udata)
+{
+	// Runs on the socket reader thread. Only frame messages here. Record parsing and user
+	// callbacks are handed off to the parse pool.
+	as_query_task* task = udata;
+	uint8_t* p = buf;
+	uint8_t* end = buf + size;
+	as_status status = AEROSPIKE_OK;
+
+	while (p < end) {
+		as_msg* msg = (as_msg*)p;
+		as_msg_swap_header_from_be(msg);
+
+		if (msg->result_code) {
+			// Set name that doesn't exist on a node returns "not found".
+			// See as_query_parse_records().
+			if (msg->result_code == AEROSPIKE_ERR_RECORD_NOT_FOUND) {
+				status = AEROSPIKE_NO_MORE_RECORDS;
+			}
+			else {
+				status = as_error_set_message(err, msg->result_code,
+											  as_error_string(msg->result_code));
+			}
+			end = (uint8_t*)msg;
+			break;
+		}
+
+		if (msg->info3 & AS_MSG_INFO3_LAST) {
+			status = AEROSPIKE_NO_MORE_RECORDS;
+			end = (uint8_t*)msg;
+			break;
+		}
+		p += sizeof(as_msg);
+		p = as_command_ignore_fields(p, msg->n_fields);
+		p = as_command_ignore_bins(p, msg->n_ops);
+	}
+
+	// The stream is drained in as_query_command_execute() after the command completes.
+	if (end > buf) {
+		as_status rv = as_parse_stream_push(task->stream, err, buf, end - buf);
+
+		if (rv != AEROSPIKE_OK) {
+			return rv;
+		}
+	}
+	return status;
+}
+
 static as_status
 as_query_command_execute(as_query_task* task)
 {
@@ -409,11 +654,20 @@ as_query_command_execute(as_query_task* task)
 	cmd.partition = NULL; // Not referenced when node set.
 	cmd.parse_results_fn = as_query_parse_records;
 	cmd.udata = task;
+
+	as_parse_stream stream;
+
+	if (task->parse_pool) {
+		as_parse_stream_init(task->parse_pool, &stream, task);
+		task->stream = &stream;
+		cmd.parse_results_fn = as_query_stage_records;
+	}
 	cmd.buf = task->cmd;
 	cmd.buf_size = task->cmd_size;
 	cmd.partition_id = 0; // Not referenced when node set.
 	cmd.replica = AS_POLICY_REPLICA_MASTER;
 	cmd.flags = flags;
+	cmd.latency_type = AS_LATENCY_TYPE_QUERY;
 
 	as_command_start_timer(&cmd);
 
@@ -422,6 +676,17 @@ as_query_command_execute(as_query_task* task)
 
 	status = as_command_execute(&cmd, &err);
 
+	if (task->parse_pool) {
+		// Blocks may still be queued when the command failed.
+		as_error parse_err;
+		as_status parse_status = as_parse_stream_drain(&stream, &parse_err);
+
+		if (parse_status != AEROSPIKE_OK && status == AEROSPIKE_OK) {
+			status = parse_status;
+			as_error_copy(&err, &parse_err);
+		}
+	}
+
 	if (status) {
 		// Set main error only once.
 		if (as_fas_uint32(task->error_mutex, 1) == 0) {
@@ -891,6 +1156,24 @@ as_query_execute(as_query_task* task, const as_query* query, as_nodes* nodes, ui
 	task->cmd_size = size;
 	task->complete_q = cf_queue_create(sizeof(as_query_complete_task), true);
 
+	as_parse_pool parse_pool;
+	task->parse_pool = NULL;
+
+	if (query_type == QUERY_FOREGROUND && task->query_policy &&
+		task->query_policy->parse_threads > 0) {
+		const as_policy_query* qp = task->query_policy;
+		status = as_parse_pool_init(&parse_pool, task->err, qp->parse_threads,
+									qp->parse_queue_size, qp->parse_ordered,
+									as_query_parse_block);
+
+		if (status != AEROSPIKE_OK) {
+			cf_queue_destroy(task->complete_q);
+			as_command_buffer_free(cmd, size);
+			return status;
+		}
+		task->parse_pool = &parse_pool;
+	}
+
 	uint32_t n_wait_nodes = nodes->size;
 	uint32_t thread_pool_size = task->cluster->thread_pool.thread_size;
 
@@ -936,6 +1219,10 @@ as_query_execute(as_query_task* task, const as_query* query, as_nodes* nodes, ui
 		}
 	}
 	
+	if (task->parse_pool) {
+		as_parse_pool_destroy(task->parse_pool);
+	}
+
 	// If user aborts query, command is considered successful.
 	if (status == AEROSPIKE_ERR_CLIENT_ABORT) {
 		status = AEROSPIKE_OK;
@@ -972,15 +1259,18 @@ as_query_aggregate(void* data)
 	};
 
 	// The callback stream provides the ability to write to a user callback function
-	// when as_stream_write is called.
+	// when as_stream_write is called. Parallel aggregations below the final state write to
+	// their parent's merge stream instead.
 	as_stream output_stream;
 	as_stream_init(&output_stream, task->callback_data, &output_stream_hooks);
 	
+	as_stream* ostream = task->output_stream ? task->output_stream : &output_stream;
+
 	// Apply the UDF to the result stream
 	as_result res;
 	as_result_init(&res);
 	
-	as_status status = as_module_apply_stream(&mod_lua, &ctx, query->apply.module, query->apply.function, task->input_stream, query->apply.arglist, &output_stream, &res);
+	as_status status = as_module_apply_stream(&mod_lua, &ctx, query->apply.module, task->function, task->input_stream, query->apply.arglist, ostream, &res);
 	
 	if (status) {
 		// Aggregation failed. Abort entire query.
@@ -1006,11 +1296,144 @@ as_query_aggregate(void* data)
 			}
 			cf_free(rs);
 		}
+		else {
+			// Query already failed and this aggregation was stopped as a result.
+			status = AEROSPIKE_ERR_QUERY_ABORTED;
+		}
+
+		// Unblock query threads and other aggregations waiting on full or empty streams.
+		for (uint32_t i = 0; i < task->n_queues; i++) {
+			as_query_aggr_queue_abort(&task->queues[i]);
+		}
 	}
 	as_result_destroy(&res);
 	cf_queue_push(task->complete_q, &status);
 }
 
+static void*
+as_query_aggregate_worker(void* data)
+{
+	as_query_aggregate(data);
+	return NULL;
+}
+
+static as_status
+as_query_aggregate_parallel(
+	as_query_task* task, const as_query* query, as_nodes* nodes, as_query_task_aggr* task_aggr,
+	uint32_t n_threads, uint32_t capacity
+	)
+{
+	// Server results are distributed across n_threads leaf states. Leaf states reduce their
+	// share with the merge function, and their partial results are merged in a tree of merge
+	// states with at most QUERY_AGGR_FAN_IN children each. Only the root state runs the
+	// client side stage of the apply function, so stages after reduce() run exactly once.
+	uint32_t n_states = n_threads;
+	uint32_t level_size = n_threads;
+
+	while (level_size > 1) {
+		level_size = (level_size + QUERY_AGGR_FAN_IN - 1) / QUERY_AGGR_FAN_IN;
+		n_states += level_size;
+	}
+
+	uint32_t root = n_states - 1;
+	as_query_aggr_queue* queues = cf_malloc(sizeof(as_query_aggr_queue) * n_states);
+	as_stream* streams = cf_malloc(sizeof(as_stream) * n_states);
+	as_query_aggr_merge* merges = cf_malloc(sizeof(as_query_aggr_merge) * n_states);
+	as_stream* merge_outputs = cf_malloc(sizeof(as_stream) * n_states);
+	as_query_task_aggr* tasks = cf_malloc(sizeof(as_query_task_aggr) * n_states);
+	pthread_t* threads = cf_malloc(sizeof(pthread_t) * n_states);
+
+	for (uint32_t i = 0; i < n_states; i++) {
+		as_query_aggr_queue_init(&queues[i], capacity);
+		as_stream_init(&streams[i], &queues[i], &input_stream_hooks);
+
+		as_query_task_aggr* ta = &tasks[i];
+		memcpy(ta, task_aggr, sizeof(as_query_task_aggr));
+		ta->function = (i == root)? query->apply.function : query->apply_merge;
+		ta->input_stream = &streams[i];
+		ta->output_stream = NULL;
+		ta->queues = queues;
+		ta->n_queues = n_states;
+
+		merges[i].stream = &streams[i];
+		merges[i].remaining = 0;
+		as_stream_init(&merge_outputs[i], &merges[i], &merge_stream_hooks);
+	}
+
+	// Connect each state to its parent merge state, one tree level at a time.
+	uint32_t level_begin = 0;
+	level_size = n_threads;
+
+	while (level_size > 1) {
+		uint32_t parent_begin = level_begin + level_size;
+
+		for (uint32_t i = 0; i < level_size; i++) {
+			uint32_t parent = parent_begin + i / QUERY_AGGR_FAN_IN;
+			tasks[level_begin + i].output_stream = &merge_outputs[parent];
+			merges[parent].remaining++;
+		}
+		level_begin = parent_begin;
+		level_size = (level_size + QUERY_AGGR_FAN_IN - 1) / QUERY_AGGR_FAN_IN;
+	}
+
+	as_query_aggr_input input;
+	input.streams = streams;
+	input.n_streams = n_threads;
+	input.next = 0;
+
+	task->callback = as_query_aggregate_parallel_callback;
+	task->udata = &input;
+
+	as_status status = AEROSPIKE_OK;
+	uint32_t n_started = 0;
+
+	for (uint32_t i = 0; i < n_states; i++) {
+		int rc = pthread_create(&threads[i], NULL, as_query_aggregate_worker, &tasks[i]);
+
+		if (rc != 0) {
+			if (as_fas_uint32(task->error_mutex, 1) == 0) {
+				status = as_error_update(task->err, AEROSPIKE_ERR_CLIENT,
+										 "Failed to create aggregate thread: %d", rc);
+			}
+
+			for (uint32_t j = 0; j < n_states; j++) {
+				as_query_aggr_queue_abort(&queues[j]);
+			}
+			break;
+		}
+		n_started++;
+	}
+
+	if (status == AEROSPIKE_OK) {
+		status = as_query_execute(task, query, nodes, QUERY_FOREGROUND);
+	}
+
+	// Wait for aggregation threads to finish.
+	for (uint32_t i = 0; i < n_started; i++) {
+		as_status complete_status = AEROSPIKE_OK;
+		cf_queue_pop(task_aggr->complete_q, &complete_status, CF_QUEUE_FOREVER);
+
+		if (complete_status != AEROSPIKE_OK && status == AEROSPIKE_OK) {
+			status = complete_status;
+		}
+	}
+
+	for (uint32_t i = 0; i < n_started; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	for (uint32_t i = 0; i < n_states; i++) {
+		as_query_aggr_queue_destroy(&queues[i]);
+	}
+	cf_free(threads);
+	cf_free(tasks);
+	cf_free(merge_outputs);
+	cf_free(merges);
+	cf_free(streams);
+	cf_free(queues);
+	return status;
+}
+
 static void
 convert_query_to_scan(
 	const as_policy_query* query_policy, const as_query* query, as_policy_scan* scan_policy,
@@ -1043,6 +1466,35 @@ convert_query_to_scan(
 	scan->_free = query->_free;
 }
 
+static bool
+as_query_native_callback(const as_val* v, void* udata)
+{
+	if (! v) {
+		return true;
+	}
+
+	as_query_native* native = udata;
+	const as_query_aggregator* aggr = native->aggr;
+	as_record* rec = as_record_fromval(v);
+
+	if (! rec) {
+		return false;
+	}
+
+	// Each thread folds records into its own partial state.
+	void* state = pthread_getspecific(native->key);
+
+	if (! state) {
+		state = aggr->create(aggr->udata);
+		pthread_setspecific(native->key, state);
+
+		pthread_mutex_lock(&native->lock);
+		as_vector_append(&native->states, &state);
+		pthread_mutex_unlock(&native->lock);
+	}
+	return aggr->map(state, rec, aggr->udata);
+}
+
 /******************************************************************************
  * FUNCTIONS
  *****************************************************************************/
@@ -1070,6 +1522,13 @@ aerospike_query_foreach(
 
 	as_error_reset(err);
 
+	if (query->apply.function[0] && policy->aggregate_threads > 1 && ! query->apply_merge[0]) {
+		// Partial results can't be merged with the client side stage of the apply function,
+		// because stages after reduce() would run more than once.
+		return as_error_set_message(err, AEROSPIKE_ERR_PARAM,
+									"Parallel aggregation requires as_query_apply_merge()");
+	}
+
 	as_nodes* nodes;
 	as_status status = as_cluster_reserve_all_nodes(cluster, err, &nodes);
 
@@ -1090,22 +1549,47 @@ aerospike_query_foreach(
 		.udata = 0,
 		.error_mutex = &error_mutex,
 		.err = err,
-		.input_queue = 0,
 		.complete_q = 0,
 		.task_id = as_random_get_uint64(),
 		.cluster_key = 0,
 		.cmd = 0,
 		.cmd_size = 0,
+		.aggregate = false,
 		.first = true
 	};
 	
-	if (query->apply.function[0]) {
+	if (query->apply.function[0] && policy->aggregate_threads > 1) {
+		// Query with parallel aggregation.
+		task.aggregate = true;
+
+		as_query_user_callback callback_data;
+		callback_data.callback = callback;
+		callback_data.udata = udata;
+		callback_data.error_mutex = &error_mutex;
+
+		as_query_task_aggr task_aggr;
+		task_aggr.query = query;
+		task_aggr.callback_data = &callback_data;
+		task_aggr.error_mutex = &error_mutex;
+		task_aggr.err = err;
+		task_aggr.complete_q = cf_queue_create(sizeof(as_status), true);
+
+		status = as_query_aggregate_parallel(&task, query, nodes, &task_aggr,
+											 policy->aggregate_threads,
+											 policy->aggregate_queue_size);
+
+		cf_queue_destroy(task_aggr.complete_q);
+	}
+	else if (query->apply.function[0]) {
 		// Query with aggregation.
-		task.input_queue = cf_queue_create(sizeof(void*), true);
-		
+		task.aggregate = true;
+
+		as_query_aggr_queue input_queue;
+		as_query_aggr_queue_init(&input_queue, policy->aggregate_queue_size);
+
         // Stream for results from each node
         as_stream input_stream;
-        as_stream_init(&input_stream, task.input_queue, &input_stream_hooks);
+        as_stream_init(&input_stream, &input_queue, &input_stream_hooks);
 		
 		task.callback = as_query_aggregate_callback;
 		task.udata = &input_stream;
@@ -1113,11 +1597,16 @@ aerospike_query_foreach(
 		as_query_user_callback callback_data;
 		callback_data.callback = callback;
 		callback_data.udata = udata;
+		callback_data.error_mutex = &error_mutex;
 
 		as_query_task_aggr task_aggr;
 		task_aggr.query = query;
+		task_aggr.function = query->apply.function;
 		task_aggr.input_stream = &input_stream;
+		task_aggr.output_stream = NULL;
 		task_aggr.callback_data = &callback_data;
+		task_aggr.queues = &input_queue;
+		task_aggr.n_queues = 1;
 		task_aggr.error_mutex = &error_mutex;
 		task_aggr.err = err;
 		task_aggr.complete_q = cf_queue_create(sizeof(as_status), true);
@@ -1143,17 +1632,12 @@ aerospike_query_foreach(
 		cf_queue_destroy(task_aggr.complete_q);
 		
 		// Empty input queue.
-        as_val* val = NULL;
-        while (cf_queue_pop(task.input_queue, &val, CF_QUEUE_NOWAIT) == CF_QUEUE_OK) {
-            as_val_destroy(val);
-        }
-        cf_queue_destroy(task.input_queue);
+		as_query_aggr_queue_destroy(&input_queue);
 	}
 	else {
 		// Normal query without aggregation.
 		task.callback = callback;
 		task.udata = udata;
-		task.input_queue = 0;
 		status = as_query_execute(&task, query, nodes, QUERY_FOREGROUND);
 	}
 
@@ -1161,6 +1645,64 @@ aerospike_query_foreach(
 	return status;
 }
 
+as_status
+aerospike_query_aggregate(
+	aerospike* as, as_error* err, const as_policy_query* policy, const as_query* query,
+	const as_query_aggregator* aggr, void** result
+	)
+{
+	*result = NULL;
+
+	if (query->apply.function[0]) {
+		return as_error_set_message(err, AEROSPIKE_ERR_PARAM,
+									"Native aggregation does not support query UDF");
+	}
+
+	as_query_native native;
+	native.aggr = aggr;
+
+	int rc = pthread_key_create(&native.key, NULL);
+
+	if (rc != 0) {
+		return as_error_update(err, AEROSPIKE_ERR_CLIENT, "Failed to create thread key: %d", rc);
+	}
+
+	pthread_mutex_init(&native.lock, NULL);
+	as_vector_inita(&native.states, sizeof(void*), 32);
+
+	as_status status = aerospike_query_foreach(as, err, policy, query, as_query_native_callback,
+											   &native);
+
+	// All worker threads are finished, so the states can be combined without locking.
+	if (status == AEROSPIKE_OK) {
+		void* state;
+
+		if (native.states.size > 0) {
+			state = *(void**)as_vector_get(&native.states, 0);
+
+			for (uint32_t i = 1; i < native.states.size; i++) {
+				void* other = *(void**)as_vector_get(&native.states, i);
+				aggr->reduce(state, other, aggr->udata);
+				aggr->destroy(other, aggr->udata);
+			}
+		}
+		else {
+			state = aggr->create(aggr->udata);
+		}
+		*result = state;
+	}
+	else {
+		for (uint32_t i = 0; i < native.states.size; i++) {
+			aggr->destroy(*(void**)as_vector_get(&native.states, i), aggr->udata);
+		}
+	}
+
+	as_vector_destroy(&native.states);
+	pthread_mutex_destroy(&native.lock);
+	pthread_key_delete(native.key);
+	return status;
+}
+
 as_status
 aerospike_query_async(
 	aerospike* as, as_error* err, const as_policy_query* policy, const as_query* query,
@@ -1258,11 +1800,17 @@ aerospike_query_async(
 		cmd->buf = ((as_async_query_command*)cmd)->space;
 		cmd->write_len = (uint32_t)size;
 		cmd->read_capacity = (uint32_t)(s - size - sizeof(as_async_query_command));
+		cmd->alloc_size = (uint32_t)s;
 		cmd->type = AS_ASYNC_TYPE_QUERY;
 		cmd->proto_type = AS_MESSAGE_TYPE;
 		cmd->state = AS_ASYNC_STATE_UNREGISTERED;
-		cmd->flags = AS_ASYNC_FLAGS_MASTER;
+		cmd->flags = 0;
 		cmd->flags2 = policy->deserialize ? AS_ASYNC_FLAGS2_DESERIALIZE : 0;
+		cmd->replica_index = 0;
+
+		if (policy->record_arena) {
+			cmd->flags2 |= AS_ASYNC_FLAGS2_RECORD_ARENA;
+		}
 		memcpy(cmd->buf, cmd_buf, size);
 		exec->commands[i] = cmd;
 	}
@@ -1335,12 +1883,12 @@ aerospike_query_background(
 		.udata = 0,
 		.error_mutex = &error_mutex,
 		.err = err,
-		.input_queue = 0,
 		.complete_q = 0,
 		.task_id = task_id,
 		.cluster_key = 0,
 		.cmd = 0,
 		.cmd_size = 0,
+		.aggregate = false,
 		.first = false
 	};
 	
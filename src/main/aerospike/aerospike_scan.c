@@ -24,6 +24,7 @@
 #include <aerospike/as_log.h>
 #include <aerospike/as_msgpack.h>
 #include <aerospike/as_operations.h>
+#include <aerospike/as_parse_pool.h>
 #include <aerospike/as_partition_tracker.h>
 #include <aerospike/as_query_validate.h>
 #include <aerospike/as_random.h>
@@ -50,6 +51,8 @@ typedef struct as_scan_task_s {
 	void* udata;
 	as_error* err;
 	cf_queue* complete_q;
+	as_parse_pool* parse_pool;
+	as_parse_stream* stream;
 	uint32_t* error_mutex;
 	uint64_t task_id;
 	uint64_t cluster_key;
@@ -72,9 +75,11 @@ typedef struct as_async_scan_executor {
 	uint32_t cmd_size_pre;
 	uint32_t cmd_size_post;
 	uint32_t task_id_offset;
+	uint32_t rps_offset;
 	uint16_t n_fields;
 	bool concurrent;
 	bool deserialize_list_map;
+	bool record_arena;
 } as_async_scan_executor;
 
 typedef struct as_async_scan_command {
@@ -89,8 +94,10 @@ typedef struct as_scan_builder {
 	as_buffer argbuffer;
 	as_queue* opsbuffers;
 	uint64_t max_records;
+	uint32_t records_per_second;
 	uint32_t predexp_size;
 	uint32_t task_id_offset;
+	uint32_t rps_offset;
 	uint32_t parts_full_size;
 	uint32_t parts_partial_size;
 	uint32_t cmd_size_pre;
@@ -172,7 +179,8 @@ as_scan_parse_record_async(
 	*pp = as_command_parse_key(*pp, msg->n_fields, &rec.key);
 
 	as_status status = as_command_parse_bins(pp, err, &rec, msg->n_ops,
-											 sc->command.flags2 & AS_ASYNC_FLAGS2_DESERIALIZE);
+											 sc->command.flags2 & AS_ASYNC_FLAGS2_DESERIALIZE,
+											 sc->command.flags2 & AS_ASYNC_FLAGS2_RECORD_ARENA);
 
 	if (status != AEROSPIKE_OK) {
 		as_record_destroy(&rec);
@@ -269,7 +277,9 @@ as_scan_parse_record(uint8_t** pp, as_msg* msg, as_scan_task* task, as_error* er
 	rec.ttl = cf_server_void_time_to_ttl(msg->record_ttl);
 	*pp = as_command_parse_key(*pp, msg->n_fields, &rec.key);
 
-	as_status status = as_command_parse_bins(pp, err, &rec, msg->n_ops, task->scan->deserialize_list_map);
+	as_status status = as_command_parse_bins(pp, err, &rec, msg->n_ops,
+											 task->scan->deserialize_list_map,
+											 task->policy->record_arena);
 
 	if (status != AEROSPIKE_OK) {
 		as_record_destroy(&rec);
@@ -349,6 +359,108 @@ as_scan_parse_records(as_error* err, as_node* node, uint8_t* buf, size_t size, v
 	return AEROSPIKE_OK;
 }
 
+static as_status
+as_scan_parse_block(as_error* err, uint8_t* buf, size_t size, void* udata)
+{
+	// Runs on a parse thread. Message headers were swapped by the socket reader in
+	// as_scan_stage_records(). Partition status is only updated here, after records are
+	// delivered, so a resumed scan never skips records that the callback did not receive.
+	as_scan_task* task = udata;
+	uint8_t* p = buf;
+	uint8_t* end = buf + size;
+	as_status status;
+
+	while (p < end) {
+		as_msg* msg = (as_msg*)p;
+		p += sizeof(as_msg);
+
+		if (msg->info3 & AS_MSG_INFO3_PARTITION_DONE) {
+			// Only mark partition done when result_code is AEROSPIKE_OK.
+			// The server may return PARTITION_UNAVAILABLE (AEROSPIKE_ERR_CLUSTER) which
+			// means the specified partition will need to be requested on the scan retry.
+			if (task->pt && msg->result_code == AEROSPIKE_OK) {
+				as_partition_tracker_part_done(task->pt, task->np, msg->generation);
+			}
+			continue;
+		}
+
+		status = as_scan_parse_record(&p, msg, task, err);
+
+		if (status != AEROSPIKE_OK) {
+			return status;
+		}
+
+		if (as_load_uint32(task->error_mutex)) {
+			err->code = AEROSPIKE_ERR_SCAN_ABORTED;
+			return err->code;
+		}
+	}
+	return AEROSPIKE_OK;
+}
+
+static as_status
+as_scan_stage_records(as_error* err, as_node* node, uint8_t* buf, size_t size, void* udata)
+{
+	// Runs on the socket reader thread. Only frame messages here. Record parsing, user
+	// callbacks and partition status updates are handed off to the parse pool.
+	as_scan_task* task = udata;
+	uint8_t* p = buf;
+	uint8_t* end = buf + size;
+	as_status status = AEROSPIKE_OK;
+
+	while (p < end) {
+		as_msg* msg = (as_msg*)p;
+		as_msg_swap_header_from_be(msg);
+
+		if (msg->info3 & AS_MSG_INFO3_LAST) {
+			if (msg->result_code != AEROSPIKE_OK) {
+				// The server returned a fatal error.
+				status = as_error_set_message(err, msg->result_code,
+											  as_error_string(msg->result_code));
+			}
+			else {
+				status = AEROSPIKE_NO_MORE_RECORDS;
+			}
+			end = (uint8_t*)msg;
+			break;
+		}
+
+		if (task->pt && (msg->info3 & AS_MSG_INFO3_PARTITION_DONE)) {
+			// Partition done markers are applied in order by the parse thread.
+			p += sizeof(as_msg);
+			continue;
+		}
+
+		if (msg->result_code != AEROSPIKE_OK) {
+			// Background scans return AEROSPIKE_ERR_RECORD_NOT_FOUND
+			// when the set does not exist on the target node.
+			if (msg->result_code == AEROSPIKE_ERR_RECORD_NOT_FOUND) {
+				// Non-fatal error.
+				status = AEROSPIKE_NO_MORE_RECORDS;
+			}
+			else {
+				status = as_error_set_message(err, msg->result_code,
+											  as_error_string(msg->result_code));
+			}
+			end = (uint8_t*)msg;
+			break;
+		}
+		p += sizeof(as_msg);
+		p = as_command_ignore_fields(p, msg->n_fields);
+		p = as_command_ignore_bins(p, msg->n_ops);
+	}
+
+	// The stream is drained in as_scan_command_execute() after the command completes.
+	if (end > buf) {
+		as_status rv = as_parse_stream_push(task->stream, err, buf, end - buf);
+
+		if (rv != AEROSPIKE_OK) {
+			return rv;
+		}
+	}
+	return status;
+}
+
 static size_t
 as_scan_command_size(const as_policy_scan* policy, const as_scan* scan, as_scan_builder* sb)
 {
@@ -375,7 +487,7 @@ as_scan_command_size(const as_policy_scan* policy, const as_scan* scan, as_scan_
 		n_fields++;
 	}
 	
-	if (policy->records_per_second > 0) {
+	if (sb->records_per_second > 0) {
 		size += as_command_field_size(sizeof(uint32_t));
 		n_fields++;
 	}
@@ -494,8 +606,12 @@ as_scan_command_init(
 		p = as_command_write_field_string(p, AS_FIELD_SETNAME, scan->set);
 	}
 
-	if (policy->records_per_second > 0) {
-		p = as_command_write_field_uint32(p, AS_FIELD_SCAN_RPS, policy->records_per_second);
+	if (sb->records_per_second > 0) {
+		p = as_command_write_field_uint32(p, AS_FIELD_SCAN_RPS, sb->records_per_second);
+		sb->rps_offset = ((uint32_t)(p - cmd)) - sizeof(uint32_t);
+	}
+	else {
+		sb->rps_offset = 0;
 	}
 
 	// Write socket timeout.
@@ -613,9 +729,11 @@ as_scan_command_execute(as_scan_task* task)
 
 	if (task->pt) {
 		sb.max_records = task->np->record_max;
+		sb.records_per_second = task->np->records_per_second;
 	}
 	else {
 		sb.max_records = 0;
+		sb.records_per_second = task->policy->records_per_second;
 	}
 
 	size_t size = as_scan_command_size(task->policy, task->scan, &sb);
@@ -630,11 +748,26 @@ as_scan_command_execute(as_scan_task* task)
 	cmd.partition = NULL; // Not referenced when node set.
 	cmd.parse_results_fn = as_scan_parse_records;
 	cmd.udata = task;
+
+	as_parse_stream stream;
+
+	if (task->parse_pool) {
+		as_parse_stream_init(task->parse_pool, &stream, task);
+		task->stream = &stream;
+
+		if (task->pt) {
+			// Partition status must be updated in delivery order, so blocks of a partition
+			// scan are parsed sequentially on the stream's parse thread.
+			stream.ordered = true;
+		}
+		cmd.parse_results_fn = as_scan_stage_records;
+	}
 	cmd.buf = buf;
 	cmd.buf_size = size;
 	cmd.partition_id = 0; // Not referenced when node set.
 	cmd.replica = AS_POLICY_REPLICA_MASTER;
 	cmd.flags = AS_COMMAND_FLAGS_READ;
+	cmd.latency_type = AS_LATENCY_TYPE_SCAN;
 
 	as_command_start_timer(&cmd);
 
@@ -644,6 +777,17 @@ as_scan_command_execute(as_scan_task* task)
 
 	status = as_command_execute(&cmd, &err);
 
+	if (task->parse_pool) {
+		// Blocks may still be queued when the command failed.
+		as_error parse_err;
+		as_status parse_status = as_parse_stream_drain(&stream, &parse_err);
+
+		if (parse_status != AEROSPIKE_OK && status == AEROSPIKE_OK) {
+			status = parse_status;
+			as_error_copy(&err, &parse_err);
+		}
+	}
+
 	// Free command memory.
 	as_command_buffer_free(buf, size);
 
@@ -729,6 +873,7 @@ as_scan_generic(
 	as_scan_task task;
 	task.np = NULL;
 	task.pt = NULL;
+	task.parse_pool = NULL;
 	task.cluster = cluster;
 	task.policy = policy;
 	task.scan = scan;
@@ -825,13 +970,24 @@ as_scan_partitions(
 	as_partition_tracker* pt, aerospike_scan_foreach_callback callback, void* udata)
 {
 	as_status status;
+	as_parse_pool parse_pool;
+
+	if (policy->parse_threads > 0) {
+		status = as_parse_pool_init(&parse_pool, err, policy->parse_threads,
+									policy->parse_queue_size, policy->parse_ordered,
+									as_scan_parse_block);
+
+		if (status != AEROSPIKE_OK) {
+			return status;
+		}
+	}
 
 	while (true) {
 		uint64_t task_id = as_random_get_uint64();
 		status = as_partition_tracker_assign(pt, cluster, scan->ns, err);
 
 		if (status != AEROSPIKE_OK) {
-			return status;
+			break;
 		}
 
 		uint32_t n_nodes = pt->node_parts.size;
@@ -850,6 +1006,7 @@ as_scan_partitions(
 		task.task_id = task_id;
 		task.cluster_key = 0;
 		task.first = false;
+		task.parse_pool = (policy->parse_threads > 0)? &parse_pool : NULL;
 
 		if (scan->concurrent && n_nodes > 1) {
 			uint32_t n_wait_nodes = n_nodes;
@@ -865,6 +1022,9 @@ as_scan_partitions(
 				task_node->np = as_vector_get(&pt->node_parts, i);
 				task_node->node = task_node->np->node;
 
+				// Sub-scans on the same node (node_parallelism > 1) require distinct task ids.
+				task_node->task_id = task_id + i;
+
 				int rc = as_thread_pool_queue_task(&cluster->thread_pool, as_scan_worker, task_node);
 				
 				if (rc) {
@@ -910,7 +1070,7 @@ as_scan_partitions(
 		}
 
 		if (status != AEROSPIKE_OK) {
-			return status;
+			break;
 		}
 
 		status = as_partition_tracker_is_complete(pt, err);
@@ -926,6 +1086,10 @@ as_scan_partitions(
 		}
 	}
 
+	if (policy->parse_threads > 0) {
+		as_parse_pool_destroy(&parse_pool);
+	}
+
 	if (status == AEROSPIKE_OK) {
 		callback(NULL, udata);
 	}
@@ -974,6 +1138,16 @@ as_scan_partition_execute_async(as_async_scan_executor* se, as_partition_tracker
 		// Copy first part of generic command.
 		memcpy(p, se->cmd_buf, se->cmd_size_pre);
 
+		if (i > 0) {
+			// Sub-scans on the same node (node_parallelism > 1) require distinct task ids.
+			*(uint64_t*)(p + se->task_id_offset) += i;
+		}
+
+		if (se->rps_offset > 0) {
+			// Sub-scans on the same node (node_parallelism > 1) share the node's rps limit.
+			*(uint32_t*)(p + se->rps_offset) = cf_swap_to_be32(np->records_per_second);
+		}
+
 		// Update n_fields in header.
 		*(uint16_t*)&p[26] = cf_swap_to_be16(n_fields);
 		p += se->cmd_size_pre;
@@ -1031,11 +1205,17 @@ as_scan_partition_execute_async(as_async_scan_executor* se, as_partition_tracker
 		cmd->pipe_listener = NULL;
 		cmd->write_len = (uint32_t)size;
 		cmd->read_capacity = (uint32_t)(s - size - sizeof(as_async_scan_command));
+		cmd->alloc_size = (uint32_t)s;
 		cmd->type = AS_ASYNC_TYPE_SCAN_PARTITION;
 		cmd->proto_type = AS_MESSAGE_TYPE;
 		cmd->state = AS_ASYNC_STATE_UNREGISTERED;
-		cmd->flags = AS_ASYNC_FLAGS_MASTER;
+		cmd->flags = 0;
 		cmd->flags2 = se->deserialize_list_map ? AS_ASYNC_FLAGS2_DESERIALIZE : 0;
+		cmd->replica_index = 0;
+
+		if (se->record_arena) {
+			cmd->flags2 |= AS_ASYNC_FLAGS2_RECORD_ARENA;
+		}
 		ee->commands[i] = cmd;
 	}
 
@@ -1079,9 +1259,11 @@ as_scan_partition_retry_async(as_async_scan_executor* se_old, as_error* err)
 	se->cmd_size_pre = se_old->cmd_size_pre;
 	se->cmd_size_post = se_old->cmd_size_post;
 	se->task_id_offset = se_old->task_id_offset;
+	se->rps_offset = se_old->rps_offset;
 	se->n_fields = se_old->n_fields;
 	se->concurrent = se_old->concurrent;
 	se->deserialize_list_map = se_old->deserialize_list_map;
+	se->record_arena = se_old->record_arena;
 
 	// Must change task_id each round. Otherwise, server rejects command.
 	uint64_t task_id = as_random_get_uint64();
@@ -1140,6 +1322,7 @@ as_scan_partition_async(
 	sb.np = NULL;
 	sb.opsbuffers = &opsbuffers;
 	sb.max_records = 0;
+	sb.records_per_second = policy->records_per_second;
 
 	size_t cmd_size = as_scan_command_size(policy, scan, &sb);
 	uint8_t* cmd_buf = cf_malloc(cmd_size);
@@ -1154,9 +1337,11 @@ as_scan_partition_async(
 	se->cmd_size_pre = sb.cmd_size_pre;
 	se->cmd_size_post = sb.cmd_size_post;
 	se->task_id_offset = sb.task_id_offset;
+	se->rps_offset = sb.rps_offset;
 	se->n_fields = sb.n_fields;
 	se->concurrent = scan->concurrent;
 	se->deserialize_list_map = scan->deserialize_list_map;
+	se->record_arena = policy->record_arena;
 
 	uint32_t n_nodes = pt->node_parts.size;
 
@@ -77,6 +77,27 @@ as_conn_stats_tostring(as_string_builder* sb, const char* title, as_conn_stats*
 	as_string_builder_append_char(sb, ')');
 }
 
+static void
+as_latency_tostring(as_string_builder* sb, as_node_stats* node_stats)
+{
+	for (uint32_t i = 0; i < AS_LATENCY_TYPE_MAX; i++) {
+		as_latency_buckets* latency = &node_stats->latency[i];
+		uint64_t count = as_latency_count(latency);
+
+		if (count == 0) {
+			continue;
+		}
+
+		char buf[256];
+		snprintf(buf, sizeof(buf), "%s: %" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64,
+				 as_latency_type_string(i), count, as_latency_percentile(latency, 50.0),
+				 as_latency_percentile(latency, 99.0), as_latency_percentile(latency, 99.9));
+
+		as_string_builder_append(sb, buf);
+		as_string_builder_append_newline(sb);
+	}
+}
+
 /******************************************************************************
  * FUNCTIONS
  *****************************************************************************/
@@ -110,6 +131,8 @@ aerospike_cluster_stats(as_cluster* cluster, as_cluster_stats* stats)
 
 	// cf_queue applies locks, so we are safe here.
 	stats->thread_pool_queued_tasks = cf_queue_sz(cluster->thread_pool.dispatch_queue);
+
+	as_compress_stats_get(&stats->compression);
 }
 
 void
@@ -134,6 +157,13 @@ aerospike_node_stats(as_node* node, as_node_stats* stats)
 	as_node_reserve(node); // Released in aerospike_node_stats_destroy()
 	stats->node = node;
 	stats->error_count = as_node_get_error_count(node);
+	stats->concurrency_limit = as_load_uint32(&node->concurrency_limit);
+	stats->concurrency = as_load_uint32(&node->concurrency);
+	stats->concurrency_rejected = as_load_uint32(&node->concurrency_rejected);
+
+	for (uint32_t i = 0; i < AS_LATENCY_TYPE_MAX; i++) {
+		as_latency_copy(&stats->latency[i], &node->latency[i]);
+	}
 
 	as_sum_init(&stats->sync);
 	as_sum_init(&stats->async);
@@ -145,10 +175,9 @@ aerospike_node_stats(as_node* node, as_node_stats* stats)
 	for (uint32_t i = 0; i < max; i++) {
 		as_conn_pool* pool = &node->sync_conn_pools[i];
 
-		pthread_mutex_lock(&pool->lock);
-		uint32_t in_pool = as_queue_size(&pool->queue);
-		uint32_t total = pool->queue.total;
-		pthread_mutex_unlock(&pool->lock);
+		uint32_t in_pool;
+		uint32_t total;
+		as_conn_pool_usage(pool, &in_pool, &total);
 
 		stats->sync.in_pool += in_pool;
 		stats->sync.in_use += total - in_pool;
@@ -186,10 +215,24 @@ aerospike_stats_to_string(as_cluster_stats* stats)
 		as_string_builder_append(&sb, "error count: ");
 		as_string_builder_append_uint(&sb, node_stats->error_count);
 		as_string_builder_append_newline(&sb);
+
+		if (node_stats->concurrency_limit > 0) {
+			as_string_builder_append(&sb, "concurrency(limit,inUse,rejected): (");
+			as_string_builder_append_uint(&sb, node_stats->concurrency_limit);
+			as_string_builder_append_char(&sb, ',');
+			as_string_builder_append_uint(&sb, node_stats->concurrency);
+			as_string_builder_append_char(&sb, ',');
+			as_string_builder_append_uint(&sb, node_stats->concurrency_rejected);
+			as_string_builder_append_char(&sb, ')');
+			as_string_builder_append_newline(&sb);
+		}
+		as_string_builder_append(&sb, "latency(count,p50,p99,p999) in microseconds:");
+		as_string_builder_append_newline(&sb);
+		as_latency_tostring(&sb, node_stats);
 	}
 
 	if (stats->event_loops) {
-		as_string_builder_append(&sb, "event loops(processSize,queueSize): ");
+		as_string_builder_append(&sb, "event loops(processSize,queueSize,submitSize,wakeups): ");
 
 		for (uint32_t i = 0; i < stats->event_loops_size; i++) {
 			as_event_loop_stats* ev_stats = &stats->event_loops[i];
@@ -201,9 +244,28 @@ aerospike_stats_to_string(as_cluster_stats* stats)
 			as_string_builder_append_int(&sb, ev_stats->process_size);
 			as_string_builder_append_char(&sb, ',');
 			as_string_builder_append_uint(&sb, ev_stats->queue_size);
+			as_string_builder_append_char(&sb, ',');
+			as_string_builder_append_uint(&sb, ev_stats->submit_size);
+
+			char buf[32];
+			snprintf(buf, sizeof(buf), ",%" PRIu64, ev_stats->wakeups);
+			as_string_builder_append(&sb, buf);
 			as_string_builder_append_char(&sb, ')');
 		}
 		as_string_builder_append_newline(&sb);
 	}
+
+	as_compress_stats* cs = &stats->compression;
+
+	if (cs->compress_in > 0 || cs->decompress_in > 0) {
+		char buf[256];
+		snprintf(buf, sizeof(buf),
+				 "compression(in,out,ns): compress(%" PRIu64 ",%" PRIu64 ",%" PRIu64
+				 ") decompress(%" PRIu64 ",%" PRIu64 ",%" PRIu64 ")",
+				 cs->compress_in, cs->compress_out, cs->compress_ns,
+				 cs->decompress_in, cs->decompress_out, cs->decompress_ns);
+		as_string_builder_append(&sb, buf);
+		as_string_builder_append_newline(&sb);
+	}
 	return sb.data;
 }
@@ -17,6 +17,7 @@
 #include <aerospike/as_cluster.h>
 #include <aerospike/as_address.h>
 #include <aerospike/as_admin.h>
+#include <aerospike/as_cluster_snapshot.h>
 #include <aerospike/as_command.h>
 #include <aerospike/as_cpu.h>
 #include <aerospike/as_info.h>
@@ -33,6 +34,7 @@
 #include <citrusleaf/alloc.h>
 #include <citrusleaf/cf_byte_order.h>
 #include <citrusleaf/cf_clock.h>
+#include <citrusleaf/cf_queue.h>
 
 /******************************************************************************
  * Globals
@@ -58,6 +60,17 @@ as_node_refresh_partitions(as_cluster* cluster, as_error* err, as_node* node, as
 as_status
 as_node_refresh_racks(as_cluster* cluster, as_error* err, as_node* node);
 
+void
+as_node_tend_request_init(as_node_tend_request* req, as_node* node, as_node_tend_type type);
+
+void
+as_node_tend_fetch(as_node_tend_request* req);
+
+as_status
+as_node_tend_process(
+	as_cluster* cluster, as_error* err, as_node_tend_request* req, as_peers* peers
+	);
+
 void
 as_event_balance_connections(as_cluster* cluster);
 
@@ -667,6 +680,59 @@ as_cluster_destroy_peers(as_peers* peers)
 /**
  * Check health of all nodes in the cluster.
  */
+typedef struct as_tend_task_s {
+	as_node_tend_request req;
+	cf_queue* complete_q;
+} as_tend_task;
+
+static void
+as_cluster_tend_worker(void* data)
+{
+	as_tend_task* task = data;
+	as_node_tend_fetch(&task->req);
+
+	int complete = 1;
+	cf_queue_push(task->complete_q, &complete);
+}
+
+static void
+as_cluster_tend_fetch(as_cluster* cluster, as_tend_task* tasks, uint32_t n_tasks)
+{
+	if (cluster->tend_pool.thread_size == 0 || n_tasks <= 1) {
+		// Send info requests sequentially in tend thread.
+		for (uint32_t i = 0; i < n_tasks; i++) {
+			as_node_tend_fetch(&tasks[i].req);
+		}
+		return;
+	}
+
+	// Send info requests to all nodes in parallel, so tend takes about one round trip
+	// regardless of cluster size.
+	cf_queue* complete_q = cf_queue_create(sizeof(int), true);
+	uint32_t n_wait = 0;
+
+	for (uint32_t i = 0; i < n_tasks; i++) {
+		as_tend_task* task = &tasks[i];
+		task->complete_q = complete_q;
+
+		int rc = as_thread_pool_queue_task(&cluster->tend_pool, as_cluster_tend_worker, task);
+
+		if (rc) {
+			// Thread could not be added. Send request in tend thread.
+			as_node_tend_fetch(&task->req);
+			continue;
+		}
+		n_wait++;
+	}
+
+	// Wait for requests to complete.
+	for (uint32_t i = 0; i < n_wait; i++) {
+		int complete;
+		cf_queue_pop(complete_q, &complete, CF_QUEUE_FOREVER);
+	}
+	cf_queue_destroy(complete_q);
+}
+
 as_status
 as_cluster_tend(as_cluster* cluster, as_error* err, bool enable_seed_warnings)
 {
@@ -728,19 +794,29 @@ as_cluster_tend(as_cluster* cluster, as_error* err, bool enable_seed_warnings)
 		}
 
 		// Refresh all known nodes.
+		as_tend_task* tasks = cf_malloc(sizeof(as_tend_task) * nodes->size);
+		uint32_t n_tasks = 0;
+
 		for (uint32_t i = 0; i < nodes->size; i++) {
 			as_node* node = nodes->array[i];
 
 			if (node->active) {
-				as_status status = as_node_refresh(cluster, &error_local, node, &peers);
+				as_node_tend_request_init(&tasks[n_tasks++].req, node, AS_NODE_TEND_REFRESH);
+			}
+		}
 
-				if (status != AEROSPIKE_OK) {
-					// Use info level so aql doesn't see message by default.
-					as_log_info("Node %s refresh failed: %s %s",
-						node->name, as_error_string(status), error_local.message);
-					peers.gen_changed = true;
-					as_cluster_node_failure(node);
-				}
+		as_cluster_tend_fetch(cluster, tasks, n_tasks);
+
+		for (uint32_t i = 0; i < n_tasks; i++) {
+			as_node* node = tasks[i].req.node;
+			as_status status = as_node_tend_process(cluster, &error_local, &tasks[i].req, &peers);
+
+			if (status != AEROSPIKE_OK) {
+				// Use info level so aql doesn't see message by default.
+				as_log_info("Node %s refresh failed: %s %s",
+					node->name, as_error_string(status), error_local.message);
+				peers.gen_changed = true;
+				as_cluster_node_failure(node);
 			}
 		}
 
@@ -749,18 +825,27 @@ as_cluster_tend(as_cluster* cluster, as_error* err, bool enable_seed_warnings)
 			// Refresh peers for all nodes that responded the first time even if only one node's
 			// peers changed.
 			peers.refresh_count = 0;
+			n_tasks = 0;
 
 			for (uint32_t i = 0; i < nodes->size; i++) {
 				as_node* node = nodes->array[i];
 
 				if (node->failures == 0 && node->active) {
-					as_status status = as_node_refresh_peers(cluster, &error_local, node, &peers);
-	
-					if (status != AEROSPIKE_OK) {
-						as_log_warn("Node %s peers refresh failed: %s %s",
-							node->name, as_error_string(status), error_local.message);
-						as_cluster_node_failure(node);
-					}
+					as_node_tend_request_init(&tasks[n_tasks++].req, node, AS_NODE_TEND_PEERS);
+				}
+			}
+
+			as_cluster_tend_fetch(cluster, tasks, n_tasks);
+
+			for (uint32_t i = 0; i < n_tasks; i++) {
+				as_node* node = tasks[i].req.node;
+				as_status status = as_node_tend_process(cluster, &error_local, &tasks[i].req,
+														&peers);
+
+				if (status != AEROSPIKE_OK) {
+					as_log_warn("Node %s peers refresh failed: %s %s",
+						node->name, as_error_string(status), error_local.message);
+					as_cluster_node_failure(node);
 				}
 			}
 
@@ -777,6 +862,7 @@ as_cluster_tend(as_cluster* cluster, as_error* err, bool enable_seed_warnings)
 			}
 			as_vector_destroy(&nodes_to_remove);
 		}
+		cf_free(tasks);
 
 		// Add peer nodes to cluster.
 		if (peers.nodes.size > 0) {
@@ -789,6 +875,9 @@ as_cluster_tend(as_cluster* cluster, as_error* err, bool enable_seed_warnings)
 	cluster->invalid_node_count = as_peers_invalid_count(&peers);
 
 	// Refresh partition map when necessary.
+	as_tend_task* tasks = cf_malloc(sizeof(as_tend_task) * (nodes->size + 1));
+	uint32_t n_tasks = 0;
+
 	for (uint32_t i = 0; i < nodes->size; i++) {
 		as_node* node = nodes->array[i];
 		
@@ -797,30 +886,54 @@ as_cluster_tend(as_cluster* cluster, as_error* err, bool enable_seed_warnings)
 		// nodes to be dropped.
 		if (node->partition_changed && node->failures == 0 && node->active &&
 		   (node->peers_count > 0 || peers.refresh_count == 1)) {
-			as_status status = as_node_refresh_partitions(cluster, &error_local, node, &peers);
-			
-			if (status != AEROSPIKE_OK) {
-				as_log_warn("Node %s partition refresh failed: %s %s",
-							node->name, as_error_string(status), error_local.message);
-				as_cluster_node_failure(node);
-			}
+			as_node_tend_request_init(&tasks[n_tasks++].req, node, AS_NODE_TEND_PARTITIONS);
 		}
+	}
+
+	// Responses are processed in node order on the tend thread, so partition tables are
+	// still only modified by a single thread.
+	as_cluster_tend_fetch(cluster, tasks, n_tasks);
+
+	for (uint32_t i = 0; i < n_tasks; i++) {
+		as_node* node = tasks[i].req.node;
+		as_status status = as_node_tend_process(cluster, &error_local, &tasks[i].req, &peers);
+
+		if (status != AEROSPIKE_OK) {
+			as_log_warn("Node %s partition refresh failed: %s %s",
+						node->name, as_error_string(status), error_local.message);
+			as_cluster_node_failure(node);
+		}
+	}
+
+	// Refresh racks when necessary.
+	n_tasks = 0;
+
+	for (uint32_t i = 0; i < nodes->size; i++) {
+		as_node* node = nodes->array[i];
 
 		if (node->rebalance_changed && node->failures == 0 && node->active) {
-			as_status status = as_node_refresh_racks(cluster, &error_local, node);
+			as_node_tend_request_init(&tasks[n_tasks++].req, node, AS_NODE_TEND_RACKS);
+		}
+	}
 
-			if (status == AEROSPIKE_OK) {
-				if (cluster->shm_info && node->racks && node->racks->size > 0) {
-					rebalance = true;
-				}
-			}
-			else {
-				as_log_warn("Node %s rack refresh failed: %s %s",
-							node->name, as_error_string(status), error_local.message);
-				as_cluster_node_failure(node);
+	as_cluster_tend_fetch(cluster, tasks, n_tasks);
+
+	for (uint32_t i = 0; i < n_tasks; i++) {
+		as_node* node = tasks[i].req.node;
+		as_status status = as_node_tend_process(cluster, &error_local, &tasks[i].req, NULL);
+
+		if (status == AEROSPIKE_OK) {
+			if (cluster->shm_info && node->racks && node->racks->size > 0) {
+				rebalance = true;
 			}
 		}
+		else {
+			as_log_warn("Node %s rack refresh failed: %s %s",
+						node->name, as_error_string(status), error_local.message);
+			as_cluster_node_failure(node);
+		}
 	}
+	cf_free(tasks);
 
 	if (rebalance && cluster->shm_info) {
 		// Update shared memory to notify prole tenders to rebalance (retrieve racks info).
@@ -881,6 +994,15 @@ as_cluster_tender(void* data)
 		if (status != AEROSPIKE_OK) {
 			as_log_warn("Tend error: %s %s", as_error_string(status), err.message);
 		}
+
+		if (cluster->snapshot_path) {
+			uint64_t now = cf_getms();
+
+			if (now - cluster->snapshot_ms >= cluster->snapshot_interval) {
+				as_cluster_snapshot_write(cluster);
+				cluster->snapshot_ms = now;
+			}
+		}
 		
 		// Convert tend interval into absolute timeout.
 		cf_clock_current_add(&delta, &abstime);
@@ -981,6 +1103,13 @@ as_cluster_add_seeds(as_cluster* cluster)
 as_status
 as_cluster_init(as_cluster* cluster, as_error* err, bool fail_if_not_connected)
 {
+	// Route commands from snapshot while the tend thread validates the snapshot nodes.
+	if (cluster->snapshot_path && as_cluster_snapshot_load(cluster)) {
+		as_cluster_add_seeds(cluster);
+		cluster->valid = true;
+		return AEROSPIKE_OK;
+	}
+
 	// Tend cluster until all nodes identified.
 	as_status status = as_wait_till_stabilized(cluster, err);
 	
@@ -1194,12 +1323,30 @@ as_cluster_create(as_config* config, as_error* err, as_cluster** cluster_out)
 	// Heap allocated cluster_name continues to be owned by as->config.
 	// Make a reference copy here.
 	cluster->cluster_name = config->cluster_name;
+
+	// Snapshot sessions can't be persisted and shared memory already provides warm startup.
+	if (config->snapshot_path && ! cluster->auth_enabled && ! config->use_shm) {
+		cluster->snapshot_path = config->snapshot_path;
+	}
+	else {
+		cluster->snapshot_path = NULL;
+	}
+	cluster->snapshot_interval = config->snapshot_interval;
+	cluster->snapshot_ms = 0;
 	cluster->event_callback = config->event_callback;
 	cluster->event_callback_udata = config->event_callback_udata;
 
 	// Initialize cluster tend and node parameters
 	cluster->max_error_rate = config->max_error_rate;
 	cluster->error_rate_window = config->error_rate_window;
+	cluster->max_concurrency = config->max_concurrency_per_node;
+	cluster->min_concurrency = (config->min_concurrency_per_node == 0) ?
+		1 : config->min_concurrency_per_node;
+
+	if (cluster->min_concurrency > cluster->max_concurrency) {
+		cluster->min_concurrency = cluster->max_concurrency;
+	}
+	cluster->concurrency_latency_ns = (uint64_t)config->concurrency_latency_threshold * 1000 * 1000;
 	cluster->tend_interval = (config->tender_interval < 250)? 250 : config->tender_interval;
 	cluster->min_conns_per_node = config->min_conns_per_node;
 	cluster->max_conns_per_node = config->max_conns_per_node;
@@ -1211,6 +1358,7 @@ as_cluster_create(as_config* config, as_error* err, as_cluster** cluster_out)
 	cluster->tend_thread_cpu = config->tend_thread_cpu;
 	cluster->conn_pools_per_node = config->conn_pools_per_node;
 	cluster->use_services_alternate = config->use_services_alternate;
+	cluster->conn_pools_lock_free = config->conn_pools_lock_free;
 	cluster->rack_aware = config->rack_aware;
 
 	if (config->rack_ids) {
@@ -1280,6 +1428,19 @@ as_cluster_create(as_config* config, as_error* err, as_cluster** cluster_out)
 		return status;
 	}
 
+	// Initialize tend thread pool.  Zero threads sends tend requests from the tend thread.
+	uint32_t tend_threads = (config->tend_threads > 1)? config->tend_threads : 0;
+	rc = as_thread_pool_init(&cluster->tend_pool, tend_threads);
+	cluster->tend_pool.fini_fn = as_tls_thread_cleanup;
+
+	if (rc) {
+		as_status status = as_error_update(err, AEROSPIKE_ERR_CLIENT,
+				"Failed to initialize tend thread pool of size %u: %d", tend_threads, rc);
+		as_cluster_destroy(cluster);
+		*cluster_out = 0;
+		return status;
+	}
+
 	if (config->tls.enable) {
 		// Initialize TLS parameters.
 		cluster->tls_ctx = cf_malloc(sizeof(as_tls_context));
@@ -1369,6 +1530,13 @@ as_cluster_destroy(as_cluster* cluster)
 		as_log_warn("Failed to destroy thread pool: %d", rc);
 	}
 
+	// Shutdown tend thread pool.
+	rc = as_thread_pool_destroy(&cluster->tend_pool);
+
+	if (rc) {
+		as_log_warn("Failed to destroy tend thread pool: %d", rc);
+	}
+
 	// Release everything in garbage collector.
 	as_cluster_gc(cluster->gc);
 	as_vector_destroy(cluster->gc);
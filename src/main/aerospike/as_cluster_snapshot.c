@@ -0,0 +1,388 @@
+/*
+ * Copyright 2008-2021 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <aerospike/as_cluster_snapshot.h>
+#include <aerospike/as_cluster.h>
+#include <aerospike/as_log_macros.h>
+#include <aerospike/as_node.h>
+#include <aerospike/as_socket.h>
+#include <aerospike/as_string_builder.h>
+#include <citrusleaf/alloc.h>
+#include <citrusleaf/cf_b64.h>
+#include <stdio.h>
+#include <string.h>
+
+/******************************************************************************
+ * MACROS
+ *****************************************************************************/
+
+#define AS_SNAPSHOT_MAGIC "ASCS"
+#define AS_SNAPSHOT_VERSION 1
+#define AS_SNAPSHOT_MAX_NODES 1024  // Well above the largest server cluster size.
+#define AS_SNAPSHOT_MAX_RACKS 1024
+#define AS_SNAPSHOT_MAX_REPLICAS_SIZE (1024 * 1024)
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+// The snapshot is a local cache for clients on the same host, so fields are written in host
+// byte order. The version must be incremented when the layout changes.
+typedef struct as_snapshot_header_s {
+	char magic[4];
+	uint32_t version;
+	uint32_t n_partitions;
+	uint32_t n_nodes;
+} as_snapshot_header;
+
+typedef struct as_snapshot_node_s {
+	char name[AS_NODE_NAME_SIZE];
+	struct sockaddr_storage addr;
+	uint32_t features;
+	uint32_t tls_name_len;
+	int32_t rack_id;
+	uint32_t racks_size;    // UINT32_MAX when racks were never retrieved.
+	uint32_t replicas_len;  // Length of "replicas" info value that follows the racks.
+	uint32_t pad;
+} as_snapshot_node;
+
+/******************************************************************************
+ * Function declarations
+ *****************************************************************************/
+
+void
+as_cluster_add_nodes_copy(as_cluster* cluster, as_vector* /* <as_node*> */ nodes_to_add);
+
+bool
+as_partition_tables_update_all(as_cluster* cluster, as_node* node, char* buf, bool has_regime);
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+static void
+as_snapshot_append_replicas(
+	as_string_builder* sb, as_partition_tables* tables, as_node* node, uint32_t n_partitions
+	)
+{
+	// Rebuild the node's "replicas" info value (with regime) from the partition tables, so
+	// loading uses the same decode path as tend. Regimes are tracked per partition, but the
+	// info value only has one regime per namespace, so the regime field only marks strong
+	// consistency namespaces. Real regimes are filled in by the first tend after loading.
+	uint32_t bitmap_size = (n_partitions + 7) / 8;
+	uint32_t b64_size = cf_b64_encoded_len(bitmap_size);
+	uint8_t* bitmap = alloca(bitmap_size);
+	char* b64 = alloca(b64_size + 1);
+
+	for (uint32_t i = 0; i < tables->size; i++) {
+		as_partition_table* table = tables->tables[i];
+		uint32_t replica_size = table->replica_size;
+		bool found = false;
+
+		for (uint32_t j = 0; j < table->size && ! found; j++) {
+			as_partition* p = &table->partitions[j];
+
+			for (uint32_t r = 0; r < replica_size; r++) {
+				if (p->nodes[r] == node) {
+					found = true;
+					break;
+				}
+			}
+		}
+
+		if (! found) {
+			continue;
+		}
+
+		as_string_builder_append(sb, table->ns);
+		as_string_builder_append_char(sb, ':');
+		as_string_builder_append_uint(sb, table->sc_mode ? 1 : 0);
+		as_string_builder_append_char(sb, ',');
+		as_string_builder_append_uint(sb, replica_size);
+
+		for (uint32_t r = 0; r < replica_size; r++) {
+			memset(bitmap, 0, bitmap_size);
+
+			for (uint32_t j = 0; j < table->size; j++) {
+				if (table->partitions[j].nodes[r] == node) {
+					bitmap[j >> 3] |= (0x80 >> (j & 7));
+				}
+			}
+
+			cf_b64_encode(bitmap, bitmap_size, b64);
+			b64[b64_size] = 0;
+			as_string_builder_append_char(sb, ',');
+			as_string_builder_append(sb, b64);
+		}
+		as_string_builder_append_char(sb, ';');
+	}
+}
+
+static bool
+as_snapshot_write_node(
+	FILE* f, as_string_builder* sb, as_partition_tables* tables, as_node* node,
+	uint32_t n_partitions
+	)
+{
+	as_snapshot_node sn;
+	memset(&sn, 0, sizeof(sn));
+	strcpy(sn.name, node->name);
+	memcpy(&sn.addr, &as_node_get_address(node)->addr, sizeof(struct sockaddr_storage));
+	sn.features = node->features;
+	sn.tls_name_len = node->tls_name ? (uint32_t)strlen(node->tls_name) : 0;
+
+	as_racks* racks = node->racks;
+
+	if (racks) {
+		sn.rack_id = racks->rack_id;
+		sn.racks_size = racks->size;
+	}
+	else {
+		sn.rack_id = -1;
+		sn.racks_size = UINT32_MAX;
+	}
+
+	as_string_builder_reset(sb);
+	as_snapshot_append_replicas(sb, tables, node, n_partitions);
+	sn.replicas_len = sb->length;
+
+	if (fwrite(&sn, sizeof(sn), 1, f) != 1) {
+		return false;
+	}
+
+	if (sn.tls_name_len > 0 && fwrite(node->tls_name, sn.tls_name_len, 1, f) != 1) {
+		return false;
+	}
+
+	if (racks && racks->size > 0 &&
+		fwrite(racks->racks, sizeof(as_rack), racks->size, f) != racks->size) {
+		return false;
+	}
+
+	if (sn.replicas_len > 0 && fwrite(sb->data, sn.replicas_len, 1, f) != 1) {
+		return false;
+	}
+	return true;
+}
+
+static as_node*
+as_snapshot_read_node(as_cluster* cluster, FILE* f, char** replicas)
+{
+	as_snapshot_node sn;
+
+	if (fread(&sn, sizeof(sn), 1, f) != 1) {
+		return NULL;
+	}
+
+	if (sn.name[AS_NODE_NAME_SIZE - 1] != 0 || sn.tls_name_len >= AS_HOSTNAME_SIZE ||
+		(sn.racks_size != UINT32_MAX && sn.racks_size > AS_SNAPSHOT_MAX_RACKS) ||
+		sn.replicas_len > AS_SNAPSHOT_MAX_REPLICAS_SIZE ||
+		(sn.addr.ss_family != AF_INET && sn.addr.ss_family != AF_INET6)) {
+		return NULL;
+	}
+
+	char tls_name[AS_HOSTNAME_SIZE];
+
+	if (sn.tls_name_len > 0 && fread(tls_name, sn.tls_name_len, 1, f) != 1) {
+		return NULL;
+	}
+	tls_name[sn.tls_name_len] = 0;
+
+	as_racks* racks = NULL;
+
+	if (sn.racks_size != UINT32_MAX) {
+		racks = cf_malloc(sizeof(as_racks) + sizeof(as_rack) * sn.racks_size);
+		racks->ref_count = 1;
+		racks->rack_id = sn.rack_id;
+		racks->size = sn.racks_size;
+		racks->pad = 0;
+
+		if (sn.racks_size > 0 &&
+			fread(racks->racks, sizeof(as_rack), sn.racks_size, f) != sn.racks_size) {
+			cf_free(racks);
+			return NULL;
+		}
+	}
+
+	char* buf = cf_malloc(sn.replicas_len + 1);
+
+	if (sn.replicas_len > 0 && fread(buf, sn.replicas_len, 1, f) != 1) {
+		cf_free(buf);
+		cf_free(racks);
+		return NULL;
+	}
+	buf[sn.replicas_len] = 0;
+
+	// Node is not validated here. The info socket is opened and the node name is verified
+	// on the first tend.
+	as_node_info node_info;
+	memset(&node_info, 0, sizeof(node_info));
+	strcpy(node_info.name, sn.name);
+	node_info.features = sn.features;
+	node_info.host.tls_name = sn.tls_name_len > 0 ? tls_name : NULL;
+	as_socket_init(&node_info.socket);
+	memcpy(&node_info.addr, &sn.addr, sizeof(struct sockaddr_storage));
+	node_info.session = NULL;
+
+	as_node* node = as_node_create(cluster, &node_info);
+	node->racks = racks;
+	*replicas = buf;
+	return node;
+}
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+bool
+as_cluster_snapshot_load(as_cluster* cluster)
+{
+	FILE* f = fopen(cluster->snapshot_path, "rb");
+
+	if (! f) {
+		return false;
+	}
+
+	as_snapshot_header header;
+
+	if (fread(&header, sizeof(header), 1, f) != 1 ||
+		memcmp(header.magic, AS_SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+		header.version != AS_SNAPSHOT_VERSION || header.n_partitions == 0 ||
+		header.n_nodes == 0 || header.n_nodes > AS_SNAPSHOT_MAX_NODES) {
+		as_log_warn("Ignore invalid cluster snapshot %s", cluster->snapshot_path);
+		fclose(f);
+		return false;
+	}
+
+	as_vector nodes;
+	as_vector_inita(&nodes, sizeof(as_node*), header.n_nodes);
+
+	char** replicas = cf_malloc(sizeof(char*) * header.n_nodes);
+	bool valid = true;
+
+	for (uint32_t i = 0; i < header.n_nodes; i++) {
+		as_node* node = as_snapshot_read_node(cluster, f, &replicas[i]);
+
+		if (! node) {
+			valid = false;
+			break;
+		}
+		as_vector_append(&nodes, &node);
+	}
+	fclose(f);
+
+	if (! valid) {
+		as_log_warn("Ignore invalid cluster snapshot %s", cluster->snapshot_path);
+
+		for (uint32_t i = 0; i < nodes.size; i++) {
+			as_node_release(as_vector_get_ptr(&nodes, i));
+			cf_free(replicas[i]);
+		}
+		cf_free(replicas);
+		as_vector_destroy(&nodes);
+		return false;
+	}
+
+	cluster->n_partitions = header.n_partitions;
+	as_cluster_add_nodes_copy(cluster, &nodes);
+
+	// Partition entries are applied with the same decode path as tend. Node partition
+	// generations start unset, so the first tend refreshes every node's partition map.
+	for (uint32_t i = 0; i < nodes.size; i++) {
+		as_node* node = as_vector_get_ptr(&nodes, i);
+
+		if (! as_partition_tables_update_all(cluster, node, replicas[i], true)) {
+			as_log_warn("Ignore invalid snapshot partitions for node %s", node->name);
+		}
+		cf_free(replicas[i]);
+	}
+	cf_free(replicas);
+
+	// Clear placeholder regimes, so the first tend accepts every node's real regime.
+	as_partition_tables* tables = &cluster->partition_tables;
+
+	for (uint32_t i = 0; i < tables->size; i++) {
+		as_partition_table* table = tables->tables[i];
+
+		for (uint32_t j = 0; j < table->size; j++) {
+			table->partitions[j].regime = 0;
+		}
+	}
+
+	as_log_info("Loaded cluster snapshot %s with %u nodes", cluster->snapshot_path, nodes.size);
+	as_vector_destroy(&nodes);
+	return true;
+}
+
+void
+as_cluster_snapshot_write(as_cluster* cluster)
+{
+	as_nodes* nodes = cluster->nodes;
+
+	if (nodes->size == 0 || cluster->n_partitions == 0) {
+		return;
+	}
+
+	// Write to a temporary file and rename, so readers never see a partial snapshot.
+	size_t len = strlen(cluster->snapshot_path);
+	char* tmp_path = alloca(len + 5);
+	memcpy(tmp_path, cluster->snapshot_path, len);
+	memcpy(tmp_path + len, ".tmp", 5);
+
+	FILE* f = fopen(tmp_path, "wb");
+
+	if (! f) {
+		as_log_warn("Failed to create cluster snapshot %s", tmp_path);
+		return;
+	}
+
+	as_snapshot_header header;
+	memcpy(header.magic, AS_SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = AS_SNAPSHOT_VERSION;
+	header.n_partitions = cluster->n_partitions;
+	header.n_nodes = nodes->size;
+
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+
+	as_string_builder sb;
+	as_string_builder_init(&sb, 4096, true);
+
+	for (uint32_t i = 0; ok && i < nodes->size; i++) {
+		ok = as_snapshot_write_node(f, &sb, &cluster->partition_tables, nodes->array[i],
+									cluster->n_partitions);
+	}
+	as_string_builder_destroy(&sb);
+
+	if (fclose(f) != 0) {
+		ok = false;
+	}
+
+	if (! ok) {
+		as_log_warn("Failed to write cluster snapshot %s", tmp_path);
+		remove(tmp_path);
+		return;
+	}
+
+#if defined(_MSC_VER)
+	// Windows rename does not replace an existing file.
+	remove(cluster->snapshot_path);
+#endif
+
+	if (rename(tmp_path, cluster->snapshot_path) != 0) {
+		as_log_warn("Failed to rename cluster snapshot %s", tmp_path);
+		remove(tmp_path);
+	}
+}
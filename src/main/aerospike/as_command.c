@@ -16,10 +16,12 @@
  */
 #include <aerospike/as_command.h>
 #include <aerospike/as_cluster.h>
+#include <aerospike/as_compress.h>
 #include <aerospike/as_event.h>
 #include <aerospike/as_key.h>
 #include <aerospike/as_log_macros.h>
 #include <aerospike/as_msgpack.h>
+#include <aerospike/as_poll.h>
 #include <aerospike/as_record.h>
 #include <aerospike/as_serializer.h>
 #include <aerospike/as_sleep.h>
@@ -29,7 +31,6 @@
 #include <citrusleaf/cf_digest.h>
 #include <stdlib.h>
 #include <string.h>
-#include <zlib.h>
 
 /******************************************************************************
  * STATIC VARIABLES
@@ -45,13 +46,10 @@ static uint8_t as_protocol_types[] = {1, 2, 3, 4, 3, 4, 5, 7, 8, 9, 10, 11, 12,
 static as_status
 as_command_read_messages(as_error* err, as_command* cmd, as_socket* sock, as_node* node);
 
-static as_status
-as_command_read_message(as_error* err, as_command* cmd, as_socket* sock, as_node* node);
-
 as_status
 as_batch_retry(as_command* cmd, as_error* err);
 
-static size_t
+size_t
 as_command_user_key_size(const as_key* key)
 {
 	size_t size = AS_FIELD_HEADER_SIZE + 1;  // Add 1 for key's value type.
@@ -267,7 +265,7 @@ as_command_write_header_read_header(
 	return cmd + AS_HEADER_SIZE;
 }
 
-static uint8_t*
+uint8_t*
 as_command_write_user_key(uint8_t* begin, const as_key* key)
 {
 	uint8_t* p = begin + AS_FIELD_HEADER_SIZE;
@@ -338,6 +336,12 @@ as_command_write_key(uint8_t* p, as_policy_key policy, const as_key* key)
 
 uint8_t*
 as_command_write_bin_name(uint8_t* cmd, const char* name)
+{
+	return as_command_write_op_name(cmd, AS_OPERATOR_READ, name);
+}
+
+uint8_t*
+as_command_write_op_name(uint8_t* cmd, as_operator op_type, const char* name)
 {
 	uint8_t* p = cmd + AS_OPERATION_HEADER_SIZE;
 	
@@ -348,56 +352,40 @@ as_command_write_bin_name(uint8_t* cmd, const char* name)
 	uint8_t name_len = (uint8_t)(p - cmd - AS_OPERATION_HEADER_SIZE);
 	*(uint32_t*)cmd = cf_swap_to_be32((uint32_t)name_len + 4);
 	cmd += 4;
-	*cmd++ = as_protocol_types[AS_OPERATOR_READ];
+	*cmd++ = as_protocol_types[op_type];
 	*cmd++ = 0;
 	*cmd++ = 0;
 	*cmd++ = name_len;
 	return p;
 }
 
-uint8_t*
-as_command_write_bin(uint8_t* begin, as_operator op_type, const as_bin* bin, as_queue* buffers)
+static uint8_t*
+as_command_write_value(uint8_t* p, as_val* val, as_queue* buffers, uint8_t* val_type)
 {
-	uint8_t* p = begin + AS_OPERATION_HEADER_SIZE;
-	const char* name = bin->name;
-
-	// Copy string, but do not transfer null byte.
-	while (*name) {
-		*p++ = *name++;
-	}
-	uint8_t name_len = (uint8_t)(p - begin - AS_OPERATION_HEADER_SIZE);
-	as_val* val = (as_val*)bin->valuep;
-	uint32_t val_len;
-	uint8_t val_type;
-	
 	switch (val->type) {
 		default:
 		case AS_NIL: {
-			val_len = 0;
-			val_type = AS_BYTES_UNDEF;
+			*val_type = AS_BYTES_UNDEF;
 			break;
 		}
 		case AS_BOOLEAN: {
 			as_boolean* v = as_boolean_fromval(val);
 			*p++ = v->value;
-			val_len = 1;
-			val_type = AS_BYTES_BOOL;
+			*val_type = AS_BYTES_BOOL;
 			break;
 		}
 		case AS_INTEGER: {
 			as_integer* v = as_integer_fromval(val);
 			*(uint64_t*)p = cf_swap_to_be64(v->value);
 			p += 8;
-			val_len = 8;
-			val_type = AS_BYTES_INTEGER;
+			*val_type = AS_BYTES_INTEGER;
 			break;
 		}
 		case AS_DOUBLE: {
 			as_double* v = as_double_fromval(val);
 			*(double*)p = cf_swap_to_big_float64(v->value);
 			p += 8;
-			val_len = 8;
-			val_type = AS_BYTES_DOUBLE;
+			*val_type = AS_BYTES_DOUBLE;
 			break;
 		}
 		case AS_STRING: {
@@ -405,8 +393,7 @@ as_command_write_bin(uint8_t* begin, as_operator op_type, const as_bin* bin, as_
 			// v->len should have been already set by as_command_value_size().
 			memcpy(p, v->value, v->len);
 			p += v->len;
-			val_len = (uint32_t)v->len;
-			val_type = AS_BYTES_STRING;
+			*val_type = AS_BYTES_STRING;
 			break;
 		}
 		case AS_GEOJSON: {
@@ -434,19 +421,17 @@ as_command_write_bin(uint8_t* begin, as_operator op_type, const as_bin* bin, as_
 			memcpy(p, v->value, v->len);
 			p += v->len;
 
-			val_len = (uint32_t)(1 + 2 + (0 * 8) + v->len);
-			val_type = AS_BYTES_GEOJSON;
+			*val_type = AS_BYTES_GEOJSON;
 			break;
 		}
 		case AS_BYTES: {
 			as_bytes* v = as_bytes_fromval(val);
 			memcpy(p, v->value, v->size);
 			p += v->size;
-			val_len = v->size;
 			// Note: v->type must be a blob type (AS_BYTES_BLOB, AS_BYTES_JAVA, AS_BYTES_PYTHON ...).
 			// Otherwise, the particle type will be reassigned to a non-blob which causes a
 			// mismatch between type and value.
-			val_type = v->type;
+			*val_type = v->type;
 			break;
 		}
 		case AS_LIST: {
@@ -454,8 +439,7 @@ as_command_write_bin(uint8_t* begin, as_operator op_type, const as_bin* bin, as_
 			as_queue_pop(buffers, &buffer);
 			memcpy(p, buffer.data, buffer.size);
 			p += buffer.size;
-			val_len = buffer.size;
-			val_type = AS_BYTES_LIST;
+			*val_type = AS_BYTES_LIST;
 			cf_free(buffer.data);
 			break;
 		}
@@ -464,39 +448,147 @@ as_command_write_bin(uint8_t* begin, as_operator op_type, const as_bin* bin, as_
 			as_queue_pop(buffers, &buffer);
 			memcpy(p, buffer.data, buffer.size);
 			p += buffer.size;
-			val_len = buffer.size;
-			val_type = AS_BYTES_MAP;
+			*val_type = AS_BYTES_MAP;
 			cf_free(buffer.data);
 			break;
 		}
 	}
+	return p;
+}
+
+uint8_t*
+as_command_write_bin(uint8_t* begin, as_operator op_type, const as_bin* bin, as_queue* buffers)
+{
+	uint8_t* p = begin + AS_OPERATION_HEADER_SIZE;
+	const char* name = bin->name;
+
+	// Copy string, but do not transfer null byte.
+	while (*name) {
+		*p++ = *name++;
+	}
+	uint8_t name_len = (uint8_t)(p - begin - AS_OPERATION_HEADER_SIZE);
+	uint8_t val_type;
+	uint8_t* end = as_command_write_value(p, (as_val*)bin->valuep, buffers, &val_type);
+	uint32_t val_len = (uint32_t)(end - p);
+
+	*(uint32_t*)begin = cf_swap_to_be32(name_len + val_len + 4);
+	begin += 4;
+	*begin++ = as_protocol_types[op_type];
+	*begin++ = val_type;
+	*begin++ = 0;
+	*begin++ = name_len;
+	return end;
+}
+
+uint8_t*
+as_command_write_op_value(uint8_t* begin, as_val* val, as_queue* buffers)
+{
+	// Operation header and bin name were already copied from a prepared template.
+	uint8_t name_len = begin[7];
+	uint8_t* p = begin + AS_OPERATION_HEADER_SIZE + name_len;
+	uint8_t val_type;
+	uint8_t* end = as_command_write_value(p, val, buffers, &val_type);
+	uint32_t val_len = (uint32_t)(end - p);
+
 	*(uint32_t*)begin = cf_swap_to_be32(name_len + val_len + 4);
+	begin[5] = val_type;
+	return end;
+}
+
+static inline void
+as_command_iov_add(as_command_iov* iov, uint8_t* end, uint8_t* data, size_t len)
+{
+	// Close current command buffer run.
+	as_socket_iov seg = {iov->run, end - iov->run};
+	as_vector_append(&iov->segments, &seg);
+
+	// Reference bin value in place.
+	seg.data = data;
+	seg.len = len;
+	as_vector_append(&iov->segments, &seg);
+
+	iov->run = end;
+	iov->ref_size += len;
+}
+
+uint8_t*
+as_command_write_bin_iov(
+	uint8_t* begin, as_operator op_type, const as_bin* bin, as_queue* buffers,
+	as_command_iov* iov
+	)
+{
+	as_val* val = (as_val*)bin->valuep;
+	size_t ref_size = as_command_value_ref_size(val);
+
+	if (ref_size == 0) {
+		return as_command_write_bin(begin, op_type, bin, buffers);
+	}
+
+	uint8_t* data;
+	uint8_t val_type;
+
+	if (val->type == AS_STRING) {
+		data = (uint8_t*)((as_string*)val)->value;
+		val_type = AS_BYTES_STRING;
+	}
+	else {
+		as_bytes* v = (as_bytes*)val;
+		data = v->value;
+		val_type = v->type;
+	}
+
+	uint8_t* p = begin + AS_OPERATION_HEADER_SIZE;
+	const char* name = bin->name;
+
+	// Copy string, but do not transfer null byte.
+	while (*name) {
+		*p++ = *name++;
+	}
+	uint8_t name_len = (uint8_t)(p - begin - AS_OPERATION_HEADER_SIZE);
+	*(uint32_t*)begin = cf_swap_to_be32(name_len + (uint32_t)ref_size + 4);
 	begin += 4;
 	*begin++ = as_protocol_types[op_type];
 	*begin++ = val_type;
 	*begin++ = 0;
 	*begin++ = name_len;
+
+	as_command_iov_add(iov, p, data, ref_size);
 	return p;
 }
 
+size_t
+as_command_write_end_iov(uint8_t* begin, uint8_t* end, as_command_iov* iov)
+{
+	if (end > iov->run) {
+		as_socket_iov seg = {iov->run, end - iov->run};
+		as_vector_append(&iov->segments, &seg);
+		iov->run = end;
+	}
+
+	uint64_t len = (end - begin) + iov->ref_size;
+	uint64_t proto = (len - 8) | ((uint64_t)AS_PROTO_VERSION << 56) | ((uint64_t)AS_MESSAGE_TYPE << 48);
+	*(uint64_t*)begin = cf_swap_to_be64(proto);
+	return len;
+}
+
 size_t
 as_command_compress_max_size(size_t cmd_sz)
 {
-	return compressBound((uLong)cmd_sz) + sizeof(as_compressed_proto);
+	return as_compress_bound(cmd_sz) + sizeof(as_compressed_proto);
 }
 
 as_status
 as_command_compress(as_error* err, uint8_t* cmd, size_t cmd_sz, uint8_t* compressed_cmd, size_t* compressed_size)
 {
 	*compressed_size -= sizeof(as_compressed_proto);
-	int ret_val = compress2(compressed_cmd + sizeof(as_compressed_proto), (uLongf*)compressed_size,
-							cmd, (uLong)cmd_sz, Z_BEST_SPEED);
+	as_status status = as_compress(err, compressed_cmd + sizeof(as_compressed_proto),
+								   compressed_size, cmd, cmd_sz);
 	
-	if (ret_val) {
-		return as_error_update(err, AEROSPIKE_ERR_CLIENT, "Compress failed: %d", ret_val);
+	if (status != AEROSPIKE_OK) {
+		return status;
 	}
 	
-	// compressed_size will now have to actual compressed size from compress2()
+	// compressed_size will now have to actual compressed size from as_compress()
 	as_command_compress_write_end(compressed_cmd, compressed_cmd + sizeof(as_compressed_proto) +
 								  *compressed_size, cmd_sz);
 	
@@ -538,6 +630,33 @@ as_command_send(
 	return status;
 }
 
+as_status
+as_command_send_iov(
+	as_command* cmd, as_error* err, as_write_iov_fn write_fn, void* udata, uint32_t ref_count
+	)
+{
+	size_t capacity = cmd->buf_size;
+	cmd->buf = as_command_buffer_init(capacity);
+
+	// Each referenced value closes one command buffer run. Add one for the final run.
+	as_command_iov iov;
+	as_vector_inita(&iov.segments, sizeof(as_socket_iov), ref_count * 2 + 1);
+	iov.run = cmd->buf;
+	iov.ref_size = 0;
+
+	cmd->buf_size = write_fn(udata, cmd->buf, &iov);
+	cmd->iov = iov.segments.list;
+	cmd->iov_size = iov.segments.size;
+	cmd->flags |= AS_COMMAND_FLAGS_IOV;
+
+	as_command_start_timer(cmd);
+
+	as_status status = as_command_execute(cmd, err);
+	as_vector_destroy(&iov.segments);
+	as_command_buffer_free(cmd->buf, capacity);
+	return status;
+}
+
 static inline bool
 is_server_timeout(as_error* err)
 {
@@ -545,6 +664,116 @@ is_server_timeout(as_error* err)
 	return err->message[0];
 }
 
+static int
+as_command_hedge_wait(as_command* cmd, as_socket* sock, as_socket* hedge_sock)
+{
+	uint32_t timeout = cmd->socket_timeout;
+
+	if (cmd->deadline_ms > 0) {
+		uint64_t now = cf_getms();
+
+		if (now >= cmd->deadline_ms) {
+			return 0;
+		}
+
+		uint64_t remaining = cmd->deadline_ms - now;
+
+		if (timeout == 0 || remaining < timeout) {
+			timeout = (uint32_t)remaining;
+		}
+	}
+
+	as_socket_fd max_fd = (sock->fd > hedge_sock->fd)? sock->fd : hedge_sock->fd;
+	as_poll poll;
+	as_poll_init(&poll, max_fd);
+	int rv = as_poll_read2(&poll, sock->fd, hedge_sock->fd, timeout);
+	as_poll_destroy(&poll);
+	return rv;
+}
+
+static void
+as_command_hedge(as_command* cmd, as_socket* sock, as_node** node_ptr, uint64_t* begin)
+{
+	as_node* node = *node_ptr;
+	uint32_t delay = as_node_hedge_delay(node, cmd->hedge_delay, cmd->hedge_percentile);
+
+	if (delay == 0 || (cmd->socket_timeout > 0 && delay >= cmd->socket_timeout) ||
+		(cmd->deadline_ms > 0 && cf_getms() + delay >= cmd->deadline_ms)) {
+		// Timeout would occur before hedge.
+		return;
+	}
+
+	// Wait for first response up to the hedge delay.
+	as_poll poll;
+	as_poll_init(&poll, sock->fd);
+	int rv = as_poll_socket(&poll, sock->fd, delay, true);
+	as_poll_destroy(&poll);
+
+	if (rv != 0) {
+		// Response is available or socket failed. Read response normally.
+		return;
+	}
+
+	as_node* hedge_node = as_partition_get_node(cmd->cluster, cmd->ns, cmd->partition, node,
+												cmd->replica, cmd->replica_index + 1);
+
+	if (! hedge_node || hedge_node == node) {
+		return;
+	}
+	as_node_reserve(hedge_node);
+
+	if (! as_node_valid_error_count(hedge_node) || ! as_node_concurrency_acquire(hedge_node)) {
+		as_node_release(hedge_node);
+		return;
+	}
+
+	// Hedge failures are ignored because the original request is still pending.
+	as_error err;
+	uint64_t hedge_begin = cf_getns();
+	as_socket hedge_sock;
+	as_status status = as_node_get_connection(&err, hedge_node, cmd->socket_timeout,
+											  cmd->deadline_ms, &hedge_sock);
+
+	if (status != AEROSPIKE_OK) {
+		as_node_concurrency_release(hedge_node, hedge_begin, status == AEROSPIKE_ERR_TIMEOUT);
+		as_node_release(hedge_node);
+		return;
+	}
+
+	if (cmd->flags & AS_COMMAND_FLAGS_IOV) {
+		status = as_socket_writev_deadline(&err, &hedge_sock, hedge_node, cmd->iov, cmd->iov_size,
+										   cmd->socket_timeout, cmd->deadline_ms);
+	}
+	else {
+		status = as_socket_write_deadline(&err, &hedge_sock, hedge_node, cmd->buf, cmd->buf_size,
+										  cmd->socket_timeout, cmd->deadline_ms);
+	}
+
+	if (status != AEROSPIKE_OK) {
+		as_node_close_conn_error(hedge_node, &hedge_sock, hedge_sock.pool);
+		as_node_concurrency_release(hedge_node, hedge_begin, true);
+		as_node_release(hedge_node);
+		return;
+	}
+
+	// Use whichever node responds first. The other connection still has a response pending,
+	// so it must be closed.
+	if (as_command_hedge_wait(cmd, sock, &hedge_sock) == 2) {
+		as_node_close_connection(node, sock, sock->pool);
+		as_node_concurrency_release(node, *begin, true);
+		as_node_release(node);
+		*sock = hedge_sock;
+		*node_ptr = hedge_node;
+		*begin = hedge_begin;
+		cmd->replica_index++;
+	}
+	else {
+		as_node_close_connection(hedge_node, &hedge_sock, hedge_sock.pool);
+		as_node_concurrency_cancel(hedge_node);
+		as_node_release(hedge_node);
+	}
+}
+
 as_status
 as_command_execute(as_command* cmd, as_error* err)
 {
@@ -564,7 +793,7 @@ as_command_execute(as_command* cmd, as_error* err)
 			// This works because the previous node is only used for pointer comparison
 			// and the previous node's contents are not examined during this call.
 			node = as_partition_get_node(cmd->cluster, cmd->ns, cmd->partition, node, cmd->replica,
-										 cmd->master);
+										 cmd->replica_index);
 
 			if (! node) {
 				return as_error_update(err, AEROSPIKE_ERR_INVALID_NODE,
@@ -580,10 +809,23 @@ as_command_execute(as_command* cmd, as_error* err)
 			goto Retry;
 		}
 
+		// Adaptive concurrency limit applies to single record commands (release_node is true).
+		if (release_node && ! as_node_concurrency_acquire(node)) {
+			status = as_error_set_message(err, AEROSPIKE_ERR_CONCURRENCY_LIMIT,
+										  "Node concurrency limit exceeded");
+			goto Retry;
+		}
+
+		uint64_t begin = cf_getns();
 		as_socket socket;
 		status = as_node_get_connection(err, node, cmd->socket_timeout, cmd->deadline_ms, &socket);
 		
 		if (status != AEROSPIKE_OK) {
+			if (release_node) {
+				as_node_concurrency_release(node, begin, status == AEROSPIKE_ERR_TIMEOUT ||
+											status == AEROSPIKE_ERR_NO_MORE_CONNECTIONS);
+			}
+
 			// Do not retry on server error response such as invalid user/password.
 			if (status > 0 && status != AEROSPIKE_ERR_TIMEOUT) {
 				if (release_node) {
@@ -596,13 +838,23 @@ as_command_execute(as_command* cmd, as_error* err)
 		}
 		
 		// Send command.
-		status = as_socket_write_deadline(err, &socket, node, cmd->buf, cmd->buf_size,
-										  cmd->socket_timeout, cmd->deadline_ms);
+		if (cmd->flags & AS_COMMAND_FLAGS_IOV) {
+			status = as_socket_writev_deadline(err, &socket, node, cmd->iov, cmd->iov_size,
+											   cmd->socket_timeout, cmd->deadline_ms);
+		}
+		else {
+			status = as_socket_write_deadline(err, &socket, node, cmd->buf, cmd->buf_size,
+											  cmd->socket_timeout, cmd->deadline_ms);
+		}
 		
 		if (status != AEROSPIKE_OK) {
 			// Socket errors are considered temporary anomalies.  Retry.
 			// Close socket to flush out possible garbage.	Do not put back in pool.
 			as_node_close_conn_error(node, &socket, socket.pool);
+
+			if (release_node) {
+				as_node_concurrency_release(node, begin, true);
+			}
 			goto Retry;
 		}
 		command_sent_counter++;
@@ -612,7 +864,14 @@ as_command_execute(as_command* cmd, as_error* err)
 			status = as_command_read_messages(err, cmd, &socket, node);
 		}
 		else {
+			if (cmd->flags & AS_COMMAND_FLAGS_HEDGE) {
+				// Hedge only the first attempt.
+				cmd->flags &= ~AS_COMMAND_FLAGS_HEDGE;
+				as_command_hedge(cmd, &socket, &node, &begin);
+			}
 			status = as_command_read_message(err, cmd, &socket, node);
+			as_node_concurrency_release(node, begin, status == AEROSPIKE_ERR_TIMEOUT ||
+				status == AEROSPIKE_ERR_CONNECTION || status == AEROSPIKE_ERR_DEVICE_OVERLOAD);
 		}
 
 		if (status == AEROSPIKE_OK) {
@@ -662,6 +921,9 @@ as_command_execute(as_command* cmd, as_error* err)
 			}
 		}
 		
+		// Server responded. Record latency.
+		as_node_add_latency(node, cmd->latency_type, begin);
+
 		// Put connection back in pool.
 		as_node_put_connection(node, &socket);
 		
@@ -679,15 +941,15 @@ Retry:
 
 		uint32_t sleep_between_retries;
 
-		// Alternate between master and prole on socket errors or database reads.
+		// Advance to next replica on socket errors or database reads.
 		// Timeouts/NO_MORE_CONNECTIONS are not a good indicator of impending data migration.
 		if (cmd->replica != AS_POLICY_REPLICA_MASTER && (
 			((cmd->flags & AS_COMMAND_FLAGS_READ) && !(cmd->flags & AS_COMMAND_FLAGS_LINEARIZE)) ||
 			(status != AEROSPIKE_ERR_TIMEOUT && status != AEROSPIKE_ERR_NO_MORE_CONNECTIONS &&
-			 status != AEROSPIKE_MAX_ERROR_RATE)
+			 status != AEROSPIKE_MAX_ERROR_RATE && status != AEROSPIKE_ERR_CONCURRENCY_LIMIT)
 			)) {
 			// Note: SC session read will ignore this setting because it uses master only.
-			cmd->master = !cmd->master;
+			cmd->replica_index++;
 
 			// Disable sleep on first failure because target node is likely to change.
 			sleep_between_retries = (cmd->iteration == 1)? 0 : cmd->policy->sleep_between_retries;
@@ -841,7 +1103,7 @@ as_command_read_messages(as_error* err, as_command* cmd, as_socket* sock, as_nod
 	return status;
 }
 
-static as_status
+as_status
 as_command_read_message(as_error* err, as_command* cmd, as_socket* sock, as_node* node)
 {
 	as_proto proto;
@@ -1271,10 +1533,69 @@ abort_record_memory(as_error* err, as_record* rec, size_t size)
 	return as_error_update(err, AEROSPIKE_ERR_CLIENT, "malloc failure: %zu", size);
 }
 
+static uint8_t*
+as_command_record_arena(as_record* rec, uint8_t* p, uint32_t n_bins, size_t* size)
+{
+	// Calculate upper bound of value memory. Each op size includes bin name and
+	// header, so the total also covers null terminators for strings.
+	size_t values_size = 0;
+
+	for (uint32_t i = 0; i < n_bins; i++) {
+		uint32_t op_size = cf_swap_from_be32(*(uint32_t*)p);
+		values_size += op_size;
+		p += 4 + op_size;
+	}
+
+	size_t entries_size = sizeof(as_bin) * n_bins;
+	*size = entries_size + values_size;
+
+	uint8_t* block = cf_malloc(*size);
+
+	if (! block) {
+		return NULL;
+	}
+
+	// Record now owns the arena through its bin array.
+	if (rec->bins._free) {
+		cf_free(rec->bins.entries);
+	}
+	rec->bins.entries = (as_bin*)block;
+	rec->bins.capacity = n_bins;
+	rec->bins.size = 0;
+	rec->bins._free = true;
+	return block + entries_size;
+}
+
+static inline void*
+as_command_value_malloc(uint8_t** arena, size_t size)
+{
+	if (*arena) {
+		uint8_t* value = *arena;
+		*arena += size;
+		return value;
+	}
+	return cf_malloc(size);
+}
+
 as_status
-as_command_parse_bins(uint8_t** pp, as_error* err, as_record* rec, uint32_t n_bins, bool deserialize)
+as_command_parse_bins(
+	uint8_t** pp, as_error* err, as_record* rec, uint32_t n_bins, bool deserialize, bool arena
+	)
 {
 	uint8_t* p = *pp;
+	uint8_t* mem = NULL;
+
+	if (arena && n_bins > 0) {
+		size_t size;
+		mem = as_command_record_arena(rec, p, n_bins, &size);
+
+		if (! mem) {
+			return abort_record_memory(err, rec, size);
+		}
+	}
+
+	// Values allocated from the arena must not be freed individually.
+	bool free_value = (mem == NULL);
 	as_bin* bin = rec->bins.entries;
 
 	// Reset size in case we are reusing a record.
@@ -1321,14 +1642,14 @@ as_command_parse_bins(uint8_t** pp, as_error* err, as_record* rec, uint32_t n_bi
 				break;
 			}
 			case AS_BYTES_STRING: {
-				char* value = cf_malloc(value_size + 1);
+				char* value = as_command_value_malloc(&mem, value_size + 1);
 
 				if (! value) {
 					return abort_record_memory(err, rec, value_size + 1);
 				}
 				memcpy(value, p, value_size);
 				value[value_size] = 0;
-				as_string_init_wlen((as_string*)&bin->value, (char*)value, value_size, true);
+				as_string_init_wlen((as_string*)&bin->value, (char*)value, value_size, free_value);
 				bin->valuep = &bin->value;
 				break;
 			}
@@ -1347,7 +1668,7 @@ as_command_parse_bins(uint8_t** pp, as_error* err, as_record* rec, uint32_t n_bi
 
 				// Use the json bytes.
 				size_t jsonsz = value_size - 1 - 2 - (ncells * sizeof(uint64_t));
-				char* v = cf_malloc(jsonsz + 1);
+				char* v = as_command_value_malloc(&mem, jsonsz + 1);
 
 				if (! v) {
 					return abort_record_memory(err, rec, jsonsz + 1);
@@ -1355,7 +1676,7 @@ as_command_parse_bins(uint8_t** pp, as_error* err, as_record* rec, uint32_t n_bi
 				memcpy(v, ptr, jsonsz);
 				v[jsonsz] = 0;
 				as_geojson_init_wlen((as_geojson*)&bin->value,
-									 (char*)v, jsonsz, true);
+									 (char*)v, jsonsz, free_value);
 				bin->valuep = &bin->value;
 				break;
 			}
@@ -1379,26 +1700,26 @@ as_command_parse_bins(uint8_t** pp, as_error* err, as_record* rec, uint32_t n_bi
 					bin->valuep = (as_bin_value*)value;
 				}
 				else {
-					void* value = cf_malloc(value_size);
+					void* value = as_command_value_malloc(&mem, value_size);
 
 					if (! value) {
 						return abort_record_memory(err, rec, value_size);
 					}
 					memcpy(value, p, value_size);
-					as_bytes_init_wrap((as_bytes*)&bin->value, value, value_size, true);
+					as_bytes_init_wrap((as_bytes*)&bin->value, value, value_size, free_value);
 					bin->value.bytes.type = (as_bytes_type)type;
 					bin->valuep = &bin->value;
 				}
 				break;
 			}
 			default: {
-				void* value = cf_malloc(value_size);
+				void* value = as_command_value_malloc(&mem, value_size);
 
 				if (! value) {
 					return abort_record_memory(err, rec, value_size);
 				}
 				memcpy(value, p, value_size);
-				as_bytes_init_wrap((as_bytes*)&bin->value, value, value_size, true);
+				as_bytes_init_wrap((as_bytes*)&bin->value, value, value_size, free_value);
 				bin->value.bytes.type = (as_bytes_type)type;
 				bin->valuep = &bin->value;
 				break;
@@ -1439,7 +1760,8 @@ as_command_parse_result(as_error* err, as_node* node, uint8_t* buf, size_t size,
 						bin->valuep = NULL;
 					}
 
-					if (msg->n_ops > rec->bins.capacity) {
+					// The record arena replaces the bin array, so only grow it otherwise.
+					if (msg->n_ops > rec->bins.capacity && ! data->arena) {
 						if (rec->bins._free) {
 							cf_free(rec->bins.entries);
 						}
@@ -1451,7 +1773,8 @@ as_command_parse_result(as_error* err, as_node* node, uint8_t* buf, size_t size,
 					free_on_error = false;
 				}
 				else {
-					rec = as_record_new(msg->n_ops);
+					// The record arena provides the bin array.
+					rec = as_record_new(data->arena ? 0 : msg->n_ops);
 					*data->record = rec;
 					free_on_error = true;
 				}
@@ -1459,7 +1782,8 @@ as_command_parse_result(as_error* err, as_node* node, uint8_t* buf, size_t size,
 				rec->ttl = cf_server_void_time_to_ttl(msg->record_ttl);
 				
 				p = as_command_ignore_fields(p, msg->n_fields);
-				status = as_command_parse_bins(&p, err, rec, msg->n_ops, data->deserialize);
+				status = as_command_parse_bins(&p, err, rec, msg->n_ops, data->deserialize,
+											   data->arena);
 
 				if (status != AEROSPIKE_OK && free_on_error) {
 					as_record_destroy(rec);
@@ -0,0 +1,286 @@
+/*
+ * Copyright 2008-2021 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <aerospike/as_compress.h>
+#include <aerospike/as_atomic.h>
+#include <citrusleaf/alloc.h>
+#include <citrusleaf/cf_clock.h>
+#include <pthread.h>
+#include <string.h>
+
+#if defined(AS_USE_LIBDEFLATE)
+#include <libdeflate.h>
+#else
+#include <zlib.h>
+#endif
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+// Compressor state is expensive to allocate, so each thread (including event loop threads)
+// creates its state on first use and reuses it until the thread exits.
+typedef struct as_compress_ctx_s {
+#if defined(AS_USE_LIBDEFLATE)
+	struct libdeflate_compressor* compressor;
+	struct libdeflate_decompressor* decompressor;
+#else
+	z_stream deflate;
+	z_stream inflate;
+	bool deflate_init;
+	bool inflate_init;
+#endif
+} as_compress_ctx;
+
+/******************************************************************************
+ * GLOBALS
+ *****************************************************************************/
+
+static pthread_once_t as_compress_once = PTHREAD_ONCE_INIT;
+static pthread_key_t as_compress_key;
+static as_compress_stats as_compress_totals;
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+static void
+as_compress_ctx_destroy(void* data)
+{
+	as_compress_ctx* ctx = data;
+
+#if defined(AS_USE_LIBDEFLATE)
+	if (ctx->compressor) {
+		libdeflate_free_compressor(ctx->compressor);
+	}
+
+	if (ctx->decompressor) {
+		libdeflate_free_decompressor(ctx->decompressor);
+	}
+#else
+	if (ctx->deflate_init) {
+		deflateEnd(&ctx->deflate);
+	}
+
+	if (ctx->inflate_init) {
+		inflateEnd(&ctx->inflate);
+	}
+#endif
+	cf_free(ctx);
+}
+
+static void
+as_compress_key_create(void)
+{
+	pthread_key_create(&as_compress_key, as_compress_ctx_destroy);
+}
+
+static as_compress_ctx*
+as_compress_ctx_get(void)
+{
+	pthread_once(&as_compress_once, as_compress_key_create);
+
+	as_compress_ctx* ctx = pthread_getspecific(as_compress_key);
+
+	if (! ctx) {
+		ctx = cf_malloc(sizeof(as_compress_ctx));
+		memset(ctx, 0, sizeof(as_compress_ctx));
+		pthread_setspecific(as_compress_key, ctx);
+	}
+	return ctx;
+}
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+#if defined(AS_USE_LIBDEFLATE)
+
+size_t
+as_compress_bound(size_t src_sz)
+{
+	as_compress_ctx* ctx = as_compress_ctx_get();
+
+	if (! ctx->compressor) {
+		ctx->compressor = libdeflate_alloc_compressor(1);
+
+		if (! ctx->compressor) {
+			// Compress will fail and report the error.
+			return src_sz;
+		}
+	}
+	return libdeflate_zlib_compress_bound(ctx->compressor, src_sz);
+}
+
+as_status
+as_compress(as_error* err, uint8_t* trg, size_t* trg_sz, uint8_t* src, size_t src_sz)
+{
+	uint64_t begin = cf_getns();
+	as_compress_ctx* ctx = as_compress_ctx_get();
+
+	if (! ctx->compressor) {
+		ctx->compressor = libdeflate_alloc_compressor(1);
+
+		if (! ctx->compressor) {
+			return as_error_set_message(err, AEROSPIKE_ERR_CLIENT,
+										"Failed to allocate compressor");
+		}
+	}
+
+	size_t sz = libdeflate_zlib_compress(ctx->compressor, src, src_sz, trg, *trg_sz);
+
+	if (sz == 0) {
+		return as_error_update(err, AEROSPIKE_ERR_CLIENT,
+							   "Compress failed: buffer size %zu", *trg_sz);
+	}
+	*trg_sz = sz;
+
+	as_add_uint64(&as_compress_totals.compress_in, src_sz);
+	as_add_uint64(&as_compress_totals.compress_out, sz);
+	as_add_uint64(&as_compress_totals.compress_ns, cf_getns() - begin);
+	return AEROSPIKE_OK;
+}
+
+as_status
+as_decompress(as_error* err, uint8_t* trg, size_t* trg_sz, uint8_t* src, size_t src_sz)
+{
+	uint64_t begin = cf_getns();
+	as_compress_ctx* ctx = as_compress_ctx_get();
+
+	if (! ctx->decompressor) {
+		ctx->decompressor = libdeflate_alloc_decompressor();
+
+		if (! ctx->decompressor) {
+			return as_error_set_message(err, AEROSPIKE_ERR_CLIENT,
+										"Failed to allocate decompressor");
+		}
+	}
+
+	size_t sz;
+	enum libdeflate_result rv = libdeflate_zlib_decompress(ctx->decompressor, src, src_sz, trg,
+														   *trg_sz, &sz);
+
+	if (rv != LIBDEFLATE_SUCCESS) {
+		return as_error_update(err, AEROSPIKE_ERR_CLIENT, "Decompress failed: %d", (int)rv);
+	}
+	*trg_sz = sz;
+
+	as_add_uint64(&as_compress_totals.decompress_in, src_sz);
+	as_add_uint64(&as_compress_totals.decompress_out, sz);
+	as_add_uint64(&as_compress_totals.decompress_ns, cf_getns() - begin);
+	return AEROSPIKE_OK;
+}
+
+#else // zlib
+
+size_t
+as_compress_bound(size_t src_sz)
+{
+	return compressBound((uLong)src_sz);
+}
+
+as_status
+as_compress(as_error* err, uint8_t* trg, size_t* trg_sz, uint8_t* src, size_t src_sz)
+{
+	uint64_t begin = cf_getns();
+	as_compress_ctx* ctx = as_compress_ctx_get();
+	z_stream* zs = &ctx->deflate;
+	int rv;
+
+	if (ctx->deflate_init) {
+		rv = deflateReset(zs);
+	}
+	else {
+		rv = deflateInit(zs, Z_BEST_SPEED);
+		ctx->deflate_init = (rv == Z_OK);
+	}
+
+	if (rv != Z_OK) {
+		return as_error_update(err, AEROSPIKE_ERR_CLIENT, "Compress init failed: %d", rv);
+	}
+
+	zs->next_in = src;
+	zs->avail_in = (uInt)src_sz;
+	zs->next_out = trg;
+	zs->avail_out = (uInt)*trg_sz;
+
+	rv = deflate(zs, Z_FINISH);
+
+	if (rv != Z_STREAM_END) {
+		return as_error_update(err, AEROSPIKE_ERR_CLIENT, "Compress failed: %d", rv);
+	}
+	*trg_sz = (size_t)zs->total_out;
+
+	as_add_uint64(&as_compress_totals.compress_in, src_sz);
+	as_add_uint64(&as_compress_totals.compress_out, *trg_sz);
+	as_add_uint64(&as_compress_totals.compress_ns, cf_getns() - begin);
+	return AEROSPIKE_OK;
+}
+
+as_status
+as_decompress(as_error* err, uint8_t* trg, size_t* trg_sz, uint8_t* src, size_t src_sz)
+{
+	uint64_t begin = cf_getns();
+	as_compress_ctx* ctx = as_compress_ctx_get();
+	z_stream* zs = &ctx->inflate;
+	int rv;
+
+	if (ctx->inflate_init) {
+		rv = inflateReset(zs);
+	}
+	else {
+		rv = inflateInit(zs);
+		ctx->inflate_init = (rv == Z_OK);
+	}
+
+	if (rv != Z_OK) {
+		return as_error_update(err, AEROSPIKE_ERR_CLIENT, "Decompress init failed: %d", rv);
+	}
+
+	zs->next_in = src;
+	zs->avail_in = (uInt)src_sz;
+	zs->next_out = trg;
+	zs->avail_out = (uInt)*trg_sz;
+
+	rv = inflate(zs, Z_FINISH);
+
+	if (rv != Z_STREAM_END) {
+		// Match uncompress() error for truncated input or small buffer.
+		if (rv == Z_OK || (rv == Z_BUF_ERROR && zs->avail_in == 0)) {
+			rv = Z_DATA_ERROR;
+		}
+		return as_error_update(err, AEROSPIKE_ERR_CLIENT, "Decompress failed: %d", rv);
+	}
+	*trg_sz = (size_t)zs->total_out;
+
+	as_add_uint64(&as_compress_totals.decompress_in, src_sz);
+	as_add_uint64(&as_compress_totals.decompress_out, *trg_sz);
+	as_add_uint64(&as_compress_totals.decompress_ns, cf_getns() - begin);
+	return AEROSPIKE_OK;
+}
+
+#endif
+
+void
+as_compress_stats_get(as_compress_stats* stats)
+{
+	stats->compress_in = as_load_uint64(&as_compress_totals.compress_in);
+	stats->compress_out = as_load_uint64(&as_compress_totals.compress_out);
+	stats->compress_ns = as_load_uint64(&as_compress_totals.compress_ns);
+	stats->decompress_in = as_load_uint64(&as_compress_totals.decompress_in);
+	stats->decompress_out = as_load_uint64(&as_compress_totals.decompress_out);
+	stats->decompress_ns = as_load_uint64(&as_compress_totals.decompress_ns);
+}
@@ -48,8 +48,12 @@ as_config_init(as_config* c)
 	c->max_socket_idle = 55;
 	c->max_error_rate = 0;
 	c->error_rate_window = 1;
+	c->max_concurrency_per_node = 0;
+	c->min_concurrency_per_node = 16;
+	c->concurrency_latency_threshold = 50;
 	c->tender_interval = 1000;
 	c->thread_pool_size = 16;
+	c->tend_threads = 1;
 	c->tend_thread_cpu = -1;
 	as_policies_init(&c->policies);
 	as_config_lua_init(&c->lua);
@@ -57,6 +61,7 @@ as_config_init(as_config* c)
 	c->auth_mode = AS_AUTH_INTERNAL;
 	c->fail_if_not_connected = true;
 	c->use_services_alternate = false;
+	c->conn_pools_lock_free = false;
 	c->rack_aware = false;
 	c->rack_id = 0;
 	c->rack_ids = NULL;
@@ -65,6 +70,8 @@ as_config_init(as_config* c)
 	c->shm_max_nodes = 16;
 	c->shm_max_namespaces = 8;
 	c->shm_takeover_threshold_sec = 30;
+	c->snapshot_path = NULL;
+	c->snapshot_interval = 10000;
 	return c;
 }
 
@@ -92,6 +99,10 @@ as_config_destroy(as_config* config) {
 		cf_free(config->cluster_name);
 	}
 
+	if (config->snapshot_path) {
+		cf_free(config->snapshot_path);
+	}
+
 	as_policies_destroy(&config->policies);
 
 	as_config_tls* tls = &config->tls;
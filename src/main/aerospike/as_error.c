@@ -33,6 +33,7 @@ as_error_string(as_status status)
 		CASE_ASSIGN(AEROSPIKE_OK);
 		CASE_ASSIGN(AEROSPIKE_QUERY_END);
 
+		CASE_ASSIGN(AEROSPIKE_ERR_CONCURRENCY_LIMIT);
 		CASE_ASSIGN(AEROSPIKE_MAX_ERROR_RATE);
 		CASE_ASSIGN(AEROSPIKE_USE_NORMAL_RETRY);
 		CASE_ASSIGN(AEROSPIKE_ERR_MAX_RETRIES_EXCEEDED);
@@ -73,6 +73,19 @@ as_event_validate_policy(as_error* err, as_policy_event* policy)
 static void
 as_event_initialize_loop(as_policy_event* policy, as_event_loop* event_loop, uint32_t index)
 {
+	event_loop->submit_ring = cf_malloc(sizeof(as_event_submit_slot) * AS_EVENT_SUBMIT_CAPACITY);
+
+	for (uint32_t i = 0; i < AS_EVENT_SUBMIT_CAPACITY; i++) {
+		event_loop->submit_ring[i].seq = i;
+	}
+	event_loop->submit_mask = AS_EVENT_SUBMIT_CAPACITY - 1;
+	event_loop->submit_tail = 0;
+	event_loop->submit_head = 0;
+	event_loop->submit_size = 0;
+	event_loop->overflow_size = 0;
+	event_loop->wakeups = 0;
+	event_loop->slab = cf_calloc(1, sizeof(as_event_slab));
+
 	pthread_mutex_init(&event_loop->lock, 0);
 	as_queue_init(&event_loop->queue, sizeof(as_event_commander), AS_EVENT_QUEUE_INITIAL_CAPACITY);
 
@@ -243,6 +256,12 @@ as_set_external_event_loop(as_error* err, as_policy_event* policy, void* loop, a
 {
 	as_error_reset(err);
 
+#if defined(AS_USE_IO_URING)
+	// The io_uring ring is owned and drained by the client's event loop thread.
+	return as_error_set_message(err, AEROSPIKE_ERR_CLIENT,
+		"External event loops are not supported with io_uring");
+#endif
+
 	as_policy_event pol_local;
 
 	if (policy) {
@@ -566,19 +585,55 @@ as_event_execute_from_delay_queue(as_event_loop* event_loop)
 static void
 as_event_create_connection(as_event_command* cmd, as_async_conn_pool* pool)
 {
-	as_async_connection* conn = cf_malloc(sizeof(as_async_connection));
+	as_async_connection* conn = as_event_connection_alloc(cmd->event_loop);
 	conn->base.pipeline = false;
 	conn->base.watching = 0;
 	conn->cmd = cmd;
+	conn->event_loop = cmd->event_loop;
 	cmd->conn = &conn->base;
 	as_event_connect(cmd, pool);
 }
 
+static void
+as_event_hedge_start(as_event_command* cmd)
+{
+	// Hedge only the first attempt.
+	cmd->flags2 &= ~AS_ASYNC_FLAGS2_HEDGE;
+
+	uint32_t delay = as_node_hedge_delay(cmd->node, cmd->hedge_delay, cmd->hedge_percentile);
+
+	if (delay == 0 ||
+		((cmd->flags & AS_ASYNC_FLAGS_USING_SOCKET_TIMER) && delay >= cmd->socket_timeout) ||
+		(cmd->total_deadline > 0 && cf_getms() + delay >= cmd->total_deadline)) {
+		// Timeout would occur before hedge.
+		return;
+	}
+
+	as_node* hedge_node = as_partition_get_node(cmd->cluster, cmd->ns, cmd->partition, cmd->node,
+		cmd->replica, cmd->replica_index + 1);
+
+	if (! hedge_node || hedge_node == cmd->node) {
+		return;
+	}
+
+	// Replace command timer with hedge timer. The command timer is restored when the hedge
+	// timer fires or the command is retried.
+	as_event_timer_stop(cmd);
+	cmd->flags2 |= AS_ASYNC_FLAGS2_HEDGE_TIMER;
+	as_event_timer_once(cmd, delay);
+}
+
 static void
 as_event_command_begin(as_event_loop* event_loop, as_event_command* cmd)
 {
 	cmd->state = AS_ASYNC_STATE_CONNECT;
 
+	if (cmd->flags2 & AS_ASYNC_FLAGS2_CONCURRENCY) {
+		// Prior attempt failed. Release its concurrency slot.
+		cmd->flags2 &= ~AS_ASYNC_FLAGS2_CONCURRENCY;
+		as_node_concurrency_release(cmd->node, cmd->begin, true);
+	}
+
 	if (cmd->partition) {
 		// If in retry, need to release node from prior attempt.
 		if (cmd->node) {
@@ -589,7 +644,7 @@ as_event_command_begin(as_event_loop* event_loop, as_event_command* cmd)
 		// This works because the previous node is only used for pointer comparison
 		// and the previous node's contents are not examined during this call.
 		cmd->node = as_partition_get_node(cmd->cluster, cmd->ns, cmd->partition, cmd->node,
-										  cmd->replica, cmd->flags & AS_ASYNC_FLAGS_MASTER);
+										  cmd->replica, cmd->replica_index);
 
 		if (! cmd->node) {
 			event_loop->errors++;
@@ -620,6 +675,32 @@ as_event_command_begin(as_event_loop* event_loop, as_event_command* cmd)
 		return;
 	}
 
+	// Adaptive concurrency limit applies to single record commands.
+	if (cmd->partition) {
+		if (! as_node_concurrency_acquire(cmd->node)) {
+			event_loop->errors++;
+
+			if (as_event_command_retry(cmd, true)) {
+				return;
+			}
+
+			as_error err;
+			as_error_set_message(&err, AEROSPIKE_ERR_CONCURRENCY_LIMIT,
+								 "Node concurrency limit exceeded");
+
+			as_event_timer_stop(cmd);
+			as_event_error_callback(cmd, &err);
+			return;
+		}
+		cmd->flags2 |= AS_ASYNC_FLAGS2_CONCURRENCY;
+	}
+
+	cmd->begin = cf_getns();
+
+	if (cmd->flags2 & AS_ASYNC_FLAGS2_HEDGE) {
+		as_event_hedge_start(cmd);
+	}
+
 	if (cmd->pipe_listener) {
 		as_pipe_get_connection(cmd);
 		return;
@@ -745,21 +826,22 @@ as_event_decompress(as_event_command* cmd)
 		return false;
 	}
 
-	uint8_t* buf = cf_malloc(size);
+	size_t capacity = size;
+	uint8_t* buf = as_event_slab_alloc(cmd->event_loop, &capacity);
 
 	if (as_proto_decompress(&err, buf, size, cmd->buf, cmd->len) != AEROSPIKE_OK) {
-		cf_free(buf);
+		as_event_slab_free(cmd->event_loop, buf, capacity);
 		as_event_parse_error(cmd, &err);
 		return false;
 	}
 
 	if (cmd->flags & AS_ASYNC_FLAGS_FREE_BUF) {
-		cf_free(cmd->buf);
+		as_event_slab_free(cmd->event_loop, cmd->buf, cmd->read_capacity);
 	}
 	cmd->buf = buf;
 	cmd->len = (uint32_t)size;
 	cmd->pos = sizeof(as_proto);
-	cmd->read_capacity = cmd->len;
+	cmd->read_capacity = (uint32_t)capacity;
 	cmd->flags |= AS_ASYNC_FLAGS_FREE_BUF;
 	return true;
 }
@@ -830,9 +912,79 @@ as_event_delay_timeout(as_event_command* cmd)
 	as_event_notify_error(cmd, &err);
 }
 
+static bool
+as_event_timer_restore(as_event_command* cmd)
+{
+	if (cmd->total_deadline > 0) {
+		// Check total timeout.
+		uint64_t now = cf_getms();
+
+		if (now >= cmd->total_deadline) {
+			as_event_total_timeout(cmd);
+			return false;
+		}
+
+		uint64_t remaining = cmd->total_deadline - now;
+
+		if (cmd->flags & AS_ASYNC_FLAGS_USING_SOCKET_TIMER) {
+			if (remaining <= cmd->socket_timeout) {
+				// Restore total timer.
+				cmd->flags &= ~AS_ASYNC_FLAGS_USING_SOCKET_TIMER;
+				as_event_timer_once(cmd, remaining);
+			}
+			else {
+				// Restore socket timer.
+				cmd->flags &= ~AS_ASYNC_FLAGS_EVENT_RECEIVED;
+				as_event_timer_repeat(cmd, cmd->socket_timeout);
+			}
+		}
+		else {
+			// Restore total timer.
+			as_event_timer_once(cmd, remaining);
+		}
+	}
+	else if (cmd->flags & AS_ASYNC_FLAGS_USING_SOCKET_TIMER) {
+		// Restore socket timer.
+		cmd->flags &= ~AS_ASYNC_FLAGS_EVENT_RECEIVED;
+		as_event_timer_repeat(cmd, cmd->socket_timeout);
+	}
+	return true;
+}
+
+static void
+as_event_hedge_timeout(as_event_command* cmd)
+{
+	cmd->flags2 &= ~AS_ASYNC_FLAGS2_HEDGE_TIMER;
+
+	if (cmd->state == AS_ASYNC_STATE_COMMAND_READ_BODY ||
+		(cmd->state == AS_ASYNC_STATE_COMMAND_READ_HEADER && cmd->pos > 0)) {
+		// Response has started to arrive. Restore command timer and keep reading.
+		as_event_timer_stop(cmd);
+		as_event_timer_restore(cmd);
+		return;
+	}
+
+	// An async command owns a single connection, so abandon the slow attempt and send the
+	// read to the next replica. The hedge does not count against max_retries.
+	as_event_connection_timeout(cmd, &cmd->node->async_conn_pools[cmd->event_loop->index]);
+
+	cmd->replica_index++;
+	cmd->conn = NULL;
+
+	// Execute hedge at the end of the queue. as_event_execute_retry() restores command timer.
+	as_event_timer_stop(cmd);
+	cmd->state = AS_ASYNC_STATE_RETRY;
+	as_event_timer_once(cmd, 0);
+}
+
 void
 as_event_process_timer(as_event_command* cmd)
 {
+	if (cmd->flags2 & AS_ASYNC_FLAGS2_HEDGE_TIMER) {
+		as_event_hedge_timeout(cmd);
+		return;
+	}
+
 	switch (cmd->state) {
 		case AS_ASYNC_STATE_REGISTERED:
 			// Start command from the beginning.
@@ -881,12 +1033,12 @@ as_event_command_retry(as_event_command* cmd, bool timeout)
 		return false;
 	}
 
-	// Alternate between master and prole on socket errors or database reads.
+	// Advance to next replica on socket errors or database reads.
 	// Timeouts are not a good indicator of impending data migration.
 	if (! timeout || ((cmd->flags & AS_ASYNC_FLAGS_READ) &&
 					  !(cmd->flags & AS_ASYNC_FLAGS_LINEARIZE))) {
 		// Note: SC session read will ignore this setting because it uses master only.
-		cmd->flags ^= AS_ASYNC_FLAGS_MASTER;
+		cmd->replica_index++;
 	}
 
 	// Old connection should already be closed or is closing.
@@ -907,8 +1059,9 @@ as_event_command_retry(as_event_command* cmd, bool timeout)
 		}
 	}
 
-	// Disable timeout.
+	// Disable timeout. Hedge timer is replaced by the command timer on retry.
 	as_event_timer_stop(cmd);
+	cmd->flags2 &= ~AS_ASYNC_FLAGS2_HEDGE_TIMER;
 
 	// Retry command at the end of the queue so other commands have a chance to run first.
 	// Initialize event to eventually call as_event_execute_retry().
@@ -921,38 +1074,8 @@ void
 as_event_execute_retry(as_event_command* cmd)
 {
 	// Restore timer that was reset for retry.
-	if (cmd->total_deadline > 0) {
-		// Check total timeout.
-		uint64_t now = cf_getms();
-
-		if (now >= cmd->total_deadline) {
-			as_event_total_timeout(cmd);
-			return;
-		}
-
-		uint64_t remaining = cmd->total_deadline - now;
-
-		if (cmd->flags & AS_ASYNC_FLAGS_USING_SOCKET_TIMER) {
-			if (remaining <= cmd->socket_timeout) {
-				// Restore total timer.
-				cmd->flags &= ~AS_ASYNC_FLAGS_USING_SOCKET_TIMER;
-				as_event_timer_once(cmd, remaining);
-			}
-			else {
-				// Restore socket timer.
-				cmd->flags &= ~AS_ASYNC_FLAGS_EVENT_RECEIVED;
-				as_event_timer_repeat(cmd, cmd->socket_timeout);
-			}
-		}
-		else {
-			// Restore total timer.
-			as_event_timer_once(cmd, remaining);
-		}
-	}
-	else if (cmd->flags & AS_ASYNC_FLAGS_USING_SOCKET_TIMER) {
-		// Restore socket timer.
-		cmd->flags &= ~AS_ASYNC_FLAGS_EVENT_RECEIVED;
-		as_event_timer_repeat(cmd, cmd->socket_timeout);
+	if (! as_event_timer_restore(cmd)) {
+		return;
 	}
 
 	// Retry command.
@@ -969,9 +1092,47 @@ as_event_put_connection(as_event_command* cmd, as_async_conn_pool* pool)
 	}
 }
 
+static inline uint8_t
+as_event_latency_type(as_event_command* cmd)
+{
+	switch (cmd->type) {
+		case AS_ASYNC_TYPE_WRITE:
+			return AS_LATENCY_TYPE_WRITE;
+
+		case AS_ASYNC_TYPE_RECORD:
+			return (cmd->flags & AS_ASYNC_FLAGS_READ)? AS_LATENCY_TYPE_READ : AS_LATENCY_TYPE_WRITE;
+
+		case AS_ASYNC_TYPE_VALUE:
+			return AS_LATENCY_TYPE_UDF;
+
+		case AS_ASYNC_TYPE_BATCH:
+			return AS_LATENCY_TYPE_BATCH;
+
+		case AS_ASYNC_TYPE_SCAN:
+		case AS_ASYNC_TYPE_SCAN_PARTITION:
+			return AS_LATENCY_TYPE_SCAN;
+
+		case AS_ASYNC_TYPE_QUERY:
+			return AS_LATENCY_TYPE_QUERY;
+
+		case AS_ASYNC_TYPE_INFO:
+			return AS_LATENCY_TYPE_INFO;
+
+		default:
+			return AS_LATENCY_TYPE_MAX;
+	}
+}
+
 static inline void
 as_event_response_complete(as_event_command* cmd)
 {
+	as_node_add_latency(cmd->node, as_event_latency_type(cmd), cmd->begin);
+
+	if (cmd->flags2 & AS_ASYNC_FLAGS2_CONCURRENCY) {
+		cmd->flags2 &= ~AS_ASYNC_FLAGS2_CONCURRENCY;
+		as_node_concurrency_release(cmd->node, cmd->begin, false);
+	}
+
 	if (cmd->pipe_listener != NULL) {
 		as_pipe_response_complete(cmd);
 		return;
@@ -1228,6 +1389,12 @@ as_event_response_error(as_event_command* cmd, as_error* err)
 	// Release resources, make callback and free command.
 	as_event_timer_stop(cmd);
 	as_event_stop_watcher(cmd, cmd->conn);
+
+	if (cmd->flags2 & AS_ASYNC_FLAGS2_CONCURRENCY) {
+		cmd->flags2 &= ~AS_ASYNC_FLAGS2_CONCURRENCY;
+		as_node_concurrency_release(cmd->node, cmd->begin,
+			err->code == AEROSPIKE_ERR_DEVICE_OVERLOAD || err->code == AEROSPIKE_ERR_TIMEOUT);
+	}
 	
 	as_async_conn_pool* pool = &cmd->node->async_conn_pools[cmd->event_loop->index];
 
@@ -1290,14 +1457,16 @@ as_event_command_parse_result(as_event_command* cmd)
 		case AEROSPIKE_OK: {
 			if (cmd->flags2 & AS_ASYNC_FLAGS2_HEAP_REC) {
 				// Create record on heap and let user call as_record_destroy() on success.
-				as_record* rec = as_record_new(msg->n_ops);
+				// The record arena provides the bin array.
+				bool arena = cmd->flags2 & AS_ASYNC_FLAGS2_RECORD_ARENA;
+				as_record* rec = as_record_new(arena ? 0 : msg->n_ops);
 
 				rec->gen = msg->generation;
 				rec->ttl = cf_server_void_time_to_ttl(msg->record_ttl);
 
 				p = as_command_ignore_fields(p, msg->n_fields);
 				status = as_command_parse_bins(&p, &err, rec, msg->n_ops,
-											   cmd->flags2 & AS_ASYNC_FLAGS2_DESERIALIZE);
+											   cmd->flags2 & AS_ASYNC_FLAGS2_DESERIALIZE, arena);
 
 				if (status == AEROSPIKE_OK) {
 					as_event_response_complete(cmd);
@@ -1313,7 +1482,11 @@ as_event_command_parse_result(as_event_command* cmd)
 				// Create record on stack and call as_record_destroy() after listener completes.
 				as_record rec;
 
-				if (msg->n_ops < 1000) {
+				if (cmd->flags2 & AS_ASYNC_FLAGS2_RECORD_ARENA) {
+					// The record arena provides the bin array.
+					as_record_init(&rec, 0);
+				}
+				else if (msg->n_ops < 1000) {
 					as_record_inita(&rec, msg->n_ops);
 				}
 				else {
@@ -1325,7 +1498,8 @@ as_event_command_parse_result(as_event_command* cmd)
 				
 				p = as_command_ignore_fields(p, msg->n_fields);
 				status = as_command_parse_bins(&p, &err, &rec, msg->n_ops,
-											   cmd->flags2 & AS_ASYNC_FLAGS2_DESERIALIZE);
+											   cmd->flags2 & AS_ASYNC_FLAGS2_DESERIALIZE,
+											   cmd->flags2 & AS_ASYNC_FLAGS2_RECORD_ARENA);
 
 				if (status == AEROSPIKE_OK) {
 					as_event_response_complete(cmd);
@@ -1433,15 +1607,20 @@ as_event_command_free(as_event_command* cmd)
 	}
 	cmd->cluster->pending[event_loop->index]--;
 
+	if (cmd->flags2 & AS_ASYNC_FLAGS2_CONCURRENCY) {
+		// Command ended without a server response (timeout or connection error).
+		as_node_concurrency_release(cmd->node, cmd->begin, true);
+	}
+
 	if (cmd->node) {
 		as_node_release(cmd->node);
 	}
 
 	if (cmd->flags & AS_ASYNC_FLAGS_FREE_BUF) {
-		cf_free(cmd->buf);
+		as_event_slab_free(event_loop, cmd->buf, cmd->read_capacity);
 	}
 
-	cf_free(cmd);
+	as_event_slab_free(event_loop, cmd, cmd->alloc_size);
 
 	if (event_loop->max_commands_in_process > 0 && ! event_loop->using_delay_queue) {
 		// Try executing commands from the delay queue.
@@ -1579,12 +1758,14 @@ connector_execute_command(as_event_loop* event_loop, connector_shared* cs)
 	cmd->write_offset = (uint32_t)(cmd->buf - (uint8_t*)cmd);
 	cmd->write_len = 0;
 	cmd->read_capacity = (uint32_t)(s - sizeof(connector_command));
+	cmd->alloc_size = (uint32_t)s;
 	cmd->type = AS_ASYNC_TYPE_CONNECTOR;
 	cmd->proto_type = AS_MESSAGE_TYPE;
 	cmd->proto_type_rcv = 0;
 	cmd->state = AS_ASYNC_STATE_CONNECT;
-	cmd->flags = AS_ASYNC_FLAGS_MASTER;
+	cmd->flags = 0;
 	cmd->flags2 = 0;
+	cmd->replica_index = 0;
 
 	cmd->total_deadline = cf_getms() + cs->timeout_ms;
 	as_event_timer_once(cmd, cs->timeout_ms);
@@ -1958,3 +2139,256 @@ as_event_close_cluster(as_cluster* cluster)
 		cf_free(monitor);
 	}
 }
+
+/******************************************************************************
+ * SUBMISSION QUEUE
+ *****************************************************************************/
+
+static bool
+as_event_submit_push(as_event_loop* event_loop, as_event_commander* qcmd)
+{
+	// Bounded multi-producer ring. Each slot sequence tells producers when the slot
+	// is free and tells the consumer when the slot has been published.
+	uint32_t pos = as_load_uint32(&event_loop->submit_tail);
+	as_event_submit_slot* slot;
+
+	while (true) {
+		slot = &event_loop->submit_ring[pos & event_loop->submit_mask];
+
+		uint32_t seq = as_load_uint32(&slot->seq);
+		as_fence_acquire();
+
+		int32_t diff = (int32_t)(seq - pos);
+
+		if (diff == 0) {
+			if (as_cas_uint32(&event_loop->submit_tail, pos, pos + 1)) {
+				break;
+			}
+			pos = as_load_uint32(&event_loop->submit_tail);
+		}
+		else if (diff < 0) {
+			// Ring is full.
+			return false;
+		}
+		else {
+			pos = as_load_uint32(&event_loop->submit_tail);
+		}
+	}
+
+	slot->cmd = *qcmd;
+	as_fence_release();
+	as_store_uint32(&slot->seq, pos + 1);
+	return true;
+}
+
+bool
+as_event_submit(as_event_loop* event_loop, as_event_commander* qcmd, bool* wakeup)
+{
+	// Once the ring overflows, keep using the overflow queue until it has been drained
+	// so commands from the same thread are executed in order.
+	if (as_load_uint32(&event_loop->overflow_size) > 0 || ! as_event_submit_push(event_loop, qcmd)) {
+		pthread_mutex_lock(&event_loop->lock);
+		bool queued = as_queue_push(&event_loop->queue, qcmd);
+
+		if (queued) {
+			as_store_uint32(&event_loop->overflow_size, event_loop->overflow_size + 1);
+		}
+		pthread_mutex_unlock(&event_loop->lock);
+
+		if (! queued) {
+			*wakeup = false;
+			return false;
+		}
+	}
+
+	// Only signal event loop when the queue transitions from empty to non-empty.
+	// The event loop re-signals itself if commands remain after processing.
+	if (as_faa_uint32(&event_loop->submit_size, 1) == 0) {
+		as_incr_uint64(&event_loop->wakeups);
+		*wakeup = true;
+	}
+	else {
+		*wakeup = false;
+	}
+	return true;
+}
+
+bool
+as_event_submit_pop(as_event_loop* event_loop, as_event_commander* qcmd)
+{
+	// Must be called from event loop thread.
+	uint32_t pos = event_loop->submit_head;
+	as_event_submit_slot* slot = &event_loop->submit_ring[pos & event_loop->submit_mask];
+
+	uint32_t seq = as_load_uint32(&slot->seq);
+	as_fence_acquire();
+
+	if (seq == pos + 1) {
+		*qcmd = slot->cmd;
+		as_fence_release();
+		as_store_uint32(&slot->seq, pos + event_loop->submit_mask + 1);
+		event_loop->submit_head = pos + 1;
+		return true;
+	}
+
+	// Overflow queue is only read after all claimed ring slots have been consumed.
+	// This preserves submission order when the ring fills up.
+	if (as_load_uint32(&event_loop->overflow_size) == 0 ||
+		as_load_uint32(&event_loop->submit_tail) != pos) {
+		return false;
+	}
+
+	pthread_mutex_lock(&event_loop->lock);
+	bool status = as_queue_pop(&event_loop->queue, qcmd);
+
+	if (status) {
+		as_store_uint32(&event_loop->overflow_size, event_loop->overflow_size - 1);
+	}
+	pthread_mutex_unlock(&event_loop->lock);
+	return status;
+}
+
+bool
+as_event_submit_complete(as_event_loop* event_loop, uint32_t count)
+{
+	// Return true if commands remain that require another wakeup.
+	if (as_aaf_uint32(&event_loop->submit_size, -count) > 0) {
+		as_incr_uint64(&event_loop->wakeups);
+		return true;
+	}
+	return false;
+}
+
+/******************************************************************************
+ * SLAB ALLOCATOR
+ *****************************************************************************/
+
+static inline int
+as_event_slab_index(size_t size)
+{
+	if (size == 0 || size > AS_EVENT_SLAB_MAX_SIZE) {
+		return -1;
+	}
+
+	if (size <= 16 * 1024) {
+		return (int)((size - 1) >> 10);
+	}
+
+	int index = 16;
+	size_t class_size = 32 * 1024;
+
+	while (class_size < size) {
+		class_size <<= 1;
+		index++;
+	}
+	return index;
+}
+
+static inline size_t
+as_event_slab_class_size(int index)
+{
+	return (index < 16)? (size_t)(index + 1) << 10 : (size_t)(32 * 1024) << (index - 16);
+}
+
+void*
+as_event_slab_alloc(as_event_loop* event_loop, size_t* size)
+{
+	// Round size up to size class. Memory is always allocated with cf_malloc(), so blocks
+	// can also be released with cf_free() by code that is unaware of the slab.
+	int index = as_event_slab_index(*size);
+
+	if (index < 0) {
+		return cf_malloc(*size);
+	}
+
+	*size = as_event_slab_class_size(index);
+
+	// Freelists are not locked, so they can only be used from the event loop thread.
+	// Slab is NULL after the event loop has been closed.
+	as_event_slab* slab = event_loop->slab;
+
+	if (! slab || ! as_in_event_loop(event_loop->thread) || ! slab->blocks[index]) {
+		return cf_malloc(*size);
+	}
+
+	void* block = slab->blocks[index];
+	slab->blocks[index] = *(void**)block;
+	slab->size[index]--;
+	return block;
+}
+
+void
+as_event_slab_free(as_event_loop* event_loop, void* ptr, size_t size)
+{
+	// Only cache blocks that exactly match a size class.
+	int index = as_event_slab_index(size);
+	as_event_slab* slab = event_loop->slab;
+
+	if (index < 0 || as_event_slab_class_size(index) != size || ! slab ||
+		! as_in_event_loop(event_loop->thread) ||
+		slab->size[index] >= AS_EVENT_SLAB_CLASS_BYTES / size) {
+		cf_free(ptr);
+		return;
+	}
+
+	*(void**)ptr = slab->blocks[index];
+	slab->blocks[index] = ptr;
+	slab->size[index]++;
+}
+
+static void
+as_event_slab_free_list(void* block)
+{
+	while (block) {
+		void* next = *(void**)block;
+		cf_free(block);
+		block = next;
+	}
+}
+
+void
+as_event_slab_destroy(as_event_slab* slab)
+{
+	for (uint32_t i = 0; i < AS_EVENT_SLAB_CLASSES; i++) {
+		as_event_slab_free_list(slab->blocks[i]);
+	}
+	as_event_slab_free_list(slab->conns);
+	cf_free(slab);
+}
+
+as_async_connection*
+as_event_connection_alloc(as_event_loop* event_loop)
+{
+	as_event_slab* slab = event_loop->slab;
+
+	if (! slab || ! as_in_event_loop(event_loop->thread) || ! slab->conns) {
+		return cf_malloc(sizeof(as_async_connection));
+	}
+
+	void* conn = slab->conns;
+	slab->conns = *(void**)conn;
+	slab->conns_size--;
+	return conn;
+}
+
+void
+as_event_connection_free(as_event_connection* conn)
+{
+	if (conn->pipeline) {
+		cf_free(conn);
+		return;
+	}
+
+	as_event_loop* event_loop = ((as_async_connection*)conn)->event_loop;
+	as_event_slab* slab = event_loop->slab;
+
+	if (! slab || ! as_in_event_loop(event_loop->thread) ||
+		slab->conns_size >= AS_EVENT_SLAB_MAX_CONNS) {
+		cf_free(conn);
+		return;
+	}
+
+	*(void**)conn = slab->conns;
+	slab->conns = conn;
+	slab->conns_size++;
+}
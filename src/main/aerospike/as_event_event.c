@@ -69,6 +69,16 @@ as_event_close_loop(as_event_loop* event_loop)
 	as_event_loop_destroy(event_loop);
 }
 
+static inline void
+as_event_wakeup_send(as_event_loop* event_loop)
+{
+	if (! evtimer_pending(&event_loop->wakeup, NULL)) {
+		event_del(&event_loop->wakeup);
+		evtimer_add(&event_loop->wakeup, &as_immediate_tv);
+	}
+	//event_active(&event_loop->wakeup, 0, 0);
+}
+
 static void
 as_event_wakeup(evutil_socket_t socket, short revents, void* udata)
 {
@@ -80,27 +90,21 @@ as_event_wakeup(evutil_socket_t socket, short revents, void* udata)
 	// Only process original size of queue.  Recursive pre-registration errors can
 	// result in new commands being added while the loop is in process.  If we process
 	// them, we could end up in an infinite loop.
-	pthread_mutex_lock(&event_loop->lock);
-	uint32_t size = as_queue_size(&event_loop->queue);
-	bool status = as_queue_pop(&event_loop->queue, &cmd);
-	pthread_mutex_unlock(&event_loop->lock);
+	uint32_t size = as_load_uint32(&event_loop->submit_size);
 
-	while (status) {
+	while (i < size && as_event_submit_pop(event_loop, &cmd)) {
 		if (! cmd.executable) {
 			// Received stop signal.
 			as_event_close_loop(event_loop);
 			return;
 		}
 		cmd.executable(event_loop, cmd.udata);
+		i++;
+	}
 
-		if (++i < size) {
-			pthread_mutex_lock(&event_loop->lock);
-			status = as_queue_pop(&event_loop->queue, &cmd);
-			pthread_mutex_unlock(&event_loop->lock);
-		}
-		else {
-			break;
-		}
+	if (as_event_submit_complete(event_loop, i)) {
+		// Commands were submitted while processing or are not published yet.
+		as_event_wakeup_send(event_loop);
 	}
 }
 
@@ -207,17 +211,12 @@ as_event_execute(as_event_loop* event_loop, as_event_executable executable, void
 	}
 
 	// Send command through queue so it can be executed in event loop thread.
-	pthread_mutex_lock(&event_loop->lock);
 	as_event_commander qcmd = {.executable = executable, .udata = udata};
-	bool queued = as_queue_push(&event_loop->queue, &qcmd);
-	pthread_mutex_unlock(&event_loop->lock);
+	bool wakeup;
+	bool queued = as_event_submit(event_loop, &qcmd, &wakeup);
 
-	if (queued) {
-		if (! evtimer_pending(&event_loop->wakeup, NULL)) {
-			event_del(&event_loop->wakeup);
-			evtimer_add(&event_loop->wakeup, &as_immediate_tv);
-		}
-		//event_active(&event_loop->wakeup, 0, 0);
+	if (wakeup) {
+		as_event_wakeup_send(event_loop);
 	}
 	return queued;
 }
@@ -352,6 +351,86 @@ as_event_write(as_event_command* cmd)
 	return AS_EVENT_WRITE_COMPLETE;
 }
 
+static int
+as_event_read_ahead(as_event_command* cmd)
+{
+	as_event_connection* conn = cmd->conn;
+	as_event_read_buffer* rb = &conn->rbuf;
+	as_socket_fd fd = conn->socket.fd;
+	int bytes;
+
+	while (cmd->pos < cmd->len) {
+		uint32_t avail = rb->len - rb->pos;
+		uint32_t need = cmd->len - cmd->pos;
+
+		if (avail > 0) {
+			// Consume bytes already read ahead.
+			uint32_t n = (avail < need)? avail : need;
+			memcpy(cmd->buf + cmd->pos, rb->data + rb->pos, n);
+			cmd->pos += n;
+			rb->pos += n;
+			continue;
+		}
+
+		if (need >= AS_EVENT_READ_AHEAD_SIZE) {
+			// Large remainder. Read directly into command buffer.
+#if !defined(_MSC_VER)
+			bytes = (int)read(fd, cmd->buf + cmd->pos, need);
+#else
+			bytes = (int)recv(fd, cmd->buf + cmd->pos, need, 0);
+#endif
+
+			if (bytes > 0) {
+				cmd->pos += bytes;
+				continue;
+			}
+		}
+		else {
+			if (! rb->data) {
+				rb->data = cf_malloc(AS_EVENT_READ_AHEAD_SIZE);
+			}
+
+			// Read as much as is available, which may include following responses blocks.
+#if !defined(_MSC_VER)
+			bytes = (int)read(fd, rb->data, AS_EVENT_READ_AHEAD_SIZE);
+#else
+			bytes = (int)recv(fd, rb->data, AS_EVENT_READ_AHEAD_SIZE, 0);
+#endif
+
+			if (bytes > 0) {
+				rb->pos = 0;
+				rb->len = (uint32_t)bytes;
+				continue;
+			}
+		}
+
+		if (bytes < 0) {
+			int e = as_last_error();
+
+			if (e == AS_WOULDBLOCK) {
+				as_event_watch_read(cmd);
+				return AS_EVENT_READ_INCOMPLETE;
+			}
+
+			if (! as_event_socket_retry(cmd)) {
+				as_error err;
+				as_socket_error(fd, cmd->node, &err, AEROSPIKE_ERR_ASYNC_CONNECTION, "Socket read failed", e);
+				as_event_socket_error(cmd, &err);
+			}
+			return AS_EVENT_READ_ERROR;
+		}
+		else {
+			if (! as_event_socket_retry(cmd)) {
+				as_error err;
+				as_socket_error(fd, cmd->node, &err, AEROSPIKE_ERR_ASYNC_CONNECTION, "Socket read closed by peer", 0);
+				as_event_socket_error(cmd, &err);
+			}
+			return AS_EVENT_READ_ERROR;
+		}
+	}
+	return AS_EVENT_READ_COMPLETE;
+}
+
 static int
 as_event_read(as_event_command* cmd)
 {
@@ -386,6 +465,9 @@ as_event_read(as_event_command* cmd)
 			// as_tls_read_once doesn't return 0
 		} while (cmd->pos < cmd->len);
 	}
+	else if (! cmd->conn->pipeline) {
+		return as_event_read_ahead(cmd);
+	}
 	else {
 		as_socket_fd fd = cmd->conn->socket.fd;
 	
@@ -502,6 +584,17 @@ as_event_command_start(as_event_command* cmd)
 	}
 }
 
+static inline bool
+as_event_body_staged(as_event_command* cmd)
+{
+	// Body can be parsed in place when it has already been fully read ahead.
+	as_event_connection* conn = cmd->conn;
+
+	return ! conn->pipeline && cmd->len > 0 && conn->rbuf.len - conn->rbuf.pos >= cmd->len &&
+		! (cmd->flags & AS_ASYNC_FLAGS_FREE_BUF) &&
+		cmd->proto_type_rcv != AS_COMPRESSED_MESSAGE_TYPE;
+}
+
 static int
 as_event_command_peek_block(as_event_command* cmd)
 {
@@ -550,13 +643,8 @@ as_event_command_peek_block(as_event_command* cmd)
 	else {
 		// Received normal data block.  Stop reading for fairness reasons and wait
 		// till next iteration.
-		if (cmd->len > cmd->read_capacity) {
-			if (cmd->flags & AS_ASYNC_FLAGS_FREE_BUF) {
-				cf_free(cmd->buf);
-			}
-			cmd->buf = cf_malloc(size);
-			cmd->read_capacity = cmd->len;
-			cmd->flags |= AS_ASYNC_FLAGS_FREE_BUF;
+		if (cmd->len > cmd->read_capacity && ! as_event_body_staged(cmd)) {
+			as_event_command_buf_grow(cmd, size);
 		}
 	}
 
@@ -612,6 +700,26 @@ as_event_parse_authentication(as_event_command* cmd)
 	return AS_EVENT_READ_COMPLETE;
 }
 
+static int
+as_event_parse_staged(as_event_command* cmd)
+{
+	// Parse body directly from the read ahead buffer.
+	as_event_read_buffer* rb = &cmd->conn->rbuf;
+	uint8_t* buf = cmd->buf;
+
+	cmd->buf = rb->data + rb->pos;
+	cmd->pos = 0;
+	rb->pos += cmd->len;
+
+	if (! cmd->parse_results(cmd)) {
+		// Batch, scan, query is not finished.
+		cmd->buf = buf;
+		return as_event_command_peek_block(cmd);
+	}
+
+	return AS_EVENT_COMMAND_DONE;
+}
+
 static int
 as_event_command_read(as_event_command* cmd)
 {
@@ -636,16 +744,15 @@ as_event_command_read(as_event_command* cmd)
 		cmd->pos = 0;
 		cmd->state = AS_ASYNC_STATE_COMMAND_READ_BODY;
 		
-		if (cmd->len > cmd->read_capacity) {
-			if (cmd->flags & AS_ASYNC_FLAGS_FREE_BUF) {
-				cf_free(cmd->buf);
-			}
-			cmd->buf = cf_malloc(size);
-			cmd->read_capacity = cmd->len;
-			cmd->flags |= AS_ASYNC_FLAGS_FREE_BUF;
+		if (cmd->len > cmd->read_capacity && ! as_event_body_staged(cmd)) {
+			as_event_command_buf_grow(cmd, size);
 		}
 	}
 	
+	if (cmd->pos == 0 && as_event_body_staged(cmd)) {
+		return as_event_parse_staged(cmd);
+	}
+
 	// Read response body
 	rv = as_event_read(cmd);
 	if (rv != AS_EVENT_READ_COMPLETE) {
@@ -757,7 +864,8 @@ as_event_callback_common(as_event_command* cmd, as_event_connection* conn) {
 	case AS_ASYNC_STATE_COMMAND_READ_BODY:
 		// If we're using TLS we must loop until there are no bytes
 		// left in the encryption buffer because we won't get another
-		// read event.
+		// read event. The same applies to bytes left in the read
+		// ahead buffer.
 		do {
 			switch (as_event_command_read(cmd)) {
 			case AS_EVENT_COMMAND_DONE:
@@ -772,7 +880,8 @@ as_event_callback_common(as_event_command* cmd, as_event_connection* conn) {
 			default:
 				break;
 			}
-		} while (as_tls_read_pending(&cmd->conn->socket) > 0);
+		} while (as_tls_read_pending(&cmd->conn->socket) > 0 ||
+				 cmd->conn->rbuf.pos < cmd->conn->rbuf.len);
 		break;
 
 	default:
@@ -833,6 +942,9 @@ as_event_watcher_init(as_event_command* cmd, as_socket* sock)
 {
 	as_event_connection* conn = cmd->conn;
 	memcpy(&conn->socket, sock, sizeof(as_socket));
+	conn->rbuf.data = NULL;
+	conn->rbuf.pos = 0;
+	conn->rbuf.len = 0;
 
 	// Change state if using TLS.
 	if (as_socket_use_tls(cmd->cluster->tls_ctx)) {
@@ -882,6 +994,10 @@ as_event_try_family_connections(as_event_command* cmd, int family, int begin, in
 		return -1001;
 	}
 
+	if (ctx) {
+		as_tls_set_session(sock->ssl, ctx, &cmd->node->tls_session);
+	}
+
 	// Try addresses.
 	as_address* addresses = cmd->node->addresses;
 	socklen_t size = (family == AF_INET)? sizeof(struct sockaddr_in) : sizeof(struct sockaddr_in6);
@@ -0,0 +1,1369 @@
+/*
+ * Copyright 2008-2021 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <aerospike/as_event.h>
+#include <aerospike/as_event_internal.h>
+#include <aerospike/as_admin.h>
+#include <aerospike/as_async.h>
+#include <aerospike/as_atomic.h>
+#include <aerospike/as_log_macros.h>
+#include <aerospike/as_pipe.h>
+#include <aerospike/as_proto.h>
+#include <aerospike/as_socket.h>
+#include <aerospike/as_status.h>
+#include <citrusleaf/alloc.h>
+#include <citrusleaf/cf_byte_order.h>
+#include <citrusleaf/cf_clock.h>
+
+/******************************************************************************
+ * IO_URING FUNCTIONS
+ *****************************************************************************/
+
+#if defined(AS_USE_IO_URING)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <liburing.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/******************************************************************************
+ * GLOBALS
+ *****************************************************************************/
+
+extern uint32_t as_event_loop_capacity;
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+#define AS_URING_ENTRIES 1024
+#define AS_URING_FILES 4096
+#define AS_URING_BUFFERS 256
+#define AS_URING_BUFFER_SIZE (16 * 1024)
+#define AS_URING_TIMERS_INITIAL_CAPACITY 256
+
+// Connection completions carry the connection pointer tagged with the operation
+// in the low bits. Operation bit in conn->ops is (1 << tag).
+#define AS_URING_TAG_READ 0
+#define AS_URING_TAG_WRITE 1
+#define AS_URING_TAG_CONNECT 2
+#define AS_URING_TAG_MASK 3
+
+// Reserved user_data values. Connection pointers are always aligned beyond these.
+#define AS_URING_CANCEL 0
+#define AS_URING_WAKEUP 1
+
+typedef struct as_uring_s {
+	struct io_uring ring;
+	as_event_loop* event_loop;
+
+	// Min-heap of active command timers ordered by deadline.
+	as_event_command** timers;
+	uint32_t timers_size;
+	uint32_t timers_capacity;
+
+	// Free registered file slots. NULL if fixed files are not supported.
+	int32_t* files_free;
+	uint32_t files_free_size;
+
+	// Registered receive buffers and free buffer slots. NULL if not supported.
+	uint8_t* buffers;
+	int32_t* buffers_free;
+	uint32_t buffers_free_size;
+
+	uint64_t wakeup_value;
+	int wakeup_fd;
+	bool stopped;
+} as_uring;
+
+#define AS_EVENT_WRITE_COMPLETE 0
+#define AS_EVENT_WRITE_INCOMPLETE 1
+#define AS_EVENT_WRITE_ERROR 2
+
+#define AS_EVENT_READ_COMPLETE 3
+#define AS_EVENT_READ_INCOMPLETE 4
+#define AS_EVENT_READ_ERROR 5
+
+#define AS_EVENT_COMMAND_DONE 8
+
+/******************************************************************************
+ * SUBMISSION FUNCTIONS
+ *****************************************************************************/
+
+static struct io_uring_sqe*
+as_uring_get_sqe(as_uring* ur)
+{
+	struct io_uring_sqe* sqe;
+
+	// Submission queue is full. Flush pending submissions and try again.
+	while (! (sqe = io_uring_get_sqe(&ur->ring))) {
+		io_uring_submit(&ur->ring);
+	}
+	return sqe;
+}
+
+static inline int
+as_uring_fd(as_event_connection* conn)
+{
+	return conn->file_index >= 0 ? conn->file_index : conn->socket.fd;
+}
+
+static inline void
+as_uring_prep_conn(struct io_uring_sqe* sqe, as_event_connection* conn, uint32_t tag)
+{
+	if (conn->file_index >= 0) {
+		io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE);
+	}
+	io_uring_sqe_set_data64(sqe, (uint64_t)(uintptr_t)conn | tag);
+	conn->ops |= (uint8_t)(1 << tag);
+}
+
+static void
+as_uring_read_submit(as_event_connection* conn)
+{
+	// Only one read is in flight per connection and staged bytes must be consumed first.
+	if ((conn->ops & AS_URING_OP_READ) || conn->rbuf_pos < conn->rbuf_len) {
+		return;
+	}
+
+	struct io_uring_sqe* sqe = as_uring_get_sqe(conn->event_loop->loop);
+
+	conn->rbuf_pos = 0;
+	conn->rbuf_len = 0;
+
+	if (conn->buf_index >= 0) {
+		io_uring_prep_read_fixed(sqe, as_uring_fd(conn), conn->rbuf, AS_URING_BUFFER_SIZE, 0,
+			conn->buf_index);
+	}
+	else {
+		io_uring_prep_recv(sqe, as_uring_fd(conn), conn->rbuf, AS_URING_BUFFER_SIZE, 0);
+	}
+	as_uring_prep_conn(sqe, conn, AS_URING_TAG_READ);
+}
+
+static void
+as_uring_send(as_event_command* cmd)
+{
+	as_event_connection* conn = cmd->conn;
+	uint8_t* buf = (uint8_t*)cmd + cmd->write_offset;
+	struct io_uring_sqe* sqe = as_uring_get_sqe(conn->event_loop->loop);
+
+	io_uring_prep_send(sqe, as_uring_fd(conn), buf + cmd->pos, cmd->len - cmd->pos, MSG_NOSIGNAL);
+	as_uring_prep_conn(sqe, conn, AS_URING_TAG_WRITE);
+}
+
+void
+as_uring_cancel(as_event_connection* conn)
+{
+	uint8_t ops = conn->ops & AS_URING_OP_IO;
+
+	if (! ops) {
+		return;
+	}
+
+	as_uring* ur = conn->event_loop->loop;
+
+	for (uint32_t tag = AS_URING_TAG_READ; tag <= AS_URING_TAG_CONNECT; tag++) {
+		if (ops & (1 << tag)) {
+			struct io_uring_sqe* sqe = as_uring_get_sqe(ur);
+			io_uring_prep_cancel64(sqe, (uint64_t)(uintptr_t)conn | tag, 0);
+			io_uring_sqe_set_data64(sqe, AS_URING_CANCEL);
+		}
+	}
+}
+
+/******************************************************************************
+ * CONNECTION FUNCTIONS
+ *****************************************************************************/
+
+static void
+as_uring_conn_init(as_uring* ur, as_event_connection* conn, as_socket* sock)
+{
+	memcpy(&conn->socket, sock, sizeof(as_socket));
+	conn->event_loop = ur->event_loop;
+	conn->rbuf_pos = 0;
+	conn->rbuf_len = 0;
+	conn->ops = 0;
+	conn->closed = false;
+	conn->file_index = -1;
+
+	if (ur->files_free_size > 0) {
+		int32_t index = ur->files_free[ur->files_free_size - 1];
+		int fd = conn->socket.fd;
+
+		if (io_uring_register_files_update(&ur->ring, (unsigned)index, &fd, 1) == 1) {
+			ur->files_free_size--;
+			conn->file_index = index;
+		}
+	}
+
+	if (ur->buffers_free_size > 0) {
+		conn->buf_index = ur->buffers_free[--ur->buffers_free_size];
+		conn->rbuf = ur->buffers + (size_t)conn->buf_index * AS_URING_BUFFER_SIZE;
+	}
+	else {
+		conn->buf_index = -1;
+		conn->rbuf = cf_malloc(AS_URING_BUFFER_SIZE);
+	}
+}
+
+static void
+as_uring_conn_free(as_event_connection* conn)
+{
+	as_uring* ur = conn->event_loop->loop;
+
+	if (conn->file_index >= 0) {
+		int fd = -1;
+		io_uring_register_files_update(&ur->ring, (unsigned)conn->file_index, &fd, 1);
+		ur->files_free[ur->files_free_size++] = conn->file_index;
+	}
+
+	if (conn->buf_index >= 0) {
+		ur->buffers_free[ur->buffers_free_size++] = conn->buf_index;
+	}
+	else {
+		cf_free(conn->rbuf);
+	}
+
+	as_socket_close(&conn->socket);
+	as_event_connection_free(conn);
+}
+
+void
+as_event_close_connection(as_event_connection* conn)
+{
+	if (conn->ops) {
+		// Operations are still in flight and may reference the receive buffer.
+		// Free connection when the last completion is received.
+		as_uring_cancel(conn);
+		shutdown(conn->socket.fd, SHUT_RDWR);
+		conn->closed = true;
+		return;
+	}
+	as_uring_conn_free(conn);
+}
+
+static inline as_event_command*
+as_uring_writer(as_event_connection* conn)
+{
+	return conn->pipeline ?
+		((as_pipe_connection*)conn)->writer :
+		((as_async_connection*)conn)->cmd;
+}
+
+static as_event_command*
+as_uring_reader(as_event_connection* conn)
+{
+	if (! conn->pipeline) {
+		return ((as_async_connection*)conn)->cmd;
+	}
+
+	as_pipe_connection* pipe = (as_pipe_connection*)conn;
+
+	if (pipe->writer && cf_ll_size(&pipe->readers) == 0) {
+		// Authentication response will only have a writer.
+		return pipe->writer;
+	}
+
+	// Next response is at head of reader linked list.
+	cf_ll_element* link = cf_ll_get_head(&pipe->readers);
+	return link ? as_pipe_link_to_command(link) : NULL;
+}
+
+static void
+as_uring_socket_error(as_event_command* cmd, const char* msg, int e)
+{
+	int fd = cmd->conn->socket.fd;
+
+	if (! as_event_socket_retry(cmd)) {
+		as_error err;
+		as_socket_error(fd, cmd->node, &err, AEROSPIKE_ERR_ASYNC_CONNECTION, msg, e);
+		as_event_socket_error(cmd, &err);
+	}
+}
+
+/******************************************************************************
+ * COMMAND FUNCTIONS
+ *****************************************************************************/
+
+static int
+as_uring_read(as_event_command* cmd)
+{
+	as_event_connection* conn = cmd->conn;
+	uint32_t avail = conn->rbuf_len - conn->rbuf_pos;
+
+	if (avail > 0) {
+		cmd->flags |= AS_ASYNC_FLAGS_EVENT_RECEIVED;
+
+		uint32_t n = cmd->len - cmd->pos;
+
+		if (n > avail) {
+			n = avail;
+		}
+
+		memcpy(cmd->buf + cmd->pos, conn->rbuf + conn->rbuf_pos, n);
+		cmd->pos += n;
+		conn->rbuf_pos += n;
+
+		if (cmd->pos >= cmd->len) {
+			return AS_EVENT_READ_COMPLETE;
+		}
+	}
+
+	// Staged bytes are exhausted. Completion will resume the read.
+	as_uring_read_submit(conn);
+	return AS_EVENT_READ_INCOMPLETE;
+}
+
+static void
+as_uring_command_start(as_event_command* cmd)
+{
+	if (cmd->cluster->auth_enabled) {
+		as_session* session = (as_session*)as_load_ptr(&cmd->node->session);
+
+		if (session) {
+			as_incr_uint32(&session->ref_count);
+			as_event_set_auth_write(cmd, session);
+			as_session_release(session);
+
+			cmd->state = AS_ASYNC_STATE_AUTH_WRITE;
+
+			// Queue auth response read with auth write.
+			as_uring_send(cmd);
+			as_uring_read_submit(cmd->conn);
+		}
+		else {
+			as_event_command_write_start(cmd);
+		}
+	}
+	else if (cmd->type == AS_ASYNC_TYPE_CONNECTOR) {
+		as_event_connector_success(cmd);
+	}
+	else {
+		as_event_command_write_start(cmd);
+	}
+}
+
+void
+as_event_command_write_start(as_event_command* cmd)
+{
+	cmd->state = AS_ASYNC_STATE_COMMAND_WRITE;
+	as_event_set_write(cmd);
+	cmd->conn->watching = 1;
+	as_uring_send(cmd);
+
+	if (cmd->pipe_listener == NULL) {
+		// Queue response read with request write. Both are submitted with a single
+		// system call on the next event loop iteration.
+		as_uring_read_submit(cmd->conn);
+	}
+}
+
+static int
+as_uring_command_peek_block(as_event_command* cmd)
+{
+	// Batch, scan, query may be waiting on end block.
+	// Prepare for next message block.
+	cmd->len = sizeof(as_proto);
+	cmd->pos = 0;
+	cmd->state = AS_ASYNC_STATE_COMMAND_READ_HEADER;
+
+	int rv = as_uring_read(cmd);
+	if (rv != AS_EVENT_READ_COMPLETE) {
+		return rv;
+	}
+
+	as_proto* proto = (as_proto*)cmd->buf;
+
+	if (! as_event_proto_parse(cmd, proto)) {
+		return AS_EVENT_READ_ERROR;
+	}
+
+	size_t size = proto->sz;
+
+	cmd->len = (uint32_t)size;
+	cmd->pos = 0;
+	cmd->state = AS_ASYNC_STATE_COMMAND_READ_BODY;
+
+	// Check for end block size.
+	if (cmd->len == sizeof(as_msg) && cmd->proto_type_rcv != AS_COMPRESSED_MESSAGE_TYPE) {
+		// Look like we received end block.  Read and parse to make sure.
+		rv = as_uring_read(cmd);
+		if (rv != AS_EVENT_READ_COMPLETE) {
+			return rv;
+		}
+		cmd->pos = 0;
+
+		if (! cmd->parse_results(cmd)) {
+			// We did not finish after all. Prepare to read next header.
+			cmd->len = sizeof(as_proto);
+			cmd->pos = 0;
+			cmd->state = AS_ASYNC_STATE_COMMAND_READ_HEADER;
+		}
+		else {
+			return AS_EVENT_COMMAND_DONE;
+		}
+	}
+	else {
+		if (cmd->len > cmd->read_capacity) {
+			as_event_command_buf_grow(cmd, size);
+		}
+	}
+
+	return AS_EVENT_READ_COMPLETE;
+}
+
+static int
+as_uring_parse_authentication(as_event_command* cmd)
+{
+	int rv;
+	if (cmd->state == AS_ASYNC_STATE_AUTH_READ_HEADER) {
+		// Read response length
+		rv = as_uring_read(cmd);
+		if (rv != AS_EVENT_READ_COMPLETE) {
+			return rv;
+		}
+
+		if (! as_event_set_auth_parse_header(cmd)) {
+			return AS_EVENT_READ_ERROR;
+		}
+
+		if (cmd->len > cmd->read_capacity) {
+			as_error err;
+			as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Authenticate response size is corrupt: %u", cmd->len);
+			as_event_parse_error(cmd, &err);
+			return AS_EVENT_READ_ERROR;
+		}
+	}
+
+	rv = as_uring_read(cmd);
+	if (rv != AS_EVENT_READ_COMPLETE) {
+		return rv;
+	}
+
+	// Parse authentication response.
+	uint8_t code = cmd->buf[AS_ASYNC_AUTH_RETURN_CODE];
+
+	if (code && code != AEROSPIKE_SECURITY_NOT_ENABLED) {
+		// Can't authenticate socket, so must close it.
+		as_node_signal_login(cmd->node);
+		as_error err;
+		as_error_update(&err, code, "Authentication failed: %s", as_error_string(code));
+		as_event_parse_error(cmd, &err);
+		return AS_EVENT_READ_ERROR;
+	}
+
+	if (cmd->type == AS_ASYNC_TYPE_CONNECTOR) {
+		as_event_connector_success(cmd);
+		return AS_EVENT_COMMAND_DONE;
+	}
+
+	as_event_command_write_start(cmd);
+	return AS_EVENT_READ_COMPLETE;
+}
+
+static int
+as_uring_command_read(as_event_command* cmd)
+{
+	int rv;
+
+	if (cmd->state == AS_ASYNC_STATE_COMMAND_READ_HEADER) {
+		// Read response length
+		rv = as_uring_read(cmd);
+		if (rv != AS_EVENT_READ_COMPLETE) {
+			return rv;
+		}
+
+		as_proto* proto = (as_proto*)cmd->buf;
+
+		if (! as_event_proto_parse(cmd, proto)) {
+			return AS_EVENT_READ_ERROR;
+		}
+
+		size_t size = proto->sz;
+
+		cmd->len = (uint32_t)size;
+		cmd->pos = 0;
+		cmd->state = AS_ASYNC_STATE_COMMAND_READ_BODY;
+
+		if (cmd->len > cmd->read_capacity) {
+			as_event_command_buf_grow(cmd, size);
+		}
+	}
+
+	// Read response body
+	rv = as_uring_read(cmd);
+	if (rv != AS_EVENT_READ_COMPLETE) {
+		return rv;
+	}
+	cmd->pos = 0;
+
+	if (cmd->proto_type_rcv == AS_COMPRESSED_MESSAGE_TYPE) {
+		if (! as_event_decompress(cmd)) {
+			return AS_EVENT_READ_ERROR;
+		}
+	}
+
+	if (! cmd->parse_results(cmd)) {
+		// Batch, scan, query is not finished.
+		return as_uring_command_peek_block(cmd);
+	}
+
+	return AS_EVENT_COMMAND_DONE;
+}
+
+static void
+as_uring_command_read_loop(as_event_command* cmd)
+{
+	// Consume staged bytes until the response completes, fails or more bytes are needed.
+	// Do not touch cmd after completion or error because it's been deallocated.
+	while (as_uring_command_read(cmd) == AS_EVENT_READ_COMPLETE) {
+	}
+}
+
+static void
+as_uring_pipe_read(as_event_connection* conn)
+{
+	// Staged bytes may contain responses for multiple readers.
+	while (! conn->closed && conn->watching) {
+		as_event_command* cmd = as_uring_reader(conn);
+
+		if (! cmd) {
+			return;
+		}
+
+		switch (cmd->state) {
+			case AS_ASYNC_STATE_AUTH_READ_HEADER:
+			case AS_ASYNC_STATE_AUTH_READ_BODY:
+				as_uring_parse_authentication(cmd);
+				return;
+
+			case AS_ASYNC_STATE_COMMAND_READ_HEADER:
+			case AS_ASYNC_STATE_COMMAND_READ_BODY: {
+				int rv = as_uring_command_read(cmd);
+
+				if (rv == AS_EVENT_READ_INCOMPLETE || rv == AS_EVENT_READ_ERROR) {
+					return;
+				}
+				break;
+			}
+
+			default:
+				// Writer has not finished. Bytes remain staged.
+				return;
+		}
+	}
+}
+
+static void
+as_uring_command_read_start(as_event_command* cmd)
+{
+	cmd->command_sent_counter++;
+	cmd->len = sizeof(as_proto);
+	cmd->pos = 0;
+	cmd->state = AS_ASYNC_STATE_COMMAND_READ_HEADER;
+
+	if (cmd->pipe_listener != NULL) {
+		as_event_connection* conn = cmd->conn;
+		as_pipe_read_start(cmd);
+		as_uring_pipe_read(conn);
+	}
+	else {
+		as_uring_command_read_loop(cmd);
+	}
+}
+
+/******************************************************************************
+ * COMPLETION FUNCTIONS
+ *****************************************************************************/
+
+static void
+as_uring_connect_complete(as_event_connection* conn, int res)
+{
+	as_event_command* cmd = as_uring_writer(conn);
+
+	if (! cmd) {
+		return;
+	}
+
+	int fd = conn->socket.fd;
+	int e = 0;
+
+	if (res < 0) {
+		e = -res;
+	}
+	else if (res & (POLLERR | POLLHUP)) {
+		socklen_t len = sizeof(e);
+
+		if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &e, &len) != 0 || e == 0) {
+			e = ECONNREFUSED;
+		}
+	}
+
+	if (e) {
+		as_uring_socket_error(cmd, "Socket connect failed", e);
+		return;
+	}
+
+	// Non-blocking sockets make io_uring return EAGAIN instead of waiting on the
+	// socket internally, so switch to blocking mode once connected.
+	int flags = fcntl(fd, F_GETFL, 0);
+
+	if (flags >= 0) {
+		fcntl(fd, F_SETFL, flags & ~O_NONBLOCK);
+	}
+
+	as_uring_command_start(cmd);
+}
+
+static void
+as_uring_write_complete(as_event_connection* conn, int res)
+{
+	as_event_command* cmd = as_uring_writer(conn);
+
+	if (! cmd) {
+		return;
+	}
+
+	if (res <= 0) {
+		if (res == -EAGAIN || res == -EINTR) {
+			as_uring_send(cmd);
+			return;
+		}
+
+		if (res == 0) {
+			as_uring_socket_error(cmd, "Socket write closed by peer", 0);
+		}
+		else {
+			as_uring_socket_error(cmd, "Socket write failed", -res);
+		}
+		return;
+	}
+
+	cmd->pos += (uint32_t)res;
+
+	if (cmd->pos < cmd->len) {
+		as_uring_send(cmd);
+		return;
+	}
+
+	// Socket timeout applies only to read events.
+	// Reset event received because we are switching from a write to a read state.
+	cmd->flags &= ~AS_ASYNC_FLAGS_EVENT_RECEIVED;
+
+	if (cmd->state == AS_ASYNC_STATE_AUTH_WRITE) {
+		// Done with auth write. Auth response may already be staged.
+		as_event_set_auth_read_header(cmd);
+
+		if (conn->pipeline) {
+			as_uring_pipe_read(conn);
+		}
+		else {
+			as_uring_parse_authentication(cmd);
+		}
+		return;
+	}
+
+	as_uring_command_read_start(cmd);
+}
+
+static void
+as_uring_read_complete(as_event_connection* conn, int res)
+{
+	if (res <= 0) {
+		if (res == -EAGAIN || res == -EINTR) {
+			as_uring_read_submit(conn);
+			return;
+		}
+
+		as_event_command* cmd = as_uring_reader(conn);
+
+		if (! cmd) {
+			as_log_debug("Pipeline read error ignored: %d", res);
+			return;
+		}
+
+		if (res == 0) {
+			as_uring_socket_error(cmd, "Socket read closed by peer", 0);
+		}
+		else {
+			as_uring_socket_error(cmd, "Socket read failed", -res);
+		}
+		return;
+	}
+
+	if (conn->pipeline) {
+		as_uring_pipe_read(conn);
+		return;
+	}
+
+	as_event_command* cmd = ((as_async_connection*)conn)->cmd;
+
+	switch (cmd->state) {
+		case AS_ASYNC_STATE_AUTH_READ_HEADER:
+		case AS_ASYNC_STATE_AUTH_READ_BODY:
+			as_uring_parse_authentication(cmd);
+			break;
+
+		case AS_ASYNC_STATE_COMMAND_READ_HEADER:
+		case AS_ASYNC_STATE_COMMAND_READ_BODY:
+			as_uring_command_read_loop(cmd);
+			break;
+
+		default:
+			// Response arrived before write completion was processed.
+			// Bytes remain staged until command switches to read state.
+			break;
+	}
+}
+
+static void
+as_uring_conn_complete(as_event_connection* conn, uint32_t tag, int res)
+{
+	conn->ops &= (uint8_t)~(1 << tag);
+
+	if (tag == AS_URING_TAG_READ && res > 0) {
+		conn->rbuf_len = (uint32_t)res;
+	}
+
+	if (conn->closed) {
+		if (conn->ops == 0) {
+			as_uring_conn_free(conn);
+		}
+		return;
+	}
+
+	if (! conn->watching) {
+		// Watcher was stopped. Received bytes remain staged for connection validation.
+		return;
+	}
+
+	if (res == -ECANCELED) {
+		// Read was canceled when the previous command stopped watching and the
+		// connection has since been reused. Resume reading for the new command.
+		if (tag == AS_URING_TAG_READ) {
+			as_uring_read_submit(conn);
+		}
+		return;
+	}
+
+	// Callbacks may close the connection. Defer free until processing returns.
+	conn->ops |= AS_URING_OP_DISPATCH;
+
+	switch (tag) {
+		case AS_URING_TAG_READ:
+			as_uring_read_complete(conn, res);
+			break;
+
+		case AS_URING_TAG_WRITE:
+			as_uring_write_complete(conn, res);
+			break;
+
+		case AS_URING_TAG_CONNECT:
+			as_uring_connect_complete(conn, res);
+			break;
+	}
+
+	conn->ops &= ~AS_URING_OP_DISPATCH;
+
+	if (conn->closed && conn->ops == 0) {
+		as_uring_conn_free(conn);
+	}
+}
+
+/******************************************************************************
+ * TIMER FUNCTIONS
+ *****************************************************************************/
+
+static inline void
+as_uring_heap_set(as_uring* ur, uint32_t pos, as_event_command* cmd)
+{
+	ur->timers[pos] = cmd;
+	cmd->timer.index = pos + 1;
+}
+
+static void
+as_uring_heap_up(as_uring* ur, uint32_t pos)
+{
+	as_event_command* cmd = ur->timers[pos];
+
+	while (pos > 0) {
+		uint32_t parent = (pos - 1) / 2;
+		as_event_command* p = ur->timers[parent];
+
+		if (p->timer.deadline <= cmd->timer.deadline) {
+			break;
+		}
+		as_uring_heap_set(ur, pos, p);
+		pos = parent;
+	}
+	as_uring_heap_set(ur, pos, cmd);
+}
+
+static void
+as_uring_heap_down(as_uring* ur, uint32_t pos)
+{
+	as_event_command* cmd = ur->timers[pos];
+	uint32_t size = ur->timers_size;
+
+	while (true) {
+		uint32_t child = pos * 2 + 1;
+
+		if (child >= size) {
+			break;
+		}
+
+		if (child + 1 < size &&
+			ur->timers[child + 1]->timer.deadline < ur->timers[child]->timer.deadline) {
+			child++;
+		}
+
+		if (cmd->timer.deadline <= ur->timers[child]->timer.deadline) {
+			break;
+		}
+		as_uring_heap_set(ur, pos, ur->timers[child]);
+		pos = child;
+	}
+	as_uring_heap_set(ur, pos, cmd);
+}
+
+static inline bool
+as_uring_timer_active(as_uring* ur, as_event_command* cmd)
+{
+	// Timer index is not initialized before the first start, so verify heap entry.
+	uint32_t index = cmd->timer.index;
+	return index > 0 && index <= ur->timers_size && ur->timers[index - 1] == cmd;
+}
+
+static void
+as_uring_timer_remove(as_uring* ur, uint32_t pos)
+{
+	ur->timers[pos]->timer.index = 0;
+
+	uint32_t last = --ur->timers_size;
+
+	if (pos == last) {
+		return;
+	}
+
+	as_event_command* moved = ur->timers[last];
+	as_uring_heap_set(ur, pos, moved);
+	as_uring_heap_down(ur, pos);
+	as_uring_heap_up(ur, moved->timer.index - 1);
+}
+
+void
+as_uring_timer_start(as_event_command* cmd, uint64_t ms)
+{
+	as_uring* ur = cmd->event_loop->loop;
+	cmd->timer.deadline = cf_getns() + ms * 1000 * 1000;
+
+	if (as_uring_timer_active(ur, cmd)) {
+		as_uring_heap_down(ur, cmd->timer.index - 1);
+		as_uring_heap_up(ur, cmd->timer.index - 1);
+		return;
+	}
+
+	if (ur->timers_size == ur->timers_capacity) {
+		ur->timers_capacity *= 2;
+		ur->timers = cf_realloc(ur->timers, sizeof(as_event_command*) * ur->timers_capacity);
+	}
+
+	uint32_t pos = ur->timers_size++;
+	as_uring_heap_set(ur, pos, cmd);
+	as_uring_heap_up(ur, pos);
+}
+
+void
+as_uring_timer_stop(as_event_command* cmd)
+{
+	as_uring* ur = cmd->event_loop->loop;
+
+	if (as_uring_timer_active(ur, cmd)) {
+		as_uring_timer_remove(ur, cmd->timer.index - 1);
+	}
+}
+
+static void
+as_uring_process_timers(as_uring* ur)
+{
+	uint64_t now = cf_getns();
+
+	while (ur->timers_size > 0 && ! ur->stopped) {
+		as_event_command* cmd = ur->timers[0];
+
+		if (cmd->timer.deadline > now) {
+			break;
+		}
+
+		if (cmd->timer.repeat) {
+			// Rearm before callback, which may stop or restart the timer.
+			cmd->timer.deadline = now + (uint64_t)cmd->timer.repeat * 1000 * 1000;
+			as_uring_heap_down(ur, 0);
+			as_event_socket_timeout(cmd);
+		}
+		else {
+			as_uring_timer_remove(ur, 0);
+			as_event_process_timer(cmd);
+		}
+	}
+}
+
+/******************************************************************************
+ * EVENT LOOP FUNCTIONS
+ *****************************************************************************/
+
+static void
+as_uring_wakeup_submit(as_uring* ur)
+{
+	struct io_uring_sqe* sqe = as_uring_get_sqe(ur);
+	io_uring_prep_read(sqe, ur->wakeup_fd, &ur->wakeup_value, sizeof(ur->wakeup_value), 0);
+	io_uring_sqe_set_data64(sqe, AS_URING_WAKEUP);
+}
+
+static void
+as_uring_signal(as_uring* ur)
+{
+	uint64_t value = 1;
+
+	if (write(ur->wakeup_fd, &value, sizeof(value)) < 0) {
+		as_log_error("Event loop wakeup failed: %d", errno);
+	}
+}
+
+void
+as_event_close_loop(as_event_loop* event_loop)
+{
+	// Worker thread releases io_uring resources when the current iteration completes.
+	event_loop->loop->stopped = true;
+
+	// Cleanup event loop resources.
+	as_event_loop_destroy(event_loop);
+}
+
+static void
+as_uring_wakeup(as_uring* ur)
+{
+	as_event_loop* event_loop = ur->event_loop;
+	as_event_commander cmd;
+	uint32_t i = 0;
+
+	// Only process original size of queue.  Recursive pre-registration errors can
+	// result in new commands being added while the loop is in process.  If we process
+	// them, we could end up in an infinite loop.
+	uint32_t size = as_load_uint32(&event_loop->submit_size);
+
+	while (i < size && as_event_submit_pop(event_loop, &cmd)) {
+		if (! cmd.executable) {
+			// Received stop signal.
+			as_event_close_loop(event_loop);
+			return;
+		}
+		cmd.executable(event_loop, cmd.udata);
+		i++;
+	}
+
+	if (as_event_submit_complete(event_loop, i)) {
+		// Commands were submitted while processing or are not published yet.
+		as_uring_signal(ur);
+	}
+
+	as_uring_wakeup_submit(ur);
+}
+
+static void
+as_uring_process_completions(as_uring* ur)
+{
+	struct io_uring_cqe* cqe;
+	unsigned head;
+	unsigned count = 0;
+
+	io_uring_for_each_cqe(&ur->ring, head, cqe) {
+		uint64_t data = io_uring_cqe_get_data64(cqe);
+		int res = cqe->res;
+
+		count++;
+
+		if (data == AS_URING_CANCEL) {
+			continue;
+		}
+
+		if (data == AS_URING_WAKEUP) {
+			if (! ur->stopped) {
+				as_uring_wakeup(ur);
+			}
+			continue;
+		}
+
+		as_event_connection* conn = (as_event_connection*)(uintptr_t)
+			(data & ~(uint64_t)AS_URING_TAG_MASK);
+
+		as_uring_conn_complete(conn, (uint32_t)(data & AS_URING_TAG_MASK), res);
+	}
+	io_uring_cq_advance(&ur->ring, count);
+}
+
+static void
+as_uring_destroy(as_uring* ur)
+{
+	io_uring_queue_exit(&ur->ring);
+	close(ur->wakeup_fd);
+	cf_free(ur->buffers);
+	cf_free(ur->buffers_free);
+	cf_free(ur->files_free);
+	cf_free(ur->timers);
+	cf_free(ur);
+}
+
+static void*
+as_uring_worker(void* udata)
+{
+	as_event_loop* event_loop = udata;
+	as_uring* ur = event_loop->loop;
+
+	while (! ur->stopped) {
+		struct __kernel_timespec ts;
+		struct __kernel_timespec* tsp = NULL;
+
+		if (ur->timers_size > 0) {
+			uint64_t now = cf_getns();
+			uint64_t deadline = ur->timers[0]->timer.deadline;
+			uint64_t wait = deadline > now ? deadline - now : 0;
+
+			ts.tv_sec = (long long)(wait / 1000000000);
+			ts.tv_nsec = (long long)(wait % 1000000000);
+			tsp = &ts;
+		}
+
+		// Submit all operations queued since the last iteration and wait for at least
+		// one completion or the next timer expiration with a single system call.
+		struct io_uring_cqe* cqe;
+		int rv = io_uring_submit_and_wait_timeout(&ur->ring, &cqe, 1, tsp, NULL);
+
+		if (rv < 0 && rv != -ETIME && rv != -EINTR) {
+			as_log_error("io_uring wait failed: %d", -rv);
+		}
+
+		as_uring_process_completions(ur);
+		as_uring_process_timers(ur);
+	}
+
+	event_loop->loop = NULL;
+	as_uring_destroy(ur);
+	return NULL;
+}
+
+static void
+as_uring_register(as_uring* ur)
+{
+	// Fixed files and registered buffers are optional. Connections fall back to plain
+	// descriptors and heap buffers when the kernel does not support them or slots run out.
+	if (io_uring_register_files_sparse(&ur->ring, AS_URING_FILES) == 0) {
+		ur->files_free = cf_malloc(sizeof(int32_t) * AS_URING_FILES);
+
+		for (uint32_t i = 0; i < AS_URING_FILES; i++) {
+			ur->files_free[i] = AS_URING_FILES - 1 - i;
+		}
+		ur->files_free_size = AS_URING_FILES;
+	}
+
+	uint8_t* buffers = cf_malloc((size_t)AS_URING_BUFFERS * AS_URING_BUFFER_SIZE);
+	struct iovec iov[AS_URING_BUFFERS];
+
+	for (uint32_t i = 0; i < AS_URING_BUFFERS; i++) {
+		iov[i].iov_base = buffers + (size_t)i * AS_URING_BUFFER_SIZE;
+		iov[i].iov_len = AS_URING_BUFFER_SIZE;
+	}
+
+	int rv = io_uring_register_buffers(&ur->ring, iov, AS_URING_BUFFERS);
+
+	if (rv != 0) {
+		as_log_info("io_uring registered buffers disabled: %d", -rv);
+		cf_free(buffers);
+		return;
+	}
+
+	ur->buffers = buffers;
+	ur->buffers_free = cf_malloc(sizeof(int32_t) * AS_URING_BUFFERS);
+
+	for (uint32_t i = 0; i < AS_URING_BUFFERS; i++) {
+		ur->buffers_free[i] = AS_URING_BUFFERS - 1 - i;
+	}
+	ur->buffers_free_size = AS_URING_BUFFERS;
+}
+
+bool
+as_event_create_loop(as_event_loop* event_loop)
+{
+	as_uring* ur = cf_malloc(sizeof(as_uring));
+	memset(ur, 0, sizeof(as_uring));
+
+	int rv = io_uring_queue_init(AS_URING_ENTRIES, &ur->ring, 0);
+
+	if (rv < 0) {
+		as_log_error("io_uring_queue_init failed: %d", -rv);
+		cf_free(ur);
+		return false;
+	}
+
+	ur->wakeup_fd = eventfd(0, EFD_CLOEXEC);
+
+	if (ur->wakeup_fd < 0) {
+		as_log_error("eventfd failed: %d", errno);
+		io_uring_queue_exit(&ur->ring);
+		cf_free(ur);
+		return false;
+	}
+
+	ur->event_loop = event_loop;
+	ur->timers_capacity = AS_URING_TIMERS_INITIAL_CAPACITY;
+	ur->timers = cf_malloc(sizeof(as_event_command*) * ur->timers_capacity);
+	as_uring_register(ur);
+	as_uring_wakeup_submit(ur);
+
+	event_loop->loop = ur;
+	return pthread_create(&event_loop->thread, NULL, as_uring_worker, event_loop) == 0;
+}
+
+void
+as_event_register_external_loop(as_event_loop* event_loop)
+{
+	// External event loops are rejected in as_set_external_event_loop().
+}
+
+bool
+as_event_execute(as_event_loop* event_loop, as_event_executable executable, void* udata)
+{
+	// Send command through queue so it can be executed in event loop thread.
+	as_event_commander qcmd = {.executable = executable, .udata = udata};
+	bool wakeup;
+	bool queued = as_event_submit(event_loop, &qcmd, &wakeup);
+
+	if (wakeup) {
+		as_uring_signal(event_loop->loop);
+	}
+	return queued;
+}
+
+/******************************************************************************
+ * CONNECT FUNCTIONS
+ *****************************************************************************/
+
+static int
+as_uring_try_connections(int fd, as_address* addresses, socklen_t size, int i, int max)
+{
+	while (i < max) {
+		if (as_socket_connect_fd(fd, (struct sockaddr*)&addresses[i].addr, size)) {
+			return i;
+		}
+		i++;
+	}
+	return -1;
+}
+
+static int
+as_uring_try_family_connections(as_event_command* cmd, int family, int begin, int end, int index, as_address* primary, as_socket* sock)
+{
+	// Create a non-blocking socket.
+	as_socket_fd fd;
+	int rv = as_socket_create_fd(family, &fd);
+
+	if (rv < 0) {
+		return rv;
+	}
+
+	if (cmd->pipe_listener && ! as_pipe_modify_fd(fd)) {
+		return -1000;
+	}
+
+	if (! as_socket_wrap(sock, family, fd, NULL, cmd->node->tls_name)) {
+		return -1001;
+	}
+
+	// Try addresses.
+	as_address* addresses = cmd->node->addresses;
+	socklen_t size = (family == AF_INET)? sizeof(struct sockaddr_in) : sizeof(struct sockaddr_in6);
+
+	if (index >= 0) {
+		// Try primary address.
+		if (as_socket_connect_fd(fd, (struct sockaddr*)&primary->addr, size)) {
+			return index;
+		}
+
+		// Start from current index + 1 to end.
+		rv = as_uring_try_connections(fd, addresses, size, index + 1, end);
+
+		if (rv < 0) {
+			// Start from begin to index.
+			rv = as_uring_try_connections(fd, addresses, size, begin, index);
+		}
+	}
+	else {
+		rv = as_uring_try_connections(fd, addresses, size, begin, end);
+	}
+
+	if (rv < 0) {
+		// Couldn't start a connection on any socket address - close the socket.
+		as_socket_close(sock);
+		return -1002;
+	}
+	return rv;
+}
+
+static void
+as_uring_connect_error(as_event_command* cmd, as_address* primary, int rv)
+{
+	// Socket has already been closed. Release connection.
+	cf_free(cmd->conn);
+	as_event_decr_conn(cmd);
+	cmd->event_loop->errors++;
+
+	if (as_event_command_retry(cmd, false)) {
+		return;
+	}
+
+	as_error err;
+	as_error_update(&err, AEROSPIKE_ERR_ASYNC_CONNECTION, "Connect failed: %d %s %s", rv, cmd->node->name, primary->name);
+
+	// Only timer needs to be released on socket connection failure.
+	// Connection has not been registered yet.
+	as_event_timer_stop(cmd);
+	as_event_error_callback(cmd, &err);
+}
+
+void
+as_event_connect(as_event_command* cmd, as_async_conn_pool* pool)
+{
+	if (as_socket_use_tls(cmd->cluster->tls_ctx)) {
+		// TLS handshakes and records are processed by OpenSSL directly on the socket,
+		// which does not fit completion based io.
+		cf_free(cmd->conn);
+		as_event_decr_conn(cmd);
+
+		as_error err;
+		as_error_set_message(&err, AEROSPIKE_ERR_TLS_ERROR,
+			"TLS is not supported by the io_uring event loop");
+		as_event_timer_stop(cmd);
+		as_event_error_callback(cmd, &err);
+		return;
+	}
+
+	// Try addresses.
+	as_socket sock;
+	as_node* node = cmd->node;
+	uint32_t index = node->address_index;
+	as_address* primary = &node->addresses[index];
+	int rv;
+	int first_rv;
+
+	if (primary->addr.ss_family == AF_INET) {
+		// Try IPv4 addresses first.
+		rv = as_uring_try_family_connections(cmd, AF_INET, 0, node->address4_size, index, primary, &sock);
+
+		if (rv < 0) {
+			// Try IPv6 addresses.
+			first_rv = rv;
+			rv = as_uring_try_family_connections(cmd, AF_INET6, AS_ADDRESS4_MAX, AS_ADDRESS4_MAX + node->address6_size, -1, NULL, &sock);
+		}
+	}
+	else {
+		// Try IPv6 addresses first.
+		rv = as_uring_try_family_connections(cmd, AF_INET6, AS_ADDRESS4_MAX, AS_ADDRESS4_MAX + node->address6_size, index, primary, &sock);
+
+		if (rv < 0) {
+			// Try IPv4 addresses.
+			first_rv = rv;
+			rv = as_uring_try_family_connections(cmd, AF_INET, 0, node->address4_size, -1, NULL, &sock);
+		}
+	}
+
+	if (rv < 0) {
+		as_uring_connect_error(cmd, primary, first_rv);
+		return;
+	}
+
+	if (rv != index) {
+		// Replace invalid primary address with valid alias.
+		// Other threads may not see this change immediately.
+		// It's just a hint, not a requirement to try this new address first.
+		as_store_uint32(&node->address_index, rv);
+		as_log_debug("Change node address %s %s", node->name, as_node_get_address_string(node));
+	}
+
+	pool->opened++;
+
+	// Register socket and wait for connection to complete.
+	as_uring* ur = cmd->event_loop->loop;
+	as_event_connection* conn = cmd->conn;
+	as_uring_conn_init(ur, conn, &sock);
+	conn->watching = 1;
+
+	struct io_uring_sqe* sqe = as_uring_get_sqe(ur);
+	io_uring_prep_poll_add(sqe, as_uring_fd(conn), POLLOUT);
+	as_uring_prep_conn(sqe, conn, AS_URING_TAG_CONNECT);
+
+	cmd->event_loop->errors = 0; // Reset errors on valid connection.
+}
+
+static void
+as_event_close_connection_cb(as_event_loop* event_loop, as_event_connection* conn)
+{
+	as_event_close_connection(conn);
+}
+
+static bool
+as_uring_queue_close_connections(as_node* node, as_async_conn_pool* pool, as_event_loop* event_loop)
+{
+	as_event_connection* conn;
+
+	// Queue connection commands to event loops.
+	while (as_queue_pop(&pool->queue, &conn)) {
+		if (! as_event_execute(event_loop, (as_event_executable)as_event_close_connection_cb, conn)) {
+			as_log_error("Failed to queue connection close");
+			return false;
+		}
+
+		// Connection counts are decremented before the connection is closed because
+		// the node will be invalid when the deferred connection close occurs.
+		as_queue_decr_total(&pool->queue);
+	}
+	return true;
+}
+
+void
+as_event_node_destroy(as_node* node)
+{
+	// Connections hold ring resources that may only be released by their event loop thread.
+	for (uint32_t i = 0; i < as_event_loop_size; i++) {
+		as_event_loop* event_loop = &as_event_loops[i];
+
+		as_uring_queue_close_connections(node, &node->async_conn_pools[i], event_loop);
+		as_uring_queue_close_connections(node, &node->pipe_conn_pools[i], event_loop);
+	}
+
+	// Destroy all queues.
+	for (uint32_t i = 0; i < as_event_loop_capacity; i++) {
+		as_queue_destroy(&node->async_conn_pools[i].queue);
+		as_queue_destroy(&node->pipe_conn_pools[i].queue);
+	}
+	cf_free(node->async_conn_pools);
+	cf_free(node->pipe_conn_pools);
+}
+
+#endif
@@ -91,7 +91,7 @@ as_uv_connection_closed(uv_handle_t* socket)
 		cf_free(tls->buf);
 		cf_free(tls);
 	}
-	cf_free(conn);
+	as_event_connection_free(conn);
 }
 
 void
@@ -119,27 +119,21 @@ as_uv_wakeup(uv_async_t* wakeup)
 	// Only process original size of queue.  Recursive pre-registration errors can
 	// result in new commands being added while the loop is in process.  If we process
 	// them, we could end up in an infinite loop.
-	pthread_mutex_lock(&event_loop->lock);
-	uint32_t size = as_queue_size(&event_loop->queue);
-	bool status = as_queue_pop(&event_loop->queue, &cmd);
-	pthread_mutex_unlock(&event_loop->lock);
+	uint32_t size = as_load_uint32(&event_loop->submit_size);
 
-	while (status) {
+	while (i < size && as_event_submit_pop(event_loop, &cmd)) {
 		if (! cmd.executable) {
 			// Received stop signal.
 			as_event_close_loop(event_loop);
 			return;
 		}
 		cmd.executable(event_loop, cmd.udata);
+		i++;
+	}
 
-		if (++i < size) {
-			pthread_mutex_lock(&event_loop->lock);
-			status = as_queue_pop(&event_loop->queue, &cmd);
-			pthread_mutex_unlock(&event_loop->lock);
-		}
-		else {
-			break;
-		}
+	if (as_event_submit_complete(event_loop, i)) {
+		// Commands were submitted while processing or are not published yet.
+		uv_async_send(event_loop->wakeup);
 	}
 }
 
@@ -234,12 +228,11 @@ bool
 as_event_execute(as_event_loop* event_loop, as_event_executable executable, void* udata)
 {
 	// Send command through queue so it can be executed in event loop thread.
-	pthread_mutex_lock(&event_loop->lock);
 	as_event_commander qcmd = {.executable = executable, .udata = udata};
-	bool queued = as_queue_push(&event_loop->queue, &qcmd);
-	pthread_mutex_unlock(&event_loop->lock);
+	bool wakeup;
+	bool queued = as_event_submit(event_loop, &qcmd, &wakeup);
 
-	if (queued) {
+	if (wakeup) {
 		uv_async_send(event_loop->wakeup);
 	}
 	return queued;
@@ -334,12 +327,7 @@ as_uv_command_read(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf)
 		}
 		
 		if (cmd->len > cmd->read_capacity) {
-			if (cmd->flags & AS_ASYNC_FLAGS_FREE_BUF) {
-				cf_free(cmd->buf);
-			}
-			cmd->buf = cf_malloc(size);
-			cmd->read_capacity = cmd->len;
-			cmd->flags |= AS_ASYNC_FLAGS_FREE_BUF;
+			as_event_command_buf_grow(cmd, size);
 		}
 		return;
 	}
@@ -1052,12 +1040,7 @@ as_uv_tls_read(as_event_command* cmd)
 				}
 
 				if (cmd->len > cmd->read_capacity) {
-					if (cmd->flags & AS_ASYNC_FLAGS_FREE_BUF) {
-						cf_free(cmd->buf);
-					}
-					cmd->buf = cf_malloc(size);
-					cmd->read_capacity = cmd->len;
-					cmd->flags |= AS_ASYNC_FLAGS_FREE_BUF;
+					as_event_command_buf_grow(cmd, size);
 				}
 				break;
 			}
@@ -1249,6 +1232,7 @@ as_uv_tls_init_connection(as_event_command* cmd, uv_stream_t* stream, as_tls_con
 	}
 
 	as_tls_set_context_name(tls->ssl, ctx, cmd->node->tls_name);
+	as_tls_set_session(tls->ssl, ctx, &cmd->node->tls_session);
 
 	int rv = BIO_new_bio_pair(&tls->ibio, 0, &tls->nbio, 0);
 
@@ -1473,18 +1457,13 @@ as_event_close_connection_cb(as_event_loop* event_loop, as_event_connection* con
 }
 
 static bool
-as_uv_queue_close_connections(as_node* node, as_async_conn_pool* pool, as_queue* cmd_queue)
+as_uv_queue_close_connections(as_node* node, as_async_conn_pool* pool, as_event_loop* event_loop)
 {
-	as_event_commander qcmd;
-	qcmd.executable = (as_event_executable)as_event_close_connection_cb;
-	
 	as_event_connection* conn;
 	
 	// Queue connection commands to event loops.
 	while (as_queue_pop(&pool->queue, &conn)) {
-		qcmd.udata = conn;
-		
-		if (! as_queue_push(cmd_queue, &qcmd)) {
+		if (! as_event_execute(event_loop, (as_event_executable)as_event_close_connection_cb, conn)) {
 			as_log_error("Failed to queue connection close");
 			return false;
 		}
@@ -1505,12 +1484,8 @@ as_event_node_destroy(as_node* node)
 	for (uint32_t i = 0; i < as_event_loop_size; i++) {
 		as_event_loop* event_loop = &as_event_loops[i];
 		
-		pthread_mutex_lock(&event_loop->lock);
-		as_uv_queue_close_connections(node, &node->async_conn_pools[i], &event_loop->queue);
-		as_uv_queue_close_connections(node, &node->pipe_conn_pools[i], &event_loop->queue);
-		pthread_mutex_unlock(&event_loop->lock);
-		
-		uv_async_send(event_loop->wakeup);
+		as_uv_queue_close_connections(node, &node->async_conn_pools[i], event_loop);
+		as_uv_queue_close_connections(node, &node->pipe_conn_pools[i], event_loop);
 	}
 		
 	// Destroy all queues.
@@ -114,6 +114,7 @@ as_info_command_node(
 	char** response
 	)
 {
+	uint64_t begin = cf_getns();
 	as_socket socket;
 	as_status status = as_node_get_connection(err, node, 0, deadline_ms, &socket);
 	
@@ -138,6 +139,7 @@ as_info_command_node(
 		return status;
 	}
 
+	as_node_add_latency(node, AS_LATENCY_TYPE_INFO, begin);
 	as_node_put_connection(node, &socket);
 	return status;
 }
@@ -17,6 +17,7 @@
 #include <aerospike/as_key.h>
 #include <aerospike/as_double.h>
 #include <aerospike/as_log_macros.h>
+#include <aerospike/as_ripemd160.h>
 #include <aerospike/as_string.h>
 #include <aerospike/as_bytes.h>
 
@@ -28,6 +29,78 @@
  * STATIC FUNCTIONS
  *****************************************************************************/
 
+/**
+ * Return size of key value as hashed by the digest (particle type + value bytes).
+ * Return zero if the key type is invalid.
+ */
+static inline size_t
+as_key_value_size(const as_val* val)
+{
+	switch (val->type) {
+		case AS_INTEGER:
+		case AS_DOUBLE:
+			return 9;
+
+		case AS_STRING:
+			return as_string_len((as_string*)val) + 1;
+
+		case AS_BYTES:
+			return ((as_bytes*)val)->size + 1;
+
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Write key value as hashed by the digest. Buffer must be at least as_key_value_size().
+ */
+static inline void
+as_key_value_write(const as_val* val, uint8_t* buf)
+{
+	switch (val->type) {
+		case AS_INTEGER: {
+			as_integer* v = as_integer_fromval(val);
+			buf[0] = AS_BYTES_INTEGER;
+			*(uint64_t*)&buf[1] = cf_swap_to_be64(v->value);
+			break;
+		}
+		case AS_DOUBLE: {
+			as_double* v = as_double_fromval(val);
+			buf[0] = AS_BYTES_DOUBLE;
+			*(double*)&buf[1] = cf_swap_to_big_float64(v->value);
+			break;
+		}
+		case AS_STRING: {
+			as_string* v = as_string_fromval(val);
+			buf[0] = AS_BYTES_STRING;
+			memcpy(&buf[1], v->value, as_string_len(v));
+			break;
+		}
+		case AS_BYTES: {
+			as_bytes* v = as_bytes_fromval(val);
+			// Note: v->type must be a blob type (AS_BYTES_BLOB, AS_BYTES_JAVA,
+			// AS_BYTES_PYTHON ...). Otherwise, the particle type will be reassigned to a
+			// non-blob which causes a mismatch between type and value.
+			buf[0] = v->type;
+			memcpy(&buf[1], v->value, v->size);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+static inline void
+as_key_digests_complete(as_ripemd160_input* inputs, as_key** keys, uint32_t n_keys)
+{
+	as_ripemd160_compute_many(inputs, n_keys);
+
+	for (uint32_t i = 0; i < n_keys; i++) {
+		keys[i]->digest.init = true;
+	}
+}
+
 static as_key*
 as_key_cons(
 	as_key* key, bool free, const as_namespace ns, const char* set, const as_key_value* valuep,
@@ -46,6 +119,7 @@ as_key_cons(
 
 	key->_free = free;
 	key->valuep = (as_key_value *) valuep;
+	key->ns_handle = 0;
 	
 	if (digest == NULL) {
 		key->digest.init = false;
@@ -244,55 +318,81 @@ as_key_set_digest(as_error* err, as_key* key)
 		return AEROSPIKE_OK;
 	}
 	
-	size_t set_len = strlen(key->set);
-	size_t size;
-	
 	as_val* val = (as_val*)key->valuep;
-	uint8_t* buf;
-	
-	switch (val->type) {
-		case AS_INTEGER: {
-			as_integer* v = as_integer_fromval(val);
-			size = 9;
-			buf = alloca(size);
-			buf[0] = AS_BYTES_INTEGER;
-			*(uint64_t*)&buf[1] = cf_swap_to_be64(v->value);
-			break;
-		}
-		case AS_DOUBLE: {
-			as_double* v = as_double_fromval(val);
-			size = 9;
-			buf = alloca(size);
-			buf[0] = AS_BYTES_DOUBLE;
-			*(double*)&buf[1] = cf_swap_to_big_float64(v->value);
-			break;
+	size_t size = as_key_value_size(val);
+
+	if (size == 0) {
+		return as_error_update(err, AEROSPIKE_ERR_PARAM, "Invalid key type: %d", val->type);
+	}
+
+	uint8_t* buf = alloca(size);
+	as_key_value_write(val, buf);
+
+	cf_digest_compute2(key->set, strlen(key->set), buf, size, (cf_digest*)key->digest.value);
+	key->digest.init = true;
+	return AEROSPIKE_OK;
+}
+
+as_status
+as_key_set_digests(as_error* err, as_key* keys, uint32_t n_keys)
+{
+	return as_key_set_digests_stride(err, keys, n_keys, sizeof(as_key));
+}
+
+as_status
+as_key_set_digests_stride(as_error* err, void* keys, uint32_t n_keys, size_t stride)
+{
+	as_ripemd160_input inputs[AS_RIPEMD160_LANES];
+	as_key* pending[AS_RIPEMD160_LANES];
+	uint8_t bufs[AS_RIPEMD160_LANES][AS_RIPEMD160_MAX_SIZE];
+	uint32_t n_pending = 0;
+	uint8_t* p = keys;
+
+	for (uint32_t i = 0; i < n_keys; i++, p += stride) {
+		as_key* key = (as_key*)p;
+
+		if (key->digest.init) {
+			continue;
 		}
-		case AS_STRING: {
-			as_string* v = as_string_fromval(val);
-			size_t len = as_string_len(v);
-			size = len + 1;
-			buf = alloca(size);
-			buf[0] = AS_BYTES_STRING;
-			memcpy(&buf[1], v->value, len);
-			break;
+
+		as_val* val = (as_val*)key->valuep;
+		size_t size = as_key_value_size(val);
+
+		if (size == 0) {
+			return as_error_update(err, AEROSPIKE_ERR_PARAM, "Invalid key type: %d", val->type);
 		}
-		case AS_BYTES: {
-			as_bytes* v = as_bytes_fromval(val);
-			size = v->size + 1;
-			buf = alloca(size);
-			// Note: v->type must be a blob type (AS_BYTES_BLOB, AS_BYTES_JAVA, AS_BYTES_PYTHON ...).
-			// Otherwise, the particle type will be reassigned to a non-blob which causes a
-			// mismatch between type and value.
-			buf[0] = v->type;
-			memcpy(&buf[1], v->value, v->size);
-			break;
+
+		size_t set_len = strlen(key->set);
+
+		if (set_len + size > AS_RIPEMD160_MAX_SIZE) {
+			// Key is too long for multi-buffer digest.
+			as_status status = as_key_set_digest(err, key);
+
+			if (status != AEROSPIKE_OK) {
+				return status;
+			}
+			continue;
 		}
-		default: {
-			return as_error_update(err, AEROSPIKE_ERR_PARAM, "Invalid key type: %d", val->type);
+
+		uint8_t* buf = bufs[n_pending];
+		as_key_value_write(val, buf);
+
+		as_ripemd160_input* in = &inputs[n_pending];
+		in->data1 = (uint8_t*)key->set;
+		in->len1 = set_len;
+		in->data2 = buf;
+		in->len2 = size;
+		in->digest = key->digest.value;
+		pending[n_pending++] = key;
+
+		if (n_pending == AS_RIPEMD160_LANES) {
+			as_key_digests_complete(inputs, pending, n_pending);
+			n_pending = 0;
 		}
 	}
-		
-	cf_digest_compute2(key->set, set_len, buf, size, (cf_digest*)key->digest.value);
-	key->digest.init = true;
+
+	if (n_pending > 0) {
+		as_key_digests_complete(inputs, pending, n_pending);
+	}
 	return AEROSPIKE_OK;
 }
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2008-2021 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <aerospike/as_latency.h>
+
+/******************************************************************************
+ * STATIC VARIABLES
+ *****************************************************************************/
+
+// These values must line up with as_latency_type enum.
+static const char* as_latency_type_names[] = {
+	"read", "write", "batch", "scan", "query", "udf", "info"
+};
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+uint64_t
+as_latency_count(const as_latency_buckets* latency)
+{
+	uint64_t count = 0;
+
+	for (uint32_t i = 0; i < AS_LATENCY_BUCKETS; i++) {
+		count += latency->buckets[i];
+	}
+	return count;
+}
+
+uint64_t
+as_latency_percentile(const as_latency_buckets* latency, double percentile)
+{
+	uint64_t count = as_latency_count(latency);
+
+	if (count == 0) {
+		return 0;
+	}
+
+	// Find first bucket where the running total covers the requested percentile.
+	double limit = (double)count * percentile / 100.0;
+	uint64_t sum = 0;
+
+	for (uint32_t i = 0; i < AS_LATENCY_BUCKETS; i++) {
+		sum += latency->buckets[i];
+
+		if ((double)sum >= limit && sum > 0) {
+			// Return bucket upper bound in microseconds.
+			return (uint64_t)1 << i;
+		}
+	}
+	return (uint64_t)1 << (AS_LATENCY_BUCKETS - 1);
+}
+
+const char*
+as_latency_type_string(as_latency_type type)
+{
+	if ((uint32_t)type >= AS_LATENCY_TYPE_MAX) {
+		return "unknown";
+	}
+	return as_latency_type_names[type];
+}
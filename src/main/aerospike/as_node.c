@@ -25,6 +25,7 @@
 #include <aerospike/as_log_macros.h>
 #include <aerospike/as_peers.h>
 #include <aerospike/as_queue.h>
+#include <aerospike/as_random.h>
 #include <aerospike/as_shm_cluster.h>
 #include <aerospike/as_socket.h>
 #include <aerospike/as_string.h>
@@ -34,6 +35,9 @@
 // Replicas take ~2K per namespace, so this will cover most deployments:
 #define INFO_STACK_BUF_SIZE (16 * 1024)
 
+// Minimum latency samples before a node's latency percentile is trusted as a hedge delay.
+#define AS_HEDGE_MIN_SAMPLES 100
+
 /******************************************************************************
  * Function declarations.
  *****************************************************************************/
@@ -115,6 +119,7 @@ as_node_create(as_cluster* cluster, as_node_info* node_info)
 
 	memcpy(&node->info_socket, &node_info->socket, sizeof(as_socket));
 	node->tls_name = node_info->host.tls_name ? cf_strdup(node_info->host.tls_name) : NULL;
+	as_tls_session_init(&node->tls_session);
 
 	if (node->info_socket.ssl) {
 		// Required to keep as_socket tls_name in scope.
@@ -136,7 +141,13 @@ as_node_create(as_cluster* cluster, as_node_info* node_info)
 	node->sync_conns_opened = 1;
 	node->sync_conns_closed = 0;
 	node->error_count = 0;
+	node->concurrency = 0;
+	node->concurrency_limit = cluster->max_concurrency;
+	node->concurrency_successes = 0;
+	node->concurrency_rejected = 0;
+	node->concurrency_decreased = 0;
 	node->conn_iter = 0;
+	memset(node->latency, 0, sizeof(node->latency));
 
 	uint32_t min = cluster->min_conns_per_node / cluster->conn_pools_per_node;
 	uint32_t rem_min = cluster->min_conns_per_node - (min * cluster->conn_pools_per_node);
@@ -147,7 +158,7 @@ as_node_create(as_cluster* cluster, as_node_info* node_info)
 		as_conn_pool* pool = &node->sync_conn_pools[i];
 		uint32_t min_size = i < rem_min ? min + 1 : min;
 		uint32_t max_size = i < rem_max ? max + 1 : max;
-		as_conn_pool_init(pool, sizeof(as_socket), min_size, max_size);
+		as_conn_pool_init(pool, sizeof(as_socket), min_size, max_size, cluster->conn_pools_lock_free);
 	}
 
 	if (as_event_loop_capacity == 0) {
@@ -193,6 +204,7 @@ as_node_destroy(as_node* node)
 	if (node->tls_name) {
 		cf_free(node->tls_name);
 	}
+	as_tls_session_destroy(&node->tls_session);
 
 	as_session* session = (as_session*)as_load_ptr(&node->session);
 
@@ -348,6 +360,10 @@ as_node_try_family_connections(as_node* node, int family, int begin, int end, in
 	if (rv < 0) {
 		return rv;
 	}
+
+	if (ctx) {
+		as_tls_set_session(sock->ssl, ctx, &node->tls_session);
+	}
 	
 	// Try addresses.
 	as_address* addresses = node->addresses;
@@ -522,6 +538,12 @@ as_node_get_connection(as_error* err, as_node* node, uint32_t socket_timeout, ui
 		initial_index = 0;
 		backward = false;
 	}
+	else if (cluster->conn_pools_lock_free) {
+		// Avoid shared iterator cache line contention by starting at a thread local
+		// random pool.
+		initial_index = as_random_get_uint32() % max;
+		backward = true;
+	}
 	else {
 		uint32_t iter = node->conn_iter++; // not atomic by design
 		initial_index = iter % max;
@@ -584,7 +606,7 @@ as_node_get_connection(as_error* err, as_node* node, uint32_t socket_timeout, ui
 			else if (++pool_index >= max) {
 				break;
 			}
-			pool = &pool[pool_index];
+			pool = &pools[pool_index];
 		}
 	}
 	// All queues full.
@@ -959,72 +981,6 @@ as_node_process_response(as_cluster* cluster, as_error* err, as_node* node, as_v
 	return AEROSPIKE_OK;
 }
 
-/**
- * Request current status from server node.
- */
-as_status
-as_node_refresh(as_cluster* cluster, as_error* err, as_node* node, as_peers* peers)
-{
-	as_status status = as_node_get_tend_connection(err, node);
-	
-	if (status != AEROSPIKE_OK) {
-		return status;
-	}
-
-	// Set new deadline because login may have occurred which can take a long time.
-	uint64_t deadline_ms = as_socket_deadline(cluster->conn_timeout_ms);
-
-	const char* command;
-	size_t command_len;
-	
-	if (cluster->rack_aware) {
-		command = INFO_STR_CHECK_RACK;
-		command_len = sizeof(INFO_STR_CHECK_RACK) - 1;
-	}
-	else {
-		command = INFO_STR_CHECK_PEERS;
-		command_len = sizeof(INFO_STR_CHECK_PEERS) - 1;
-	}
-
-	uint8_t stack_buf[INFO_STACK_BUF_SIZE];
-	uint8_t* buf = as_node_get_info(err, node, command, command_len, deadline_ms, stack_buf);
-	
-	if (! buf) {
-		as_node_close_socket(node, &node->info_socket);
-		return err->code;
-	}
-	
-	as_vector values;
-	as_vector_inita(&values, sizeof(as_name_value), 4);
-	
-	as_info_parse_multi_response((char*)buf, &values);
-
-	status = as_node_process_response(cluster, err, node, &values, peers);
-
-	if (status == AEROSPIKE_ERR_CLIENT) {
-		as_node_close_socket(node, &node->info_socket);
-	}
-		
-	if (buf != stack_buf) {
-		cf_free(buf);
-	}
-
-	as_vector_destroy(&values);
-
-	if (status == AEROSPIKE_OK) {
-		peers->refresh_count++;
-
-		// Reload peers, partitions and racks if there were failures on previous tend.
-		if (node->failures > 0) {
-			peers->gen_changed = true;
-			node->partition_changed = true;
-			node->rebalance_changed = cluster->rack_aware;
-		}
-		node->failures = 0;
-	}
-	return status;
-}
-
 static const char INFO_STR_PEERS_TLS_ALT[] = "peers-tls-alt\n";
 static const char INFO_STR_PEERS_TLS_STD[] = "peers-tls-std\n";
 static const char INFO_STR_PEERS_CLEAR_ALT[] = "peers-clear-alt\n";
@@ -1054,62 +1010,6 @@ as_node_process_peers(as_cluster* cluster, as_error* err, as_node* node, as_vect
 	return AEROSPIKE_OK;
 }
 
-as_status
-as_node_refresh_peers(as_cluster* cluster, as_error* err, as_node* node, as_peers* peers)
-{
-	as_log_debug("Update peers for node %s", as_node_get_address_string(node));
-
-	uint64_t deadline_ms = as_socket_deadline(cluster->conn_timeout_ms);
-	const char* command;
-	size_t command_len;
-
-	if (cluster->tls_ctx) {
-		if (cluster->use_services_alternate) {
-			command = INFO_STR_PEERS_TLS_ALT;
-			command_len = sizeof(INFO_STR_PEERS_TLS_ALT) - 1;
-		}
-		else {
-			command = INFO_STR_PEERS_TLS_STD;
-			command_len = sizeof(INFO_STR_PEERS_TLS_STD) - 1;
-		}
-	}
-	else {
-		if (cluster->use_services_alternate) {
-			command = INFO_STR_PEERS_CLEAR_ALT;
-			command_len = sizeof(INFO_STR_PEERS_CLEAR_ALT) - 1;
-		}
-		else {
-			command = INFO_STR_PEERS_CLEAR_STD;
-			command_len = sizeof(INFO_STR_PEERS_CLEAR_STD) - 1;
-		}
-	}
-	
-	uint8_t stack_buf[INFO_STACK_BUF_SIZE];
-	uint8_t* buf = as_node_get_info(err, node, command, command_len, deadline_ms, stack_buf);
-	
-	if (! buf) {
-		as_node_close_socket(node, &node->info_socket);
-		return err->code;
-	}
-	
-	as_vector values;
-	as_vector_inita(&values, sizeof(as_name_value), 4);
-	
-	as_info_parse_multi_response((char*)buf, &values);
-	as_status status = as_node_process_peers(cluster, err, node, &values, peers);
-	
-	if (buf != stack_buf) {
-		cf_free(buf);
-	}
-	
-	as_vector_destroy(&values);
-
-	if (status == AEROSPIKE_OK) {
-		peers->refresh_count++;
-	}
-	return status;
-}
-
 static const char INFO_STR_GET_REPLICAS_REGIME[] = "partition-generation\nreplicas\n";
 
 static as_status
@@ -1134,37 +1034,6 @@ as_node_process_partitions(as_cluster* cluster, as_error* err, as_node* node, as
 	return AEROSPIKE_OK;
 }
 
-as_status
-as_node_refresh_partitions(as_cluster* cluster, as_error* err, as_node* node, as_peers* peers)
-{
-	as_log_debug("Update partition map for node %s", as_node_get_address_string(node));
-
-	uint64_t deadline_ms = as_socket_deadline(cluster->conn_timeout_ms);
-	const char* command = INFO_STR_GET_REPLICAS_REGIME;
-	size_t command_len = sizeof(INFO_STR_GET_REPLICAS_REGIME) - 1;
-
-	uint8_t stack_buf[INFO_STACK_BUF_SIZE];
-	uint8_t* buf = as_node_get_info(err, node, command, command_len, deadline_ms, stack_buf);
-
-	if (! buf) {
-		as_node_close_socket(node, &node->info_socket);
-		return err->code;
-	}
-
-	as_vector values;
-	as_vector_inita(&values, sizeof(as_name_value), 4);
-
-	as_info_parse_multi_response((char*)buf, &values);
-	as_status status = as_node_process_partitions(cluster, err, node, &values);
-
-	if (buf != stack_buf) {
-		cf_free(buf);
-	}
-
-	as_vector_destroy(&values);
-	return status;
-}
-
 /**
  * Use non-inline function for garbarge collector function pointer reference.
  * Forward to inlined release.
@@ -1312,31 +1181,291 @@ as_node_process_racks(as_cluster* cluster, as_error* err, as_node* node, as_vect
 
 static const char INFO_STR_GET_RACKS[] = "rebalance-generation\nrack-ids\n";
 
-as_status
-as_node_refresh_racks(as_cluster* cluster, as_error* err, as_node* node)
+static void
+as_node_tend_command(
+	as_cluster* cluster, as_node_tend_type type, const char** command, size_t* command_len
+	)
+{
+	switch (type) {
+		case AS_NODE_TEND_REFRESH:
+			if (cluster->rack_aware) {
+				*command = INFO_STR_CHECK_RACK;
+				*command_len = sizeof(INFO_STR_CHECK_RACK) - 1;
+			}
+			else {
+				*command = INFO_STR_CHECK_PEERS;
+				*command_len = sizeof(INFO_STR_CHECK_PEERS) - 1;
+			}
+			break;
+
+		case AS_NODE_TEND_PEERS:
+			if (cluster->tls_ctx) {
+				if (cluster->use_services_alternate) {
+					*command = INFO_STR_PEERS_TLS_ALT;
+					*command_len = sizeof(INFO_STR_PEERS_TLS_ALT) - 1;
+				}
+				else {
+					*command = INFO_STR_PEERS_TLS_STD;
+					*command_len = sizeof(INFO_STR_PEERS_TLS_STD) - 1;
+				}
+			}
+			else {
+				if (cluster->use_services_alternate) {
+					*command = INFO_STR_PEERS_CLEAR_ALT;
+					*command_len = sizeof(INFO_STR_PEERS_CLEAR_ALT) - 1;
+				}
+				else {
+					*command = INFO_STR_PEERS_CLEAR_STD;
+					*command_len = sizeof(INFO_STR_PEERS_CLEAR_STD) - 1;
+				}
+			}
+			break;
+
+		case AS_NODE_TEND_PARTITIONS:
+			*command = INFO_STR_GET_REPLICAS_REGIME;
+			*command_len = sizeof(INFO_STR_GET_REPLICAS_REGIME) - 1;
+			break;
+
+		case AS_NODE_TEND_RACKS:
+			*command = INFO_STR_GET_RACKS;
+			*command_len = sizeof(INFO_STR_GET_RACKS) - 1;
+			break;
+	}
+}
+
+void
+as_node_tend_request_init(as_node_tend_request* req, as_node* node, as_node_tend_type type)
+{
+	req->node = node;
+	req->response = NULL;
+	as_error_init(&req->err);
+	req->status = AEROSPIKE_OK;
+	req->type = type;
+}
+
+/**
+ * Send info request on the node's tend connection and read the response.  Only the
+ * node's own socket is accessed, so requests for different nodes can run in parallel.
+ */
+void
+as_node_tend_fetch(as_node_tend_request* req)
 {
-	as_log_debug("Update racks for node %s", as_node_get_address_string(node));
+	as_node* node = req->node;
+	as_cluster* cluster = node->cluster;
+
+	switch (req->type) {
+		case AS_NODE_TEND_REFRESH:
+			req->status = as_node_get_tend_connection(&req->err, node);
+
+			if (req->status != AEROSPIKE_OK) {
+				return;
+			}
+			break;
+
+		case AS_NODE_TEND_PEERS:
+			as_log_debug("Update peers for node %s", as_node_get_address_string(node));
+			break;
 
+		case AS_NODE_TEND_PARTITIONS:
+			as_log_debug("Update partition map for node %s", as_node_get_address_string(node));
+			break;
+
+		case AS_NODE_TEND_RACKS:
+			as_log_debug("Update racks for node %s", as_node_get_address_string(node));
+			break;
+	}
+
+	// Set new deadline because login may have occurred which can take a long time.
 	uint64_t deadline_ms = as_socket_deadline(cluster->conn_timeout_ms);
 
+	const char* command;
+	size_t command_len;
+	as_node_tend_command(cluster, req->type, &command, &command_len);
+
 	uint8_t stack_buf[INFO_STACK_BUF_SIZE];
-	uint8_t* buf = as_node_get_info(err, node, INFO_STR_GET_RACKS, sizeof(INFO_STR_GET_RACKS) - 1, deadline_ms, stack_buf);
+	uint8_t* buf = as_node_get_info(&req->err, node, command, command_len, deadline_ms, stack_buf);
 
 	if (! buf) {
 		as_node_close_socket(node, &node->info_socket);
-		return err->code;
+		req->status = req->err.code;
+		return;
+	}
+
+	if (buf == stack_buf) {
+		// Response must outlive this call because it is processed later on the tend thread.
+		req->response = cf_strdup((char*)buf);
+	}
+	else {
+		req->response = (char*)buf;
+	}
+}
+
+/**
+ * Process info response on the tend thread.
+ */
+as_status
+as_node_tend_process(
+	as_cluster* cluster, as_error* err, as_node_tend_request* req, as_peers* peers
+	)
+{
+	as_node* node = req->node;
+
+	if (req->status != AEROSPIKE_OK) {
+		as_error_copy(err, &req->err);
+		return req->status;
 	}
 
 	as_vector values;
 	as_vector_inita(&values, sizeof(as_name_value), 4);
 
-	as_info_parse_multi_response((char*)buf, &values);
-	as_status status = as_node_process_racks(cluster, err, node, &values);
+	as_info_parse_multi_response(req->response, &values);
+
+	as_status status;
+
+	switch (req->type) {
+		default:
+		case AS_NODE_TEND_REFRESH:
+			status = as_node_process_response(cluster, err, node, &values, peers);
 
-	if (buf != stack_buf) {
-		cf_free(buf);
+			if (status == AEROSPIKE_ERR_CLIENT) {
+				as_node_close_socket(node, &node->info_socket);
+			}
+			break;
+
+		case AS_NODE_TEND_PEERS:
+			status = as_node_process_peers(cluster, err, node, &values, peers);
+			break;
+
+		case AS_NODE_TEND_PARTITIONS:
+			status = as_node_process_partitions(cluster, err, node, &values);
+			break;
+
+		case AS_NODE_TEND_RACKS:
+			status = as_node_process_racks(cluster, err, node, &values);
+			break;
 	}
 
+	cf_free(req->response);
+	req->response = NULL;
 	as_vector_destroy(&values);
-	return status;
+
+	if (status != AEROSPIKE_OK) {
+		return status;
+	}
+
+	if (req->type == AS_NODE_TEND_REFRESH) {
+		peers->refresh_count++;
+
+		// Reload peers, partitions and racks if there were failures on previous tend.
+		if (node->failures > 0) {
+			peers->gen_changed = true;
+			node->partition_changed = true;
+			node->rebalance_changed = cluster->rack_aware;
+		}
+		node->failures = 0;
+	}
+	else if (req->type == AS_NODE_TEND_PEERS) {
+		peers->refresh_count++;
+	}
+	return AEROSPIKE_OK;
+}
+
+static as_status
+as_node_tend_execute(
+	as_cluster* cluster, as_error* err, as_node* node, as_node_tend_type type, as_peers* peers
+	)
+{
+	as_node_tend_request req;
+	as_node_tend_request_init(&req, node, type);
+	as_node_tend_fetch(&req);
+	return as_node_tend_process(cluster, err, &req, peers);
+}
+
+/**
+ * Request current status from server node.
+ */
+as_status
+as_node_refresh(as_cluster* cluster, as_error* err, as_node* node, as_peers* peers)
+{
+	return as_node_tend_execute(cluster, err, node, AS_NODE_TEND_REFRESH, peers);
+}
+
+as_status
+as_node_refresh_peers(as_cluster* cluster, as_error* err, as_node* node, as_peers* peers)
+{
+	return as_node_tend_execute(cluster, err, node, AS_NODE_TEND_PEERS, peers);
+}
+
+as_status
+as_node_refresh_partitions(as_cluster* cluster, as_error* err, as_node* node, as_peers* peers)
+{
+	return as_node_tend_execute(cluster, err, node, AS_NODE_TEND_PARTITIONS, peers);
+}
+
+as_status
+as_node_refresh_racks(as_cluster* cluster, as_error* err, as_node* node)
+{
+	return as_node_tend_execute(cluster, err, node, AS_NODE_TEND_RACKS, NULL);
+}
+
+void
+as_node_concurrency_update(as_node* node, uint64_t begin_ns, bool overload)
+{
+	as_cluster* cluster = node->cluster;
+	as_decr_uint32(&node->concurrency);
+
+	uint64_t now = cf_getns();
+
+	if (! overload && now - begin_ns <= cluster->concurrency_latency_ns) {
+		// Additive increase. Grow limit by one after a full limit of fast commands.
+		uint32_t limit = as_load_uint32(&node->concurrency_limit);
+
+		if (limit < cluster->max_concurrency &&
+			as_aaf_uint32(&node->concurrency_successes, 1) >= limit) {
+			as_store_uint32(&node->concurrency_successes, 0);
+			as_cas_uint32(&node->concurrency_limit, limit, limit + 1);
+		}
+		return;
+	}
+
+	// Multiplicative decrease. Decrease at most once per latency threshold, so the many slow
+	// responses caused by one overload event do not collapse the limit.
+	uint64_t last = as_load_uint64(&node->concurrency_decreased);
+
+	if (now - last < cluster->concurrency_latency_ns ||
+		! as_cas_uint64(&node->concurrency_decreased, last, now)) {
+		return;
+	}
+
+	uint32_t limit = as_load_uint32(&node->concurrency_limit);
+	uint32_t new_limit = limit - limit / 4;
+
+	if (new_limit < cluster->min_concurrency) {
+		new_limit = cluster->min_concurrency;
+	}
+	as_store_uint32(&node->concurrency_limit, new_limit);
+	as_store_uint32(&node->concurrency_successes, 0);
+}
+
+uint32_t
+as_node_hedge_delay(as_node* node, uint32_t hedge_delay, double hedge_percentile)
+{
+	if (hedge_percentile <= 0.0) {
+		return hedge_delay;
+	}
+
+	as_latency_buckets* latency = &node->latency[AS_LATENCY_TYPE_READ];
+
+	if (as_latency_count(latency) < AS_HEDGE_MIN_SAMPLES) {
+		return hedge_delay;
+	}
+
+	// Round bucket upper bound up to whole milliseconds.
+	uint64_t us = as_latency_percentile(latency, hedge_percentile);
+	uint32_t delay = (uint32_t)((us + 999) / 1000);
+
+	if (hedge_delay > 0 && delay > hedge_delay) {
+		return hedge_delay;
+	}
+	return delay;
 }
@@ -0,0 +1,254 @@
+/*
+ * Copyright 2008-2021 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <aerospike/as_parse_pool.h>
+#include <citrusleaf/alloc.h>
+#include <string.h>
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+static void*
+as_parse_worker(void* data)
+{
+	as_parse_queue* q = data;
+	as_parse_pool* pool = q->pool;
+	as_parse_block block;
+	as_error err;
+
+	pthread_mutex_lock(&pool->lock);
+
+	while (true) {
+		while (q->size == 0 && ! pool->closing) {
+			pthread_cond_wait(&q->not_empty, &pool->lock);
+		}
+
+		if (q->size == 0) {
+			break;
+		}
+
+		block = q->blocks[q->head];
+		q->head = (q->head + 1) % pool->capacity;
+		q->size--;
+		pthread_cond_broadcast(&pool->not_full);
+
+		as_parse_stream* stream = block.stream;
+
+		// Skip remaining blocks once the stream has failed.
+		bool valid = stream->status == AEROSPIKE_OK;
+		pthread_mutex_unlock(&pool->lock);
+
+		as_status status = AEROSPIKE_OK;
+
+		if (valid) {
+			as_error_init(&err);
+			status = pool->fn(&err, block.buf, block.size, stream->udata);
+		}
+		cf_free(block.buf);
+
+		pthread_mutex_lock(&pool->lock);
+
+		if (status != AEROSPIKE_OK && stream->status == AEROSPIKE_OK) {
+			stream->status = status;
+			as_error_copy(&stream->err, &err);
+
+			// Wake reader if it is waiting for room, so it can stop reading.
+			pthread_cond_broadcast(&pool->not_full);
+		}
+
+		if (--stream->pending == 0) {
+			pthread_cond_broadcast(&pool->drained);
+		}
+	}
+	pthread_mutex_unlock(&pool->lock);
+	return NULL;
+}
+
+static void
+as_parse_pool_close(as_parse_pool* pool, uint32_t n_started)
+{
+	pthread_mutex_lock(&pool->lock);
+	pool->closing = true;
+
+	for (uint32_t i = 0; i < n_started; i++) {
+		pthread_cond_signal(&pool->queues[i].not_empty);
+	}
+	pthread_mutex_unlock(&pool->lock);
+
+	for (uint32_t i = 0; i < n_started; i++) {
+		pthread_join(pool->queues[i].thread, NULL);
+	}
+
+	for (uint32_t i = 0; i < pool->n_threads; i++) {
+		as_parse_queue* q = &pool->queues[i];
+
+		// Streams are drained before close, so queues should already be empty.
+		while (q->size > 0) {
+			cf_free(q->blocks[q->head].buf);
+			q->head = (q->head + 1) % pool->capacity;
+			q->size--;
+		}
+		pthread_cond_destroy(&q->not_empty);
+		cf_free(q->blocks);
+	}
+	cf_free(pool->queues);
+	pthread_cond_destroy(&pool->drained);
+	pthread_cond_destroy(&pool->not_full);
+	pthread_mutex_destroy(&pool->lock);
+}
+
+static inline as_parse_queue*
+as_parse_pool_least_busy(as_parse_pool* pool)
+{
+	as_parse_queue* min = &pool->queues[0];
+
+	for (uint32_t i = 1; i < pool->n_threads && min->size > 0; i++) {
+		as_parse_queue* q = &pool->queues[i];
+
+		if (q->size < min->size) {
+			min = q;
+		}
+	}
+	return min;
+}
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+as_status
+as_parse_pool_init(
+	as_parse_pool* pool, as_error* err, uint32_t n_threads, uint32_t capacity, bool ordered,
+	as_parse_pool_fn fn
+	)
+{
+	if (capacity == 0) {
+		capacity = 1;
+	}
+
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->not_full, NULL);
+	pthread_cond_init(&pool->drained, NULL);
+	pool->queues = cf_malloc(sizeof(as_parse_queue) * n_threads);
+	pool->fn = fn;
+	pool->n_threads = n_threads;
+	pool->capacity = capacity;
+	pool->next = 0;
+	pool->ordered = ordered;
+	pool->closing = false;
+
+	for (uint32_t i = 0; i < n_threads; i++) {
+		as_parse_queue* q = &pool->queues[i];
+		q->pool = pool;
+		q->blocks = cf_malloc(sizeof(as_parse_block) * capacity);
+		pthread_cond_init(&q->not_empty, NULL);
+		q->head = 0;
+		q->size = 0;
+	}
+
+	for (uint32_t i = 0; i < n_threads; i++) {
+		as_parse_queue* q = &pool->queues[i];
+		int rc = pthread_create(&q->thread, NULL, as_parse_worker, q);
+
+		if (rc != 0) {
+			as_parse_pool_close(pool, i);
+			return as_error_update(err, AEROSPIKE_ERR_CLIENT, "Failed to create parse thread: %d", rc);
+		}
+	}
+	return AEROSPIKE_OK;
+}
+
+void
+as_parse_pool_destroy(as_parse_pool* pool)
+{
+	as_parse_pool_close(pool, pool->n_threads);
+}
+
+void
+as_parse_stream_init(as_parse_pool* pool, as_parse_stream* stream, void* udata)
+{
+	stream->pool = pool;
+	stream->udata = udata;
+	as_error_init(&stream->err);
+	stream->status = AEROSPIKE_OK;
+	stream->pending = 0;
+	stream->ordered = pool->ordered;
+
+	pthread_mutex_lock(&pool->lock);
+	stream->queue = pool->next++ % pool->n_threads;
+	pthread_mutex_unlock(&pool->lock);
+}
+
+as_status
+as_parse_stream_push(as_parse_stream* stream, as_error* err, uint8_t* buf, size_t size)
+{
+	// Copy block because the socket reader reuses its buffer for the next block.
+	uint8_t* copy = cf_malloc(size);
+	memcpy(copy, buf, size);
+
+	as_parse_pool* pool = stream->pool;
+	as_parse_queue* q;
+
+	pthread_mutex_lock(&pool->lock);
+
+	while (true) {
+		if (stream->status != AEROSPIKE_OK) {
+			as_status status = stream->status;
+			as_error_copy(err, &stream->err);
+			pthread_mutex_unlock(&pool->lock);
+			cf_free(copy);
+			return status;
+		}
+
+		q = stream->ordered ? &pool->queues[stream->queue] : as_parse_pool_least_busy(pool);
+
+		if (q->size < pool->capacity) {
+			break;
+		}
+		pthread_cond_wait(&pool->not_full, &pool->lock);
+	}
+
+	as_parse_block* block = &q->blocks[(q->head + q->size) % pool->capacity];
+	block->stream = stream;
+	block->buf = copy;
+	block->size = size;
+	q->size++;
+	stream->pending++;
+	pthread_cond_signal(&q->not_empty);
+	pthread_mutex_unlock(&pool->lock);
+	return AEROSPIKE_OK;
+}
+
+as_status
+as_parse_stream_drain(as_parse_stream* stream, as_error* err)
+{
+	as_parse_pool* pool = stream->pool;
+
+	pthread_mutex_lock(&pool->lock);
+
+	while (stream->pending > 0) {
+		pthread_cond_wait(&pool->drained, &pool->lock);
+	}
+
+	as_status status = stream->status;
+
+	if (status != AEROSPIKE_OK) {
+		as_error_copy(err, &stream->err);
+	}
+	pthread_mutex_unlock(&pool->lock);
+	return status;
+}
@@ -37,8 +37,8 @@ as_partition_table_print(as_partition_table* table)
 	for (uint32_t i = 0; i < table->size; i++) {
 		as_partition* p = &table->partitions[i];
 		
-		if (p->master) {
-			printf("%u %s\n", i, p->master->name);
+		if (p->nodes[0]) {
+			printf("%u %s\n", i, p->nodes[0]->name);
 		}
 		else {
 			printf("%u null\n", i);
@@ -131,13 +131,11 @@ as_partition_table_destroy(as_partition_table* table)
 {
 	for (uint32_t i = 0; i < table->size; i++) {
 		as_partition* p = &table->partitions[i];
-		
-		if (p->master) {
-			as_partition_release_node_now(p->master);
-		}
-		
-		if (p->prole) {
-			as_partition_release_node_now(p->prole);
+
+		for (uint32_t j = 0; j < AS_MAX_REPLICAS; j++) {
+			if (p->nodes[j]) {
+				as_partition_release_node_now(p->nodes[j]);
+			}
 		}
 	}
 	cf_free(table);
@@ -164,61 +162,52 @@ try_master(as_cluster* cluster, as_node* node)
 	return NULL;
 }
 
-static inline as_node*
-try_node(as_cluster* cluster, as_node* node)
+static inline uint32_t
+load_nodes(as_partition* p, uint32_t replica_index, as_node** nodes)
 {
 	// Make volatile reference so changes to tend thread will be reflected in this thread.
-	if (node && as_load_uint8(&node->active)) {
-		return node;
+	as_node* all[AS_MAX_REPLICAS];
+	uint32_t n = 0;
+
+	for (uint32_t i = 0; i < AS_MAX_REPLICAS; i++) {
+		as_node* node = (as_node*)as_load_ptr(&p->nodes[i]);
+
+		if (node) {
+			all[n++] = node;
+		}
 	}
-	return NULL;
-}
 
-static as_node*
-try_node_alternate(as_cluster* cluster, as_node* chosen, as_node* alternate)
-{
-	// Make volatile reference so changes to tend thread will be reflected in this thread.
-	if (as_load_uint8(&chosen->active)) {
-		return chosen;
+	// Rotate so the replica at replica_index is tried first.
+	for (uint32_t i = 0; i < n; i++) {
+		nodes[i] = all[(replica_index + i) % n];
 	}
-	return try_node(cluster, alternate);
+	return n;
 }
 
 static as_node*
-get_sequence_node(as_cluster* cluster, as_partition* p, bool use_master)
+get_sequence_node(as_cluster* cluster, as_partition* p, uint32_t replica_index)
 {
-	as_node* master = (as_node*)as_load_ptr(&p->master);
-	as_node* prole = (as_node*)as_load_ptr(&p->prole);
+	as_node* nodes[AS_MAX_REPLICAS];
+	uint32_t n = load_nodes(p, replica_index, nodes);
 
-	if (! prole) {
-		return try_node(cluster, master);
-	}
+	for (uint32_t i = 0; i < n; i++) {
+		as_node* node = nodes[i];
 
-	if (! master) {
-		return try_node(cluster, prole);
-	}
-	
-	if (use_master) {
-		return try_node_alternate(cluster, master, prole);
+		if (as_load_uint8(&node->active)) {
+			return node;
+		}
 	}
-	return try_node_alternate(cluster, prole, master);
+	return NULL;
 }
 
 static as_node*
 prefer_rack_node(
-	as_cluster* cluster, const char* ns, as_partition* p, as_node* prev_node, bool use_master
+	as_cluster* cluster, const char* ns, as_partition* p, as_node* prev_node,
+	uint32_t replica_index
 	)
 {
-	as_node* nodes[2];
-
-	if (use_master) {
-		nodes[0] = (as_node*)as_load_ptr(&p->master);
-		nodes[1] = (as_node*)as_load_ptr(&p->prole);
-	}
-	else {
-		nodes[0] = (as_node*)as_load_ptr(&p->prole);
-		nodes[1] = (as_node*)as_load_ptr(&p->master);
-	}
+	as_node* nodes[AS_MAX_REPLICAS];
+	uint32_t n = load_nodes(p, replica_index, nodes);
 
 	as_node* fallback1 = NULL;
 	as_node* fallback2 = NULL;
@@ -227,30 +216,28 @@ prefer_rack_node(
 	for (uint32_t i = 0; i < max; i++) {
 		int rack_id = cluster->rack_ids[i];
 
-		for (uint32_t j = 0; j < 2; j++) {
+		for (uint32_t j = 0; j < n; j++) {
 			as_node* node = nodes[j];
 
-			if (node) {
-				// Avoid retrying on node where command failed even if node is the
-				// only one on the same rack. The contents of prev_node may have
-				// already been destroyed, so just use pointer comparison and never
-				// examine the contents of prev_node!
-				if (node != prev_node) {
-					if (as_node_has_rack(node, ns, rack_id)) {
-						if (as_load_uint8(&node->active)) {
-							return node;
-						}
-					}
-					else if (!fallback1 && as_load_uint8(&node->active)) {
-						// Meets all criteria except not on same rack.
-						fallback1 = node;
+			// Avoid retrying on node where command failed even if node is the
+			// only one on the same rack. The contents of prev_node may have
+			// already been destroyed, so just use pointer comparison and never
+			// examine the contents of prev_node!
+			if (node != prev_node) {
+				if (as_node_has_rack(node, ns, rack_id)) {
+					if (as_load_uint8(&node->active)) {
+						return node;
 					}
 				}
-				else if (!fallback2 && as_load_uint8(&node->active)) {
-					// Previous node is the least desirable fallback.
-					fallback2 = node;
+				else if (!fallback1 && as_load_uint8(&node->active)) {
+					// Meets all criteria except not on same rack.
+					fallback1 = node;
 				}
 			}
+			else if (!fallback2 && as_load_uint8(&node->active)) {
+				// Previous node is the least desirable fallback.
+				fallback2 = node;
+			}
 		}
 	}
 
@@ -271,40 +258,76 @@ static uint32_t g_randomizer = 0;
 as_node*
 as_partition_reg_get_node(
 	as_cluster* cluster, const char* ns, as_partition* p, as_node* prev_node,
-	as_policy_replica replica, bool use_master
+	as_policy_replica replica, uint8_t replica_index
 	)
 {
 	switch (replica) {
 		case AS_POLICY_REPLICA_MASTER: {
 			// Make volatile reference so changes to tend thread will be reflected in this thread.
-			as_node* master = (as_node*)as_load_ptr(&p->master);
+			as_node* master = (as_node*)as_load_ptr(&p->nodes[0]);
 			return try_master(cluster, master);
 		}
 
 		case AS_POLICY_REPLICA_ANY: {
-			// Alternate between master and prole for reads with global iterator.
+			// Distribute reads across all replicas with global iterator.
 			uint32_t r = as_faa_uint32(&g_randomizer, 1);
-			use_master = (r & 1);
-			return get_sequence_node(cluster, p, use_master);
+			return get_sequence_node(cluster, p, r);
 		}
 
 		default:
 		case AS_POLICY_REPLICA_SEQUENCE: {
-			return get_sequence_node(cluster, p, use_master);
+			return get_sequence_node(cluster, p, replica_index);
 		}
 
 		case AS_POLICY_REPLICA_PREFER_RACK: {
-			return prefer_rack_node(cluster, ns, p, prev_node, use_master);
+			return prefer_rack_node(cluster, ns, p, prev_node, replica_index);
 		}
 	}
 }
 
+static inline as_partition_table_shm*
+as_partition_shm_table_by_key(as_cluster_shm* cluster_shm, const as_key* key)
+{
+	// Tables are only appended, so a resolved index stays valid. Verify the table namespace
+	// because the handle may have been resolved on another aerospike instance or shared
+	// memory segment, or the key namespace may have changed since. Fall back to name lookup
+	// when the handle is not set, out of range or does not match.
+	uint32_t index = key->ns_handle - 1;
+
+	if (index < as_load_uint32(&cluster_shm->partition_tables_size)) {
+		as_partition_table_shm* table = as_shm_get_partition_table(cluster_shm,
+			as_shm_get_partition_tables(cluster_shm), index);
+
+		if (strcmp(table->ns, key->ns) == 0) {
+			return table;
+		}
+	}
+	return as_shm_find_partition_table(cluster_shm, key->ns);
+}
+
+static inline as_partition_table*
+as_partition_table_by_key(as_partition_tables* tables, const as_key* key)
+{
+	// Tables are only appended, so a resolved index stays valid. Verify the table namespace
+	// in case the handle belongs to another aerospike instance or the key namespace changed.
+	uint32_t index = key->ns_handle - 1;
+
+	if (index < as_load_uint32(&tables->size)) {
+		as_partition_table* table = tables->tables[index];
+
+		if (strcmp(table->ns, key->ns) == 0) {
+			return table;
+		}
+	}
+	return as_partition_tables_get(tables, key->ns);
+}
+
 as_status
 as_partition_info_init(as_partition_info* pi, as_cluster* cluster, as_error* err, const as_key* key)
 {
 	if (cluster->shm_info) {
 		as_cluster_shm* cluster_shm = cluster->shm_info->cluster_shm;
-		as_partition_table_shm* table = as_shm_find_partition_table(cluster_shm, key->ns);
+		as_partition_table_shm* table = as_partition_shm_table_by_key(cluster_shm, key);
 
 		if (! table) {
 			as_nodes* nodes = as_nodes_reserve(cluster);
@@ -322,7 +345,7 @@ as_partition_info_init(as_partition_info* pi, as_cluster* cluster, as_error* err
 		pi->sc_mode = table->sc_mode;
 	}
 	else {
-		as_partition_table* table = as_partition_tables_get(&cluster->partition_tables, key->ns);
+		as_partition_table* table = as_partition_table_by_key(&cluster->partition_tables, key);
 
 		if (! table) {
 			as_nodes* nodes = as_nodes_reserve(cluster);
@@ -342,6 +365,37 @@ as_partition_info_init(as_partition_info* pi, as_cluster* cluster, as_error* err
 	return AEROSPIKE_OK;
 }
 
+as_status
+as_partition_namespace_handle(as_cluster* cluster, as_error* err, const char* ns, uint32_t* handle)
+{
+	if (cluster->shm_info) {
+		as_cluster_shm* cluster_shm = cluster->shm_info->cluster_shm;
+		as_partition_table_shm* table = as_shm_get_partition_tables(cluster_shm);
+		uint32_t max = as_load_uint32(&cluster_shm->partition_tables_size);
+
+		for (uint32_t i = 0; i < max; i++) {
+			if (strcmp(table->ns, ns) == 0) {
+				*handle = i + 1;
+				return AEROSPIKE_OK;
+			}
+			table = as_shm_next_partition_table(cluster_shm, table);
+		}
+	}
+	else {
+		as_partition_tables* tables = &cluster->partition_tables;
+		uint32_t max = as_load_uint32(&tables->size);
+
+		for (uint32_t i = 0; i < max; i++) {
+			if (strcmp(tables->tables[i]->ns, ns) == 0) {
+				*handle = i + 1;
+				return AEROSPIKE_OK;
+			}
+		}
+	}
+	*handle = 0;
+	return as_error_update(err, AEROSPIKE_ERR_PARAM, "Invalid namespace: %s", ns);
+}
+
 as_partition_table*
 as_partition_tables_get(as_partition_tables* tables, const char* ns)
 {
@@ -363,10 +417,31 @@ force_replicas_refresh(as_node* node)
 	node->partition_generation = (uint32_t)-1;
 }
 
+static void
+set_replica_size(as_partition_table* table, uint8_t replica_size)
+{
+	if (replica_size < table->replica_size) {
+		// Replication factor was reduced. Remove nodes from replica levels that no longer exist.
+		for (uint32_t i = 0; i < table->size; i++) {
+			as_partition* p = &table->partitions[i];
+
+			for (uint32_t j = replica_size; j < table->replica_size; j++) {
+				as_node* tmp = p->nodes[j];
+
+				if (tmp) {
+					set_node(&p->nodes[j], NULL);
+					as_partition_release_node_delayed(tmp);
+				}
+			}
+		}
+	}
+	table->replica_size = replica_size;
+}
+
 static void
 decode_and_update(
-	char* bitmap_b64, uint32_t len, as_partition_table* table, as_node* node, bool master,
-	uint32_t regime, bool* regime_error
+	char* bitmap_b64, uint32_t len, as_partition_table* table, as_node* node,
+	uint32_t replica_index, uint32_t regime, bool* regime_error
 	)
 {
 	// Size allows for padding - is actual size rounded up to multiple of 3.
@@ -379,8 +454,7 @@ decode_and_update(
 	for (uint32_t i = 0; i < table->size; i++) {
 		if ((bitmap[i >> 3] & (0x80 >> (i & 7))) != 0) {
 			// This node claims ownership of partition.
-			// as_log_debug("Set partition %s:%s:%u:%s", master? "master" : "prole", table->ns, i,
-			//				node->name);
+			// as_log_debug("Set partition %s:%u:%u:%s", table->ns, replica_index, i, node->name);
 
 			// Volatile reads are not necessary because the tend thread exclusively modifies
 			// partition.  Volatile writes are used so other threads can view change.
@@ -391,28 +465,14 @@ decode_and_update(
 					p->regime = regime;
 				}
 
-				if (master) {
-					if (node != p->master) {
-						as_node* tmp = p->master;
-						as_partition_reserve_node(node);
-						set_node(&p->master, node);
+				if (node != p->nodes[replica_index]) {
+					as_node* tmp = p->nodes[replica_index];
+					as_partition_reserve_node(node);
+					set_node(&p->nodes[replica_index], node);
 
-						if (tmp) {
-							force_replicas_refresh(tmp);
-							as_partition_release_node_delayed(tmp);
-						}
-					}
-				}
-				else {
-					if (node != p->prole) {
-						as_node* tmp = p->prole;
-						as_partition_reserve_node(node);
-						set_node(&p->prole, node);
-
-						if (tmp) {
-							force_replicas_refresh(tmp);
-							as_partition_release_node_delayed(tmp);
-						}
+					if (tmp) {
+						force_replicas_refresh(tmp);
+						as_partition_release_node_delayed(tmp);
 					}
 				}
 			}
@@ -480,8 +540,10 @@ as_partition_tables_update_all(as_cluster* cluster, as_node* node, char* buf, bo
 			}
 			
 			int replica_count = atoi(begin);
-			
-			// Parse master and one prole partition bitmaps.
+			uint8_t replica_size = (replica_count < AS_MAX_REPLICAS)?
+				(uint8_t)replica_count : AS_MAX_REPLICAS;
+
+			// Parse master and prole partition bitmaps.
 			for (int i = 0; i < replica_count; i++) {
 				begin = ++p;
 				
@@ -501,15 +563,13 @@ as_partition_tables_update_all(as_cluster* cluster, as_node* node, char* buf, bo
 					return false;
 				}
 				
-				// Only handle first two levels.  Do not process other proles.
 				// Level 0: master
-				// Level 1: prole 1
-				if (i < 2) {
-					bool master = (i == 0);
-					
+				// Level 1..n: proles
+				// Proles beyond AS_MAX_REPLICAS are ignored.
+				if (i < AS_MAX_REPLICAS) {
 					if (cluster->shm_info) {
-						as_shm_update_partitions(cluster->shm_info, ns, begin, len, node, master,
-												 regime);
+						as_shm_update_partitions(cluster->shm_info, ns, begin, len, node,
+												 (uint32_t)i, replica_size, regime);
 					}
 					else {
 						as_partition_table* table = as_partition_tables_get(tables, ns);
@@ -526,8 +586,12 @@ as_partition_tables_update_all(as_cluster* cluster, as_node* node, char* buf, bo
 															  regime != 0);
 						}
 						
+						if (i == 0) {
+							set_replica_size(table, replica_size);
+						}
+
 						// Decode partition bitmap and update client's view.
-						decode_and_update(begin, (uint32_t)len, table, node, master, regime,
+						decode_and_update(begin, (uint32_t)len, table, node, (uint32_t)i, regime,
 										  &regime_error);
 
 						if (create) {
@@ -559,12 +623,19 @@ as_partition_tables_dump(as_cluster* cluster)
 
 		for (uint32_t j = 0; j < pt->size; j++) {
 			as_partition* p = &pt->partitions[j];
-			as_node* master = (as_node*)as_load_ptr(&p->master);
-			as_node* prole = (as_node*)as_load_ptr(&p->prole);
-			const char* mstr = master ? as_node_get_address_string(master) : "null";
-			const char* pstr = prole ? as_node_get_address_string(prole) : "null";
+			char str[AS_MAX_REPLICAS * 64];
+			size_t len = 0;
+
+			str[0] = 0;
+
+			for (uint32_t k = 0; k < pt->replica_size && len < sizeof(str); k++) {
+				as_node* node = (as_node*)as_load_ptr(&p->nodes[k]);
+				const char* nstr = node ? as_node_get_address_string(node) : "null";
+
+				len += snprintf(str + len, sizeof(str) - len, ",%s", nstr);
+			}
 
-			as_log_info("%s[%u] %u,%s,%s", pt->ns, j, p->regime, mstr, pstr);
+			as_log_info("%s[%u] %u%s", pt->ns, j, p->regime, str);
 		}
 	}
 }
@@ -76,6 +76,9 @@ tracker_init(
 	as_vector_init(&pt->node_parts, sizeof(as_node_partitions), pt->node_capacity);
 	pt->errors = NULL;
 	pt->max_records = policy->max_records;
+	pt->node_parallelism = (scan->concurrent && policy->node_parallelism > 1)?
+		policy->node_parallelism : 1;
+	pt->records_per_second = policy->records_per_second;
 
 	const as_policy_base* pb = &policy->base;
 	pt->sleep_between_retries = pb->sleep_between_retries;
@@ -122,6 +125,7 @@ assign_partition(as_partition_tracker* pt, as_partition_status* ps, as_node* nod
 		np = as_vector_reserve(&pt->node_parts);
 		as_node_reserve(node);
 		np->node = node;
+		np->records_per_second = pt->records_per_second;
 		as_vector_init(&np->parts_full, sizeof(uint16_t), pt->parts_capacity);
 		as_vector_init(&np->parts_partial, sizeof(uint16_t), pt->parts_capacity);
 	}
@@ -135,6 +139,84 @@ assign_partition(as_partition_tracker* pt, as_partition_status* ps, as_node* nod
 	np->parts_requested++;
 }
 
+static void
+split_list(as_vector* src, as_vector* trg, uint32_t begin, uint32_t end)
+{
+	for (uint32_t i = begin; i < end; i++) {
+		as_vector_append(trg, as_vector_get(src, i));
+	}
+}
+
+static void
+split_node_partitions(as_partition_tracker* pt)
+{
+	// Divide each node's partitions into multiple sub-scans that can run concurrently.
+	// Each sub-scan is a separate as_node_partitions entry, so partition status tracking
+	// and retries are unchanged.
+	uint32_t n = pt->node_parts.size;
+
+	for (uint32_t i = 0; i < n; i++) {
+		as_node_partitions* np = as_vector_get(&pt->node_parts, i);
+		uint32_t n_full = np->parts_full.size;
+		uint32_t n_partial = np->parts_partial.size;
+		uint32_t total = n_full + n_partial;
+		uint32_t n_sub = (pt->node_parallelism < total)? pt->node_parallelism : total;
+
+		if (n_sub <= 1) {
+			continue;
+		}
+
+		// Partitions are assigned in sequence across the concatenation of full and
+		// partial lists. The original entry keeps the first share.
+		uint32_t share = total / n_sub;
+		uint32_t rem = total % n_sub;
+		uint32_t begin = share + (rem > 0 ? 1 : 0);
+
+		// The server applies records_per_second to each scan command, so divide the limit
+		// across sub-scans to keep the node's combined rate at the configured limit.
+		// Round up so a limit is never sent as zero (unlimited).
+		uint32_t rps = (np->records_per_second + n_sub - 1) / n_sub;
+		np->records_per_second = rps;
+
+		for (uint32_t j = 1; j < n_sub; j++) {
+			uint32_t end = begin + share + (j < rem ? 1 : 0);
+
+			// Reserve may reallocate node_parts, so np must be reloaded afterwards.
+			as_node_partitions* sub = as_vector_reserve(&pt->node_parts);
+			np = as_vector_get(&pt->node_parts, i);
+
+			as_node_reserve(np->node);
+			sub->node = np->node;
+			sub->records_per_second = rps;
+			as_vector_init(&sub->parts_full, sizeof(uint16_t), share + 1);
+			as_vector_init(&sub->parts_partial, sizeof(uint16_t), share + 1);
+
+			if (begin < n_full) {
+				split_list(&np->parts_full, &sub->parts_full, begin, end < n_full ? end : n_full);
+			}
+
+			if (end > n_full) {
+				split_list(&np->parts_partial, &sub->parts_partial,
+					begin > n_full ? begin - n_full : 0, end - n_full);
+			}
+			sub->parts_requested = sub->parts_full.size + sub->parts_partial.size;
+			begin = end;
+		}
+
+		// Truncate original entry to its share.
+		uint32_t first = share + (rem > 0 ? 1 : 0);
+
+		if (first < n_full) {
+			np->parts_full.size = first;
+			np->parts_partial.size = 0;
+		}
+		else {
+			np->parts_partial.size = first - n_full;
+		}
+		np->parts_requested = np->parts_full.size + np->parts_partial.size;
+	}
+}
+
 static void
 release_np(as_node_partitions* np)
 {
@@ -239,7 +321,7 @@ as_partition_tracker_assign(
 			as_partition_status* ps = &parts_all->parts[i];
 
 			if (!ps->done) {
-				as_node* node = table->partitions[ps->part_id].master;
+				as_node* node = table->partitions[ps->part_id].nodes[0];
 
 				if (! node) {
 					return as_error_update(err, AEROSPIKE_ERR_INVALID_NODE,
@@ -272,7 +354,7 @@ as_partition_tracker_assign(
 			as_partition_status* ps = &parts_all->parts[i];
 
 			if (!ps->done) {
-				uint32_t master = as_load_uint32(&table->partitions[ps->part_id].master);
+				uint32_t master = as_load_uint32(&table->partitions[ps->part_id].nodes[0]);
 
 				// node index zero indicates unset.
 				if (master == 0) {
@@ -299,6 +381,10 @@ as_partition_tracker_assign(
 		}
 	}
 
+	if (pt->node_parallelism > 1) {
+		split_node_partitions(pt);
+	}
+
 	if (pt->max_records > 0) {
 		// Distribute max_records across nodes.
 		uint32_t node_size = pt->node_parts.size;
@@ -56,6 +56,7 @@ as_query_defaults(as_query* query, bool free, const as_namespace ns, const as_se
 	query->no_bins = false;
 
 	as_udf_call_init(&query->apply, NULL, NULL, NULL);
+	query->apply_merge[0] = '\0';
 
 	return query;
 }
@@ -294,3 +295,18 @@ as_query_apply(as_query* query, const char* module, const char* function, const
 	as_udf_call_init(&query->apply, module, function, (as_list *) arglist);
 	return true;
 }
+
+bool
+as_query_apply_merge(as_query* query, const char* function)
+{
+	if ( !query ) return false;
+
+	if ( function ) {
+		if ( strlen(function) >= AS_UDF_FUNCTION_MAX_SIZE ) return false;
+		strcpy(query->apply_merge, function);
+	}
+	else {
+		query->apply_merge[0] = '\0';
+	}
+	return true;
+}
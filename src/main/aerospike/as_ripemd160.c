@@ -0,0 +1,270 @@
+/*
+ * Copyright 2008-2021 Aerospike, Inc.
+ *
+ * Portions may be licensed to Aerospike, Inc. under one or more contributor
+ * license agreements.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+#include <aerospike/as_ripemd160.h>
+#include <citrusleaf/cf_digest.h>
+#include <string.h>
+
+// Multi-buffer hashing uses compiler vector extensions which map to SSE2/AVX2 on x86
+// and NEON on ARM. Other compilers use the scalar implementation.
+#if defined(__GNUC__) || defined(__clang__)
+#define AS_RIPEMD160_SIMD
+#endif
+
+#if defined(AS_RIPEMD160_SIMD)
+
+/******************************************************************************
+ * TYPES
+ *****************************************************************************/
+
+typedef uint32_t as_vu32 __attribute__((vector_size(AS_RIPEMD160_LANES * sizeof(uint32_t))));
+
+/******************************************************************************
+ * STATIC VARIABLES
+ *****************************************************************************/
+
+// Message word selection for left and right lines.
+static const uint8_t as_rmd_rl[80] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+	7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8,
+	3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12,
+	1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2,
+	4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3, 8, 11, 6, 15, 13
+};
+
+static const uint8_t as_rmd_rr[80] = {
+	5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12,
+	6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2,
+	15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13,
+	8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14,
+	12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13, 14, 0, 3, 9, 11
+};
+
+// Rotate amounts for left and right lines.
+static const uint8_t as_rmd_sl[80] = {
+	11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8,
+	7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12,
+	11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5,
+	11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12,
+	9, 15, 5, 11, 6, 8, 13, 12, 5, 12, 13, 14, 11, 8, 5, 6
+};
+
+static const uint8_t as_rmd_sr[80] = {
+	8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6,
+	9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11,
+	9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5,
+	15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8,
+	8, 5, 12, 9, 12, 5, 14, 6, 8, 13, 6, 5, 15, 13, 11, 11
+};
+
+static const uint32_t as_rmd_kl[5] = {
+	0x00000000, 0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xA953FD4E
+};
+
+static const uint32_t as_rmd_kr[5] = {
+	0x50A28BE6, 0x5C4DD124, 0x6D703EF3, 0x7A6D76E9, 0x00000000
+};
+
+static const uint32_t as_rmd_init[5] = {
+	0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0
+};
+
+/******************************************************************************
+ * STATIC FUNCTIONS
+ *****************************************************************************/
+
+#define AS_RMD_F1(x, y, z) ((x) ^ (y) ^ (z))
+#define AS_RMD_F2(x, y, z) (((x) & (y)) | (~(x) & (z)))
+#define AS_RMD_F3(x, y, z) (((x) | ~(y)) ^ (z))
+#define AS_RMD_F4(x, y, z) (((x) & (z)) | ((y) & ~(z)))
+#define AS_RMD_F5(x, y, z) ((x) ^ ((y) | ~(z)))
+
+#define AS_RMD_ROL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+// Run 16 steps of round r on both lines.
+#define AS_RMD_ROUND(r, FL, FR) \
+	kl = as_vu32_splat(as_rmd_kl[r]); \
+	kr = as_vu32_splat(as_rmd_kr[r]); \
+	for (uint32_t j = r * 16; j < r * 16 + 16; j++) { \
+		t = al + FL(bl, cl, dl) + x[as_rmd_rl[j]] + kl; \
+		t = AS_RMD_ROL(t, as_rmd_sl[j]) + el; \
+		al = el; el = dl; dl = AS_RMD_ROL(cl, 10); cl = bl; bl = t; \
+		t = ar + FR(br, cr, dr) + x[as_rmd_rr[j]] + kr; \
+		t = AS_RMD_ROL(t, as_rmd_sr[j]) + er; \
+		ar = er; er = dr; dr = AS_RMD_ROL(cr, 10); cr = br; br = t; \
+	}
+
+static inline as_vu32
+as_vu32_splat(uint32_t v)
+{
+	as_vu32 r;
+
+	for (uint32_t i = 0; i < AS_RIPEMD160_LANES; i++) {
+		r[i] = v;
+	}
+	return r;
+}
+
+static inline void
+as_ripemd160_compress(as_vu32* h, const as_vu32* x)
+{
+	as_vu32 al = h[0], bl = h[1], cl = h[2], dl = h[3], el = h[4];
+	as_vu32 ar = al, br = bl, cr = cl, dr = dl, er = el;
+	as_vu32 t, kl, kr;
+
+	AS_RMD_ROUND(0, AS_RMD_F1, AS_RMD_F5)
+	AS_RMD_ROUND(1, AS_RMD_F2, AS_RMD_F4)
+	AS_RMD_ROUND(2, AS_RMD_F3, AS_RMD_F3)
+	AS_RMD_ROUND(3, AS_RMD_F4, AS_RMD_F2)
+	AS_RMD_ROUND(4, AS_RMD_F5, AS_RMD_F1)
+
+	t = h[1] + cl + dr;
+	h[1] = h[2] + dl + er;
+	h[2] = h[3] + el + ar;
+	h[3] = h[4] + al + br;
+	h[4] = h[0] + bl + cr;
+	h[0] = t;
+}
+
+static inline uint32_t
+as_ripemd160_load(const uint8_t* p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+		((uint32_t)p[3] << 24);
+}
+
+static inline void
+as_ripemd160_store(uint8_t* p, uint32_t v)
+{
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+static void
+as_ripemd160_lanes(const as_ripemd160_input** lanes, uint32_t n_lanes)
+{
+	uint8_t msg[AS_RIPEMD160_LANES][AS_RIPEMD160_MAX_BLOCKS * 64];
+	uint32_t n_blocks[AS_RIPEMD160_LANES];
+	uint32_t max_blocks = 1;
+
+	// Write padded messages. Unused lanes hash a zero block that is discarded.
+	for (uint32_t i = 0; i < AS_RIPEMD160_LANES; i++) {
+		uint8_t* m = msg[i];
+
+		if (i >= n_lanes) {
+			memset(m, 0, 64);
+			n_blocks[i] = 1;
+			continue;
+		}
+
+		const as_ripemd160_input* in = lanes[i];
+		size_t len = in->len1 + in->len2;
+		uint32_t nb = (uint32_t)((len + 8) / 64 + 1);
+		size_t size = nb * 64;
+
+		memcpy(m, in->data1, in->len1);
+		memcpy(m + in->len1, in->data2, in->len2);
+		memset(m + len, 0, size - len);
+		m[len] = 0x80;
+
+		uint64_t bits = (uint64_t)len << 3;
+		as_ripemd160_store(m + size - 8, (uint32_t)bits);
+		as_ripemd160_store(m + size - 4, (uint32_t)(bits >> 32));
+
+		n_blocks[i] = nb;
+
+		if (nb > max_blocks) {
+			max_blocks = nb;
+		}
+	}
+
+	as_vu32 h[5];
+
+	for (uint32_t i = 0; i < 5; i++) {
+		h[i] = as_vu32_splat(as_rmd_init[i]);
+	}
+
+	for (uint32_t b = 0; b < max_blocks; b++) {
+		// Transpose block words so each vector holds the same word from every lane.
+		as_vu32 x[16];
+
+		for (uint32_t j = 0; j < 16; j++) {
+			for (uint32_t i = 0; i < AS_RIPEMD160_LANES; i++) {
+				x[j][i] = (b < n_blocks[i])? as_ripemd160_load(msg[i] + b * 64 + j * 4) : 0;
+			}
+		}
+
+		as_ripemd160_compress(h, x);
+
+		// Extract digests of lanes that finished on this block.
+		for (uint32_t i = 0; i < n_lanes; i++) {
+			if (n_blocks[i] == b + 1) {
+				uint8_t* digest = lanes[i]->digest;
+
+				for (uint32_t k = 0; k < 5; k++) {
+					as_ripemd160_store(digest + k * 4, h[k][i]);
+				}
+			}
+		}
+	}
+}
+
+#endif
+
+/******************************************************************************
+ * FUNCTIONS
+ *****************************************************************************/
+
+void
+as_ripemd160_compute_many(const as_ripemd160_input* inputs, uint32_t n_inputs)
+{
+#if defined(AS_RIPEMD160_SIMD)
+	const as_ripemd160_input* lanes[AS_RIPEMD160_LANES];
+	uint32_t n_lanes = 0;
+
+	for (uint32_t i = 0; i < n_inputs; i++) {
+		const as_ripemd160_input* in = &inputs[i];
+
+		if (in->len1 + in->len2 > AS_RIPEMD160_MAX_SIZE) {
+			// Long messages would stall the other lanes.
+			cf_digest_compute2(in->data1, in->len1, in->data2, in->len2, (cf_digest*)in->digest);
+			continue;
+		}
+
+		lanes[n_lanes++] = in;
+
+		if (n_lanes == AS_RIPEMD160_LANES) {
+			as_ripemd160_lanes(lanes, n_lanes);
+			n_lanes = 0;
+		}
+	}
+
+	if (n_lanes == 1) {
+		const as_ripemd160_input* in = lanes[0];
+		cf_digest_compute2(in->data1, in->len1, in->data2, in->len2, (cf_digest*)in->digest);
+	}
+	else if (n_lanes > 1) {
+		as_ripemd160_lanes(lanes, n_lanes);
+	}
+#else
+	for (uint32_t i = 0; i < n_inputs; i++) {
+		const as_ripemd160_input* in = &inputs[i];
+		cf_digest_compute2(in->data1, in->len1, in->data2, in->len2, (cf_digest*)in->digest);
+	}
+#endif
+}
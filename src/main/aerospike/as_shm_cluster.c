@@ -90,7 +90,7 @@ as_shm_dump_partition_table(as_partition_table_shm* table, uint32_t n_partitions
 
 	for (uint32_t i = 0; i < n_partitions; i++) {
 		as_partition_shm* p = &table->partitions[i];
-		printf("%d %d\n", i, p->master);
+		printf("%d %d\n", i, p->nodes[0]);
 	}
 }
 
@@ -462,7 +462,25 @@ as_shm_force_replicas_refresh(as_shm_info* shm_info, uint32_t node_index)
 }
 
 static void
-as_shm_decode_and_update(as_shm_info* shm_info, char* bitmap_b64, int64_t len, as_partition_table_shm* table, uint32_t node_index, bool master, uint32_t regime)
+as_shm_set_replica_size(as_shm_info* shm_info, as_partition_table_shm* table, uint8_t replica_size)
+{
+	if (replica_size < table->replica_size) {
+		// Replication factor was reduced. Remove nodes from replica levels that no longer exist.
+		uint32_t max = shm_info->cluster_shm->n_partitions;
+
+		for (uint32_t i = 0; i < max; i++) {
+			as_partition_shm* p = &table->partitions[i];
+
+			for (uint32_t j = replica_size; j < table->replica_size; j++) {
+				as_store_uint32(&p->nodes[j], 0);
+			}
+		}
+	}
+	as_store_uint8(&table->replica_size, replica_size);
+}
+
+static void
+as_shm_decode_and_update(as_shm_info* shm_info, char* bitmap_b64, int64_t len, as_partition_table_shm* table, uint32_t node_index, uint32_t replica_index, uint32_t regime)
 {
 	// Size allows for padding - is actual size rounded up to multiple of 3.
 	uint8_t* bitmap = (uint8_t*)alloca(cf_b64_decoded_buf_size((uint32_t)len));
@@ -483,22 +501,14 @@ as_shm_decode_and_update(as_shm_info* shm_info, char* bitmap_b64, int64_t len, a
 					as_store_uint32(&p->regime, regime);
 				}
 
-				if (master) {
-					// node_index starts at one (zero indicates unset).
-					if (node_index != p->master) {
-						if (p->master) {
-							as_shm_force_replicas_refresh(shm_info, p->master);
-						}
-						as_store_uint32(&p->master, node_index);
-					}
-				}
-				else {
-					if (node_index != p->prole) {
-						if (p->prole) {
-							as_shm_force_replicas_refresh(shm_info, p->prole);
-						}
-						as_store_uint32(&p->prole, node_index);
+				// node_index starts at one (zero indicates unset).
+				uint32_t prev = p->nodes[replica_index];
+
+				if (node_index != prev) {
+					if (prev) {
+						as_shm_force_replicas_refresh(shm_info, prev);
 					}
+					as_store_uint32(&p->nodes[replica_index], node_index);
 				}
 			}
 		}
@@ -506,7 +516,7 @@ as_shm_decode_and_update(as_shm_info* shm_info, char* bitmap_b64, int64_t len, a
 }
 
 void
-as_shm_update_partitions(as_shm_info* shm_info, const char* ns, char* bitmap_b64, int64_t len, as_node* node, bool master, uint32_t regime)
+as_shm_update_partitions(as_shm_info* shm_info, const char* ns, char* bitmap_b64, int64_t len, as_node* node, uint32_t replica_index, uint32_t replica_size, uint32_t regime)
 {
 	as_cluster_shm* cluster_shm = shm_info->cluster_shm;
 	as_partition_table_shm* table = as_shm_find_partition_table(cluster_shm, ns);
@@ -516,7 +526,10 @@ as_shm_update_partitions(as_shm_info* shm_info, const char* ns, char* bitmap_b64
 	}
 	
 	if (table) {
-		as_shm_decode_and_update(shm_info, bitmap_b64, len, table, node->index + 1, master, regime);
+		if (replica_index == 0) {
+			as_shm_set_replica_size(shm_info, table, (uint8_t)replica_size);
+		}
+		as_shm_decode_and_update(shm_info, bitmap_b64, len, table, node->index + 1, replica_index, regime);
 	}
 }
 
@@ -535,74 +548,57 @@ as_shm_try_master(as_cluster* cluster, as_node** local_nodes, uint32_t node_inde
 	return NULL;
 }
 
-static inline as_node*
-as_shm_try_node(as_cluster* cluster, as_node** local_nodes, uint32_t node_index)
+static inline uint32_t
+as_shm_load_nodes(as_partition_shm* p, uint32_t replica_index, uint32_t* node_indexes)
 {
-	// node_index starts at one (zero indicates unset).
-	if (node_index) {
-		as_node* node = (as_node*)as_load_ptr(&local_nodes[node_index-1]);
+	// Make volatile reference so changes to tend thread will be reflected in this thread.
+	uint32_t all[AS_MAX_REPLICAS];
+	uint32_t n = 0;
 
-		if (node && as_load_uint8(&node->active)) {
-			return node;
+	for (uint32_t i = 0; i < AS_MAX_REPLICAS; i++) {
+		// node_index starts at one (zero indicates unset).
+		uint32_t node_index = as_load_uint32(&p->nodes[i]);
+
+		if (node_index) {
+			all[n++] = node_index;
 		}
 	}
-	return NULL;
-}
 
-static as_node*
-as_shm_try_node_alternate(
-	as_cluster* cluster, as_node** local_nodes, uint32_t chosen_index, uint32_t alternate_index
-	)
-{
-	// index values start at one (zero indicates unset).
-	as_node* chosen = (as_node*)as_load_ptr(&local_nodes[chosen_index-1]);
-	
-	// Make volatile reference so changes to tend thread will be reflected in this thread.
-	if (chosen && as_load_uint8(&chosen->active)) {
-		return chosen;
+	// Rotate so the replica at replica_index is tried first.
+	for (uint32_t i = 0; i < n; i++) {
+		node_indexes[i] = all[(replica_index + i) % n];
 	}
-	return as_shm_try_node(cluster, local_nodes, alternate_index);
+	return n;
 }
 
 static as_node*
 shm_get_sequence_node(
-	as_cluster* cluster, as_node** local_nodes, as_partition_shm* p, bool use_master
+	as_cluster* cluster, as_node** local_nodes, as_partition_shm* p, uint32_t replica_index
 	)
 {
-	uint32_t master = as_load_uint32(&p->master);
-	uint32_t prole = as_load_uint32(&p->prole);
+	uint32_t node_indexes[AS_MAX_REPLICAS];
+	uint32_t n = as_shm_load_nodes(p, replica_index, node_indexes);
 
-	if (! prole) {
-		return as_shm_try_node(cluster, local_nodes, master);
-	}
-
-	if (! master) {
-		return as_shm_try_node(cluster, local_nodes, prole);
-	}
+	for (uint32_t i = 0; i < n; i++) {
+		// index values start at one (zero indicates unset).
+		as_node* node = (as_node*)as_load_ptr(&local_nodes[node_indexes[i]-1]);
 
-	if (use_master) {
-		return as_shm_try_node_alternate(cluster, local_nodes, master, prole);
+		if (node && as_load_uint8(&node->active)) {
+			return node;
+		}
 	}
-	return as_shm_try_node_alternate(cluster, local_nodes, prole, master);
+	return NULL;
 }
 
 static as_node*
 shm_prefer_rack_node(
 	as_cluster* cluster, as_node** local_nodes, const char* ns, as_partition_shm* p,
-	as_node* prev_node, bool use_master
+	as_node* prev_node, uint32_t replica_index
 	)
 {
 	as_node_shm* nodes_shm = cluster->shm_info->cluster_shm->nodes;
-	uint32_t node_indexes[2];
-
-	if (use_master) {
-		node_indexes[0] = as_load_uint32(&p->master);
-		node_indexes[1] = as_load_uint32(&p->prole);
-	}
-	else {
-		node_indexes[0] = as_load_uint32(&p->prole);
-		node_indexes[1] = as_load_uint32(&p->master);
-	}
+	uint32_t node_indexes[AS_MAX_REPLICAS];
+	uint32_t n = as_shm_load_nodes(p, replica_index, node_indexes);
 
 	as_node* fallback1 = NULL;
 	as_node* fallback2 = NULL;
@@ -611,14 +607,9 @@ shm_prefer_rack_node(
 	for (uint32_t i = 0; i < max; i++) {
 		int search_id = cluster->rack_ids[i];
 
-		for (uint32_t j = 0; j < 2; j++) {
-			uint32_t node_index = node_indexes[j];
-
+		for (uint32_t j = 0; j < n; j++) {
 			// node_index starts at one (zero indicates unset).
-			if (! node_index) {
-				continue;
-			}
-			node_index--;
+			uint32_t node_index = node_indexes[j] - 1;
 
 			as_node_shm* node_shm = &nodes_shm[node_index];
 			int rack_id;
@@ -679,7 +670,7 @@ static uint32_t g_shm_randomizer = 0;
 as_node*
 as_partition_shm_get_node(
 	as_cluster* cluster, const char* ns, as_partition_shm* p, as_node* prev_node,
-	as_policy_replica replica, bool use_master
+	as_policy_replica replica, uint8_t replica_index
 	)
 {
 	as_node** local_nodes = cluster->shm_info->local_nodes;
@@ -687,24 +678,23 @@ as_partition_shm_get_node(
 	switch (replica) {
 		case AS_POLICY_REPLICA_MASTER: {
 			// Make volatile reference so changes to tend thread will be reflected in this thread.
-			uint32_t master = as_load_uint32(&p->master);
+			uint32_t master = as_load_uint32(&p->nodes[0]);
 			return as_shm_try_master(cluster, local_nodes, master);
 		}
 
 		case AS_POLICY_REPLICA_ANY: {
-			// Alternate between master and prole for reads with global iterator.
+			// Distribute reads across all replicas with global iterator.
 			uint32_t r = as_faa_uint32(&g_shm_randomizer, 1);
-			use_master = (r & 1);
-			return shm_get_sequence_node(cluster, local_nodes, p, use_master);
+			return shm_get_sequence_node(cluster, local_nodes, p, r);
 		}
 
 		default:
 		case AS_POLICY_REPLICA_SEQUENCE: {
-			return shm_get_sequence_node(cluster, local_nodes, p, use_master);
+			return shm_get_sequence_node(cluster, local_nodes, p, replica_index);
 		}
 
 		case AS_POLICY_REPLICA_PREFER_RACK: {
-			return shm_prefer_rack_node(cluster, local_nodes, ns, p, prev_node, use_master);
+			return shm_prefer_rack_node(cluster, local_nodes, ns, p, prev_node, replica_index);
 		}
 	}
 }
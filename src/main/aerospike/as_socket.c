@@ -62,6 +62,12 @@ as_socket_is_error(int e)
 
 #define IPV6_ADDR_PREFERENCES 72
 
+// Maximum segments passed to a single writev()/sendmsg() call.
+#define AS_SOCKET_IOV_MAX 64
+
+// Maximum TLS record plaintext size.
+#define AS_SOCKET_TLS_RECORD_SIZE (1024 * 16)
+
 bool as_socket_stop_on_interrupt = false;
 
 /******************************************************************************
@@ -297,6 +303,28 @@ as_socket_validate_fd(as_socket_fd fd)
 #endif
 }
 
+static as_status
+as_socket_write_tls(
+	as_error* err, as_socket* sock, as_node* node, uint8_t* buf, size_t buf_len,
+	uint32_t socket_timeout, uint64_t deadline
+	)
+{
+	as_status status = AEROSPIKE_OK;
+	int rv = as_tls_write(sock, buf, buf_len, socket_timeout, deadline);
+
+	if (rv < 0) {
+		status = as_socket_error(sock->fd, node, err, AEROSPIKE_ERR_CONNECTION, "TLS write error", rv);
+	}
+	else if (rv == 1) {
+		// Do not set error string to avoid affecting performance.
+		// Calling functions usually retry, so the error string is
+		// not used anyway.
+		status = err->code = AEROSPIKE_ERR_TIMEOUT;
+		err->message[0] = 0;
+	}
+	return status;
+}
+
 as_status
 as_socket_write_deadline(
 	as_error* err, as_socket* sock, struct as_node_s* node, uint8_t *buf, size_t buf_len,
@@ -304,20 +332,7 @@ as_socket_write_deadline(
 	)
 {
 	if (sock->ctx) {
-		as_status status = AEROSPIKE_OK;
-		int rv = as_tls_write(sock, buf, buf_len, socket_timeout, deadline);
-
-		if (rv < 0) {
-			status = as_socket_error(sock->fd, node, err, AEROSPIKE_ERR_CONNECTION, "TLS write error", rv);
-		}
-		else if (rv == 1) {
-			// Do not set error string to avoid affecting performance.
-			// Calling functions usually retry, so the error string is
-			// not used anyway.
-			status = err->code = AEROSPIKE_ERR_TIMEOUT;
-			err->message[0] = 0;
-		}
-		return status;
+		return as_socket_write_tls(err, sock, node, buf, buf_len, socket_timeout, deadline);
 	}
 
 	as_poll poll;
@@ -400,6 +415,207 @@ as_socket_write_deadline(
 	return status;
 }
 
+static as_status
+as_socket_writev_tls(
+	as_error* err, as_socket* sock, as_node* node, as_socket_iov* iov, uint32_t iov_size,
+	uint32_t socket_timeout, uint64_t deadline
+	)
+{
+	// Coalesce small segments into full TLS records. Large segments are written directly
+	// to avoid the copy.
+	uint8_t* stage = NULL;
+	size_t stage_len = 0;
+	as_status status = AEROSPIKE_OK;
+
+	for (uint32_t i = 0; i < iov_size; i++) {
+		uint8_t* data = iov[i].data;
+		size_t len = iov[i].len;
+
+		if (len >= AS_SOCKET_TLS_RECORD_SIZE) {
+			if (stage_len > 0) {
+				status = as_socket_write_tls(err, sock, node, stage, stage_len, socket_timeout,
+											 deadline);
+
+				if (status != AEROSPIKE_OK) {
+					break;
+				}
+				stage_len = 0;
+			}
+
+			status = as_socket_write_tls(err, sock, node, data, len, socket_timeout, deadline);
+
+			if (status != AEROSPIKE_OK) {
+				break;
+			}
+			continue;
+		}
+
+		if (! stage) {
+			stage = alloca(AS_SOCKET_TLS_RECORD_SIZE);
+		}
+
+		while (len > 0) {
+			size_t n = AS_SOCKET_TLS_RECORD_SIZE - stage_len;
+
+			if (n > len) {
+				n = len;
+			}
+			memcpy(stage + stage_len, data, n);
+			stage_len += n;
+			data += n;
+			len -= n;
+
+			if (stage_len == AS_SOCKET_TLS_RECORD_SIZE) {
+				status = as_socket_write_tls(err, sock, node, stage, stage_len, socket_timeout,
+											 deadline);
+
+				if (status != AEROSPIKE_OK) {
+					return status;
+				}
+				stage_len = 0;
+			}
+		}
+	}
+
+	if (status == AEROSPIKE_OK && stage_len > 0) {
+		status = as_socket_write_tls(err, sock, node, stage, stage_len, socket_timeout, deadline);
+	}
+	return status;
+}
+
+as_status
+as_socket_writev_deadline(
+	as_error* err, as_socket* sock, as_node* node, as_socket_iov* iov, uint32_t iov_size,
+	uint32_t socket_timeout, uint64_t deadline
+	)
+{
+	if (sock->ctx) {
+		return as_socket_writev_tls(err, sock, node, iov, iov_size, socket_timeout, deadline);
+	}
+
+#if defined(_MSC_VER)
+	for (uint32_t i = 0; i < iov_size; i++) {
+		as_status status = as_socket_write_deadline(err, sock, node, iov[i].data, iov[i].len,
+													socket_timeout, deadline);
+
+		if (status != AEROSPIKE_OK) {
+			return status;
+		}
+	}
+	return AEROSPIKE_OK;
+#else
+	as_poll poll;
+	as_poll_init(&poll, sock->fd);
+
+	struct iovec vec[AS_SOCKET_IOV_MAX];
+	uint32_t index = 0;
+	size_t offset = 0;
+	as_status status = AEROSPIKE_OK;
+	uint32_t timeout;
+
+	while (index < iov_size) {
+		if (iov[index].len == 0) {
+			// Skip empty segment.
+			index++;
+			continue;
+		}
+
+		if (deadline > 0) {
+			uint64_t now = cf_getms();
+
+			if (now >= deadline) {
+				// Timeout.  Do not set error string to avoid affecting performance.
+				// Calling functions usually retry, so the error string is not used anyway.
+				status = err->code = AEROSPIKE_ERR_TIMEOUT;
+				err->message[0] = 0;
+				break;
+			}
+
+			timeout = (uint32_t)(deadline - now);
+
+			if (socket_timeout > 0 && socket_timeout < timeout) {
+				timeout = socket_timeout;
+			}
+		}
+		else {
+			timeout = socket_timeout;
+		}
+
+		int rv = as_poll_socket(&poll, sock->fd, timeout, false);
+
+		if (rv > 0) {
+			// Map remaining segments. The first segment may have been partially written.
+			uint32_t n = 0;
+
+			for (uint32_t i = index; i < iov_size && n < AS_SOCKET_IOV_MAX; i++, n++) {
+				vec[n].iov_base = iov[i].data;
+				vec[n].iov_len = iov[i].len;
+			}
+			vec[0].iov_base = (uint8_t*)vec[0].iov_base + offset;
+			vec[0].iov_len -= offset;
+
+#if defined(__linux__)
+			struct msghdr msg;
+			memset(&msg, 0, sizeof(msg));
+			msg.msg_iov = vec;
+			msg.msg_iovlen = n;
+
+			ssize_t w_bytes = sendmsg(sock->fd, &msg, MSG_NOSIGNAL);
+#else
+			ssize_t w_bytes = writev(sock->fd, vec, (int)n);
+#endif
+
+			if (w_bytes > 0) {
+				// Advance past written segments.
+				size_t w = (size_t)w_bytes;
+
+				while (w > 0) {
+					size_t rem = iov[index].len - offset;
+
+					if (w >= rem) {
+						w -= rem;
+						index++;
+						offset = 0;
+					}
+					else {
+						offset += w;
+						w = 0;
+					}
+				}
+			}
+			else if (w_bytes == 0) {
+				status = as_error_set_message(err, AEROSPIKE_ERR_CONNECTION, "Bad file descriptor");
+				break;
+			}
+			else {
+				int e = as_last_error();
+				if (as_socket_is_error(e)) {
+					status = as_socket_error(sock->fd, node, err, AEROSPIKE_ERR_CONNECTION, "Socket write error", e);
+					break;
+				}
+			}
+		}
+		else if (rv == 0) {
+			// Timeout.  Do not set error string to avoid affecting performance.
+			// Calling functions usually retry, so the error string is not used anyway.
+			status = err->code = AEROSPIKE_ERR_TIMEOUT;
+			err->message[0] = 0;
+			break;
+		}
+		else if (rv == -1) {
+			int e = as_last_error();
+			if (e != AS_EINTR || as_socket_stop_on_interrupt) {
+				status = as_socket_error(sock->fd, node, err, AEROSPIKE_ERR_CONNECTION, "Socket write error", e);
+				break;
+			}
+		}
+	}
+
+	as_poll_destroy(&poll);
+	return status;
+#endif
+}
+
 as_status
 as_socket_read_deadline(
 	as_error* err, as_socket* sock, as_node* node, uint8_t *buf, size_t buf_len,
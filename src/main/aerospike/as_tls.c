@@ -41,6 +41,7 @@ static bool s_tls_inited = false;
 static pthread_mutex_t s_tls_init_mutex = PTHREAD_MUTEX_INITIALIZER;
 static int s_ex_name_index = -1;
 static int s_ex_ctxt_index = -1;
+static int s_ex_session_index = -1;
 
 typedef enum as_tls_protocol_e {
 	// SSLv2 is always disabled per RFC 6176, we maintain knowledge of
@@ -259,6 +260,7 @@ as_tls_check_init()
 
 		s_ex_name_index = SSL_get_ex_new_index(0, NULL, NULL, NULL, NULL);
 		s_ex_ctxt_index = SSL_get_ex_new_index(0, NULL, NULL, NULL, NULL);
+		s_ex_session_index = SSL_get_ex_new_index(0, NULL, NULL, NULL, NULL);
 		
 		as_fence_memory();
 		
@@ -415,6 +417,38 @@ password_cb(char* buf, int size, int rwflag, void* udata)
 	return pw_len;
 }
 
+static int
+new_session_callback(SSL* ssl, SSL_SESSION* sess)
+{
+	as_tls_session* session = SSL_get_ex_data(ssl, s_ex_session_index);
+
+	if (! session) {
+		// Seed and login connections are not associated with a node.
+		return 0;
+	}
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	if (! SSL_SESSION_is_resumable(sess)) {
+		return 0;
+	}
+#endif
+
+	as_tls_context* ctx = SSL_get_ex_data(ssl, s_ex_ctxt_index);
+
+	pthread_mutex_lock(&session->lock);
+	SSL_SESSION* prev = session->session;
+	session->session = sess;
+	session->gen = as_load_uint32(&ctx->session_gen);
+	pthread_mutex_unlock(&session->lock);
+
+	if (prev) {
+		SSL_SESSION_free(prev);
+	}
+
+	// Keep reference to new session.
+	return 1;
+}
+
 as_status
 as_tls_context_setup(as_config_tls* tlscfg, as_tls_context* ctx, as_error* errp)
 {
@@ -422,8 +456,10 @@ as_tls_context_setup(as_config_tls* tlscfg, as_tls_context* ctx, as_error* errp)
 	ctx->ssl_ctx = NULL;
 	ctx->pkey = NULL;
 	ctx->cert_blacklist = NULL;
+	ctx->session_gen = 0;
 	ctx->log_session_info = tlscfg->log_session_info;
 	ctx->for_login_only = tlscfg->for_login_only;
+	ctx->session_resumption = ! tlscfg->disable_session_resumption;
 
 	as_tls_check_init();
 	pthread_mutex_init(&ctx->lock, NULL);
@@ -636,6 +672,22 @@ as_tls_context_setup(as_config_tls* tlscfg, as_tls_context* ctx, as_error* errp)
 	}
 
 	SSL_CTX_set_verify(ctx->ssl_ctx, SSL_VERIFY_PEER, verify_callback);
+
+	if (ctx->session_resumption) {
+		// Sessions are cached per node by new_session_callback() instead of the context's
+		// internal store, because each node issues its own session tickets.
+		SSL_CTX_set_session_cache_mode(ctx->ssl_ctx,
+			SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+		SSL_CTX_sess_set_new_cb(ctx->ssl_ctx, new_session_callback);
+	}
+
+	if (tlscfg->enable_ktls) {
+#if defined(SSL_OP_ENABLE_KTLS)
+		SSL_CTX_set_options(ctx->ssl_ctx, SSL_OP_ENABLE_KTLS);
+#else
+		as_log_warn("Kernel TLS is not supported by this OpenSSL version");
+#endif
+	}
 	manage_sigpipe();
 	return AEROSPIKE_OK;
 }
@@ -709,6 +761,10 @@ as_tls_config_reload(as_config_tls* tlscfg, as_tls_context* ctx,
 		ctx->cert_blacklist = new_cbl;
 	}
 
+	// Resumed sessions skip certificate verification, so discard sessions established with
+	// the previous certificates and blacklist.
+	as_incr_uint32(&ctx->session_gen);
+
 	pthread_mutex_unlock(&ctx->lock);
 	return AEROSPIKE_OK;
 }
@@ -753,11 +809,54 @@ as_tls_set_context_name(struct ssl_st* ssl, as_tls_context* ctx, const char* tls
 	SSL_set_ex_data(ssl, s_ex_ctxt_index, ctx);
 }
 
+void
+as_tls_session_init(as_tls_session* session)
+{
+	pthread_mutex_init(&session->lock, NULL);
+	session->session = NULL;
+	session->gen = 0;
+}
+
+void
+as_tls_session_destroy(as_tls_session* session)
+{
+	if (session->session) {
+		SSL_SESSION_free(session->session);
+	}
+	pthread_mutex_destroy(&session->lock);
+}
+
+void
+as_tls_set_session(struct ssl_st* ssl, as_tls_context* ctx, as_tls_session* session)
+{
+	if (! ctx->session_resumption) {
+		return;
+	}
+
+	// Sessions received on this connection are saved by new_session_callback().
+	SSL_set_ex_data(ssl, s_ex_session_index, session);
+
+	pthread_mutex_lock(&session->lock);
+
+	if (session->session && session->gen == as_load_uint32(&ctx->session_gen)) {
+		SSL_set_session(ssl, session->session);
+	}
+	pthread_mutex_unlock(&session->lock);
+}
+
 static void
 log_session_info(as_socket* sock)
 {
 	if (! sock->ctx->log_session_info)
 		return;
+
+	as_log_info("TLS session resumed: %s", SSL_session_reused(sock->ssl) ? "true" : "false");
+
+#if defined(SSL_OP_ENABLE_KTLS)
+	as_log_info("TLS kernel offload: send=%s recv=%s",
+				BIO_get_ktls_send(SSL_get_wbio(sock->ssl)) ? "true" : "false",
+				BIO_get_ktls_recv(SSL_get_rbio(sock->ssl)) ? "true" : "false");
+#endif
 	
 	SSL_CIPHER const* cipher = SSL_get_current_cipher(sock->ssl);
 	if (cipher) {
@@ -191,6 +191,35 @@ batch_sequence_callback(as_key* key, as_record* record, void* udata)
 	return true;
 }
 
+static bool
+batch_chunk_callback(const as_batch_read* results, uint32_t n, void* udata)
+{
+	batch_read_data* data = (batch_read_data*)udata;
+
+	// thread_id is overloaded to count callbacks.
+	data->thread_id++;
+	data->total += n;
+
+	for (uint32_t i = 0; i < n; i++) {
+		if (results[i].result == AEROSPIKE_OK) {
+			data->found++;
+
+			int64_t key = as_integer_getorelse((as_integer *) results[i].key->valuep, -1);
+			int64_t val = as_record_get_int64(&results[i].record, "val", -1);
+			if (key != val) {
+				warn("key(%d) != val(%d)", key, val);
+				data->errors++;
+				data->last_error = -2;
+			}
+		}
+		else if (results[i].result != AEROSPIKE_ERR_RECORD_NOT_FOUND) {
+			data->errors++;
+			data->last_error = results[i].result;
+		}
+	}
+	return true;
+}
+
 /******************************************************************************
  * TEST CASES
  *****************************************************************************/
@@ -241,6 +270,35 @@ TEST(batch_get_sequence, "Batch get in sequence")
 	assert_int_eq(data.errors, 0);
 }
 
+TEST(batch_get_chunked, "Batch get in chunks")
+{
+	as_error err;
+
+	as_batch batch;
+	as_batch_inita(&batch, N_KEYS);
+
+	for (uint32_t i = 0; i < N_KEYS; i++) {
+		as_key_init_int64(as_batch_keyat(&batch,i), NAMESPACE, SET, i+1);
+	}
+
+	as_policy_batch policy;
+	as_policy_batch_init(&policy);
+	policy.max_chunk_keys = 30;
+
+	batch_read_data data = {0};
+
+	aerospike_batch_get(as, &err, &policy, &batch, batch_chunk_callback, &data);
+	if (err.code != AEROSPIKE_OK) {
+		info("error(%d): %s", err.code, err.message);
+	}
+	assert_int_eq(err.code, AEROSPIKE_OK);
+
+	assert_int_eq(data.thread_id, (N_KEYS + 29) / 30);
+	assert_int_eq(data.total, N_KEYS);
+	assert_int_eq(data.found, N_KEYS - N_KEYS/20);
+	assert_int_eq(data.errors, 0);
+}
+
 static void*
 batch_get_function(void* thread_id)
 {
@@ -553,6 +611,7 @@ SUITE(batch_get, "aerospike_batch_get tests")
 	suite_after(after);
 	suite_add(batch_get_1);
 	suite_add(batch_get_sequence);
+	suite_add(batch_get_chunked);
 	suite_add(multithreaded_batch_get);
 	suite_add(batch_get_bins);
 	suite_add(batch_read_complex);
@@ -17,22 +17,28 @@
 #include <aerospike/aerospike.h>
 #include <aerospike/aerospike_key.h>
 #include <aerospike/aerospike_scan.h>
+#include <aerospike/aerospike_stats.h>
 #include <aerospike/as_arraylist.h>
 #include <aerospike/as_buffer.h>
+#include <aerospike/as_cluster.h>
+#include <aerospike/as_compress.h>
 #include <aerospike/as_error.h>
 #include <aerospike/as_hashmap.h>
 #include <aerospike/as_integer.h>
 #include <aerospike/as_list.h>
 #include <aerospike/as_map.h>
 #include <aerospike/as_msgpack_serializer.h>
+#include <aerospike/as_partition.h>
 #include <aerospike/as_record.h>
 #include <aerospike/as_serializer.h>
+#include <aerospike/as_sleep.h>
 #include <aerospike/as_status.h>
 #include <aerospike/as_string.h>
 #include <aerospike/as_stringmap.h>
 #include <aerospike/as_val.h>
 
 #include "../test.h"
+#include "../aerospike_test.h"
 
 /******************************************************************************
  * GLOBAL VARS
@@ -47,6 +53,7 @@ extern bool g_enterprise_server;
 
 #define NAMESPACE "test"
 #define SET "test_basics"
+#define SNAPSHOT_PATH "key_basics_snapshot.bin"
 
 /******************************************************************************
  * STATIC FUNCTIONS
@@ -664,17 +671,38 @@ TEST( key_basics_compression , "put with compression write policy: (test,test,fo
 	as_key key;
 	as_key_init(&key, NAMESPACE, SET, "foo_comp");
 
+	as_compress_stats before;
+	as_compress_stats_get(&before);
+
 	as_status rc = aerospike_key_put(as, &err, &wpol, &key, rec);
 	assert_int_eq( rc, AEROSPIKE_OK );
 	as_record_destroy(rec);
 
+	// Ask the server to compress the response.
+	as_policy_read rpol;
+	as_policy_read_init(&rpol);
+	rpol.base.compress = true;
+
 	as_error_reset(&err);
 	as_record * rrec=NULL;
-	rc = aerospike_key_get(as, &err, NULL, &key, &rrec);
+	rc = aerospike_key_get(as, &err, &rpol, &key, &rrec);
 	assert_int_eq( rc, AEROSPIKE_OK );
 	assert_string_eq( as_record_get_str(rrec, "b"), "abc" );
 	assert_int_eq( as_record_get_int64(rrec, "c", 0), 456 );
 
+	as_compress_stats after;
+	as_compress_stats_get(&after);
+
+	// Compressed put and decompressed get response must both be counted.
+	assert_true( after.compress_in >= before.compress_in + count );
+	assert_true( after.compress_out > before.compress_out );
+	assert_true( after.compress_out - before.compress_out <
+				 after.compress_in - before.compress_in );
+	assert_true( after.decompress_out >= before.decompress_out + count );
+	assert_true( after.decompress_in > before.decompress_in );
+	assert_true( after.decompress_in - before.decompress_in <
+				 after.decompress_out - before.decompress_out );
+
 	as_key_destroy(&key);
 	as_record_destroy(rrec);
 }
@@ -792,6 +820,695 @@ TEST(key_basics_bool, "bool")
 
 }
 
+TEST(key_basics_large_values, "put large values via scatter/gather")
+{
+	as_error err;
+	as_key key;
+	as_key_init(&key, NAMESPACE, SET, "large");
+
+	uint32_t blob_size = 100 * 1024;
+	uint8_t* blob = malloc(blob_size);
+
+	for (uint32_t i = 0; i < blob_size; i++) {
+		blob[i] = (uint8_t)i;
+	}
+
+	uint32_t str_size = 20 * 1024;
+	char* str = malloc(str_size + 1);
+	memset(str, 'x', str_size);
+	str[str_size] = 0;
+
+	as_record rec;
+	as_record_init(&rec, 3);
+	as_record_set_rawp(&rec, "blob", blob, blob_size, true);
+	as_record_set_int64(&rec, "int", 77);
+	as_record_set_strp(&rec, "str", str, true);
+
+	as_status rc = aerospike_key_put(as, &err, NULL, &key, &rec);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	as_record_destroy(&rec);
+
+	as_record* prec = NULL;
+	rc = aerospike_key_get(as, &err, NULL, &key, &prec);
+	assert_int_eq(rc, AEROSPIKE_OK);
+
+	as_bytes* b = as_record_get_bytes(prec, "blob");
+	assert_not_null(b);
+	assert_int_eq(b->size, blob_size);
+	assert_int_eq(b->value[blob_size - 1], (uint8_t)(blob_size - 1));
+	assert_int_eq(as_record_get_int64(prec, "int", 0), 77);
+	assert_int_eq(strlen(as_record_get_str(prec, "str")), str_size);
+
+	as_record_destroy(prec);
+	as_key_destroy(&key);
+}
+
+TEST(key_basics_record_arena, "get with record arena")
+{
+	as_error err;
+	as_key key;
+	as_key_init(&key, NAMESPACE, SET, "arena");
+
+	uint8_t bytes[] = {1, 2, 3, 4, 5};
+
+	as_record rec;
+	as_record_init(&rec, 3);
+	as_record_set_str(&rec, "s", "arena string");
+	as_record_set_raw(&rec, "b", bytes, sizeof(bytes));
+	as_record_set_int64(&rec, "i", 42);
+
+	as_status rc = aerospike_key_put(as, &err, NULL, &key, &rec);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	as_record_destroy(&rec);
+
+	as_policy_read policy;
+	as_policy_read_init(&policy);
+	policy.record_arena = true;
+
+	as_record* prec = NULL;
+	rc = aerospike_key_get(as, &err, &policy, &key, &prec);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	assert_string_eq(as_record_get_str(prec, "s"), "arena string");
+	assert_int_eq(as_record_get_int64(prec, "i", 0), 42);
+
+	as_bytes* b = as_record_get_bytes(prec, "b");
+	assert_not_null(b);
+	assert_int_eq(b->size, sizeof(bytes));
+	assert_int_eq(memcmp(b->value, bytes, sizeof(bytes)), 0);
+
+	// Reuse record with arena.
+	rc = aerospike_key_get(as, &err, &policy, &key, &prec);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	assert_string_eq(as_record_get_str(prec, "s"), "arena string");
+
+	as_record_destroy(prec);
+	as_key_destroy(&key);
+}
+
+TEST(key_basics_digests, "bulk digests match single digests")
+{
+	char long_str[300];
+	memset(long_str, 'x', sizeof(long_str) - 1);
+	long_str[sizeof(long_str) - 1] = 0;
+
+	uint8_t bytes[] = {1, 2, 3, 4, 5};
+
+	as_key keys[23];
+	as_key single[23];
+
+	for (uint32_t i = 0; i < 20; i++) {
+		as_key_init_int64(&keys[i], NAMESPACE, SET, i);
+		as_key_init_int64(&single[i], NAMESPACE, SET, i);
+	}
+	as_key_init_str(&keys[20], NAMESPACE, SET, "digest string");
+	as_key_init_str(&single[20], NAMESPACE, SET, "digest string");
+	as_key_init_raw(&keys[21], NAMESPACE, "", bytes, sizeof(bytes));
+	as_key_init_raw(&single[21], NAMESPACE, "", bytes, sizeof(bytes));
+	as_key_init_str(&keys[22], NAMESPACE, SET, long_str);
+	as_key_init_str(&single[22], NAMESPACE, SET, long_str);
+
+	as_error err;
+	as_status rc = as_key_set_digests(&err, keys, 23);
+	assert_int_eq(rc, AEROSPIKE_OK);
+
+	for (uint32_t i = 0; i < 23; i++) {
+		rc = as_key_set_digest(&err, &single[i]);
+		assert_int_eq(rc, AEROSPIKE_OK);
+		assert_true(keys[i].digest.init);
+		assert_int_eq(memcmp(keys[i].digest.value, single[i].digest.value, AS_DIGEST_VALUE_SIZE),
+					  0);
+		as_key_destroy(&keys[i]);
+		as_key_destroy(&single[i]);
+	}
+}
+
+TEST(key_basics_pipeline, "pipeline of mixed commands")
+{
+	as_error err;
+	as_key keys[10];
+	as_record recs[10];
+	as_pipeline_op ops[30];
+	memset(ops, 0, sizeof(ops));
+
+	for (uint32_t i = 0; i < 10; i++) {
+		as_key_init_int64(&keys[i], NAMESPACE, SET, 1000 + i);
+		as_record_inita(&recs[i], 1);
+		as_record_set_int64(&recs[i], "a", i);
+
+		ops[i].type = AS_PIPELINE_PUT;
+		ops[i].key = &keys[i];
+		ops[i].record = &recs[i];
+
+		ops[10 + i].type = AS_PIPELINE_GET;
+		ops[10 + i].key = &keys[i];
+
+		ops[20 + i].type = AS_PIPELINE_REMOVE;
+		ops[20 + i].key = &keys[i];
+	}
+
+	as_status rc = aerospike_key_pipeline(as, &err, ops, 30);
+	assert_int_eq(rc, AEROSPIKE_OK);
+
+	for (uint32_t i = 0; i < 10; i++) {
+		assert_int_eq(ops[i].result, AEROSPIKE_OK);
+		assert_int_eq(ops[10 + i].result, AEROSPIKE_OK);
+		assert_int_eq(as_record_get_int64(ops[10 + i].record, "a", -1), i);
+		assert_int_eq(ops[20 + i].result, AEROSPIKE_OK);
+		as_record_destroy(ops[10 + i].record);
+		as_record_destroy(&recs[i]);
+	}
+
+	// Records were removed by the pipeline.
+	memset(ops, 0, sizeof(as_pipeline_op) * 10);
+
+	for (uint32_t i = 0; i < 10; i++) {
+		ops[i].type = AS_PIPELINE_EXISTS;
+		ops[i].key = &keys[i];
+	}
+
+	rc = aerospike_key_pipeline(as, &err, ops, 10);
+	assert_int_eq(rc, AEROSPIKE_OK);
+
+	for (uint32_t i = 0; i < 10; i++) {
+		assert_int_eq(ops[i].result, AEROSPIKE_ERR_RECORD_NOT_FOUND);
+		assert_int_eq(ops[i].error.code, AEROSPIKE_ERR_RECORD_NOT_FOUND);
+		as_key_destroy(&keys[i]);
+	}
+
+	// Invalid commands keep their own error details.
+	as_key key;
+	as_key_init_int64(&key, NAMESPACE, SET, 1000);
+	memset(ops, 0, sizeof(as_pipeline_op) * 2);
+
+	ops[0].type = AS_PIPELINE_PUT;
+	ops[0].key = &key;
+
+	ops[1].type = AS_PIPELINE_OPERATE;
+	ops[1].key = &key;
+
+	rc = aerospike_key_pipeline(as, &err, ops, 2);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	assert_int_eq(ops[0].result, AEROSPIKE_ERR_PARAM);
+	assert_int_eq(ops[0].error.code, AEROSPIKE_ERR_PARAM);
+	assert_string_eq(ops[0].error.message, "Record not defined");
+	assert_int_eq(ops[1].result, AEROSPIKE_ERR_PARAM);
+	assert_string_eq(ops[1].error.message, "No operations defined");
+	as_key_destroy(&key);
+}
+
+TEST(key_basics_pipeline_compress, "pipeline with compressed put and operate")
+{
+	as_error err;
+	as_key key;
+	as_key_init_int64(&key, NAMESPACE, SET, 1100);
+
+	uint8_t bytes[2000];
+	memset(bytes, 7, sizeof(bytes));
+
+	as_record rec;
+	as_record_inita(&rec, 2);
+	as_record_set_rawp(&rec, "a", bytes, sizeof(bytes), false);
+	as_record_set_int64(&rec, "b", 1);
+
+	as_policy_write wpol;
+	as_policy_write_init(&wpol);
+	wpol.compression_threshold = 1000;
+
+	as_policy_operate opol;
+	as_policy_operate_init(&opol);
+	opol.base.compress = true;
+
+	as_operations ops_write;
+	as_operations_inita(&ops_write, 2);
+	as_operations_add_write_rawp(&ops_write, "c", bytes, sizeof(bytes), false);
+	as_operations_add_incr(&ops_write, "b", 1);
+
+	as_pipeline_op ops[3];
+	memset(ops, 0, sizeof(ops));
+
+	ops[0].type = AS_PIPELINE_PUT;
+	ops[0].key = &key;
+	ops[0].policy.write = &wpol;
+	ops[0].record = &rec;
+
+	ops[1].type = AS_PIPELINE_OPERATE;
+	ops[1].key = &key;
+	ops[1].policy.operate = &opol;
+	ops[1].ops = &ops_write;
+
+	ops[2].type = AS_PIPELINE_GET;
+	ops[2].key = &key;
+
+	as_status rc = aerospike_key_pipeline(as, &err, ops, 3);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	assert_int_eq(ops[0].result, AEROSPIKE_OK);
+	assert_int_eq(ops[1].result, AEROSPIKE_OK);
+	assert_int_eq(ops[2].result, AEROSPIKE_OK);
+
+	as_record* r = ops[2].record;
+	as_bytes* a = as_record_get_bytes(r, "a");
+	as_bytes* c = as_record_get_bytes(r, "c");
+	assert_not_null(a);
+	assert_not_null(c);
+	assert_int_eq(as_bytes_size(a), sizeof(bytes));
+	assert_int_eq(memcmp(as_bytes_get(c), bytes, sizeof(bytes)), 0);
+	assert_int_eq(as_record_get_int64(r, "b", 0), 2);
+
+	as_record_destroy(ops[1].record);
+	as_record_destroy(r);
+	as_operations_destroy(&ops_write);
+	as_record_destroy(&rec);
+
+	rc = aerospike_key_remove(as, &err, NULL, &key);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	as_key_destroy(&key);
+}
+
+TEST(key_basics_hedged_read, "hedged reads")
+{
+	as_error err;
+	as_key key;
+	as_key_init_int64(&key, NAMESPACE, SET, 2000);
+
+	as_record rec;
+	as_record_inita(&rec, 1);
+	as_record_set_int64(&rec, "a", 77);
+
+	as_status rc = aerospike_key_put(as, &err, NULL, &key, &rec);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	as_record_destroy(&rec);
+
+	// Hedge after 1ms. Result must be the same whichever replica answers first.
+	as_policy_read policy;
+	as_policy_read_init(&policy);
+	policy.replica = AS_POLICY_REPLICA_SEQUENCE;
+	policy.hedge_delay = 1;
+	policy.hedge_percentile = 50.0;
+
+	for (uint32_t i = 0; i < 20; i++) {
+		as_record* r = NULL;
+		rc = aerospike_key_get(as, &err, &policy, &key, &r);
+		assert_int_eq(rc, AEROSPIKE_OK);
+		assert_int_eq(as_record_get_int64(r, "a", -1), 77);
+		as_record_destroy(r);
+	}
+
+	rc = aerospike_key_remove(as, &err, NULL, &key);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	as_key_destroy(&key);
+}
+
+static uint64_t
+key_basics_latency_count(as_latency_type type)
+{
+	as_cluster_stats stats;
+	aerospike_stats(as, &stats);
+
+	uint64_t count = 0;
+
+	for (uint32_t i = 0; i < stats.nodes_size; i++) {
+		count += as_latency_count(&stats.nodes[i].latency[type]);
+	}
+	aerospike_stats_destroy(&stats);
+	return count;
+}
+
+TEST(key_basics_latency, "latency histograms")
+{
+	uint64_t reads = key_basics_latency_count(AS_LATENCY_TYPE_READ);
+	uint64_t writes = key_basics_latency_count(AS_LATENCY_TYPE_WRITE);
+
+	as_error err;
+	as_key key;
+	as_key_init(&key, NAMESPACE, SET, "latency");
+
+	as_record rec;
+	as_record_init(&rec, 1);
+	as_record_set_int64(&rec, "a", 1);
+
+	as_status rc = aerospike_key_put(as, &err, NULL, &key, &rec);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	as_record_destroy(&rec);
+
+	as_record* prec = NULL;
+	rc = aerospike_key_get(as, &err, NULL, &key, &prec);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	as_record_destroy(prec);
+	as_key_destroy(&key);
+
+	assert_true(key_basics_latency_count(AS_LATENCY_TYPE_WRITE) > writes);
+	assert_true(key_basics_latency_count(AS_LATENCY_TYPE_READ) > reads);
+}
+
+TEST(key_basics_namespace_handle, "namespace handle")
+{
+	as_error err;
+	uint32_t handle = 0;
+
+	as_status rc = aerospike_namespace_handle(as, &err, NAMESPACE, &handle);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	assert_true(handle > 0);
+
+	rc = aerospike_namespace_handle(as, &err, "nsdoesnotexist", &handle);
+	assert_int_eq(rc, AEROSPIKE_ERR_PARAM);
+
+	aerospike_namespace_handle(as, &err, NAMESPACE, &handle);
+
+	as_key key;
+	as_key_init(&key, NAMESPACE, SET, "nshandle");
+	key.ns_handle = handle;
+
+	as_record rec;
+	as_record_init(&rec, 1);
+	as_record_set_int64(&rec, "a", 7);
+
+	rc = aerospike_key_put(as, &err, NULL, &key, &rec);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	as_record_destroy(&rec);
+
+	as_record* prec = NULL;
+	rc = aerospike_key_get(as, &err, NULL, &key, &prec);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	assert_int_eq(as_record_get_int64(prec, "a", 0), 7);
+	as_record_destroy(prec);
+
+	// Resolved handle must find the same partition as the name lookup.
+	as_key plain;
+	as_key_init(&plain, NAMESPACE, SET, "nshandle");
+
+	as_partition_info pi_handle;
+	as_partition_info pi_name;
+	rc = as_partition_info_init(&pi_handle, as->cluster, &err, &key);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	rc = as_partition_info_init(&pi_name, as->cluster, &err, &plain);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	assert_true(pi_handle.partition == pi_name.partition);
+	assert_string_eq(pi_handle.ns, NAMESPACE);
+	as_key_destroy(&plain);
+
+	// Stale or out of range handle falls back to name lookup.
+	key.ns_handle = 0xffff;
+	prec = NULL;
+	rc = aerospike_key_get(as, &err, NULL, &key, &prec);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	assert_int_eq(as_record_get_int64(prec, "a", 0), 7);
+	as_record_destroy(prec);
+	as_key_destroy(&key);
+
+	// Handle for another namespace must not route the key to that namespace.
+	as_key bad;
+	as_key_init(&bad, "nsdoesnotexist", SET, "nshandle");
+	bad.ns_handle = handle;
+	prec = NULL;
+	rc = aerospike_key_get(as, &err, NULL, &bad, &prec);
+	assert_int_eq(rc, AEROSPIKE_ERR_CLIENT);
+	as_key_destroy(&bad);
+}
+
+static aerospike*
+key_basics_snapshot_connect(const char* host, int port, as_status* status)
+{
+	as_config config;
+	as_config_init(&config);
+	as_config_add_hosts(&config, host, port);
+	as_config_set_snapshot_path(&config, SNAPSHOT_PATH);
+	config.snapshot_interval = 0;
+
+	as_error err;
+	aerospike* client = aerospike_new(&config);
+	*status = aerospike_connect(client, &err);
+
+	if (*status != AEROSPIKE_OK) {
+		aerospike_destroy(client);
+		return NULL;
+	}
+	return client;
+}
+
+static void
+key_basics_snapshot_close(aerospike* client)
+{
+	as_error err;
+	aerospike_close(client, &err);
+	aerospike_destroy(client);
+}
+
+static as_status
+key_basics_snapshot_get(aerospike* client, as_key* key)
+{
+	as_error err;
+	as_record* rec = NULL;
+	as_status status = aerospike_key_get(client, &err, NULL, key, &rec);
+	as_record_destroy(rec);
+	return status;
+}
+
+static bool
+key_basics_snapshot_truncate(void)
+{
+	FILE* f = fopen(SNAPSHOT_PATH, "rb");
+
+	if (! f) {
+		return false;
+	}
+
+	uint8_t buf[4096];
+	size_t size = fread(buf, 1, sizeof(buf), f);
+	fclose(f);
+
+	// Keep valid header, but cut off node entries.
+	f = fopen(SNAPSHOT_PATH, "wb");
+
+	if (! f) {
+		return false;
+	}
+	fwrite(buf, 1, size / 2, f);
+	fclose(f);
+	return true;
+}
+
+TEST(key_basics_snapshot, "cluster snapshot")
+{
+	as_error err;
+	as_key key;
+	as_key_init(&key, NAMESPACE, SET, "snapshot");
+
+	as_record rec;
+	as_record_init(&rec, 1);
+	as_record_set_int64(&rec, "a", 1);
+	as_status rc = aerospike_key_put(as, &err, NULL, &key, &rec);
+	as_record_destroy(&rec);
+	assert_int_eq(rc, AEROSPIKE_OK);
+
+	// Write snapshot from a tended client.
+	remove(SNAPSHOT_PATH);
+	aerospike* client = key_basics_snapshot_connect(g_host, g_port, &rc);
+	assert_not_null(client);
+	as_sleep(1500);
+	key_basics_snapshot_close(client);
+
+	FILE* f = fopen(SNAPSHOT_PATH, "rb");
+	assert_not_null(f);
+	fclose(f);
+
+	// The seed is unreachable, so the command can only be routed from the snapshot.
+	client = key_basics_snapshot_connect("127.0.0.1", 1, &rc);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	rc = key_basics_snapshot_get(client, &key);
+	key_basics_snapshot_close(client);
+	assert_int_eq(rc, AEROSPIKE_OK);
+
+	// Truncated snapshot must be ignored.
+	assert_true(key_basics_snapshot_truncate());
+	client = key_basics_snapshot_connect("127.0.0.1", 1, &rc);
+	assert_null(client);
+	assert_int_ne(rc, AEROSPIKE_OK);
+
+	// Truncated snapshot falls back to seeding.
+	assert_true(key_basics_snapshot_truncate());
+	client = key_basics_snapshot_connect(g_host, g_port, &rc);
+	assert_int_eq(rc, AEROSPIKE_OK);
+	rc = key_basics_snapshot_get(client, &key);
+	key_basics_snapshot_close(client);
+	assert_int_eq(rc, AEROSPIKE_OK);
+
+	remove(SNAPSHOT_PATH);
+	aerospike_key_remove(as, &err, NULL, &key);
+	as_key_destroy(&key);
+}
+
+static aerospike*
+key_basics_tend_connect(uint32_t tend_threads, as_status* status)
+{
+	as_config config;
+	as_config_init(&config);
+	as_config_add_hosts(&config, g_host, g_port);
+	config.tend_threads = tend_threads;
+
+	as_error err;
+	aerospike* client = aerospike_new(&config);
+	*status = aerospike_connect(client, &err);
+
+	if (*status != AEROSPIKE_OK) {
+		aerospike_destroy(client);
+		return NULL;
+	}
+	return client;
+}
+
+static as_node*
+key_basics_tend_find_node(as_nodes* nodes, const char* name)
+{
+	for (uint32_t i = 0; i < nodes->size; i++) {
+		if (strcmp(nodes->array[i]->name, name) == 0) {
+			return nodes->array[i];
+		}
+	}
+	return NULL;
+}
+
+static inline const char*
+key_basics_tend_node_name(as_node* node)
+{
+	return node ? node->name : "";
+}
+
+TEST(key_basics_tend_threads, "parallel tend matches sequential tend")
+{
+	as_status rc;
+	aerospike* seq = key_basics_tend_connect(1, &rc);
+	assert_not_null(seq);
+
+	aerospike* par = key_basics_tend_connect(4, &rc);
+
+	if (! par) {
+		key_basics_snapshot_close(seq);
+	}
+	assert_not_null(par);
+
+	// Let both clients run several tend iterations.
+	as_sleep(3000);
+
+	as_nodes* seq_nodes = as_nodes_reserve(seq->cluster);
+	as_nodes* par_nodes = as_nodes_reserve(par->cluster);
+	bool nodes_match = seq_nodes->size == par_nodes->size;
+
+	for (uint32_t i = 0; nodes_match && i < seq_nodes->size; i++) {
+		nodes_match = key_basics_tend_find_node(par_nodes, seq_nodes->array[i]->name) != NULL;
+	}
+	as_nodes_release(par_nodes);
+	as_nodes_release(seq_nodes);
+
+	as_partition_tables* seq_tables = &seq->cluster->partition_tables;
+	as_partition_tables* par_tables = &par->cluster->partition_tables;
+	bool tables_match = seq_tables->size == par_tables->size;
+
+	for (uint32_t i = 0; tables_match && i < seq_tables->size; i++) {
+		as_partition_table* st = seq_tables->tables[i];
+		as_partition_table* pt = as_partition_tables_get(par_tables, st->ns);
+
+		if (! pt || pt->size != st->size || pt->sc_mode != st->sc_mode ||
+			pt->replica_size != st->replica_size) {
+			tables_match = false;
+			break;
+		}
+
+		for (uint32_t j = 0; tables_match && j < st->size; j++) {
+			as_partition* sp = &st->partitions[j];
+			as_partition* pp = &pt->partitions[j];
+
+			if (sp->regime != pp->regime) {
+				tables_match = false;
+				break;
+			}
+
+			for (uint32_t k = 0; k < st->replica_size; k++) {
+				if (strcmp(key_basics_tend_node_name(sp->nodes[k]),
+						   key_basics_tend_node_name(pp->nodes[k])) != 0) {
+					tables_match = false;
+					break;
+				}
+			}
+		}
+	}
+
+	key_basics_snapshot_close(par);
+	key_basics_snapshot_close(seq);
+
+	assert_true(nodes_match);
+	assert_true(tables_match);
+}
+
+TEST(key_basics_prepared, "prepared commands")
+{
+	as_error err;
+	as_prepared put;
+	as_prepared sel;
+	as_prepared oper;
+
+	const char* bins[] = {"a", "b", NULL};
+	as_status rc = aerospike_key_prepare_put(as, &err, NULL, NAMESPACE, SET, bins, &put);
+	assert_int_eq(rc, AEROSPIKE_OK);
+
+	rc = aerospike_key_prepare_select(as, &err, NULL, NAMESPACE, SET, NULL, &sel);
+	assert_int_eq(rc, AEROSPIKE_OK);
+
+	as_operations ops;
+	as_operations_inita(&ops, 2);
+	as_operations_add_incr(&ops, "a", 0);
+	as_operations_add_read(&ops, "a");
+	rc = aerospike_key_prepare_operate(as, &err, NULL, NAMESPACE, SET, &ops, &oper);
+	as_operations_destroy(&ops);
+	assert_int_eq(rc, AEROSPIKE_OK);
+
+	for (int64_t i = 0; i < 5; i++) {
+		as_key key;
+		as_key_init_int64(&key, NAMESPACE, SET, 2000 + i);
+
+		as_integer a;
+		as_string b;
+		as_val* values[] = {
+			(as_val*)as_integer_init(&a, i),
+			(as_val*)as_string_init(&b, "prepared", false)
+		};
+
+		rc = aerospike_key_execute_prepared(as, &err, &put, &key, values, AS_RECORD_DEFAULT_TTL, 0,
+											NULL);
+		assert_int_eq(rc, AEROSPIKE_OK);
+
+		as_record* rec = NULL;
+		rc = aerospike_key_execute_prepared(as, &err, &sel, &key, NULL, 0, 0, &rec);
+		assert_int_eq(rc, AEROSPIKE_OK);
+		assert_int_eq(as_record_get_int64(rec, "a", -1), i);
+		assert_string_eq(as_record_get_str(rec, "b"), "prepared");
+		as_record_destroy(rec);
+
+		as_integer incr;
+		as_val* oper_values[] = {(as_val*)as_integer_init(&incr, 10), NULL};
+		rec = NULL;
+		rc = aerospike_key_execute_prepared(as, &err, &oper, &key, oper_values,
+											AS_RECORD_DEFAULT_TTL, 0, &rec);
+		assert_int_eq(rc, AEROSPIKE_OK);
+		assert_int_eq(as_record_get_int64(rec, "a", -1), i + 10);
+		as_record_destroy(rec);
+
+		rc = aerospike_key_remove(as, &err, NULL, &key);
+		assert_int_eq(rc, AEROSPIKE_OK);
+		as_key_destroy(&key);
+	}
+
+	// Key must match prepared namespace and set.
+	as_key other;
+	as_key_init_int64(&other, NAMESPACE, "other", 1);
+	rc = aerospike_key_execute_prepared(as, &err, &sel, &other, NULL, 0, 0, NULL);
+	assert_int_eq(rc, AEROSPIKE_ERR_PARAM);
+	as_key_destroy(&other);
+
+	as_prepared_destroy(&put);
+	as_prepared_destroy(&sel);
+	as_prepared_destroy(&oper);
+}
+
 /******************************************************************************
  * TEST SUITE
  *****************************************************************************/
@@ -819,8 +1536,23 @@ SUITE(key_basics, "aerospike_key basic tests") {
 	suite_add(key_basics_list_map_double);
 	suite_add(key_basics_storekey);
 	suite_add(key_basics_bool);
+	suite_add(key_basics_large_values);
+	suite_add(key_basics_record_arena);
+	suite_add(key_basics_digests);
+	suite_add(key_basics_pipeline);
+	suite_add(key_basics_hedged_read);
+	suite_add(key_basics_latency);
+	suite_add(key_basics_namespace_handle);
+	suite_add(key_basics_prepared);
+
+	// Snapshot is disabled with authentication, and test clients do not copy auth or TLS config.
+	if (! as->cluster->auth_enabled && ! as->config.tls.enable && ! as->config.use_shm) {
+		suite_add(key_basics_snapshot);
+		suite_add(key_basics_tend_threads);
+	}
 
 	if (g_enterprise_server) {
 		suite_add(key_basics_compression);
+		suite_add(key_basics_pipeline_compress);
 	}
 }
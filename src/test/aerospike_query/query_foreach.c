@@ -391,6 +391,36 @@ TEST( query_foreach_1, "count(*) where a == 'abc' (non-aggregating)" ) {
 	as_query_destroy(&q);
 }
 
+TEST( query_foreach_1_parse_threads, "count(*) where a == 'abc' with parse threads" ) {
+
+	as_error err;
+	as_error_reset(&err);
+
+	uint32_t count = 0;
+
+	as_policy_query p;
+	as_policy_query_init(&p);
+	p.parse_threads = 4;
+	p.parse_queue_size = 2;
+	p.parse_ordered = false;
+
+	as_query q;
+	as_query_init(&q, NAMESPACE, SET);
+
+	as_query_select_inita(&q, 1);
+	as_query_select(&q, "c");
+	
+	as_query_where_inita(&q, 1);
+	as_query_where(&q, "a", as_string_equals("abc"));
+	
+	aerospike_query_foreach(as, &err, &p, &q, query_foreach_count_callback, &count);
+
+	assert_int_eq( err.code, 0 );
+	assert_int_eq( count, 100 );
+
+	as_query_destroy(&q);
+}
+
 static bool query_foreach_2_callback(const as_val * v, void * udata) {
 	if ( v != NULL ) {
 		as_integer * i = as_integer_fromval(v);
@@ -471,6 +501,174 @@ TEST( query_foreach_3, "sum(e) where a == 'abc'" ) {
 	as_query_destroy(&q);
 }
 
+static void* query_native_sum_create(void * udata) {
+	return calloc(1, sizeof(int64_t));
+}
+
+static bool query_native_sum_map(void * state, const as_record * rec, void * udata) {
+	*(int64_t *) state += as_record_get_int64(rec, "e", 0);
+	return true;
+}
+
+static void query_native_sum_reduce(void * state, void * other, void * udata) {
+	*(int64_t *) state += *(int64_t *) other;
+}
+
+static void query_native_sum_destroy(void * state, void * udata) {
+	free(state);
+}
+
+TEST( query_foreach_3_native, "sum(e) where a == 'abc' with native aggregation" ) {
+
+	as_error err;
+	as_error_reset(&err);
+
+	as_query_aggregator aggr = {
+		.create = query_native_sum_create,
+		.map = query_native_sum_map,
+		.reduce = query_native_sum_reduce,
+		.destroy = query_native_sum_destroy,
+		.udata = NULL
+	};
+
+	as_query q;
+	as_query_init(&q, NAMESPACE, SET);
+
+	as_query_select_inita(&q, 1);
+	as_query_select(&q, "e");
+
+	as_query_where_inita(&q, 1);
+	as_query_where(&q, "a", as_string_equals("abc"));
+
+	void * result = NULL;
+	as_status rc = aerospike_query_aggregate(as, &err, NULL, &q, &aggr, &result);
+
+	assert_int_eq( rc, AEROSPIKE_OK );
+	assert_not_null( result );
+
+	int64_t value = *(int64_t *) result;
+	info("value: %ld", value);
+	assert_int_eq( value, 24275 );
+
+	aggr.destroy(result, aggr.udata);
+	as_query_destroy(&q);
+}
+
+TEST( query_foreach_3_parallel, "sum(e) where a == 'abc' with parallel aggregation" ) {
+	
+	as_error err;
+	as_error_reset(&err);
+
+	int64_t value = 0;
+
+	as_policy_query p;
+	as_policy_query_init(&p);
+	p.aggregate_threads = 4;
+	p.aggregate_queue_size = 2;
+
+	as_query q;
+	as_query_init(&q, NAMESPACE, SET);
+
+	as_query_where_inita(&q, 1);
+	as_query_where(&q, "a", as_string_equals("abc"));
+
+	as_query_apply(&q, UDF_FILE, "sum", NULL);
+	as_query_apply_merge(&q, "sum_merge");
+
+	aerospike_query_foreach(as, &err, &p, &q, query_foreach_3_callback, &value);
+
+	if ( err.code != AEROSPIKE_OK ) {
+		 fprintf(stderr, "error(%d) %s at [%s:%d]", err.code, err.message, err.file, err.line);
+	}
+
+	info("value: %ld", value);
+
+	assert_int_eq( err.code, AEROSPIKE_OK );
+	assert_int_eq( value, 24275 );
+
+	as_query_destroy(&q);
+}
+
+TEST( query_foreach_3_parallel_post_reduce, "sum(e) * 2 where a == 'abc' with parallel aggregation" ) {
+	
+	as_error err;
+	as_error_reset(&err);
+
+	int64_t value = 0;
+
+	as_policy_query p;
+	as_policy_query_init(&p);
+	p.aggregate_threads = 6;
+	p.aggregate_queue_size = 2;
+
+	as_query q;
+	as_query_init(&q, NAMESPACE, SET);
+
+	as_query_where_inita(&q, 1);
+	as_query_where(&q, "a", as_string_equals("abc"));
+
+	// map() after reduce() must only run on the final result.
+	as_query_apply(&q, UDF_FILE, "sum_doubled", NULL);
+
+	as_status rc = aerospike_query_foreach(as, &err, &p, &q, query_foreach_3_callback, &value);
+	assert_int_eq( rc, AEROSPIKE_ERR_PARAM );
+
+	as_query_apply_merge(&q, "sum_merge");
+
+	aerospike_query_foreach(as, &err, &p, &q, query_foreach_3_callback, &value);
+
+	if ( err.code != AEROSPIKE_OK ) {
+		 fprintf(stderr, "error(%d) %s at [%s:%d]", err.code, err.message, err.file, err.line);
+	}
+
+	info("value: %ld", value);
+
+	assert_int_eq( err.code, AEROSPIKE_OK );
+	assert_int_eq( value, 24275 * 2 );
+
+	as_query_destroy(&q);
+}
+
+static bool query_foreach_3_fail_callback(const as_val * v, void * udata) {
+	if ( v != NULL ) {
+		as_incr_uint32((uint32_t *) udata);
+	}
+	return true;
+}
+
+TEST( query_foreach_3_parallel_fail, "sum(e) where a == 'abc' with failing merge" ) {
+
+	as_error err;
+	as_error_reset(&err);
+
+	uint32_t values = 0;
+
+	as_policy_query p;
+	as_policy_query_init(&p);
+	p.aggregate_threads = 4;
+	p.aggregate_queue_size = 2;
+
+	as_query q;
+	as_query_init(&q, NAMESPACE, SET);
+
+	as_query_where_inita(&q, 1);
+	as_query_where(&q, "a", as_string_equals("abc"));
+
+	// The total sum is odd, so at least one merge state fails on an odd partial sum while
+	// states holding even partial sums complete.
+	as_query_apply(&q, UDF_FILE, "sum", NULL);
+	as_query_apply_merge(&q, "sum_merge_fail_odd");
+
+	as_status rc = aerospike_query_foreach(as, &err, &p, &q, query_foreach_3_fail_callback,
+										   &values);
+
+	assert_int_ne( rc, AEROSPIKE_OK );
+	assert_int_eq( err.code, AEROSPIKE_ERR_UDF );
+	assert_int_eq( values, 0 );
+
+	as_query_destroy(&q);
+}
+
 static bool query_foreach_4_callback(const as_val * v, void * udata) {
 	if ( v != NULL ) {
 		as_integer * result = as_integer_fromval(v);
@@ -1558,8 +1756,13 @@ SUITE( query_foreach, "aerospike_query_foreach tests" ) {
 	}
 
 	suite_add( query_foreach_1 );
+	suite_add( query_foreach_1_parse_threads );
 	suite_add( query_foreach_2 );
 	suite_add( query_foreach_3 );
+	suite_add( query_foreach_3_parallel );
+	suite_add( query_foreach_3_parallel_post_reduce );
+	suite_add( query_foreach_3_parallel_fail );
+	suite_add( query_foreach_3_native );
 	suite_add( query_foreach_4 );
 	suite_add( query_foreach_5 );
 	suite_add( query_foreach_6 );
@@ -580,6 +580,198 @@ TEST( scan_basics_set1_concurrent , "scan "SET1" concurrently" ) {
 	as_scan_destroy(&scan);
 }
 
+TEST( scan_basics_set1_parse_threads , "scan "SET1" with parse threads" ) {
+
+	scan_check check = {
+		.failed = false,
+		.set = SET1,
+		.count = 0,
+		.nobindata = false,
+		.bins = { "bin1", "bin2", "bin3", NULL }
+	};
+
+	as_error err;
+
+	as_policy_scan p;
+	as_policy_scan_init(&p);
+	p.parse_threads = 4;
+	p.parse_queue_size = 2;
+
+	as_scan scan;
+	as_scan_init(&scan, NS, SET1);
+
+	as_status rc = aerospike_scan_foreach(as, &err, &p, &scan, scan_check_callback, &check);
+
+	assert_int_eq( rc, AEROSPIKE_OK );
+	assert_false( check.failed );
+
+	assert_int_eq( check.count, NUM_RECS_SET1 );
+	info("Got %d records in the scan with parse threads. Expected %d", check.count, NUM_RECS_SET1);
+
+	as_scan_destroy(&scan);
+}
+
+typedef struct scan_abort_check_s {
+	scan_check check;
+	uint32_t limit;
+	uint32_t seen;
+} scan_abort_check;
+
+static bool scan_abort_check_callback(const as_val * val, void * udata)
+{
+	scan_abort_check * ac = (scan_abort_check *) udata;
+
+	// Abort once the limit is reached. Records rejected here are not counted and must
+	// be returned by the resumed scan.
+	if ( val && as_faa_uint32(&ac->seen, 1) >= ac->limit ) {
+		return false;
+	}
+	return scan_check_callback(val, &ac->check);
+}
+
+TEST( scan_basics_set1_abort_resume , "scan "SET1" with parse threads, abort and resume" ) {
+
+	scan_abort_check ac = {
+		.check = {
+			.failed = false,
+			.set = SET1,
+			.count = 0,
+			.nobindata = false,
+			.bins = { "bin1", "bin2", "bin3", NULL }
+		},
+		.limit = 50,
+		.seen = 0
+	};
+
+	as_error err;
+
+	as_policy_scan p;
+	as_policy_scan_init(&p);
+	p.parse_threads = 4;
+	p.parse_queue_size = 2;
+	p.parse_ordered = false;
+
+	as_scan scan;
+	as_scan_init(&scan, NS, SET1);
+	as_scan_set_concurrent(&scan, true);
+	as_scan_set_paginate(&scan, true);
+
+	// Callback aborts the scan mid-stream.
+	as_status rc = aerospike_scan_foreach(as, &err, &p, &scan, scan_abort_check_callback, &ac);
+
+	assert_int_eq( rc, AEROSPIKE_OK );
+	assert_false( ac.check.failed );
+	assert_int_eq( ac.check.count, ac.limit );
+	assert_false( as_scan_is_done(&scan) );
+
+	// Resume must return every record that was not delivered before the abort.
+	ac.limit = UINT32_MAX;
+
+	uint32_t runs = 0;
+
+	while (! as_scan_is_done(&scan) && runs++ < 10) {
+		rc = aerospike_scan_foreach(as, &err, &p, &scan, scan_abort_check_callback, &ac);
+
+		assert_int_eq( rc, AEROSPIKE_OK );
+		assert_false( ac.check.failed );
+	}
+
+	assert_true( as_scan_is_done(&scan) );
+	assert_int_eq( ac.check.count, NUM_RECS_SET1 );
+	info("Got %d records in the aborted and resumed scan. Expected %d", ac.check.count,
+		NUM_RECS_SET1);
+
+	as_scan_destroy(&scan);
+}
+
+TEST( scan_basics_set1_node_parallelism , "scan "SET1" with multiple sub-scans per node" ) {
+
+	scan_check check = {
+		.failed = false,
+		.set = SET1,
+		.count = 0,
+		.nobindata = false,
+		.bins = { "bin1", "bin2", "bin3", NULL }
+	};
+
+	as_error err;
+
+	as_policy_scan p;
+	as_policy_scan_init(&p);
+	p.node_parallelism = 4;
+	p.records_per_second = 1000;
+
+	as_scan scan;
+	as_scan_init(&scan, NS, SET1);
+	as_scan_set_concurrent(&scan, true);
+
+	as_status rc = aerospike_scan_foreach(as, &err, &p, &scan, scan_check_callback, &check);
+
+	assert_int_eq( rc, AEROSPIKE_OK );
+	assert_false( check.failed );
+
+	assert_int_eq( check.count, NUM_RECS_SET1 );
+	info("Got %d records in the sub-scans. Expected %d", check.count, NUM_RECS_SET1);
+
+	as_scan_destroy(&scan);
+}
+
+TEST( scan_basics_set1_node_parallelism_resume , "scan "SET1" pages with sub-scans and resume" ) {
+
+	scan_check check = {
+		.failed = false,
+		.set = SET1,
+		.count = 0,
+		.nobindata = false,
+		.bins = { "bin1", "bin2", "bin3", NULL }
+	};
+
+	as_error err;
+
+	as_policy_scan p;
+	as_policy_scan_init(&p);
+	p.node_parallelism = 4;
+	p.max_records = 30;
+
+	as_scan scan;
+	as_scan_init(&scan, NS, SET1);
+	as_scan_set_concurrent(&scan, true);
+	as_scan_set_paginate(&scan, true);
+
+	// Read first page.
+	as_status rc = aerospike_scan_foreach(as, &err, &p, &scan, scan_check_callback, &check);
+
+	assert_int_eq( rc, AEROSPIKE_OK );
+	assert_false( check.failed );
+	assert_true( check.count <= p.max_records );
+
+	// Resume remaining pages from saved partition status in a new scan instance.
+	as_scan scan2;
+	as_scan_init(&scan2, NS, SET1);
+	as_scan_set_concurrent(&scan2, true);
+	as_scan_set_paginate(&scan2, true);
+	as_scan_set_partitions(&scan2, scan.parts_all);
+	as_scan_destroy(&scan);
+
+	uint32_t pages = 0;
+
+	while (! as_scan_is_done(&scan2) && pages++ < NUM_RECS_SET1) {
+		uint32_t prev = check.count;
+
+		rc = aerospike_scan_foreach(as, &err, &p, &scan2, scan_check_callback, &check);
+
+		assert_int_eq( rc, AEROSPIKE_OK );
+		assert_false( check.failed );
+		assert_true( check.count - prev <= p.max_records );
+	}
+
+	assert_true( as_scan_is_done(&scan2) );
+	assert_int_eq( check.count, NUM_RECS_SET1 );
+	info("Got %d records in resumed sub-scans. Expected %d", check.count, NUM_RECS_SET1);
+
+	as_scan_destroy(&scan2);
+}
+
 TEST( scan_basics_set1_select , "scan "SET1" and select 'bin1'" ) {
 
 	scan_check check = {
@@ -1332,6 +1524,10 @@ SUITE( scan_basics, "aerospike_scan basic tests" ) {
 	suite_add( scan_basics_set1 );
 	suite_add( scan_filter_set1 );
 	suite_add( scan_basics_set1_concurrent );
+	suite_add( scan_basics_set1_parse_threads );
+	suite_add( scan_basics_set1_abort_resume );
+	suite_add( scan_basics_set1_node_parallelism );
+	suite_add( scan_basics_set1_node_parallelism_resume );
 	suite_add( scan_basics_set1_select );
 	suite_add( scan_basics_set1_nodata );
 	suite_add( scan_basics_background );
@@ -14,6 +14,17 @@ local function one(r)
     return 1;
 end
 
+local function double(v)
+    return v * 2;
+end
+
+local function fail_odd(v)
+    if v % 2 == 1 then
+        error("odd partial sum")
+    end
+    return v;
+end
+
 local function filter_none(rec)
 	return 1
 end
@@ -31,6 +42,18 @@ function sum(s)
     return s : map(select("e")) : reduce(add);
 end
 
+function sum_merge(s)
+    return s : reduce(add);
+end
+
+function sum_merge_fail_odd(s)
+    return s : map(fail_odd) : reduce(add);
+end
+
+function sum_doubled(s)
+    return s : map(select("e")) : reduce(add) : map(double);
+end
+
 function sum_on_match(s, bin, val)
 
     local function _map(rec)